@@ -190,6 +190,7 @@ func (c *collectorImpl) stop(_ context.Context) error {
 		c.runner.Stop()
 		c.runner = nil
 	}
+	python.StopPython()
 	c.state.Store(stopped)
 	return nil
 }
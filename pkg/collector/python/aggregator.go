@@ -10,6 +10,7 @@ package python
 import (
 	"unsafe"
 
+	"github.com/DataDog/datadog-agent/pkg/aggregator/sender"
 	checkid "github.com/DataDog/datadog-agent/pkg/collector/check/id"
 	metricsevent "github.com/DataDog/datadog-agent/pkg/metrics/event"
 	"github.com/DataDog/datadog-agent/pkg/metrics/servicecheck"
@@ -42,6 +43,33 @@ func SubmitMetric(checkID *C.char, metricType C.metric_type_t, metricName *C.cha
 		return
 	}
 
+	submitMetricSample(sender, metricType, metricName, value, tags, hostname, flushFirstValue)
+}
+
+// SubmitMetricBatch is the method exposed to Python scripts to submit a batch of metrics in a single call
+//
+//export SubmitMetricBatch
+func SubmitMetricBatch(checkID *C.char, samples *C.metric_sample_t, samplesCount C.int) {
+	goCheckID := C.GoString(checkID)
+
+	checkContext, err := getCheckContext()
+	if err != nil {
+		log.Errorf("Python check context: %v", err)
+		return
+	}
+
+	sender, err := checkContext.senderManager.GetSender(checkid.ID(goCheckID))
+	if err != nil || sender == nil {
+		log.Errorf("Error submitting metric to the Sender: %v", err)
+		return
+	}
+
+	for _, sample := range unsafe.Slice(samples, int(samplesCount)) {
+		submitMetricSample(sender, sample._type, sample.name, sample.value, sample.tags, sample.hostname, sample.flush_first_value)
+	}
+}
+
+func submitMetricSample(sender sender.Sender, metricType C.metric_type_t, metricName *C.char, value C.double, tags **C.char, hostname *C.char, flushFirstValue C.bool) {
 	_name := C.GoString(metricName)
 	_value := float64(value)
 	_hostname := C.GoString(hostname)
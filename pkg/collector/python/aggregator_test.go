@@ -44,3 +44,7 @@ func TestSubmitHistogramBucket(t *testing.T) {
 func TestSubmitEventPlatformEvent(t *testing.T) {
 	testSubmitEventPlatformEvent(t)
 }
+
+func TestSubmitMetricBatch(t *testing.T) {
+	testSubmitMetricBatch(t)
+}
@@ -0,0 +1,409 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build python
+
+package python
+
+import (
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"math"
+	"reflect"
+	"regexp"
+	"sort"
+	"strconv"
+	"strings"
+	"time"
+	"unicode/utf8"
+
+	yaml "gopkg.in/yaml.v2"
+	yamlv3 "gopkg.in/yaml.v3"
+
+	"github.com/DataDog/datadog-agent/comp/core/autodiscovery/integration"
+	pkgconfigsetup "github.com/DataDog/datadog-agent/pkg/config/setup"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+// Value types of the binary config encoding, decoded by `from_binary` in rtloader.
+// Every value starts with its type byte, integers are little endian.
+const (
+	binaryNone   = 'n'
+	binaryTrue   = 't'
+	binaryFalse  = 'f'
+	binaryInt    = 'i' // int64
+	binaryUint   = 'u' // uint64
+	binaryFloat  = 'd' // float64
+	binaryString = 's' // uint32 length, UTF-8 bytes
+	binaryList   = 'l' // uint32 count, items
+	binaryMap    = 'm' // uint32 count, key and value of each entry
+)
+
+// maximum nesting of lists and maps, see MAX_BINARY_DEPTH in rtloader
+const binaryMaxDepth = 64
+
+// binaryCheckConfig returns the init_config and instance of a check in the binary config
+// encoding, ok is false when the YAML configuration has to be handed over instead.
+func binaryCheckConfig(initConfig integration.Data, instance integration.Data) (binInitConfig []byte, binInstance []byte, ok bool) {
+	if !pkgconfigsetup.Datadog().GetBool("python_binary_check_config") {
+		return nil, nil, false
+	}
+
+	binInitConfig, err := yamlToBinary(initConfig)
+	if err != nil {
+		log.Debugf("could not encode init_config, falling back to YAML: %s", err)
+		return nil, nil, false
+	}
+	binInstance, err = yamlToBinary(instance)
+	if err != nil {
+		log.Debugf("could not encode instance, falling back to YAML: %s", err)
+		return nil, nil, false
+	}
+	return binInitConfig, binInstance, true
+}
+
+// yamlToBinary converts a YAML document into the binary config encoding, so rtloader
+// can build the matching Python objects without parsing YAML again. The scalars are
+// resolved the way PyYAML does, following YAML 1.1, and documents holding values the
+// encoding can't represent as PyYAML would, like timestamps or aliases, are rejected so
+// that they are handed over as YAML.
+func yamlToBinary(data []byte) ([]byte, error) {
+	var doc yamlv3.Node
+	if err := yamlv3.Unmarshal(data, &doc); err != nil {
+		return nil, err
+	}
+	if doc.Kind == 0 || len(doc.Content) == 0 {
+		return encodeBinary(nil)
+	}
+
+	root := doc.Content[0]
+	if root.Kind == yamlv3.ScalarNode {
+		// only mappings, or nothing, are valid check configurations
+		if value, err := resolveYAMLScalar(root); err != nil || value != nil {
+			return nil, errors.New("configuration is not a mapping")
+		}
+		return encodeBinary(nil)
+	}
+	if root.Kind != yamlv3.MappingNode {
+		return nil, errors.New("configuration is not a mapping")
+	}
+	return appendYAMLNode(make([]byte, 0, 256), root, 0)
+}
+
+func appendYAMLNode(buf []byte, node *yamlv3.Node, depth int) ([]byte, error) {
+	if depth > binaryMaxDepth {
+		return nil, errors.New("value is nested too deeply")
+	}
+
+	var err error
+	switch node.Kind {
+	case yamlv3.ScalarNode:
+		value, err := resolveYAMLScalar(node)
+		if err != nil {
+			return nil, err
+		}
+		return appendBinary(buf, value, depth)
+	case yamlv3.SequenceNode:
+		if node.Style&yamlv3.TaggedStyle != 0 {
+			return nil, fmt.Errorf("unsupported tag %s", node.Tag)
+		}
+		if buf, err = appendLength(buf, binaryList, len(node.Content)); err != nil {
+			return nil, err
+		}
+		for _, item := range node.Content {
+			if buf, err = appendYAMLNode(buf, item, depth+1); err != nil {
+				return nil, err
+			}
+		}
+		return buf, nil
+	case yamlv3.MappingNode:
+		if node.Style&yamlv3.TaggedStyle != 0 {
+			return nil, fmt.Errorf("unsupported tag %s", node.Tag)
+		}
+		if buf, err = appendLength(buf, binaryMap, len(node.Content)/2); err != nil {
+			return nil, err
+		}
+		for i := 0; i+1 < len(node.Content); i += 2 {
+			key := node.Content[i]
+			if key.Kind != yamlv3.ScalarNode {
+				return nil, errors.New("unsupported mapping key")
+			}
+			if key.Style&(yamlv3.TaggedStyle|yamlv3.DoubleQuotedStyle|yamlv3.SingleQuotedStyle|yamlv3.LiteralStyle|yamlv3.FoldedStyle) == 0 && key.Value == "<<" {
+				return nil, errors.New("merge keys are not supported")
+			}
+			if buf, err = appendYAMLNode(buf, key, depth+1); err != nil {
+				return nil, err
+			}
+			if buf, err = appendYAMLNode(buf, node.Content[i+1], depth+1); err != nil {
+				return nil, err
+			}
+		}
+		return buf, nil
+	case yamlv3.AliasNode:
+		return nil, errors.New("aliases are not supported")
+	}
+	return nil, fmt.Errorf("unsupported YAML node kind %d", node.Kind)
+}
+
+// The implicit resolvers of PyYAML, see yaml/resolver.py
+var (
+	pyYAMLBool      = regexp.MustCompile(`^(?:yes|Yes|YES|no|No|NO|true|True|TRUE|false|False|FALSE|on|On|ON|off|Off|OFF)$`)
+	pyYAMLFloat     = regexp.MustCompile(`^(?:[-+]?(?:[0-9][0-9_]*)\.[0-9_]*(?:[eE][-+][0-9]+)?|\.[0-9_]+(?:[eE][-+][0-9]+)?|[-+]?[0-9][0-9_]*(?::[0-5]?[0-9])+\.[0-9_]*|[-+]?\.(?:inf|Inf|INF)|\.(?:nan|NaN|NAN))$`)
+	pyYAMLInt       = regexp.MustCompile(`^(?:[-+]?0b[0-1_]+|[-+]?0[0-7_]+|[-+]?(?:0|[1-9][0-9_]*)|[-+]?0x[0-9a-fA-F_]+|[-+]?[1-9][0-9_]*(?::[0-5]?[0-9])+)$`)
+	pyYAMLNull      = regexp.MustCompile(`^(?:~|null|Null|NULL|)$`)
+	pyYAMLTimestamp = regexp.MustCompile(`^(?:[0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9]|[0-9][0-9][0-9][0-9]-[0-9][0-9]?-[0-9][0-9]?(?:[Tt]|[ \t]+)[0-9][0-9]?:[0-9][0-9]:[0-9][0-9](?:\.[0-9]*)?(?:[ \t]*(?:Z|[-+][0-9][0-9]?(?::[0-9][0-9])?))?)$`)
+)
+
+// resolveYAMLScalar returns the value PyYAML builds for the given scalar, or an error for
+// the values that have no representation in the binary config encoding.
+func resolveYAMLScalar(node *yamlv3.Node) (interface{}, error) {
+	if node.Style&yamlv3.TaggedStyle != 0 {
+		if node.Tag == "!!str" {
+			return node.Value, nil
+		}
+		return nil, fmt.Errorf("unsupported tag %s", node.Tag)
+	}
+	if node.Style != 0 {
+		// quoted and block scalars are strings
+		return node.Value, nil
+	}
+
+	value := node.Value
+	switch {
+	case pyYAMLBool.MatchString(value):
+		switch value[0] {
+		case 'y', 'Y', 't', 'T':
+			return true, nil
+		case 'o', 'O':
+			return value[1] == 'n' || value[1] == 'N', nil
+		}
+		return false, nil
+	case pyYAMLFloat.MatchString(value):
+		return resolveYAMLFloat(value)
+	case pyYAMLInt.MatchString(value):
+		return resolveYAMLInt(value)
+	case value == "<<":
+		return nil, errors.New("merge keys are not supported")
+	case pyYAMLNull.MatchString(value):
+		return nil, nil
+	case pyYAMLTimestamp.MatchString(value):
+		return nil, fmt.Errorf("timestamps are not supported: %q", value)
+	case value == "=":
+		return nil, errors.New("value keys are not supported")
+	}
+	return value, nil
+}
+
+func resolveYAMLFloat(value string) (interface{}, error) {
+	value = strings.ToLower(strings.ReplaceAll(value, "_", ""))
+	sign := 1.0
+	if value[0] == '-' || value[0] == '+' {
+		if value[0] == '-' {
+			sign = -1
+		}
+		value = value[1:]
+	}
+	switch {
+	case value == ".inf":
+		return sign * math.Inf(1), nil
+	case value == ".nan":
+		return math.NaN(), nil
+	case strings.Contains(value, ":"):
+		return nil, fmt.Errorf("sexagesimal numbers are not supported: %q", value)
+	}
+	f, err := strconv.ParseFloat(value, 64)
+	if err != nil {
+		return nil, err
+	}
+	return sign * f, nil
+}
+
+func resolveYAMLInt(value string) (interface{}, error) {
+	value = strings.ReplaceAll(value, "_", "")
+	negative := false
+	if value[0] == '-' || value[0] == '+' {
+		negative = value[0] == '-'
+		value = value[1:]
+	}
+	base := 10
+	switch {
+	case strings.Contains(value, ":"):
+		return nil, fmt.Errorf("sexagesimal numbers are not supported: %q", value)
+	case value == "0":
+	case strings.HasPrefix(value, "0b"):
+		base, value = 2, value[2:]
+	case strings.HasPrefix(value, "0x"):
+		base, value = 16, value[2:]
+	case value[0] == '0':
+		base, value = 8, value[1:]
+	}
+	if value == "" {
+		// PyYAML fails to build these, like 0b_
+		return nil, errors.New("invalid integer")
+	}
+	u, err := strconv.ParseUint(value, base, 64)
+	if err != nil {
+		// larger than Python integers can be in the binary config encoding
+		return nil, err
+	}
+	if !negative {
+		if u > math.MaxInt64 {
+			return u, nil
+		}
+		return int64(u), nil
+	}
+	if u > 1<<63 {
+		return nil, errors.New("integer is too small")
+	}
+	return -int64(u), nil
+}
+
+// encodeBinary converts a configuration value into the binary config encoding. Values
+// that have no obvious Python equivalent, like structs, are rejected.
+func encodeBinary(value interface{}) ([]byte, error) {
+	return appendBinary(make([]byte, 0, 256), value, 0)
+}
+
+func appendBinary(buf []byte, value interface{}, depth int) ([]byte, error) {
+	if depth > binaryMaxDepth {
+		return nil, fmt.Errorf("value is nested too deeply")
+	}
+
+	// fast path for the types produced by the YAML decoder and the config
+	switch v := value.(type) {
+	case nil:
+		return append(buf, binaryNone), nil
+	case bool:
+		if v {
+			return append(buf, binaryTrue), nil
+		}
+		return append(buf, binaryFalse), nil
+	case int:
+		return appendUint64(append(buf, binaryInt), uint64(v)), nil
+	case int64:
+		return appendUint64(append(buf, binaryInt), uint64(v)), nil
+	case uint64:
+		return appendUint64(append(buf, binaryUint), v), nil
+	case float64:
+		return appendUint64(append(buf, binaryFloat), math.Float64bits(v)), nil
+	case string:
+		return appendString(buf, v)
+	case time.Duration:
+		// matches the YAML representation of durations
+		return appendString(buf, v.String())
+	case yaml.MapSlice:
+		return appendMapSlice(buf, v, depth)
+	case []interface{}:
+		return appendList(buf, len(v), func(i int) interface{} { return v[i] }, depth)
+	}
+
+	rv := reflect.ValueOf(value)
+	switch rv.Kind() {
+	case reflect.Bool:
+		return appendBinary(buf, rv.Bool(), depth)
+	case reflect.Int, reflect.Int8, reflect.Int16, reflect.Int32, reflect.Int64:
+		return appendBinary(buf, rv.Int(), depth)
+	case reflect.Uint, reflect.Uint8, reflect.Uint16, reflect.Uint32, reflect.Uint64, reflect.Uintptr:
+		return appendBinary(buf, rv.Uint(), depth)
+	case reflect.Float32, reflect.Float64:
+		return appendBinary(buf, rv.Float(), depth)
+	case reflect.String:
+		return appendString(buf, rv.String())
+	case reflect.Pointer, reflect.Interface:
+		if rv.IsNil() {
+			return append(buf, binaryNone), nil
+		}
+		return appendBinary(buf, rv.Elem().Interface(), depth)
+	case reflect.Slice:
+		if rv.IsNil() {
+			return append(buf, binaryNone), nil
+		}
+		fallthrough
+	case reflect.Array:
+		return appendList(buf, rv.Len(), func(i int) interface{} { return rv.Index(i).Interface() }, depth)
+	case reflect.Map:
+		if rv.IsNil() {
+			return append(buf, binaryNone), nil
+		}
+		return appendMap(buf, rv, depth)
+	}
+
+	return nil, fmt.Errorf("unsupported type %T", value)
+}
+
+func appendUint64(buf []byte, v uint64) []byte {
+	return binary.LittleEndian.AppendUint64(buf, v)
+}
+
+func appendLength(buf []byte, kind byte, length int) ([]byte, error) {
+	if uint64(length) > math.MaxUint32 {
+		return nil, fmt.Errorf("value is too large: %d", length)
+	}
+	return binary.LittleEndian.AppendUint32(append(buf, kind), uint32(length)), nil
+}
+
+func appendString(buf []byte, s string) ([]byte, error) {
+	// rtloader decodes strings strictly, and other encodings are handed over as YAML
+	if !utf8.ValidString(s) {
+		return nil, errors.New("string is not valid UTF-8")
+	}
+	buf, err := appendLength(buf, binaryString, len(s))
+	if err != nil {
+		return nil, err
+	}
+	return append(buf, s...), nil
+}
+
+func appendList(buf []byte, length int, item func(int) interface{}, depth int) ([]byte, error) {
+	buf, err := appendLength(buf, binaryList, length)
+	if err != nil {
+		return nil, err
+	}
+	for i := 0; i < length; i++ {
+		if buf, err = appendBinary(buf, item(i), depth+1); err != nil {
+			return nil, err
+		}
+	}
+	return buf, nil
+}
+
+func appendMapSlice(buf []byte, m yaml.MapSlice, depth int) ([]byte, error) {
+	buf, err := appendLength(buf, binaryMap, len(m))
+	if err != nil {
+		return nil, err
+	}
+	for _, item := range m {
+		if buf, err = appendBinary(buf, item.Key, depth+1); err != nil {
+			return nil, err
+		}
+		if buf, err = appendBinary(buf, item.Value, depth+1); err != nil {
+			return nil, err
+		}
+	}
+	return buf, nil
+}
+
+func appendMap(buf []byte, rv reflect.Value, depth int) ([]byte, error) {
+	buf, err := appendLength(buf, binaryMap, rv.Len())
+	if err != nil {
+		return nil, err
+	}
+
+	// sort the keys so the same value always yields the same payload
+	keys := rv.MapKeys()
+	sort.Slice(keys, func(i, j int) bool {
+		return fmt.Sprint(keys[i].Interface()) < fmt.Sprint(keys[j].Interface())
+	})
+	for _, key := range keys {
+		if buf, err = appendBinary(buf, key.Interface(), depth+1); err != nil {
+			return nil, err
+		}
+		if buf, err = appendBinary(buf, rv.MapIndex(key).Interface(), depth+1); err != nil {
+			return nil, err
+		}
+	}
+	return buf, nil
+}
@@ -0,0 +1,133 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build python
+
+package python
+
+import (
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+	yaml "gopkg.in/yaml.v2"
+)
+
+func TestEncodeBinaryScalars(t *testing.T) {
+	for _, tc := range []struct {
+		value    interface{}
+		expected []byte
+	}{
+		{nil, []byte{'n'}},
+		{true, []byte{'t'}},
+		{false, []byte{'f'}},
+		{-2, []byte{'i', 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}},
+		{int32(3), []byte{'i', 3, 0, 0, 0, 0, 0, 0, 0}},
+		{uint64(1 << 63), []byte{'u', 0, 0, 0, 0, 0, 0, 0, 0x80}},
+		{1.5, []byte{'d', 0, 0, 0, 0, 0, 0, 0xf8, 0x3f}},
+		{"abc", []byte{'s', 3, 0, 0, 0, 'a', 'b', 'c'}},
+		{time.Second, []byte{'s', 2, 0, 0, 0, '1', 's'}},
+		{(*string)(nil), []byte{'n'}},
+	} {
+		data, err := encodeBinary(tc.value)
+		require.NoError(t, err)
+		assert.Equal(t, tc.expected, data, "value: %#v", tc.value)
+	}
+}
+
+func TestEncodeBinaryContainers(t *testing.T) {
+	data, err := encodeBinary([]string{"a", "b"})
+	require.NoError(t, err)
+	assert.Equal(t, []byte{'l', 2, 0, 0, 0, 's', 1, 0, 0, 0, 'a', 's', 1, 0, 0, 0, 'b'}, data)
+
+	// map keys are sorted
+	data, err = encodeBinary(map[string]interface{}{"b": nil, "a": true})
+	require.NoError(t, err)
+	assert.Equal(t, []byte{'m', 2, 0, 0, 0, 's', 1, 0, 0, 0, 'a', 't', 's', 1, 0, 0, 0, 'b', 'n'}, data)
+
+	// MapSlice keys keep their order
+	data, err = encodeBinary(yaml.MapSlice{{Key: "b", Value: nil}, {Key: 1, Value: false}})
+	require.NoError(t, err)
+	assert.Equal(t, []byte{'m', 2, 0, 0, 0, 's', 1, 0, 0, 0, 'b', 'n', 'i', 1, 0, 0, 0, 0, 0, 0, 0, 'f'}, data)
+}
+
+func TestEncodeBinaryErrors(t *testing.T) {
+	_, err := encodeBinary(struct{}{})
+	assert.Error(t, err)
+
+	_, err = encodeBinary(map[string]interface{}{"a": []interface{}{time.Now()}})
+	assert.Error(t, err)
+
+	var nested interface{} = "leaf"
+	for i := 0; i <= binaryMaxDepth; i++ {
+		nested = []interface{}{nested}
+	}
+	_, err = encodeBinary(nested)
+	assert.Error(t, err)
+}
+
+func TestYAMLToBinary(t *testing.T) {
+	data, err := yamlToBinary([]byte("b: 1\na: [x]\n"))
+	require.NoError(t, err)
+	assert.Equal(t, []byte{
+		'm', 2, 0, 0, 0,
+		's', 1, 0, 0, 0, 'b', 'i', 1, 0, 0, 0, 0, 0, 0, 0,
+		's', 1, 0, 0, 0, 'a', 'l', 1, 0, 0, 0, 's', 1, 0, 0, 0, 'x',
+	}, data)
+
+	data, err = yamlToBinary([]byte(""))
+	require.NoError(t, err)
+	assert.Equal(t, []byte{'n'}, data)
+
+	// only mappings are valid check configurations
+	_, err = yamlToBinary([]byte("- a\n"))
+	assert.Error(t, err)
+}
+
+func TestYAMLToBinaryResolvesScalarsLikePyYAML(t *testing.T) {
+	for _, tc := range []struct {
+		yaml     string
+		expected interface{}
+	}{
+		{"a: 1e3", "1e3"},
+		{"a: 1.0e+3", 1000.0},
+		{"a: yes", true},
+		{"a: Off", false},
+		{"a: 0o17", "0o17"},
+		{"a: 017", int64(15)},
+		{"a: 0x1f", int64(31)},
+		{"a: 1_000", int64(1000)},
+		{"a: ~", nil},
+		{"a: '2024-01-02'", "2024-01-02"},
+		{"a: !!str 12", "12"},
+	} {
+		data, err := yamlToBinary([]byte(tc.yaml))
+		require.NoError(t, err, tc.yaml)
+		expected, err := encodeBinary(yaml.MapSlice{{Key: "a", Value: tc.expected}})
+		require.NoError(t, err)
+		assert.Equal(t, expected, data, tc.yaml)
+	}
+}
+
+func TestYAMLToBinaryFallsBack(t *testing.T) {
+	for _, doc := range []string{
+		// PyYAML builds datetime objects
+		"a: 2024-01-02",
+		"a: 2001-12-14 21:59:43.10 -5",
+		// sexagesimal numbers
+		"a: 1:30",
+		// aliases and merge keys
+		"a: &x 1\nb: *x",
+		"base: &b {x: 1}\nc:\n  <<: *b",
+		"a: !!binary aGVsbG8=",
+	} {
+		_, err := yamlToBinary([]byte(doc))
+		assert.Error(t, err, doc)
+	}
+
+	_, err := encodeBinary("\xff")
+	assert.Error(t, err)
+}
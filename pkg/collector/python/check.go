@@ -29,6 +29,7 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/collector/check/stats"
 	pkgconfigsetup "github.com/DataDog/datadog-agent/pkg/config/setup"
 	"github.com/DataDog/datadog-agent/pkg/config/utils"
+	"github.com/DataDog/datadog-agent/pkg/telemetry"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
 
@@ -47,6 +48,17 @@ const (
 	skipInstanceErrorPattern = "The integration refused to load the check configuration, it may be too old or too new."
 )
 
+var (
+	tlmCheckWallTime = telemetry.NewCounter("python_check", "wall_time_seconds",
+		[]string{"check_name"}, "Time spent running the check")
+	tlmCheckCPUTime = telemetry.NewCounter("python_check", "cpu_time_seconds",
+		[]string{"check_name"}, "CPU time used while running the check")
+	tlmCheckGILWait = telemetry.NewCounter("python_check", "gil_wait_seconds",
+		[]string{"check_name"}, "Time spent waiting for the GIL to run the check")
+	tlmCheckAllocBytes = telemetry.NewCounter("python_check", "alloc_bytes",
+		[]string{"check_name"}, "Memory requested by the Python interpreter while running the check")
+)
+
 // PythonCheck represents a Python check, implements `Check` interface
 //
 //nolint:revive
@@ -64,6 +76,7 @@ type PythonCheck struct {
 	initConfig     string
 	instanceConfig string
 	haSupported    bool
+	profile        C.check_profile_t // resources used by the check, as of the last run
 }
 
 // NewPythonCheck conveniently creates a PythonCheck instance
@@ -96,6 +109,8 @@ func (c *PythonCheck) runCheckImpl(commitMetrics bool) error {
 	if err != nil {
 		return err
 	}
+	// hand what the run allocated and freed to the memory tracker, once the GIL is released
+	defer flushMemoryTracker()
 	defer gstate.unlock()
 
 	log.Debugf("Running python check %s (version: '%s', id: '%s')", c.ModuleName, c.version, c.id)
@@ -109,6 +124,10 @@ func (c *PythonCheck) runCheckImpl(commitMetrics bool) error {
 	}
 	defer C.rtloader_free(rtloader, unsafe.Pointer(cResult))
 
+	if c.telemetry {
+		c.reportProfile()
+	}
+
 	if commitMetrics {
 		s, err := c.senderManager.GetSender(c.ID())
 		if err != nil {
@@ -127,6 +146,21 @@ func (c *PythonCheck) runCheckImpl(commitMetrics bool) error {
 	return errors.New(checkErrStr)
 }
 
+// reportProfile reports the resources used by the last run of the check.
+// This function is run with the GIL locked by runCheck
+func (c *PythonCheck) reportProfile() {
+	var profile C.check_profile_t
+	if C.get_check_profile(rtloader, c.instance, &profile) == 0 {
+		return
+	}
+
+	tlmCheckWallTime.Add(float64(profile.wall_time_ns-c.profile.wall_time_ns)/1e9, c.ModuleName)
+	tlmCheckCPUTime.Add(float64(profile.cpu_time_ns-c.profile.cpu_time_ns)/1e9, c.ModuleName)
+	tlmCheckGILWait.Add(float64(profile.gil_wait_ns-c.profile.gil_wait_ns)/1e9, c.ModuleName)
+	tlmCheckAllocBytes.Add(float64(profile.alloc_bytes-c.profile.alloc_bytes), c.ModuleName)
+	c.profile = profile
+}
+
 func (c *PythonCheck) runCheck(commitMetrics bool) error {
 	ctx := context.Background()
 	var err error
@@ -300,7 +334,16 @@ func (c *PythonCheck) Configure(_senderManager sender.SenderManager, integration
 	defer C._free(unsafe.Pointer(cCheckName))
 
 	var check *C.rtloader_pyobject_t
-	res := C.get_check(rtloader, c.class, cInitConfig, cInstance, cCheckID, cCheckName, &check)
+	var res C.int
+	if binInitConfig, binInstance, ok := binaryCheckConfig(initConfig, data); ok {
+		// the buffers are only read during the call, no need to copy them to C memory
+		res = C.get_check_from_binary(rtloader, c.class,
+			(*C.char)(unsafe.Pointer(unsafe.SliceData(binInitConfig))), C.size_t(len(binInitConfig)),
+			(*C.char)(unsafe.Pointer(unsafe.SliceData(binInstance))), C.size_t(len(binInstance)),
+			cCheckID, cCheckName, &check)
+	} else {
+		res = C.get_check(rtloader, c.class, cInitConfig, cInstance, cCheckID, cCheckName, &check)
+	}
 	var rtLoaderError error
 	if res == 0 {
 		rtLoaderError = getRtLoaderError()
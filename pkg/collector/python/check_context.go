@@ -43,7 +43,8 @@ func getCheckContext() (*checkContext, error) {
 
 func initializeCheckContext(senderManager sender.SenderManager, logReceiver option.Option[integrations.Component], tagger tagger.Component) {
 	checkContextMutex.Lock()
-	if checkCtx == nil {
+	created := checkCtx == nil
+	if created {
 		checkCtx = &checkContext{
 			senderManager: senderManager,
 			logReceiver:   logReceiver,
@@ -56,9 +57,16 @@ func initializeCheckContext(senderManager sender.SenderManager, logReceiver opti
 	}
 
 	checkContextMutex.Unlock()
+
+	if created {
+		// the tags cache invalidation subscribes to the tagger of the context
+		initTagsCache()
+	}
 }
 
 func releaseCheckContext() {
+	stopTagsCache()
+
 	checkContextMutex.Lock()
 	checkCtx = nil
 	checkContextMutex.Unlock()
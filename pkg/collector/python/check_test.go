@@ -59,6 +59,10 @@ func TestConfigure(t *testing.T) {
 	testConfigure(t)
 }
 
+func TestConfigureBinary(t *testing.T) {
+	testConfigureBinary(t)
+}
+
 func TestConfigureDeprecated(t *testing.T) {
 	testConfigureDeprecated(t)
 }
@@ -129,6 +129,36 @@ func GetConfig(key *C.char, yamlPayload **C.char) {
 	*yamlPayload = TrackedCString(string(data))
 }
 
+// GetConfigBinary returns a value from the agent configuration in the binary config encoding.
+// Indirectly used by the C function `get_config` that's mapped to `datadog_agent.get_config`.
+// No payload is returned for values that can't be encoded or when python_binary_check_config
+// is disabled, rtloader falls back to GetConfig.
+//
+//export GetConfigBinary
+func GetConfigBinary(key *C.char, payload **C.char, payloadLen *C.size_t) {
+	*payload = nil
+	*payloadLen = 0
+
+	if !pkgconfigsetup.Datadog().GetBool("python_binary_check_config") {
+		return
+	}
+
+	goKey := C.GoString(key)
+	if !pkgconfigsetup.Datadog().IsSet(goKey) {
+		return
+	}
+
+	value := pkgconfigsetup.Datadog().Get(goKey)
+	data, err := encodeBinary(value)
+	if err != nil {
+		log.Debugf("could not encode configuration value '%s', falling back to YAML: %s", goKey, err)
+		return
+	}
+	// payload will be free by rtloader when it's done with it
+	*payload = TrackedCBytes(data)
+	*payloadLen = C.size_t(len(data))
+}
+
 // LogMessage logs a message from python through the agent logger (see
 // https://docs.python.org/2.7/library/logging.html#logging-levels)
 //
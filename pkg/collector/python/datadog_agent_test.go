@@ -31,6 +31,10 @@ func TestGetConfig(t *testing.T) {
 	testGetConfig(t)
 }
 
+func TestGetConfigBinary(t *testing.T) {
+	testGetConfigBinary(t)
+}
+
 func TestSetExternalTags(t *testing.T) {
 	testSetExternalTags(t)
 }
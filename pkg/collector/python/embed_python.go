@@ -29,6 +29,13 @@ func InitPython(paths ...string) {
 	}
 }
 
+// StopPython is called when the collector stops, Python itself is never finalized
+func StopPython() {
+	stopTagsCache()
+	// deliver the allocations still queued to the memory tracker
+	flushMemoryTracker()
+}
+
 func pySetup(paths ...string) (pythonVersion, pythonHome, pythonPath string) {
 	if err := Initialize(paths...); err != nil {
 		log.Errorf("Could not initialize Python: %s", err)
@@ -50,9 +50,9 @@ char *getStringAddr(char **array, unsigned int idx) {
 //
 // init memory tracking facilities method
 //
-void MemoryTracker(void *, size_t, rtloader_mem_ops_t);
+void MemoryTrackerBatch(rtloader_mem_event_t *, size_t);
 void initMemoryTracker(void) {
-	set_memory_tracker_cb(MemoryTracker);
+	set_memory_tracker_batch_cb(MemoryTrackerBatch);
 }
 
 //
@@ -84,6 +84,7 @@ void initLogger(rtloader_t *rtloader) {
 
 void GetClusterName(char **);
 void GetConfig(char*, char **);
+void GetConfigBinary(char*, char **, size_t *);
 void GetHostname(char **);
 void GetHostTags(char **);
 void GetVersion(char **);
@@ -103,6 +104,7 @@ void EmitAgentTelemetry(char *, char *, double, char *);
 void initDatadogAgentModule(rtloader_t *rtloader) {
 	set_get_clustername_cb(rtloader, GetClusterName);
 	set_get_config_cb(rtloader, GetConfig);
+	set_get_config_binary_cb(rtloader, GetConfigBinary);
 	set_get_hostname_cb(rtloader, GetHostname);
 	set_get_host_tags_cb(rtloader, GetHostTags);
 	set_get_version_cb(rtloader, GetVersion);
@@ -129,6 +131,7 @@ void SubmitServiceCheck(char *, char *, int, char **, char *, char *);
 void SubmitEvent(char *, event_t *);
 void SubmitHistogramBucket(char *, char *, long long, float, float, int, char *, char **, bool);
 void SubmitEventPlatformEvent(char *, char *, int, char *);
+void SubmitMetricBatch(char *, metric_sample_t *, int);
 
 void initAggregatorModule(rtloader_t *rtloader) {
 	set_submit_metric_cb(rtloader, SubmitMetric);
@@ -136,6 +139,7 @@ void initAggregatorModule(rtloader_t *rtloader) {
 	set_submit_event_cb(rtloader, SubmitEvent);
 	set_submit_histogram_bucket_cb(rtloader, SubmitHistogramBucket);
 	set_submit_event_platform_event_cb(rtloader, SubmitEventPlatformEvent);
+	set_submit_metric_batch_cb(rtloader, SubmitMetricBatch);
 }
 
 //
@@ -143,9 +147,15 @@ void initAggregatorModule(rtloader_t *rtloader) {
 //
 
 void GetSubprocessOutput(char **, char **, char **, char **, int*, char **);
+int64_t StartSubprocess(char **, char **, char **);
+int ReadSubprocessOutput(int64_t, char **, size_t *, char **, int *, char **);
+void StopSubprocess(int64_t);
 
 void initUtilModule(rtloader_t *rtloader) {
 	set_get_subprocess_output_cb(rtloader, GetSubprocessOutput);
+	set_start_subprocess_cb(rtloader, StartSubprocess);
+	set_read_subprocess_output_cb(rtloader, ReadSubprocessOutput);
+	set_stop_subprocess_cb(rtloader, StopSubprocess);
 }
 
 //
@@ -438,6 +448,7 @@ func Initialize(paths ...string) error {
 	C.initAggregatorModule(rtloader)
 	C.initUtilModule(rtloader)
 	C.initTaggerModule(rtloader)
+	initTagsCache()       // special init for the tags cache invalidation, when the check context is already set
 	initContainerFilter() // special init for the container go code
 	C.initContainersModule(rtloader)
 	C.initkubeutilModule(rtloader)
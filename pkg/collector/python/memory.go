@@ -111,14 +111,40 @@ func MemoryTracker(ptr unsafe.Pointer, sz C.size_t, op C.rtloader_mem_ops_t) {
 	}
 }
 
+// MemoryTrackerBatch is the method exposed to the RTLoader for batched memory tracking
+//
+//export MemoryTrackerBatch
+func MemoryTrackerBatch(events *C.rtloader_mem_event_t, count C.size_t) {
+	for _, event := range unsafe.Slice(events, int(count)) {
+		MemoryTracker(event.ptr, event.sz, event.op)
+	}
+}
+
+// flushMemoryTracker hands the allocations and frees queued by rtloader to MemoryTrackerBatch
+func flushMemoryTracker() {
+	C.flush_memory_tracker()
+}
+
 // TrackedCString returns a C string that will be tracked by the memory tracker
 func TrackedCString(str string) *C.char {
 	cstr := C.CString(str)
 
 	// TODO(memory-tracking): track the origin of the string (for example check name)
 	if pkgconfigsetup.Datadog().GetBool("memtrack_enabled") {
-		MemoryTracker(unsafe.Pointer(cstr), C.size_t(len(str)+1), C.DATADOG_AGENT_RTLOADER_ALLOCATION)
+		// queued with the rtloader allocations, so it is seen before the matching _free
+		C._track_memory(unsafe.Pointer(cstr), C.size_t(len(str)+1), C.DATADOG_AGENT_RTLOADER_ALLOCATION)
 	}
 
 	return cstr
 }
+
+// TrackedCBytes returns a C copy of the supplied bytes that will be tracked by the memory tracker
+func TrackedCBytes(data []byte) *C.char {
+	cdata := C.CBytes(data)
+
+	if pkgconfigsetup.Datadog().GetBool("memtrack_enabled") {
+		C._track_memory(cdata, C.size_t(len(data)), C.DATADOG_AGENT_RTLOADER_ALLOCATION)
+	}
+
+	return (*C.char)(cdata)
+}
@@ -8,6 +8,7 @@
 package python
 
 import (
+	"sync"
 	"unsafe"
 
 	"github.com/DataDog/datadog-agent/comp/core/tagger/types"
@@ -23,6 +24,73 @@ import (
 */
 import "C"
 
+const tagsCacheSubscriptionID = "python-tags-cache"
+
+var (
+	tagsCacheMutex        sync.Mutex
+	tagsCacheSubscription types.Subscription
+)
+
+// initTagsCache enables the rtloader tags cache and invalidates it every time
+// the tagger reports entity changes. It needs both rtloader and the check context,
+// which are set up in either order depending on python_lazy_loading, so it is
+// called once each of them is ready. The cache stays disabled when the tagger
+// does not support subscriptions.
+func initTagsCache() {
+	if rtloader == nil {
+		return
+	}
+	checkContext, err := getCheckContext()
+	if err != nil {
+		log.Debugf("Python tags cache disabled until the check context is set: %v", err)
+		return
+	}
+
+	tagsCacheMutex.Lock()
+	defer tagsCacheMutex.Unlock()
+	if tagsCacheSubscription != nil {
+		return
+	}
+
+	filter := types.NewFilterBuilder().Build(types.HighCardinality)
+	subscription, err := checkContext.tagger.Subscribe(tagsCacheSubscriptionID, filter)
+	if err != nil || subscription == nil {
+		log.Debugf("Python tags cache disabled, could not subscribe to the tagger: %v", err)
+		return
+	}
+	tagsCacheSubscription = subscription
+
+	rtl := rtloader
+	C.bump_tags_cache_generation(rtl)
+	go func() {
+		// ends when the subscription is cancelled by stopTagsCache
+		for range subscription.EventsChan() {
+			tagsCacheMutex.Lock()
+			// events still queued when the subscription is cancelled must not
+			// re-enable the cache disabled by stopTagsCache
+			if tagsCacheSubscription == subscription {
+				C.bump_tags_cache_generation(rtl)
+			}
+			tagsCacheMutex.Unlock()
+		}
+	}()
+}
+
+// stopTagsCache cancels the tagger subscription invalidating the tags cache,
+// and disables the cache since it would no longer be invalidated.
+func stopTagsCache() {
+	tagsCacheMutex.Lock()
+	defer tagsCacheMutex.Unlock()
+	if tagsCacheSubscription == nil {
+		return
+	}
+	tagsCacheSubscription.Unsubscribe()
+	tagsCacheSubscription = nil
+	if rtloader != nil {
+		C.disable_tags_cache(rtloader)
+	}
+}
+
 // Tags bridges towards tagger.Tag to retrieve container tags
 //
 //export Tags
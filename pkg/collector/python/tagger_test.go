@@ -22,3 +22,7 @@ func TestTagsNull(t *testing.T) {
 func TestTagsEmpty(t *testing.T) {
 	testTagsEmpty(t)
 }
+
+func TestTagsCacheSubscription(t *testing.T) {
+	testTagsCacheSubscription(t)
+}
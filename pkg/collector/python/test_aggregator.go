@@ -284,6 +284,41 @@ func testSubmitEventPlatformEvent(t *testing.T) {
 	sender.AssertEventPlatformEvent(t, []byte("raw-event"), "dbm-sample")
 }
 
+func testSubmitMetricBatch(t *testing.T) {
+	sender := mocksender.NewMockSender(checkid.ID("testID"))
+	logReceiver := option.None[integrations.Component]()
+	tagger := nooptagger.NewComponent()
+	release := scopeInitCheckContext(sender.GetSenderManager(), logReceiver, tagger)
+	defer release()
+
+	sender.SetupAcceptAll()
+
+	cTags := []*C.char{C.CString("tag1"), C.CString("tag2"), nil}
+	cEmptyTags := []*C.char{nil}
+	samples := []C.metric_sample_t{
+		{
+			_type:             C.DATADOG_AGENT_RTLOADER_GAUGE,
+			name:              C.CString("test_gauge"),
+			value:             C.double(21),
+			tags:              &cTags[0],
+			hostname:          C.CString("my_hostname"),
+			flush_first_value: C.bool(false),
+		},
+		{
+			_type:             C.DATADOG_AGENT_RTLOADER_MONOTONIC_COUNT,
+			name:              C.CString("test_monotonic_count"),
+			value:             C.double(42),
+			tags:              &cEmptyTags[0],
+			hostname:          C.CString(""),
+			flush_first_value: C.bool(true),
+		},
+	}
+	SubmitMetricBatch(C.CString("testID"), &samples[0], C.int(len(samples)))
+
+	sender.AssertMetric(t, "Gauge", "test_gauge", 21, "my_hostname", []string{"tag1", "tag2"})
+	sender.AssertMonotonicCount(t, "MonotonicCountWithFlushFirstValue", "test_monotonic_count", 42, "", nil, true)
+}
+
 func scopeInitCheckContext(senderManager sender.SenderManager, logReceiver option.Option[integrations.Component], taggerComp tagger.Component) func() {
 	// Ensure the check context is released before initializing a new one
 	releaseCheckContext()
@@ -23,6 +23,7 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/aggregator/mocksender"
 	"github.com/DataDog/datadog-agent/pkg/aggregator/sender"
 	checkid "github.com/DataDog/datadog-agent/pkg/collector/check/id"
+	pkgconfigmock "github.com/DataDog/datadog-agent/pkg/config/mock"
 )
 
 /*
@@ -104,6 +105,12 @@ char *get_check_diagnoses(rtloader_t *s, rtloader_pyobject_t *check) {
 	return get_check_diagnoses_return;
 }
 
+int get_check_profile_calls = 0;
+int get_check_profile(rtloader_t *s, rtloader_pyobject_t *check, check_profile_t *profile) {
+	get_check_profile_calls++;
+	return 0;
+}
+
 //
 // get_check MOCK
 //
@@ -131,6 +138,40 @@ const char *check_id, const char *check_name, rtloader_pyobject_t **check) {
 	return get_check_return;
 }
 
+//
+// get_check_from_binary MOCK
+//
+
+int get_check_from_binary_return = 0;
+int get_check_from_binary_calls = 0;
+rtloader_pyobject_t *get_check_from_binary_py_class = NULL;
+char *get_check_from_binary_init_config = NULL;
+size_t get_check_from_binary_init_config_len = 0;
+char *get_check_from_binary_instance = NULL;
+size_t get_check_from_binary_instance_len = 0;
+const char *get_check_from_binary_check_id = NULL;
+const char *get_check_from_binary_check_name = NULL;
+rtloader_pyobject_t *get_check_from_binary_check = NULL;
+
+int get_check_from_binary(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *init_config,
+size_t init_config_len, const char *instance, size_t instance_len, const char *check_id, const char *check_name,
+rtloader_pyobject_t **check) {
+
+	get_check_from_binary_py_class = py_class;
+	get_check_from_binary_init_config = malloc(init_config_len);
+	memcpy(get_check_from_binary_init_config, init_config, init_config_len);
+	get_check_from_binary_init_config_len = init_config_len;
+	get_check_from_binary_instance = malloc(instance_len);
+	memcpy(get_check_from_binary_instance, instance, instance_len);
+	get_check_from_binary_instance_len = instance_len;
+	get_check_from_binary_check_id = strdup(check_id);
+	get_check_from_binary_check_name = strdup(check_name);
+	*check = get_check_from_binary_check;
+
+	get_check_from_binary_calls++;
+	return get_check_from_binary_return;
+}
+
 // get_check_deprecated MOCK
 
 int get_check_deprecated_calls = 0;
@@ -185,6 +226,17 @@ void reset_check_mock() {
 	cancel_check_calls = 0;
 	cancel_check_instance = NULL;
 
+	get_check_from_binary_return = 0;
+	get_check_from_binary_calls = 0;
+	get_check_from_binary_py_class = NULL;
+	get_check_from_binary_init_config = NULL;
+	get_check_from_binary_init_config_len = 0;
+	get_check_from_binary_instance = NULL;
+	get_check_from_binary_instance_len = 0;
+	get_check_from_binary_check_id = NULL;
+	get_check_from_binary_check_name = NULL;
+	get_check_from_binary_check = NULL;
+
 	get_check_deprecated_calls = 0;
 	get_check_deprecated_return = 0;
 	get_check_deprecated_py_class = NULL;
@@ -197,6 +249,8 @@ void reset_check_mock() {
 
 	get_check_diagnoses_return = NULL;
 	get_check_diagnoses_calls = 0;
+
+	get_check_profile_calls = 0;
 }
 */
 import "C"
@@ -543,6 +597,7 @@ func testRunSimple(t *testing.T) {
 
 func testConfigure(t *testing.T) {
 	mockRtloader(t)
+	pkgconfigmock.New(t).SetWithoutSource("python_binary_check_config", false)
 
 	senderManager := mocksender.CreateDefaultDemultiplexer()
 	c, err := NewPythonFakeCheck(senderManager)
@@ -577,6 +632,7 @@ func testConfigure(t *testing.T) {
 
 func testConfigureDeprecated(t *testing.T) {
 	mockRtloader(t)
+	pkgconfigmock.New(t).SetWithoutSource("python_binary_check_config", false)
 
 	senderManager := mocksender.CreateDefaultDemultiplexer()
 	c, err := NewPythonFakeCheck(senderManager)
@@ -611,6 +667,38 @@ func testConfigureDeprecated(t *testing.T) {
 	assert.Equal(t, c.instance, C.get_check_deprecated_check)
 }
 
+func testConfigureBinary(t *testing.T) {
+	mockRtloader(t)
+	pkgconfigmock.New(t).SetWithoutSource("python_binary_check_config", true)
+
+	senderManager := mocksender.CreateDefaultDemultiplexer()
+	c, err := NewPythonFakeCheck(senderManager)
+	if !assert.Nil(t, err) {
+		return
+	}
+
+	c.class = newMockPyObjectPtr()
+
+	C.reset_check_mock()
+
+	C.get_check_from_binary_return = 1
+	C.get_check_from_binary_check = newMockPyObjectPtr()
+	err = c.Configure(senderManager, integration.FakeConfigHash, integration.Data("{\"val\": 21}"), integration.Data(""), "test")
+	assert.Nil(t, err)
+
+	// {"val": 21}
+	expectedInstance := []byte{'m', 1, 0, 0, 0, 's', 3, 0, 0, 0, 'v', 'a', 'l', 'i', 21, 0, 0, 0, 0, 0, 0, 0}
+	assert.Equal(t, c.class, C.get_check_from_binary_py_class)
+	assert.Equal(t, []byte{'n'}, C.GoBytes(unsafe.Pointer(C.get_check_from_binary_init_config), C.int(C.get_check_from_binary_init_config_len)))
+	assert.Equal(t, expectedInstance, C.GoBytes(unsafe.Pointer(C.get_check_from_binary_instance), C.int(C.get_check_from_binary_instance_len)))
+	assert.Equal(t, string(c.id), C.GoString(C.get_check_from_binary_check_id))
+	assert.Equal(t, "fake_check", C.GoString(C.get_check_from_binary_check_name))
+	assert.Equal(t, C.get_check_from_binary_check, c.instance)
+
+	assert.Equal(t, C.int(0), C.get_check_calls)
+	assert.Nil(t, C.get_check_deprecated_check)
+}
+
 func testGetDiagnoses(t *testing.T) {
 	C.reset_check_mock()
 
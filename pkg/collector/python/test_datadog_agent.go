@@ -77,6 +77,26 @@ func testGetConfig(t *testing.T) {
 	assert.Equal(t, "5001\n", C.GoString(config))
 }
 
+func testGetConfigBinary(t *testing.T) {
+	cfg := pkgconfigmock.New(t)
+	var payload *C.char
+	var payloadLen C.size_t
+
+	// the YAML path is used unless python_binary_check_config is enabled
+	cfg.SetWithoutSource("python_binary_check_config", false)
+	GetConfigBinary(C.CString("cmd_port"), &payload, &payloadLen)
+	require.Nil(t, payload)
+	assert.Zero(t, payloadLen)
+
+	cfg.SetWithoutSource("python_binary_check_config", true)
+	GetConfigBinary(C.CString("does not exist"), &payload, &payloadLen)
+	require.Nil(t, payload)
+
+	GetConfigBinary(C.CString("cmd_port"), &payload, &payloadLen)
+	require.NotNil(t, payload)
+	assert.NotZero(t, payloadLen)
+}
+
 func testSetExternalTags(t *testing.T) {
 	ctags := []*C.char{C.CString("tag1"), C.CString("tag2"), nil}
 
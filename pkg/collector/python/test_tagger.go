@@ -23,6 +23,7 @@ import (
 )
 
 /*
+#include <datadog_agent_rtloader.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -36,6 +37,16 @@ int arraylen(char **array, int max_len) {
 	return i;
 }
 
+int bump_tags_cache_generation_calls = 0;
+void bump_tags_cache_generation(rtloader_t *s) {
+	bump_tags_cache_generation_calls++;
+}
+
+int disable_tags_cache_calls = 0;
+void disable_tags_cache(rtloader_t *s) {
+	disable_tags_cache_calls++;
+}
+
 */
 import "C"
 
@@ -91,3 +102,27 @@ func testTagsEmpty(t *testing.T) {
 	res := Tags(id, 0)
 	require.Nil(t, res)
 }
+
+func testTagsCacheSubscription(t *testing.T) {
+	mockRtloader(t)
+	C.bump_tags_cache_generation_calls = 0
+	C.disable_tags_cache_calls = 0
+
+	sender := mocksender.NewMockSender(checkid.ID("testID"))
+	logReceiver := option.None[integrations.Component]()
+	tagger := taggerfxmock.SetupFakeTagger(t)
+
+	// the check context is created once rtloader is initialized
+	release := scopeInitCheckContext(sender.GetSenderManager(), logReceiver, tagger)
+	require.NotNil(t, tagsCacheSubscription)
+	assert.GreaterOrEqual(t, int(C.bump_tags_cache_generation_calls), 1)
+
+	// a second initialization doesn't subscribe again
+	subscription := tagsCacheSubscription
+	initTagsCache()
+	assert.Equal(t, subscription, tagsCacheSubscription)
+
+	release()
+	assert.Nil(t, tagsCacheSubscription)
+	assert.Equal(t, 1, int(C.disable_tags_cache_calls))
+}
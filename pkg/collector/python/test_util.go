@@ -10,8 +10,10 @@ package python
 import (
 	"sync"
 	"testing"
+	"time"
 
 	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
 )
 
 import "C"
@@ -78,6 +80,94 @@ func testGetSubprocessOutputError(t *testing.T) {
 	assert.Nil(t, exception)
 }
 
+// readStreamedSubprocess reads a subprocess started by StartSubprocess until it exits
+func readStreamedSubprocess(t *testing.T, handle C.int64_t) (stdout []string, stderr string, retCode int) {
+	for {
+		var cChunk *C.char
+		var cChunkLen C.size_t
+		var cStderr *C.char
+		var cRetCode C.int
+		var exception *C.char
+
+		if ReadSubprocessOutput(handle, &cChunk, &cChunkLen, &cStderr, &cRetCode, &exception) == 0 {
+			require.Nil(t, exception)
+			return stdout, C.GoString(cStderr), int(cRetCode)
+		}
+		stdout = append(stdout, C.GoStringN(cChunk, C.int(cChunkLen)))
+	}
+}
+
+func testStreamSubprocessOutput(t *testing.T) {
+	var argv []*C.char = []*C.char{C.CString("echo"), C.CString("hello world"), nil}
+	var env **C.char
+	var exception *C.char
+
+	handle := StartSubprocess(&argv[0], env, &exception)
+	require.Nil(t, exception)
+	require.NotEqual(t, C.int64_t(0), handle)
+
+	stdout, stderr, retCode := readStreamedSubprocess(t, handle)
+	assert.Equal(t, []string{"hello world\n"}, stdout)
+	assert.Equal(t, "", stderr)
+	assert.Equal(t, 0, retCode)
+
+	// the handle was released
+	var cChunk *C.char
+	var cChunkLen C.size_t
+	var cStderr *C.char
+	var cRetCode C.int
+	assert.Equal(t, C.int(0), ReadSubprocessOutput(handle, &cChunk, &cChunkLen, &cStderr, &cRetCode, &exception))
+	assert.NotNil(t, exception)
+}
+
+func testStreamSubprocessOutputError(t *testing.T) {
+	var argv []*C.char = []*C.char{C.CString("ls"), C.CString("does not exists"), nil}
+	var env **C.char
+	var exception *C.char
+
+	handle := StartSubprocess(&argv[0], env, &exception)
+	require.Nil(t, exception)
+
+	stdout, stderr, retCode := readStreamedSubprocess(t, handle)
+	assert.Empty(t, stdout)
+	assert.NotEqual(t, "", stderr)
+	assert.NotEqual(t, 0, retCode)
+}
+
+func testStreamSubprocessOutputUnknownBin(t *testing.T) {
+	// unlike GetSubprocessOutput, failing to start the command is reported
+	var argv []*C.char = []*C.char{C.CString("unknown_command"), nil}
+	var env **C.char
+	var exception *C.char
+
+	handle := StartSubprocess(&argv[0], env, &exception)
+	assert.Equal(t, C.int64_t(0), handle)
+	assert.NotNil(t, exception)
+}
+
+func testStopSubprocess(t *testing.T) {
+	var argv []*C.char = []*C.char{C.CString("sleep"), C.CString("60"), nil}
+	var env **C.char
+	var exception *C.char
+
+	handle := StartSubprocess(&argv[0], env, &exception)
+	require.Nil(t, exception)
+
+	value, ok := streamedSubprocesses.Load(int64(handle))
+	require.True(t, ok)
+	StopSubprocess(handle)
+	_, ok = streamedSubprocesses.Load(int64(handle))
+	assert.False(t, ok)
+
+	// the process gets killed, which closes its stdout
+	select {
+	case _, ok := <-value.(*streamedSubprocess).chunks:
+		assert.False(t, ok)
+	case <-time.After(5 * time.Second):
+		t.Error("subprocess was not killed")
+	}
+}
+
 func mockRtloader(t *testing.T) {
 	rtloader = newMockRtLoaderPtr()
 	pythonOnce.Do(func() {})
@@ -15,11 +15,14 @@ package python
 import "C"
 
 import (
+	"context"
 	"fmt"
 	"io"
 	"os/exec"
 	"sync"
+	"sync/atomic"
 	"syscall"
+	"unicode/utf8"
 )
 
 // GetSubprocessOutput runs the subprocess and returns the output
@@ -73,15 +76,193 @@ func GetSubprocessOutput(argv **C.char, env **C.char, cStdout **C.char, cStderr
 	// Wait for the pipes to be closed *before* waiting for the cmd to exit, as per os.exec docs
 	wg.Wait()
 
-	retCode := 0
-	err = cmd.Wait()
+	retCode := exitCode(cmd.Wait())
+
+	*cStdout = TrackedCString(string(output))
+	*cStderr = TrackedCString(string(outputErr))
+	*cRetCode = C.int(retCode)
+}
+
+// exitCode returns the exit code of a command given the error returned by its Wait method
+func exitCode(err error) int {
 	if exiterr, ok := err.(*exec.ExitError); ok {
 		if status, ok := exiterr.Sys().(syscall.WaitStatus); ok {
-			retCode = status.ExitStatus()
+			return status.ExitStatus()
 		}
 	}
+	return 0
+}
 
-	*cStdout = TrackedCString(string(output))
-	*cStderr = TrackedCString(string(outputErr))
+// maximum size of the stdout chunks of streamed subprocesses
+const subprocessChunkSize = 64 * 1024
+
+// streamedSubprocess is a subprocess started by StartSubprocess, its stdout is handed to
+// Python one chunk at a time.
+type streamedSubprocess struct {
+	cmd        *exec.Cmd
+	cancel     context.CancelFunc
+	chunks     chan []byte // closed once stdout is exhausted
+	stderr     []byte      // set once stderrDone is closed
+	stderrDone chan struct{}
+}
+
+var (
+	streamedSubprocesses sync.Map // handle -> *streamedSubprocess
+	lastSubprocessHandle atomic.Int64
+)
+
+// StartSubprocess starts a subprocess and returns a handle to read its output with
+// ReadSubprocessOutput, or 0 on error.
+// Indirectly used by the C function `start_subprocess_output` that's mapped to `_util.start_subprocess_output`.
+//
+//export StartSubprocess
+func StartSubprocess(argv **C.char, env **C.char, exception **C.char) C.int64_t {
+	subprocessArgs := cStringArrayToSlice(argv)
+	// this should never happen as this case is filtered by rtloader
+	if len(subprocessArgs) == 0 {
+		return 0
+	}
+
+	ctx, _ := GetSubprocessContextCancel()
+	ctx, cancel := context.WithCancel(ctx)
+	cmd := exec.CommandContext(ctx, subprocessArgs[0], subprocessArgs[1:]...)
+
+	subprocessEnv := cStringArrayToSlice(env)
+	if len(subprocessEnv) != 0 {
+		cmd.Env = subprocessEnv
+	}
+
+	stdout, err := cmd.StdoutPipe()
+	if err != nil {
+		cancel()
+		*exception = TrackedCString(fmt.Sprintf("internal error creating stdout pipe: %v", err))
+		return 0
+	}
+
+	stderr, err := cmd.StderrPipe()
+	if err != nil {
+		cancel()
+		*exception = TrackedCString(fmt.Sprintf("internal error creating stderr pipe: %v", err))
+		return 0
+	}
+
+	if err := cmd.Start(); err != nil {
+		cancel()
+		*exception = TrackedCString(fmt.Sprintf("unable to start subprocess: %v", err))
+		return 0
+	}
+
+	p := &streamedSubprocess{
+		cmd:        cmd,
+		cancel:     cancel,
+		chunks:     make(chan []byte, 4),
+		stderrDone: make(chan struct{}),
+	}
+	go p.readStdout(stdout)
+	go func() {
+		defer close(p.stderrDone)
+		p.stderr, _ = io.ReadAll(stderr)
+	}()
+
+	handle := lastSubprocessHandle.Add(1)
+	streamedSubprocesses.Store(handle, p)
+	return C.int64_t(handle)
+}
+
+// ReadSubprocessOutput waits for the next chunk of stdout of a subprocess started by
+// StartSubprocess and returns 1. Once stdout is exhausted, it waits for the subprocess
+// to exit, returns its stderr and exit code instead, and releases the handle.
+// Indirectly used by the C function backing the `_util.SubprocessOutput` python type.
+//
+//export ReadSubprocessOutput
+func ReadSubprocessOutput(handle C.int64_t, cChunk **C.char, cChunkLen *C.size_t, cStderr **C.char, cRetCode *C.int, exception **C.char) C.int {
+	value, ok := streamedSubprocesses.Load(int64(handle))
+	if !ok {
+		*exception = TrackedCString(fmt.Sprintf("unknown subprocess handle: %d", handle))
+		return 0
+	}
+	p := value.(*streamedSubprocess)
+
+	if chunk, ok := <-p.chunks; ok {
+		*cChunk = TrackedCBytes(chunk)
+		*cChunkLen = C.size_t(len(chunk))
+		return 1
+	}
+
+	streamedSubprocesses.Delete(int64(handle))
+	retCode := p.wait()
+	*cStderr = TrackedCString(string(p.stderr))
 	*cRetCode = C.int(retCode)
+	return 0
+}
+
+// StopSubprocess kills a subprocess started by StartSubprocess and releases its handle,
+// without waiting for it to exit.
+// Indirectly used by the C function backing the `_util.SubprocessOutput` python type.
+//
+//export StopSubprocess
+func StopSubprocess(handle C.int64_t) {
+	value, ok := streamedSubprocesses.LoadAndDelete(int64(handle))
+	if !ok {
+		return
+	}
+	p := value.(*streamedSubprocess)
+
+	p.cancel()
+	go func() {
+		for range p.chunks {
+		}
+		p.wait()
+	}()
+}
+
+func (p *streamedSubprocess) readStdout(stdout io.Reader) {
+	defer close(p.chunks)
+
+	buf := make([]byte, subprocessChunkSize)
+	pending := 0
+	for {
+		n, err := stdout.Read(buf[pending:])
+		n += pending
+
+		// keep incomplete UTF-8 sequences for the next chunk, so that each chunk can be
+		// decoded on its own
+		end := n
+		if err == nil {
+			end = completeRunes(buf[:n])
+		}
+		if end > 0 {
+			chunk := make([]byte, end)
+			copy(chunk, buf[:end])
+			p.chunks <- chunk
+		}
+		pending = copy(buf, buf[end:n])
+
+		if err != nil {
+			return
+		}
+	}
+}
+
+// wait waits for the subprocess to exit, once its stdout was entirely read, and returns
+// its exit code.
+func (p *streamedSubprocess) wait() int {
+	// the pipes must be drained *before* waiting for the cmd to exit, as per os.exec docs
+	<-p.stderrDone
+	defer p.cancel()
+	return exitCode(p.cmd.Wait())
+}
+
+// completeRunes returns the length of the longest prefix of buf that doesn't end with an
+// incomplete UTF-8 sequence.
+func completeRunes(buf []byte) int {
+	for i := len(buf) - 1; i >= 0 && i >= len(buf)-utf8.UTFMax; i-- {
+		if utf8.RuneStart(buf[i]) {
+			if utf8.FullRune(buf[i:]) {
+				return len(buf)
+			}
+			return i
+		}
+	}
+	return len(buf)
 }
@@ -9,6 +9,8 @@ package python
 
 import (
 	"testing"
+
+	"github.com/stretchr/testify/assert"
 )
 
 func TestGetSubprocessOutputEmptyArgs(t *testing.T) {
@@ -30,3 +32,31 @@ func TestGetSubprocessOutputError(t *testing.T) {
 func TestGetSubprocessOutputEnv(t *testing.T) {
 	testGetSubprocessOutputEnv(t)
 }
+
+func TestStreamSubprocessOutput(t *testing.T) {
+	testStreamSubprocessOutput(t)
+}
+
+func TestStreamSubprocessOutputError(t *testing.T) {
+	testStreamSubprocessOutputError(t)
+}
+
+func TestStreamSubprocessOutputUnknownBin(t *testing.T) {
+	testStreamSubprocessOutputUnknownBin(t)
+}
+
+func TestStopSubprocess(t *testing.T) {
+	testStopSubprocess(t)
+}
+
+func TestCompleteRunes(t *testing.T) {
+	euro := []byte("€") // 3 bytes
+
+	assert.Equal(t, 0, completeRunes(nil))
+	assert.Equal(t, 2, completeRunes([]byte("ab")))
+	assert.Equal(t, 5, completeRunes(append([]byte("ab"), euro...)))
+	assert.Equal(t, 2, completeRunes(append([]byte("ab"), euro[:1]...)))
+	assert.Equal(t, 2, completeRunes(append([]byte("ab"), euro[:2]...)))
+	// invalid sequences are handed over as they are
+	assert.Equal(t, 3, completeRunes([]byte{'a', 0x80, 0x80}))
+}
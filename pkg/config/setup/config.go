@@ -313,6 +313,12 @@ func InitConfig(config pkgconfigmodel.Setup) {
 	// Otherwise, Python is loaded when the collector is initialized.
 	config.BindEnvAndSetDefault("python_lazy_loading", true)
 
+	// If true, the configuration of Python checks is handed over to rtloader in a binary
+	// encoding rather than in YAML, sparing a PyYAML parse of every instance. Scalars are
+	// resolved as PyYAML does, and configurations the encoding can't represent, like
+	// timestamps, are still handed over in YAML.
+	config.BindEnvAndSetDefault("python_binary_check_config", false)
+
 	// If true, then new version of disk v2 check will be used.
 	// Otherwise, the old version of disk check will be used (maintaining backward compatibility).
 	config.BindEnvAndSetDefault("use_diskv2_check", false)
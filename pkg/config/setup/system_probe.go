@@ -197,6 +197,8 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnv(join(spNS, "closed_channel_size"))
 	cfg.BindEnv(join(netNS, "closed_channel_size"))
 	cfg.BindEnvAndSetDefault(join(netNS, "closed_buffer_wakeup_count"), 4)
+	// 0 fills the batch, whose capacity is 4 connections with perf buffers and 16 with ring buffers
+	cfg.BindEnvAndSetDefault(join(netNS, "closed_conn_batch_size"), 0)
 	cfg.BindEnvAndSetDefault(join(spNS, "max_connection_state_buffered"), 75000)
 
 	cfg.BindEnvAndSetDefault(join(spNS, "disable_dns_inspection"), false, "DD_DISABLE_DNS_INSPECTION")
@@ -251,9 +253,17 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnvAndSetDefault(join(smNS, "tls", "go", "exclude_self"), true)
 
 	cfg.BindEnvAndSetDefault(join(smNS, "enable_http2_monitoring"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_http_kernel_aggregation"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "max_http_kernel_aggregates"), 1024)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_http_compact_events"), false)
 	cfg.BindEnvAndSetDefault(join(smNS, "enable_kafka_monitoring"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_kafka_partition_offsets"), false)
 	cfg.BindEnv(join(smNS, "enable_postgres_monitoring"))
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_postgres_compact_events"), false)
 	cfg.BindEnv(join(smNS, "enable_redis_monitoring"))
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_redis_kernel_aggregation"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "redis_key_sampling_rate"), 100)
+	cfg.BindEnvAndSetDefault(join(smNS, "max_redis_kernel_aggregates"), 1024)
 	cfg.BindEnvAndSetDefault(join(smNS, "tls", "istio", "enabled"), true)
 	cfg.BindEnvAndSetDefault(join(smNS, "tls", "istio", "envoy_path"), defaultEnvoyPath)
 	cfg.BindEnv(join(smNS, "tls", "nodejs", "enabled"))
@@ -270,6 +280,7 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnv(join(smNS, "enable_quantization"))
 	cfg.BindEnv(join(smNS, "enable_connection_rollup"))
 	cfg.BindEnv(join(smNS, "enable_ring_buffers"))
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_direct_events"), false)
 	cfg.BindEnvAndSetDefault(join(smNS, "enable_event_stream"), true)
 	cfg.BindEnv(join(smNS, "kernel_buffer_pages"))
 	cfg.BindEnv(join(smNS, "data_channel_size"))
@@ -305,6 +316,8 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnvAndSetDefault(join(netNS, "dns_recorded_query_types"), []string{})
 	// (temporary) enable submitting DNS stats by query type.
 	cfg.BindEnvAndSetDefault(join(netNS, "enable_dns_by_querytype"), false)
+	// aggregate the DNS stats of UDP exchanges in eBPF
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_dns_kernel_stats"), false)
 	// connection aggregation with port rollups
 	cfg.BindEnvAndSetDefault(join(netNS, "enable_connection_rollup"), false)
 
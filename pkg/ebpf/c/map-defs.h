@@ -55,6 +55,9 @@
 #define BPF_PERCPU_ARRAY_MAP(name, value_type, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_PERCPU_ARRAY, u32, value_type, max_entries, 0, 0, INCLUDE_KEY_TYPE)
 
+#define BPF_SK_STORAGE_MAP(name, value_type) \
+    BPF_MAP(name, BPF_MAP_TYPE_SK_STORAGE, int, value_type, 0, 0, BPF_F_NO_PREALLOC, INCLUDE_KEY_TYPE)
+
 #define BPF_STACK_MAP(name, value_type, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_STACK, 0, value_type, max_entries, 0, 0, EXCLUDE_KEY_TYPE)
 
@@ -69,21 +69,64 @@ type Config struct {
 	// These stats objects get flushed on every client request (default 30s check interval)
 	MaxDNSStats int
 
+	// EnableDNSKernelStats makes the DNS socket filter aggregate the stats of DNS exchanges over
+	// UDP in eBPF, instead of copying the queries to userspace.
+	// It is relevant *only* when DNSInspection and CollectDNSStats is enabled.
+	EnableDNSKernelStats bool
+
 	// EnableHTTPMonitoring specifies whether the tracer should monitor HTTP traffic
 	EnableHTTPMonitoring bool
 
 	// EnableHTTP2Monitoring specifies whether the tracer should monitor HTTP2 traffic
 	EnableHTTP2Monitoring bool
 
+	// EnableHTTPKernelAggregation folds the latencies of HTTP transactions into histograms
+	// in eBPF, rather than sending every transaction to userspace. Status codes are then
+	// reported by class (200, 400, ...).
+	EnableHTTPKernelAggregation bool
+
+	// MaxHTTPKernelAggregates is the maximum number of (connection, path, method, status class)
+	// aggregates held in eBPF when EnableHTTPKernelAggregation is set. Every aggregate takes a
+	// histogram per CPU. The transactions of new aggregates are sent to userspace once it is full.
+	MaxHTTPKernelAggregates int
+
+	// EnableHTTPCompactEvents makes eBPF send the hash, the length and a prefix of the path
+	// of HTTP requests instead of the whole request fragment. The fragment is only sent
+	// the first time a path too long for the prefix is seen.
+	EnableHTTPCompactEvents bool
+
 	// EnableKafkaMonitoring specifies whether the tracer should monitor Kafka traffic
 	EnableKafkaMonitoring bool
 
+	// EnableKafkaPartitionOffsets makes eBPF track the high watermark and the latest fetched and
+	// produced offsets of each Kafka partition, from which the lag of the consumers is estimated.
+	EnableKafkaPartitionOffsets bool
+
 	// EnablePostgresMonitoring specifies whether the tracer should monitor Postgres traffic.
 	EnablePostgresMonitoring bool
 
+	// EnablePostgresCompactEvents makes eBPF send the fingerprint of Postgres queries instead of
+	// the query fragment. The fragment is only sent the first time a fingerprint is seen.
+	EnablePostgresCompactEvents bool
+
 	// EnableRedisMonitoring specifies whether the tracer should monitor Redis traffic.
 	EnableRedisMonitoring bool
 
+	// EnableRedisKernelAggregation folds the latencies of Redis transactions into histograms
+	// in eBPF, by connection, command and error. Only a sample of the transactions is sent to
+	// userspace with its key, see RedisKeySamplingRate.
+	EnableRedisKernelAggregation bool
+
+	// RedisKeySamplingRate is the number of Redis transactions of each aggregate for which a
+	// single one is sent to userspace with its key, when EnableRedisKernelAggregation is set.
+	// 0 disables key sampling: no key is reported.
+	RedisKeySamplingRate int
+
+	// MaxRedisKernelAggregates is the maximum number of (connection, command, error) aggregates
+	// held in eBPF when EnableRedisKernelAggregation is set. Every aggregate takes a histogram
+	// per CPU. The transactions of new aggregates are sent to userspace once it is full.
+	MaxRedisKernelAggregates int
+
 	// EnableNativeTLSMonitoring specifies whether the USM should monitor HTTPS traffic via native libraries.
 	// Supported libraries: OpenSSL, GnuTLS, LibCrypto.
 	EnableNativeTLSMonitoring bool
@@ -218,6 +261,10 @@ type Config struct {
 	// ClosedBufferWakeupCount specifies the number of events that will buffer in a perf buffer before userspace is woken up.
 	ClosedBufferWakeupCount int
 
+	// ClosedConnBatchSize specifies the number of closed connections batched in eBPF with custom batching,
+	// up to 4 with perf buffers and 16 with ring buffers. 0 uses the whole capacity of the batch.
+	ClosedConnBatchSize int
+
 	// ExcludedSourceConnections is a map of source connections to blacklist
 	ExcludedSourceConnections map[string][]string
 
@@ -283,6 +330,11 @@ type Config struct {
 	// buffers (>=5.8) will result in forcing the use of Perf Maps instead.
 	EnableUSMRingBuffers bool
 
+	// EnableUSMDirectEvents makes USM protocols write their events straight into the
+	// ring buffer with bpf_ringbuf_reserve/bpf_ringbuf_submit, instead of staging them
+	// in batches. Only effective when ring buffers are in use.
+	EnableUSMDirectEvents bool
+
 	// EnableEbpfless enables the use of network tracing without eBPF using packet capture.
 	EnableEbpfless bool
 
@@ -334,6 +386,7 @@ func New() *Config {
 		ClosedConnectionFlushThreshold: cfg.GetInt(sysconfig.FullKeyPath(netNS, "closed_connection_flush_threshold")),
 		ClosedChannelSize:              cfg.GetInt(sysconfig.FullKeyPath(netNS, "closed_channel_size")),
 		ClosedBufferWakeupCount:        cfg.GetInt(sysconfig.FullKeyPath(netNS, "closed_buffer_wakeup_count")),
+		ClosedConnBatchSize:            cfg.GetInt(sysconfig.FullKeyPath(netNS, "closed_conn_batch_size")),
 		MaxConnectionsStateBuffered:    cfg.GetInt(sysconfig.FullKeyPath(spNS, "max_connection_state_buffered")),
 		ClientStateExpiry:              2 * time.Minute,
 
@@ -345,26 +398,37 @@ func New() *Config {
 		MaxDNSStatsBuffered: 75000,
 		DNSTimeout:          time.Duration(cfg.GetInt(sysconfig.FullKeyPath(spNS, "dns_timeout_in_s"))) * time.Second,
 
+		EnableDNSKernelStats: cfg.GetBool(sysconfig.FullKeyPath(netNS, "enable_dns_kernel_stats")),
+
 		ProtocolClassificationEnabled: cfg.GetBool(sysconfig.FullKeyPath(netNS, "enable_protocol_classification")),
 
 		NPMRingbuffersEnabled: cfg.GetBool(sysconfig.FullKeyPath(netNS, "enable_ringbuffers")),
 		CustomBatchingEnabled: cfg.GetBool(sysconfig.FullKeyPath(netNS, "enable_custom_batching")),
 
-		EnableHTTPMonitoring:       cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_http_monitoring")),
-		EnableHTTP2Monitoring:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_http2_monitoring")),
-		EnableKafkaMonitoring:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_kafka_monitoring")),
-		EnablePostgresMonitoring:   cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_postgres_monitoring")),
-		EnableRedisMonitoring:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_redis_monitoring")),
-		EnableNativeTLSMonitoring:  cfg.GetBool(sysconfig.FullKeyPath(smNS, "tls", "native", "enabled")),
-		EnableIstioMonitoring:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "tls", "istio", "enabled")),
-		EnvoyPath:                  cfg.GetString(sysconfig.FullKeyPath(smNS, "tls", "istio", "envoy_path")),
-		EnableNodeJSMonitoring:     cfg.GetBool(sysconfig.FullKeyPath(smNS, "tls", "nodejs", "enabled")),
-		MaxUSMConcurrentRequests:   uint32(cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_concurrent_requests"))),
-		MaxHTTPStatsBuffered:       cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_http_stats_buffered")),
-		MaxKafkaStatsBuffered:      cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_kafka_stats_buffered")),
-		MaxPostgresStatsBuffered:   cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_postgres_stats_buffered")),
-		MaxPostgresTelemetryBuffer: cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_postgres_telemetry_buffer")),
-		MaxRedisStatsBuffered:      cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_redis_stats_buffered")),
+		EnableHTTPMonitoring:        cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_http_monitoring")),
+		EnableHTTP2Monitoring:       cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_http2_monitoring")),
+		EnableHTTPKernelAggregation: cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_http_kernel_aggregation")),
+		EnableHTTPCompactEvents:     cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_http_compact_events")),
+		EnableKafkaMonitoring:       cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_kafka_monitoring")),
+		EnablePostgresMonitoring:    cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_postgres_monitoring")),
+		EnablePostgresCompactEvents: cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_postgres_compact_events")),
+		EnableRedisMonitoring:       cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_redis_monitoring")),
+		EnableNativeTLSMonitoring:   cfg.GetBool(sysconfig.FullKeyPath(smNS, "tls", "native", "enabled")),
+		EnableIstioMonitoring:       cfg.GetBool(sysconfig.FullKeyPath(smNS, "tls", "istio", "enabled")),
+		EnvoyPath:                   cfg.GetString(sysconfig.FullKeyPath(smNS, "tls", "istio", "envoy_path")),
+		EnableNodeJSMonitoring:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "tls", "nodejs", "enabled")),
+		MaxUSMConcurrentRequests:    uint32(cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_concurrent_requests"))),
+		MaxHTTPStatsBuffered:        cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_http_stats_buffered")),
+		MaxHTTPKernelAggregates:     cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_http_kernel_aggregates")),
+		MaxKafkaStatsBuffered:       cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_kafka_stats_buffered")),
+		MaxPostgresStatsBuffered:    cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_postgres_stats_buffered")),
+		MaxPostgresTelemetryBuffer:  cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_postgres_telemetry_buffer")),
+		MaxRedisStatsBuffered:       cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_redis_stats_buffered")),
+
+		EnableRedisKernelAggregation: cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_redis_kernel_aggregation")),
+		RedisKeySamplingRate:         cfg.GetInt(sysconfig.FullKeyPath(smNS, "redis_key_sampling_rate")),
+		MaxRedisKernelAggregates:     cfg.GetInt(sysconfig.FullKeyPath(smNS, "max_redis_kernel_aggregates")),
+		EnableKafkaPartitionOffsets:  cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_kafka_partition_offsets")),
 
 		MaxTrackedHTTPConnections: cfg.GetInt64(sysconfig.FullKeyPath(smNS, "max_tracked_http_connections")),
 		HTTPNotificationThreshold: cfg.GetInt64(sysconfig.FullKeyPath(smNS, "http_notification_threshold")),
@@ -407,6 +471,7 @@ func New() *Config {
 		EnableUSMQuantization:     cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_quantization")),
 		EnableUSMConnectionRollup: cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_connection_rollup")),
 		EnableUSMRingBuffers:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_ring_buffers")),
+		EnableUSMDirectEvents:     cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_direct_events")),
 		EnableUSMEventStream:      cfg.GetBool(sysconfig.FullKeyPath(smNS, "enable_event_stream")),
 		USMKernelBufferPages:      cfg.GetInt(sysconfig.FullKeyPath(smNS, "kernel_buffer_pages")),
 		USMDataChannelSize:        cfg.GetInt(sysconfig.FullKeyPath(smNS, "data_channel_size")),
@@ -177,6 +177,86 @@ func TestEnableHTTP2Monitoring(t *testing.T) {
 	})
 }
 
+func TestEnableHTTPKernelAggregation(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnableHTTPKernelAggregation)
+		assert.Equal(t, 1024, cfg.MaxHTTPKernelAggregates)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.enable_http_kernel_aggregation", true)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.max_http_kernel_aggregates", 4096)
+		cfg := New()
+
+		assert.True(t, cfg.EnableHTTPKernelAggregation)
+		assert.Equal(t, 4096, cfg.MaxHTTPKernelAggregates)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_HTTP_KERNEL_AGGREGATION", "true")
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_MAX_HTTP_KERNEL_AGGREGATES", "2048")
+		cfg := New()
+
+		assert.True(t, cfg.EnableHTTPKernelAggregation)
+		assert.Equal(t, 2048, cfg.MaxHTTPKernelAggregates)
+	})
+}
+
+func TestEnableHTTPCompactEvents(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnableHTTPCompactEvents)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.enable_http_compact_events", true)
+		cfg := New()
+
+		assert.True(t, cfg.EnableHTTPCompactEvents)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_HTTP_COMPACT_EVENTS", "true")
+		cfg := New()
+
+		assert.True(t, cfg.EnableHTTPCompactEvents)
+	})
+}
+
+func TestEnableDNSKernelStats(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnableDNSKernelStats)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("network_config.enable_dns_kernel_stats", true)
+		cfg := New()
+
+		assert.True(t, cfg.EnableDNSKernelStats)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_NETWORK_CONFIG_ENABLE_DNS_KERNEL_STATS", "true")
+		cfg := New()
+
+		assert.True(t, cfg.EnableDNSKernelStats)
+	})
+}
+
 func TestEnableKafkaMonitoring(t *testing.T) {
 	t.Run("via YAML", func(t *testing.T) {
 		mockSystemProbe := mock.NewSystemProbe(t)
@@ -226,6 +306,31 @@ func TestEnablePostgresMonitoring(t *testing.T) {
 	})
 }
 
+func TestEnablePostgresCompactEvents(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnablePostgresCompactEvents)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.enable_postgres_compact_events", true)
+		cfg := New()
+
+		assert.True(t, cfg.EnablePostgresCompactEvents)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_POSTGRES_COMPACT_EVENTS", "true")
+		cfg := New()
+
+		assert.True(t, cfg.EnablePostgresCompactEvents)
+	})
+}
+
 func TestEnableRedisMonitoring(t *testing.T) {
 	t.Run("via YAML", func(t *testing.T) {
 		mockSystemProbe := mock.NewSystemProbe(t)
@@ -254,6 +359,91 @@ func TestEnableRedisMonitoring(t *testing.T) {
 	})
 }
 
+func TestEnableRedisKernelAggregation(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnableRedisKernelAggregation)
+		assert.Equal(t, 100, cfg.RedisKeySamplingRate)
+		assert.Equal(t, 1024, cfg.MaxRedisKernelAggregates)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.enable_redis_kernel_aggregation", true)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.redis_key_sampling_rate", 10)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.max_redis_kernel_aggregates", 4096)
+		cfg := New()
+
+		assert.True(t, cfg.EnableRedisKernelAggregation)
+		assert.Equal(t, 10, cfg.RedisKeySamplingRate)
+		assert.Equal(t, 4096, cfg.MaxRedisKernelAggregates)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_REDIS_KERNEL_AGGREGATION", "true")
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_REDIS_KEY_SAMPLING_RATE", "0")
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_MAX_REDIS_KERNEL_AGGREGATES", "2048")
+		cfg := New()
+
+		assert.True(t, cfg.EnableRedisKernelAggregation)
+		assert.Equal(t, 0, cfg.RedisKeySamplingRate)
+		assert.Equal(t, 2048, cfg.MaxRedisKernelAggregates)
+	})
+}
+
+func TestClosedConnBatchSize(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.Equal(t, 0, cfg.ClosedConnBatchSize)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("network_config.closed_conn_batch_size", 8)
+		cfg := New()
+
+		assert.Equal(t, 8, cfg.ClosedConnBatchSize)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_NETWORK_CONFIG_CLOSED_CONN_BATCH_SIZE", "2")
+		cfg := New()
+
+		assert.Equal(t, 2, cfg.ClosedConnBatchSize)
+	})
+}
+
+func TestEnableKafkaPartitionOffsets(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnableKafkaPartitionOffsets)
+	})
+
+	t.Run("via YAML", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.enable_kafka_partition_offsets", true)
+		cfg := New()
+
+		assert.True(t, cfg.EnableKafkaPartitionOffsets)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_KAFKA_PARTITION_OFFSETS", "true")
+		cfg := New()
+
+		assert.True(t, cfg.EnableKafkaPartitionOffsets)
+	})
+}
+
 func TestDefaultDisabledHTTP2Support(t *testing.T) {
 	mock.NewSystemProbe(t)
 	cfg := New()
@@ -1365,6 +1555,31 @@ func TestUSMEventStream(t *testing.T) {
 	})
 }
 
+func TestUSMDirectEvents(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		cfg := New()
+
+		assert.False(t, cfg.EnableUSMDirectEvents)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		mockSystemProbe := mock.NewSystemProbe(t)
+		mockSystemProbe.SetWithoutSource("service_monitoring_config.enable_direct_events", true)
+		cfg := New()
+
+		assert.True(t, cfg.EnableUSMDirectEvents)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		mock.NewSystemProbe(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_DIRECT_EVENTS", "true")
+		cfg := New()
+
+		assert.True(t, cfg.EnableUSMDirectEvents)
+	})
+}
+
 func TestUSMKernelBufferPages(t *testing.T) {
 	t.Run("default value", func(t *testing.T) {
 		mock.NewSystemProbe(t)
@@ -9,12 +9,15 @@ package dns
 
 import (
 	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
 
 	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
+	"github.com/DataDog/datadog-agent/pkg/util/kernel"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
 
 const probeUID = "dns"
@@ -23,6 +26,9 @@ type ebpfProgram struct {
 	*manager.Manager
 	cfg      *config.Config
 	bytecode bytecode.AssetReader
+
+	// kernelStats is set when the stats of DNS exchanges over UDP are aggregated in eBPF
+	kernelStats bool
 }
 
 func newEBPFProgram(c *config.Config) (*ebpfProgram, error) {
@@ -43,12 +49,27 @@ func newEBPFProgram(c *config.Config) (*ebpfProgram, error) {
 	}
 
 	return &ebpfProgram{
-		Manager:  mgr,
-		bytecode: bc,
-		cfg:      c,
+		Manager:     mgr,
+		bytecode:    bc,
+		cfg:         c,
+		kernelStats: kernelStatsSupported(c),
 	}, nil
 }
 
+// kernelStatsSupported returns whether the DNS stats can be aggregated in eBPF, which
+// requires LRU maps for dns_domains
+func kernelStatsSupported(c *config.Config) bool {
+	if !c.CollectDNSStats || !c.EnableDNSKernelStats {
+		return false
+	}
+	kv, err := kernel.HostVersion()
+	if err != nil || kv < kernel.VersionCode(4, 10, 0) {
+		log.Warn("DNS stats can't be aggregated in eBPF on this kernel, falling back to userspace")
+		return false
+	}
+	return true
+}
+
 func (e *ebpfProgram) Init() error {
 	defer e.bytecode.Close()
 
@@ -60,6 +81,31 @@ func (e *ebpfProgram) Init() error {
 		})
 	}
 
+	mapSpecEditors := map[string]manager.MapSpecEditor{}
+	if e.kernelStats {
+		constantEditors = append(constantEditors,
+			manager.ConstantEditor{Name: "dns_kernel_stats_enabled", Value: uint64(1)},
+			manager.ConstantEditor{Name: "dns_timeout_ns", Value: uint64(e.cfg.DNSTimeout.Nanoseconds())},
+		)
+		if e.cfg.CollectDNSDomains {
+			constantEditors = append(constantEditors, manager.ConstantEditor{Name: "dns_collect_domains", Value: uint64(1)})
+		}
+		mapSpecEditors[dnsStatsMap] = manager.MapSpecEditor{
+			MaxEntries: uint32(e.cfg.MaxDNSStats),
+			EditorFlag: manager.EditMaxEntries,
+		}
+	} else {
+		// the maps are unused, keep them minimal and loadable on kernels without LRU maps
+		for _, name := range []string{dnsQueriesMap, dnsStatsMap} {
+			mapSpecEditors[name] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+		}
+		mapSpecEditors[dnsDomainsMap] = manager.MapSpecEditor{
+			Type:       ebpf.Hash,
+			MaxEntries: 1,
+			EditorFlag: manager.EditType | manager.EditMaxEntries,
+		}
+	}
+
 	kprobeAttachMethod := manager.AttachKprobeWithPerfEventOpen
 	if e.cfg.AttachKprobesWithKprobeEventsABI {
 		kprobeAttachMethod = manager.AttachKprobeWithKprobeEvents
@@ -75,6 +121,7 @@ func (e *ebpfProgram) Init() error {
 			},
 		},
 		ConstantEditors:           constantEditors,
+		MapSpecEditors:            mapSpecEditors,
 		DefaultKprobeAttachMethod: kprobeAttachMethod,
 		BypassEnabled:             e.cfg.BypassEnabled,
 	})
@@ -0,0 +1,227 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package dns
+
+import (
+	"bytes"
+	"syscall"
+	"time"
+	"unsafe"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/google/gopacket/layers"
+
+	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/process/util"
+	"github.com/DataDog/datadog-agent/pkg/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+const (
+	dnsQueriesMap   = "dns_queries"
+	dnsStatsMap     = "dns_stats"
+	dnsDomainsMap   = "dns_domains"
+	dnsTelemetryMap = "dns_telemetry"
+
+	// maxCachedDomains bounds the domain names cached in userspace, twice the size of
+	// dns_domains
+	maxCachedDomains = 8192
+)
+
+var kernelStatsTelemetry = struct {
+	insertFailed *telemetry.StatCounterWrapper
+}{
+	telemetry.NewStatCounterWrapper(dnsModuleName, "kernel_stats_insert_failed", []string{}, "Counter measuring the number of DNS responses dropped by eBPF because its stats map was full"),
+}
+
+// kernelStats drains the stats of the DNS exchanges over UDP aggregated by the socket
+// filter when in-kernel aggregation is enabled. eBPF only knows the hash of the queried
+// domains, their names are read from dns_domains where eBPF stores them.
+type kernelStats struct {
+	queries *maps.GenericMap[netebpf.DNSQueryKey, netebpf.DNSQuery]
+	stats   *maps.GenericMap[netebpf.DNSStatsKey, netebpf.DNSStats]
+	domains *maps.GenericMap[uint64, netebpf.DNSDomain]
+	// telemetry holds monotonic counters, lastInsertFailed is the value reported last
+	telemetry        *maps.GenericMap[uint32, netebpf.DNSTelemetry]
+	lastInsertFailed uint64
+	// domain names already read from dns_domains
+	names map[uint64]Hostname
+
+	timeout         time.Duration
+	collectDomains  bool
+	collectLocalDNS bool
+	queryTypes      map[layers.DNSType]struct{}
+
+	// buffers reused across drains
+	statsKeys []netebpf.DNSStatsKey
+	expired   []expiredQuery
+}
+
+type expiredQuery struct {
+	key   netebpf.DNSQueryKey
+	query netebpf.DNSQuery
+}
+
+func newKernelStats(mgr *manager.Manager, cfg *config.Config) (*kernelStats, error) {
+	queries, err := maps.GetMap[netebpf.DNSQueryKey, netebpf.DNSQuery](mgr, dnsQueriesMap)
+	if err != nil {
+		return nil, err
+	}
+	stats, err := maps.GetMap[netebpf.DNSStatsKey, netebpf.DNSStats](mgr, dnsStatsMap)
+	if err != nil {
+		return nil, err
+	}
+	domains, err := maps.GetMap[uint64, netebpf.DNSDomain](mgr, dnsDomainsMap)
+	if err != nil {
+		return nil, err
+	}
+	telemetryMap, err := maps.GetMap[uint32, netebpf.DNSTelemetry](mgr, dnsTelemetryMap)
+	if err != nil {
+		return nil, err
+	}
+
+	return &kernelStats{
+		queries:         queries,
+		stats:           stats,
+		domains:         domains,
+		telemetry:       telemetryMap,
+		names:           make(map[uint64]Hostname),
+		timeout:         cfg.DNSTimeout,
+		collectDomains:  cfg.CollectDNSDomains,
+		collectLocalDNS: cfg.CollectLocalDNS,
+		queryTypes:      getRecordedQueryTypes(cfg),
+	}, nil
+}
+
+// Drain hands the stats aggregated in eBPF to the stat keeper and removes them from the
+// eBPF maps. Queries still waiting for their response after the DNS timeout are counted
+// as timeouts, like the expired states of the stat keeper.
+func (k *kernelStats) Drain(statKeeper *dnsStatKeeper) {
+	var key netebpf.DNSStatsKey
+	var stats netebpf.DNSStats
+	k.statsKeys = k.statsKeys[:0]
+	iter := k.stats.Iterate()
+	for iter.Next(&key, &stats) {
+		k.statsKeys = append(k.statsKeys, key)
+		// latencies are measured in nanoseconds in eBPF, in microseconds in userspace
+		k.process(statKeeper, &key.Key, key.Domain_hash, key.Qtype, key.Rcode, stats.Count, stats.Timeouts, stats.Latency_sum/1000)
+	}
+	if err := iter.Err(); err != nil {
+		log.Warnf("failed to iterate over %s: %s", dnsStatsMap, err)
+	}
+
+	// Responses folded between the lookup above and the deletion below are lost, this is
+	// the price of draining the map without stopping eBPF.
+	for i := range k.statsKeys {
+		_ = k.stats.Delete(&k.statsKeys[i])
+	}
+	k.reportTelemetry()
+
+	now, err := ddebpf.NowNanoseconds()
+	if err != nil {
+		log.Warnf("failed to expire DNS queries: %s", err)
+		return
+	}
+	threshold := uint64(now - k.timeout.Nanoseconds())
+
+	var queryKey netebpf.DNSQueryKey
+	var query netebpf.DNSQuery
+	k.expired = k.expired[:0]
+	queryIter := k.queries.Iterate()
+	for queryIter.Next(&queryKey, &query) {
+		if query.Timestamp < threshold {
+			k.expired = append(k.expired, expiredQuery{key: queryKey, query: query})
+		}
+	}
+	if err := queryIter.Err(); err != nil {
+		log.Warnf("failed to iterate over %s: %s", dnsQueriesMap, err)
+	}
+
+	for i := range k.expired {
+		expired := &k.expired[i]
+		// the response may have been matched in the meantime
+		if err := k.queries.Delete(&expired.key); err != nil {
+			continue
+		}
+		k.process(statKeeper, &expired.key.Key, expired.query.Domain_hash, expired.query.Qtype, 0, 0, 1, 0)
+	}
+}
+
+func (k *kernelStats) reportTelemetry() {
+	var zero uint32
+	var tel netebpf.DNSTelemetry
+	if err := k.telemetry.Lookup(&zero, &tel); err != nil {
+		log.Warnf("failed to read %s: %s", dnsTelemetryMap, err)
+		return
+	}
+	if tel.Stats_insert_failed > k.lastInsertFailed {
+		kernelStatsTelemetry.insertFailed.Add(int64(tel.Stats_insert_failed - k.lastInsertFailed))
+	}
+	k.lastInsertFailed = tel.Stats_insert_failed
+}
+
+func (k *kernelStats) process(statKeeper *dnsStatKeeper, ebpfKey *netebpf.DNSKey, domainHash uint64, qtype uint16, rcode uint8, count, timeouts uint32, latencySum uint64) {
+	if _, ok := k.queryTypes[layers.DNSType(qtype)]; !ok {
+		return
+	}
+
+	key := dnsKey(ebpfKey)
+	if !k.collectLocalDNS && key.ServerIP.IsLoopback() {
+		return
+	}
+	statKeeper.ProcessAggregate(key, k.domain(domainHash), QueryType(qtype), rcode, count, timeouts, latencySum)
+}
+
+// domain returns the name behind the given hash, or an empty name when it was evicted
+// from dns_domains before we read it.
+func (k *kernelStats) domain(hash uint64) Hostname {
+	if !k.collectDomains {
+		return ToHostname("")
+	}
+	if name, ok := k.names[hash]; ok {
+		return name
+	}
+
+	var domain netebpf.DNSDomain
+	if err := k.domains.Lookup(&hash, &domain); err != nil {
+		return ToHostname("")
+	}
+	if len(k.names) >= maxCachedDomains {
+		clear(k.names)
+	}
+	name := domainName(&domain)
+	k.names[hash] = name
+	return name
+}
+
+// dnsKey converts the key of an exchange aggregated in eBPF, always over UDP. Like the
+// keys of dns_stats, it leaves the client port out, see network.DNSKey.
+func dnsKey(key *netebpf.DNSKey) Key {
+	dnsKey := Key{
+		Protocol: syscall.IPPROTO_UDP,
+	}
+	if key.Metadata&uint32(netebpf.IPv6) != 0 {
+		dnsKey.ServerIP = util.V6Address(key.Server_l, key.Server_h)
+		dnsKey.ClientIP = util.V6Address(key.Client_l, key.Client_h)
+	} else {
+		dnsKey.ServerIP = util.V4Address(uint32(key.Server_l))
+		dnsKey.ClientIP = util.V4Address(uint32(key.Client_l))
+	}
+	return dnsKey
+}
+
+func domainName(domain *netebpf.DNSDomain) Hostname {
+	name := unsafe.Slice((*byte)(unsafe.Pointer(&domain.Name[0])), len(domain.Name))
+	if i := bytes.IndexByte(name, 0); i != -1 {
+		name = name[:i]
+	}
+	return HostnameFromBytes(name)
+}
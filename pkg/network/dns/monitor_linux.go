@@ -27,6 +27,8 @@ import (
 type dnsMonitor struct {
 	*socketFilterSnooper
 	p *ebpfProgram
+	// set when the stats of DNS exchanges over UDP are aggregated in eBPF
+	kernelStats *kernelStats
 }
 
 // NewReverseDNS starts snooping on DNS traffic to allow IP -> domain reverse resolution
@@ -60,6 +62,7 @@ func NewReverseDNS(cfg *config.Config, _ telemetry.Component) (ReverseDNS, error
 	pre410Kernel := currKernelVersion < kernel.VersionCode(4, 1, 0)
 
 	var p *ebpfProgram
+	var ks *kernelStats
 	if pre410Kernel || cfg.EnableEbpfless {
 		if bpfFilter, err := generateBPFFilter(cfg); err != nil {
 			return nil, fmt.Errorf("error creating bpf classic filter: %w", err)
@@ -84,6 +87,12 @@ func NewReverseDNS(cfg *config.Config, _ telemetry.Component) (ReverseDNS, error
 		if err = packetSrc.SetEbpf(filter); err != nil {
 			return nil, fmt.Errorf("could not set file descriptor for eBPF program: %w", err)
 		}
+
+		if p.kernelStats {
+			if ks, err = newKernelStats(p.Manager, cfg); err != nil {
+				return nil, fmt.Errorf("error retrieving the DNS stats maps: %w", err)
+			}
+		}
 	}
 
 	snoop, err := newSocketFilterSnooper(cfg, packetSrc)
@@ -94,9 +103,19 @@ func NewReverseDNS(cfg *config.Config, _ telemetry.Component) (ReverseDNS, error
 	return &dnsMonitor{
 		snoop,
 		p,
+		ks,
 	}, nil
 }
 
+// GetDNSStats gets the latest Stats keyed by unique Key, and domain, including the stats
+// aggregated in eBPF
+func (m *dnsMonitor) GetDNSStats() StatsByKeyByNameByType {
+	if m.kernelStats != nil && m.statKeeper != nil {
+		m.kernelStats.Drain(m.statKeeper)
+	}
+	return m.socketFilterSnooper.GetDNSStats()
+}
+
 func (m *dnsMonitor) WaitForDomain(domain string) error {
 	return m.statKeeper.WaitForDomain(domain)
 }
@@ -175,6 +175,47 @@ func (d *dnsStatKeeper) ProcessPacketInfo(info dnsPacketInfo, ts time.Time) {
 	d.stats[info.key] = allStats
 }
 
+// ProcessAggregate merges exchanges aggregated outside of the stat keeper, in eBPF, into
+// the stats of the given key, domain and query type. count responses of the given rcode
+// took latencySum microseconds in total.
+func (d *dnsStatKeeper) ProcessAggregate(key Key, question Hostname, qtype QueryType, rcode uint8, count, timeouts uint32, latencySum uint64) {
+	d.mux.Lock()
+	defer d.mux.Unlock()
+
+	allStats, ok := d.stats[key]
+	if !ok {
+		allStats = make(map[Hostname]map[QueryType]Stats)
+	}
+	stats, ok := allStats[question]
+	if !ok {
+		stats = make(map[QueryType]Stats)
+	}
+	byqtype, ok := stats[qtype]
+	if !ok {
+		if d.processedStats >= d.maxStats {
+			d.droppedStats++
+			statsTelemetry.droppedStats.Inc()
+			return
+		}
+		byqtype.CountByRcode = make(map[uint32]uint32)
+		d.processedStats++
+		statsTelemetry.processedStats.Inc()
+	}
+
+	byqtype.Timeouts += timeouts
+	if count > 0 {
+		byqtype.CountByRcode[uint32(rcode)] += count
+		if rcode == 0 {
+			byqtype.SuccessLatencySum += latencySum
+		} else {
+			byqtype.FailureLatencySum += latencySum
+		}
+	}
+	stats[qtype] = byqtype
+	allStats[question] = stats
+	d.stats[key] = allStats
+}
+
 func (d *dnsStatKeeper) GetAndResetAllStats() StatsByKeyByNameByType {
 	d.mux.Lock()
 	defer d.mux.Unlock()
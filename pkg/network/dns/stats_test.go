@@ -106,6 +106,28 @@ func TestExpiredStateRemoval(t *testing.T) {
 	assert.Equal(t, uint32(1), stats[key][d][TypeA].Timeouts)
 }
 
+func TestProcessAggregate(t *testing.T) {
+	sk := newDNSStatkeeper(DNSTimeoutSecs*time.Second, 10000)
+	key := getSampleDNSKey()
+	var d = ToHostname("abc.com")
+
+	sk.ProcessPacketInfo(dnsPacketInfo{transactionID: 1, pktType: query, key: key, question: d, queryType: TypeA}, time.Now())
+	sk.ProcessPacketInfo(dnsPacketInfo{transactionID: 1, key: key, pktType: successfulResponse, queryType: TypeA}, time.Now())
+
+	sk.ProcessAggregate(key, d, TypeA, 0, 3, 1, 300)
+	sk.ProcessAggregate(key, d, TypeA, 3, 2, 0, 500)
+
+	stats := sk.GetAndResetAllStats()
+	require.Contains(t, stats, key)
+	require.Contains(t, stats[key], d)
+
+	assert.Equal(t, uint32(4), stats[key][d][TypeA].CountByRcode[0])
+	assert.Equal(t, uint32(2), stats[key][d][TypeA].CountByRcode[3])
+	assert.Equal(t, uint32(1), stats[key][d][TypeA].Timeouts)
+	assert.LessOrEqual(t, uint64(300), stats[key][d][TypeA].SuccessLatencySum)
+	assert.Equal(t, uint64(500), stats[key][d][TypeA].FailureLatencySum)
+}
+
 func BenchmarkStats(b *testing.B) {
 	key := getSampleDNSKey()
 
@@ -17,10 +17,15 @@
 #include "tracer/stats.h"
 #include "tracer/telemetry.h"
 #include "tracer/port.h"
+#include "tracer/port_iter.h"
 
 BPF_PERCPU_HASH_MAP(udp6_send_skb_args, u64, u64, 1024)
 BPF_PERCPU_HASH_MAP(udp_send_skb_args, u64, conn_tuple_t, 1024)
 
+/* This map holds the pid of ongoing TCP connections on the socket itself, in place of
+   tcp_ongoing_connect_pid, so entries are freed along with their socket */
+BPF_SK_STORAGE_MAP(tcp_ongoing_connect_pid_sk, pid_ts_t)
+
 #define RETURN_IF_NOT_IN_SYSPROBE_TASK(prog_name)           \
     if (!event_in_task(prog_name)) {                        \
         return 0;                                           \
@@ -52,6 +57,45 @@ static __always_inline bool event_in_task(char *prog_name) {
     return !error;
 }
 
+// use_sk_storage is set when tracing programs can use socket-local storage (5.11+)
+static __always_inline bool use_sk_storage() {
+    __u64 val = 0;
+    LOAD_CONSTANT("use_sk_storage", val);
+    return val > 0;
+}
+
+static __always_inline void set_ongoing_connect_pid(struct sock *sk, conn_tuple_t *t, pid_ts_t *pid_ts) {
+    if (use_sk_storage()) {
+        pid_ts_t *val = bpf_sk_storage_get(&tcp_ongoing_connect_pid_sk, sk, 0, BPF_SK_STORAGE_GET_F_CREATE);
+        if (val != NULL) {
+            *val = *pid_ts;
+        }
+        return;
+    }
+
+    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = *t};
+    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &skp_conn, pid_ts, BPF_ANY);
+}
+
+static __always_inline pid_ts_t *get_ongoing_connect_pid(struct sock *sk, conn_tuple_t *t) {
+    if (use_sk_storage()) {
+        return bpf_sk_storage_get(&tcp_ongoing_connect_pid_sk, sk, 0, 0);
+    }
+
+    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = *t};
+    return bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &skp_conn);
+}
+
+static __always_inline void delete_ongoing_connect_pid(struct sock *sk, conn_tuple_t *t) {
+    // socket-local storage is freed along with the socket
+    if (use_sk_storage()) {
+        return;
+    }
+
+    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = *t};
+    bpf_map_delete_elem(&tcp_ongoing_connect_pid, &skp_conn);
+}
+
 static __always_inline int read_conn_tuple_partial_from_flowi4(conn_tuple_t *t, struct flowi4 *fl4, u64 pid_tgid, metadata_mask_t type) {
     t->pid = GET_USER_MODE_PID(pid_tgid);
     t->metadata = type;
@@ -240,10 +284,9 @@ int BPF_PROG(tcp_close, struct sock *sk, long timeout) {
     }
     log_debug("fentry/tcp_close: netns: %u, sport: %u, dport: %u", t.netns, t.sport, t.dport);
 
-    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = t};
-    skp_conn.tup.pid = 0;
-
-    bpf_map_delete_elem(&tcp_ongoing_connect_pid, &skp_conn);
+    conn_tuple_t skp_tup = t;
+    skp_tup.pid = 0;
+    delete_ongoing_connect_pid(sk, &skp_tup);
 
     cleanup_conn(ctx, &t, sk);
     return 0;
@@ -459,9 +502,8 @@ int BPF_PROG(tcp_connect, struct sock *sk) {
         return 0;
     }
 
-    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = t};
     pid_ts_t pid_ts = {.pid_tgid = pid_tgid, .timestamp = bpf_ktime_get_ns()};
-    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &skp_conn, &pid_ts, BPF_ANY);
+    set_ongoing_connect_pid(sk, &t, &pid_ts);
 
     return 0;
 }
@@ -474,8 +516,7 @@ int BPF_PROG(tcp_finish_connect, struct sock *sk, struct sk_buff *skb, int rc) {
         increment_telemetry_count(tcp_finish_connect_failed_tuple);
         return 0;
     }
-    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = t};
-    pid_ts_t *pid_tgid_p = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &skp_conn);
+    pid_ts_t *pid_tgid_p = get_ongoing_connect_pid(sk, &t);
     if (!pid_tgid_p) {
         return 0;
     }
@@ -513,9 +554,8 @@ int BPF_PROG(inet_csk_accept_exit, struct sock *_sk, int flags, int *err, bool k
     pb.port = t.sport;
     add_port_bind(&pb, port_bindings);
 
-    skp_conn_tuple_t skp_conn = {.sk = sk, .tup = t};
     pid_ts_t pid_ts = {.pid_tgid = pid_tgid, .timestamp = bpf_ktime_get_ns()};
-    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &skp_conn, &pid_ts, BPF_ANY);
+    set_ongoing_connect_pid(sk, &t, &pid_ts);
     log_debug("fexit/inet_csk_accept: netns: %u, sport: %u, dport: %u", t.netns, t.sport, t.dport);
     return 0;
 }
@@ -620,4 +660,14 @@ int BPF_PROG(inet6_bind_exit, struct socket *sock, struct sockaddr *uaddr, int a
     return sys_exit_bind(rc);
 }
 
+SEC("iter/tcp")
+int iter__tcp_port_bindings(struct bpf_iter__tcp *ctx) {
+    return iter_tcp_port_binding(ctx->sk_common);
+}
+
+SEC("iter/udp")
+int iter__udp_port_bindings(struct bpf_iter__udp *ctx) {
+    return iter_udp_port_binding(ctx->udp_sk);
+}
+
 char _license[] SEC("license") = "GPL";
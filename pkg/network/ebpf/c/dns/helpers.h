@@ -0,0 +1,189 @@
+#ifndef __DNS_HELPERS_H
+#define __DNS_HELPERS_H
+
+#include "ktypes.h"
+#include "bpf_builtins.h"
+#include "bpf_helpers.h"
+#include "bpf_telemetry.h"
+
+#include "ip.h"
+#include "dns/maps.h"
+#include "dns/types.h"
+
+#define DNS_HEADER_SIZE 12
+#define DNS_MAX_LABEL_LEN 63
+#define DNS_CLASS_IN 1
+
+// Masks of the flags field of the DNS header
+#define DNS_FLAG_QR 0x8000
+#define DNS_FLAG_OPCODE 0x7800
+#define DNS_FLAG_RCODE 0x000f
+
+// FNV-1a parameters, see dns_domain_hash in pkg/network/dns
+#define DNS_DOMAIN_HASH_OFFSET 14695981039346656037ULL
+#define DNS_DOMAIN_HASH_PRIME 1099511628211ULL
+
+static __always_inline bool dns_kernel_stats_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("dns_kernel_stats_enabled", val);
+    return val == ENABLED;
+}
+
+static __always_inline bool dns_collect_domains() {
+    __u64 val = 0;
+    LOAD_CONSTANT("dns_collect_domains", val);
+    return val == ENABLED;
+}
+
+static __always_inline __u64 dns_timeout_ns() {
+    __u64 val = 0;
+    LOAD_CONSTANT("dns_timeout_ns", val);
+    return val;
+}
+
+// dns_parse_question reads the question starting at the given offset. The queried
+// name is written in its dotted form into domain, which must be zeroed, and hashed.
+// It returns false if the question can't be aggregated in eBPF.
+static __always_inline bool dns_parse_question(struct __sk_buff *skb, __u32 offset, dns_domain_t *domain, __u64 *domain_hash, __u16 *qtype) {
+    __u64 hash = DNS_DOMAIN_HASH_OFFSET;
+    __u32 next_label = 0;
+    __u32 i = 0;
+
+#pragma unroll
+    for (; i < DNS_MAX_DOMAIN_LEN; i++) {
+        __u8 c = __load_byte(skb, offset + i);
+        if (i == next_label) {
+            if (c == 0) {
+                break;
+            }
+            // compression pointers are not expected in questions
+            if (c > DNS_MAX_LABEL_LEN) {
+                return false;
+            }
+            next_label = i + c + 1;
+            if (i == 0) {
+                continue;
+            }
+            c = '.';
+        }
+        domain->name[i - 1] = c;
+        hash ^= c;
+        hash *= DNS_DOMAIN_HASH_PRIME;
+    }
+
+    // the name is too long
+    if (i == DNS_MAX_DOMAIN_LEN) {
+        return false;
+    }
+
+    *domain_hash = hash;
+    *qtype = __load_half(skb, offset + i + 1);
+    return __load_half(skb, offset + i + 3) == DNS_CLASS_IN;
+}
+
+// dns_key_from_tuple fills the DNS key of the given UDP tuple, which goes from the
+// client to the server for queries and the other way around for responses.
+static __always_inline void dns_key_from_tuple(dns_key_t *key, conn_tuple_t *tup, bool response) {
+    key->metadata = tup->metadata & (CONN_V4 | CONN_V6);
+    if (response) {
+        key->client_h = tup->daddr_h;
+        key->client_l = tup->daddr_l;
+        key->server_h = tup->saddr_h;
+        key->server_l = tup->saddr_l;
+        key->client_port = tup->dport;
+    } else {
+        key->client_h = tup->saddr_h;
+        key->client_l = tup->saddr_l;
+        key->server_h = tup->daddr_h;
+        key->server_l = tup->daddr_l;
+        key->client_port = tup->sport;
+    }
+}
+
+// dns_record_response adds a response matched with its query to dns_stats
+static __always_inline void dns_record_response(dns_stats_key_t *stats_key, __u64 latency) {
+    dns_stats_t *stats = bpf_map_lookup_elem(&dns_stats, stats_key);
+    if (!stats) {
+        dns_stats_t empty = {};
+        bpf_map_update_elem(&dns_stats, stats_key, &empty, BPF_NOEXIST);
+        stats = bpf_map_lookup_elem(&dns_stats, stats_key);
+        if (!stats) {
+            __u32 zero = 0;
+            dns_telemetry_t *telemetry = bpf_map_lookup_elem(&dns_telemetry, &zero);
+            if (telemetry) {
+                __sync_fetch_and_add(&telemetry->stats_insert_failed, 1);
+            }
+            return;
+        }
+    }
+
+    if (latency > dns_timeout_ns()) {
+        __sync_fetch_and_add(&stats->timeouts, 1);
+        return;
+    }
+    __sync_fetch_and_add(&stats->count, 1);
+    __sync_fetch_and_add(&stats->latency_sum, latency);
+}
+
+// dns_process_packet aggregates the stats of DNS exchanges over UDP in eBPF: queries
+// are recorded in dns_queries and matched with their response by transaction ID.
+// It returns true if the packet must still be copied to userspace: responses always
+// are, as userspace resolves the IPs they hold, while queries only are when they
+// can't be aggregated in eBPF.
+static __always_inline bool dns_process_packet(struct __sk_buff *skb, skb_info_t *skb_info, conn_tuple_t *tup) {
+    __u32 offset = skb_info->data_off;
+    if (offset + DNS_HEADER_SIZE > skb_info->data_end) {
+        return true;
+    }
+
+    __u16 flags = __load_half(skb, offset + 2);
+    // only standard queries holding a single question are aggregated, like in userspace
+    if ((flags & DNS_FLAG_OPCODE) != 0 || __load_half(skb, offset + 4) != 1) {
+        return true;
+    }
+
+    dns_query_key_t query_key = {};
+    query_key.id = __load_half(skb, offset);
+
+    if (flags & DNS_FLAG_QR) {
+        dns_key_from_tuple(&query_key.key, tup, true);
+        dns_query_t *query = bpf_map_lookup_elem(&dns_queries, &query_key);
+        if (!query) {
+            return true;
+        }
+
+        dns_stats_key_t stats_key = {};
+        stats_key.key = query_key.key;
+        // the client port only matters to match the response with its query
+        stats_key.key.client_port = 0;
+        stats_key.domain_hash = query->domain_hash;
+        stats_key.qtype = query->qtype;
+        stats_key.rcode = flags & DNS_FLAG_RCODE;
+        __u64 latency = bpf_ktime_get_ns() - query->timestamp;
+        bpf_map_delete_elem(&dns_queries, &query_key);
+
+        dns_record_response(&stats_key, latency);
+        return true;
+    }
+
+    dns_domain_t domain;
+    bpf_memset(&domain, 0, sizeof(domain));
+    dns_query_t query = {};
+    if (!dns_parse_question(skb, offset + DNS_HEADER_SIZE, &domain, &query.domain_hash, &query.qtype)) {
+        return true;
+    }
+
+    if (dns_collect_domains()) {
+        bpf_map_update_elem(&dns_domains, &query.domain_hash, &domain, BPF_NOEXIST);
+    } else {
+        query.domain_hash = 0;
+    }
+
+    dns_key_from_tuple(&query_key.key, tup, false);
+    query.timestamp = bpf_ktime_get_ns();
+    long ret = bpf_map_update_elem(&dns_queries, &query_key, &query, BPF_NOEXIST);
+    // retransmitted queries are ignored, as they are in userspace
+    return ret != 0 && ret != -EEXIST;
+}
+
+#endif
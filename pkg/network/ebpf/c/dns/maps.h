@@ -0,0 +1,22 @@
+#ifndef __DNS_MAPS_H
+#define __DNS_MAPS_H
+
+#include "map-defs.h"
+
+#include "dns/types.h"
+
+// The UDP queries waiting for their response. Userspace counts the queries that
+// are still there after the DNS timeout as timeouts, and removes them.
+BPF_HASH_MAP(dns_queries, dns_query_key_t, dns_query_t, 10000)
+
+// The stats of the responses matched with their query, drained by userspace.
+// The maximum number of entries is set from userspace.
+BPF_HASH_MAP(dns_stats, dns_stats_key_t, dns_stats_t, 0)
+
+// Maps the hash of the queried domains to their name, read by userspace.
+BPF_LRU_MAP(dns_domains, __u64, dns_domain_t, 4096)
+
+// Counters of the responses eBPF failed to aggregate, read by userspace
+BPF_ARRAY_MAP(dns_telemetry, dns_telemetry_t, 1)
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef __DNS_TYPES_H
+#define __DNS_TYPES_H
+
+#include "ktypes.h"
+
+// Maximum length of the domain names aggregated in eBPF, in their dotted form
+#define DNS_MAX_DOMAIN_LEN 128
+
+// The client and the server of a DNS exchange over UDP
+typedef struct {
+    /* Using the type unsigned __int128 generates an error in the ebpf verifier */
+    __u64 client_h;
+    __u64 client_l;
+    __u64 server_h;
+    __u64 server_l;
+    __u16 client_port;
+    __u16 _pad;
+    // CONN_V4 or CONN_V6
+    __u32 metadata;
+} dns_key_t;
+
+// The key of dns_queries: a DNS query waiting for its response
+typedef struct {
+    dns_key_t key;
+    __u16 id;
+    __u16 _pad[3];
+} dns_query_key_t;
+
+typedef struct {
+    // bpf_ktime_get_ns() when the query was seen
+    __u64 timestamp;
+    // FNV-1a hash of the queried domain, 0 unless domains are collected
+    __u64 domain_hash;
+    __u16 qtype;
+    __u16 _pad[3];
+} dns_query_t;
+
+// The key of dns_stats. The client port of its DNS key is always 0, so that the
+// exchanges of a client with a server are folded together whatever their source port.
+typedef struct {
+    dns_key_t key;
+    __u64 domain_hash;
+    __u16 qtype;
+    __u8 rcode;
+    __u8 _pad[5];
+} dns_stats_key_t;
+
+typedef struct {
+    // sum of the latencies of the responses received in time, in nanoseconds
+    __u64 latency_sum;
+    // responses received in time
+    __u32 count;
+    // responses received after the DNS timeout
+    __u32 timeouts;
+} dns_stats_t;
+
+typedef struct {
+    // responses dropped because dns_stats was full
+    __u64 stats_insert_failed;
+} dns_telemetry_t;
+
+// A NUL-terminated domain name, in its dotted form
+typedef struct {
+    char name[DNS_MAX_DOMAIN_LEN];
+} dns_domain_t;
+
+#endif
@@ -6,10 +6,12 @@
 
 #include "offsets.h"
 #include "ip.h"
+#include "dns/helpers.h"
 
 // This function is meant to be used as a BPF_PROG_TYPE_SOCKET_FILTER.
 // When attached to a RAW_SOCKET, this code filters out everything but DNS traffic.
 // All structs referenced here are kernel independent as they simply map protocol headers (Ethernet, IP and UDP).
+// When DNS stats are aggregated in eBPF, the UDP queries parsed here are not copied to the socket.
 SEC("socket/dns_filter")
 int socket__dns_filter(struct __sk_buff* skb) {
     skb_info_t skb_info;
@@ -22,6 +24,11 @@ int socket__dns_filter(struct __sk_buff* skb) {
         return 0;
     }
 
+    // TCP exchanges are always handled in userspace
+    if (dns_kernel_stats_enabled() && !(tup.metadata & CONN_TYPE_TCP) && !dns_process_packet(skb, &skb_info, &tup)) {
+        return 0;
+    }
+
     return -1;
 }
 
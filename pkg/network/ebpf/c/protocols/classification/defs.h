@@ -29,6 +29,13 @@
 #define LAYER_APPLICATION_MAX (LAYER_APPLICATION_BIT + MAX_ENTRIES_PER_LAYER)
 #define LAYER_ENCRYPTION_MAX  (LAYER_ENCRYPTION_BIT + MAX_ENTRIES_PER_LAYER)
 
+// Number of connections to a server endpoint that have to be classified by the same
+// classification program before new connections to that endpoint try it first
+#define PROTOCOL_HINT_MIN_HITS 16
+
+// Maximum number of server endpoints holding a protocol hint
+#define PROTOCOL_HINTS_MAX_ENTRIES 1024
+
 #define FLAG_FULLY_CLASSIFIED       1 << 0
 #define FLAG_USM_ENABLED            1 << 1
 #define FLAG_NPM_ENABLED            1 << 2
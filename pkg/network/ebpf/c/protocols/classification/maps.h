@@ -10,4 +10,8 @@
 // mark if we've seen a specific mongo request, so we can eliminate false-positive classification on responses.
 BPF_HASH_MAP(mongo_request_id, mongo_key, bool, 1024)
 
+// Maps a server endpoint to the application-layer classification program that keeps
+// classifying its connections, so new connections to it skip the other programs.
+BPF_LRU_MAP(protocol_hints, protocol_hint_key_t, protocol_hint_t, PROTOCOL_HINTS_MAX_ENTRIES)
+
 #endif
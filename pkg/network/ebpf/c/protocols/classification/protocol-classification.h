@@ -66,6 +66,81 @@ static __always_inline void update_protocol_information(classification_context_t
     classification_ctx->routing_skip_layers |= proto;
 }
 
+// protocol_hint_key fills the protocol_hints key of the server side of the given tuple.
+static __always_inline void protocol_hint_key(conn_tuple_t *tuple, protocol_hint_key_t *key) {
+    conn_tuple_t normalized = *tuple;
+    normalize_tuple(&normalized);
+    key->addr_h = normalized.daddr_h;
+    key->addr_l = normalized.daddr_l;
+    key->port = normalized.dport;
+}
+
+// record_protocol_hint counts a connection classified by the given application-layer
+// program. Once enough connections to the same server were classified by the same
+// program, new connections to that server try it before the other programs.
+static __always_inline void record_protocol_hint(classification_context_t *classification_ctx, classification_prog_t program) {
+    protocol_hint_key_t key = {0};
+    protocol_hint_key(&classification_ctx->tuple, &key);
+
+    protocol_hint_t *hint = bpf_map_lookup_elem(&protocol_hints, &key);
+    if (hint && hint->program == program) {
+        if (hint->hits < PROTOCOL_HINT_MIN_HITS) {
+            hint->hits++;
+        }
+        return;
+    }
+
+    protocol_hint_t new_hint = {
+        .program = program,
+        .hits = 1,
+    };
+    bpf_map_update_elem(&protocol_hints, &key, &new_hint, BPF_ANY);
+}
+
+// try_protocol_hint tail-calls the application-layer program hinted for the server of
+// the current connection, if any. It returns if there is no usable hint.
+static __always_inline void try_protocol_hint(struct __sk_buff *skb, classification_context_t *classification_ctx) {
+    if (classification_ctx->routing_skip_layers & LAYER_APPLICATION_BIT) {
+        return;
+    }
+
+    protocol_hint_key_t key = {0};
+    protocol_hint_key(&classification_ctx->tuple, &key);
+    protocol_hint_t *hint = bpf_map_lookup_elem(&protocol_hints, &key);
+    if (!hint || hint->hits < PROTOCOL_HINT_MIN_HITS) {
+        return;
+    }
+
+    classification_prog_t program = hint->program;
+    if (program <= __PROG_APPLICATION || program >= __PROG_API) {
+        return;
+    }
+
+    log_debug("classification tail-call: skb=%p hinted=%d", skb, program);
+    classification_ctx->routing_current_program = program;
+    classification_ctx->routing_hinted = true;
+    bpf_tail_call_compat(skb, &classification_progs, program);
+
+    // the tail call failed, fall back to the regular routing
+    classification_ctx->routing_current_program = CLASSIFICATION_PROG_UNKNOWN;
+    classification_ctx->routing_hinted = false;
+}
+
+// protocol_hint_missed is called when the hinted program could not classify the
+// current packet: the hint loses a hit and the routing restarts from the first
+// application-layer program, so none of them is skipped.
+static __always_inline void protocol_hint_missed(classification_context_t *classification_ctx) {
+    protocol_hint_key_t key = {0};
+    protocol_hint_key(&classification_ctx->tuple, &key);
+    protocol_hint_t *hint = bpf_map_lookup_elem(&protocol_hints, &key);
+    if (hint && hint->hits > 0) {
+        hint->hits--;
+    }
+
+    classification_ctx->routing_current_program = CLASSIFICATION_PROG_UNKNOWN;
+    classification_ctx->routing_hinted = false;
+}
+
 // Check if the connections is used for gRPC traffic.
 static __always_inline void classify_grpc(classification_context_t *classification_ctx, protocol_stack_t *protocol_stack, struct __sk_buff *skb, skb_info_t *skb_info) {
     grpc_status_t status = is_grpc(skb, skb_info);
@@ -224,6 +299,10 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint(struct
         return;
     }
 
+    // The application layer is still unknown, skip straight to the program that
+    // classified the previous connections to the same server.
+    try_protocol_hint(skb, classification_ctx);
+
  next_program:
     classification_next_program(skb, classification_ctx);
 }
@@ -268,6 +347,9 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint_queues
     const char *buffer = &(classification_ctx->buffer.data[0]);
     protocol_t cur_fragment_protocol = classify_queue_protocols(skb, &classification_ctx->skb_info, buffer, classification_ctx->buffer.size);
     if (!cur_fragment_protocol) {
+        if (classification_ctx->routing_hinted) {
+            protocol_hint_missed(classification_ctx);
+        }
         goto next_program;
     }
 
@@ -277,6 +359,7 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint_queues
     }
     update_protocol_information(classification_ctx, protocol_stack, cur_fragment_protocol);
     mark_as_fully_classified(protocol_stack);
+    record_protocol_hint(classification_ctx, CLASSIFICATION_QUEUES_PROG);
 
  next_program:
     classification_next_program(skb, classification_ctx);
@@ -291,6 +374,9 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint_dbs(st
     const char *buffer = &classification_ctx->buffer.data[0];
     protocol_t cur_fragment_protocol = classify_db_protocols(&classification_ctx->tuple, buffer, classification_ctx->buffer.size);
     if (!cur_fragment_protocol) {
+        if (classification_ctx->routing_hinted) {
+            protocol_hint_missed(classification_ctx);
+        }
         goto next_program;
     }
 
@@ -301,6 +387,7 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint_dbs(st
 
     update_protocol_information(classification_ctx, protocol_stack, cur_fragment_protocol);
     mark_as_fully_classified(protocol_stack);
+    record_protocol_hint(classification_ctx, CLASSIFICATION_DBS_PROG);
  next_program:
     classification_next_program(skb, classification_ctx);
 }
@@ -54,6 +54,7 @@ static __always_inline void classification_next_program(struct __sk_buff *skb, c
 static __always_inline void init_routing_cache(classification_context_t *classification_ctx, protocol_stack_t *stack) {
     classification_ctx->routing_skip_layers = 0;
     classification_ctx->routing_current_program = CLASSIFICATION_PROG_UNKNOWN;
+    classification_ctx->routing_hinted = false;
 
     // No protocol stack, nothing to mark for skipping
     if (!stack) {
@@ -18,6 +18,20 @@ typedef struct {
     __s32 req_id;
 } mongo_key;
 
+// The key used in protocol_hints: the server side of a connection.
+typedef struct {
+    __u64 addr_h;
+    __u64 addr_l;
+    __u16 port;
+    __u16 pad[3];
+} protocol_hint_key_t;
+
+// The classification program that classified the last connections to a server endpoint.
+typedef struct {
+    __u8 program; // classification_prog_t
+    __u8 hits;    // number of connections classified by program, up to PROTOCOL_HINT_MIN_HITS
+} protocol_hint_t;
+
 typedef struct {
     conn_tuple_t tup;
     skb_info_t skb_info;
@@ -9,6 +9,8 @@
    data to userspace:
    1) <name>_batch_enqueue
    2) <name>_batch_flush
+   When direct events are enabled on a ring buffer, <name>_batch_enqueue writes events
+   straight into the ring and batches are only used when it is full.
    For more information of this please refer to
    pkg/networks/protocols/events/README.md */
 #define USM_EVENTS_INIT(name, value, batch_size)                                                        \
@@ -43,6 +45,7 @@
         u64 use_ring_buffer;                                                                            \
         LOAD_CONSTANT("use_ring_buffer", use_ring_buffer);                                              \
         long perf_ret;                                                                                  \
+        u32 flush_size;                                                                                 \
                                                                                                         \
         _Pragma(_STR(unroll(BATCH_PAGES_PER_CPU)))                                                      \
             for (int i = 0; i < BATCH_PAGES_PER_CPU; i++) {                                             \
@@ -54,11 +57,12 @@
                     return;                                                                             \
                 }                                                                                       \
                                                                                                         \
+                flush_size = batch_flush_size(batch, sizeof(value));                                    \
                 if (use_ring_buffer) {                                                                  \
                     if (with_telemetry) {                                                               \
-                        perf_ret = bpf_ringbuf_output_with_telemetry(&name##_batch_events, batch, sizeof(batch_data_t), 0);\
+                        perf_ret = bpf_ringbuf_output_with_telemetry(&name##_batch_events, batch, flush_size, 0);\
                     } else {                                                                            \
-                        perf_ret = bpf_ringbuf_output(&name##_batch_events, batch, sizeof(batch_data_t), 0);\
+                        perf_ret = bpf_ringbuf_output(&name##_batch_events, batch, flush_size, 0);\
                     }                                                                                   \
                 } else {                                                                                \
                     if (with_telemetry) {                                                               \
@@ -66,13 +70,13 @@
                                                          &name##_batch_events,                          \
                                                          key.cpu,                                       \
                                                          batch,                                         \
-                                                         sizeof(batch_data_t));                         \
+                                                         flush_size);                                   \
                     } else {                                                                            \
                         perf_ret = bpf_perf_event_output(ctx,                                           \
                                                      &name##_batch_events,                              \
                                                      key.cpu,                                           \
                                                      batch,                                             \
-                                                     sizeof(batch_data_t));                             \
+                                                     flush_size);                                       \
                     }                                                                                   \
                 }                                                                                       \
                 if (perf_ret < 0) {                                                                     \
@@ -99,6 +103,23 @@
     }                                                                                                   \
                                                                                                         \
     static __always_inline void name##_batch_enqueue(value *event) {                                    \
+        u64 use_ring_buffer;                                                                            \
+        u64 use_direct_events;                                                                          \
+        LOAD_CONSTANT("use_ring_buffer", use_ring_buffer);                                              \
+        LOAD_CONSTANT("use_direct_events", use_direct_events);                                          \
+        if (use_ring_buffer && use_direct_events) {                                                     \
+            /* write the event straight into the ring buffer. userspace tells it                        \
+            apart from a batch by its size, as flushed batches are always larger */                     \
+            value *record = bpf_ringbuf_reserve(&name##_batch_events, sizeof(value), 0);                \
+            if (record != NULL) {                                                                       \
+                bpf_memcpy(record, event, sizeof(value));                                               \
+                bpf_ringbuf_submit(record, 0);                                                          \
+                return;                                                                                 \
+            }                                                                                           \
+            /* the ring buffer is full, so we stage the event in a batch, which                         \
+            will be flushed once there is room again */                                                 \
+        }                                                                                               \
+                                                                                                        \
         u32 zero = 0;                                                                                   \
         batch_state_t *batch_state =  bpf_map_lookup_elem(&name##_batch_state, &zero);                  \
         if (batch_state == NULL) {                                                                      \
@@ -160,6 +181,19 @@ static __always_inline bool __enqueue_event(batch_data_t *batch, void *event, si
     return true;
 }
 
+// batch_flush_size returns the number of bytes of the batch that hold data: the header
+// followed by the `len` events enqueued so far. Flushes only send those, rather than
+// the whole data buffer.
+static __always_inline u32 batch_flush_size(batch_data_t *batch, u32 event_size) {
+    u32 size = offsetof(batch_data_t, data) + batch->len * event_size;
+    /* bounds check to make eBPF verifier happy */
+    barrier_var(size);
+    if (size > sizeof(batch_data_t)) {
+        size = sizeof(batch_data_t);
+    }
+    return size;
+}
+
 #define _LOG(protocol, message, args...) \
     log_debug(_STR(protocol) " " message, args);
 
@@ -28,12 +28,14 @@ http2 is supported only from kernel 5.2, therefore it does not have the kprobe v
 SEC("tracepoint/net/netif_receive_skb")
 int tracepoint__net__netif_receive_skb_http(void *ctx) {
     http_batch_flush_with_telemetry(ctx);
+    http_compact_batch_flush_with_telemetry(ctx);
     return 0;
 }
 
 SEC("kprobe/__netif_receive_skb_core")
 int netif_receive_skb_core_http_4_14(void *ctx) {
     http_batch_flush_with_telemetry(ctx);
+    http_compact_batch_flush_with_telemetry(ctx);
     return 0;
 }
 
@@ -59,12 +61,14 @@ int netif_receive_skb_core_kafka_4_14(void *ctx) {
 SEC("tracepoint/net/netif_receive_skb")
 int tracepoint__net__netif_receive_skb_postgres(void *ctx) {
     postgres_batch_flush_with_telemetry(ctx);
+    postgres_compact_batch_flush_with_telemetry(ctx);
     return 0;
 }
 
 SEC("kprobe/__netif_receive_skb_core")
 int netif_receive_skb_core_postgres_4_14(void *ctx) {
     postgres_batch_flush_with_telemetry(ctx);
+    postgres_compact_batch_flush_with_telemetry(ctx);
     return 0;
 }
 
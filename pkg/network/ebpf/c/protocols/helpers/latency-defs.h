@@ -0,0 +1,13 @@
+#ifndef __USM_LATENCY_DEFS_H
+#define __USM_LATENCY_DEFS_H
+
+// Latencies aggregated in-kernel are folded into log-bucketed histograms: every power of two
+// between 2^USM_LATENCY_MIN_EXPONENT and 2^USM_LATENCY_MAX_EXPONENT nanoseconds (~1us to ~34s)
+// is split into 2^USM_LATENCY_SUB_BUCKET_BITS buckets. Latencies out of this range are
+// accounted for in the first and last buckets.
+#define USM_LATENCY_MIN_EXPONENT 10
+#define USM_LATENCY_MAX_EXPONENT 35
+#define USM_LATENCY_SUB_BUCKET_BITS 2
+#define USM_LATENCY_BUCKETS ((USM_LATENCY_MAX_EXPONENT - USM_LATENCY_MIN_EXPONENT + 1) << USM_LATENCY_SUB_BUCKET_BITS)
+
+#endif
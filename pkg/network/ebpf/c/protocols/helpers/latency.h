@@ -0,0 +1,32 @@
+#ifndef __USM_LATENCY_H
+#define __USM_LATENCY_H
+
+#include "ktypes.h"
+
+#include "protocols/helpers/latency-defs.h"
+
+// Returns the index of the log-bucket holding the given latency, in nanoseconds
+static __always_inline __u32 usm_latency_bucket(__u64 latency) {
+    if (latency < (1ULL << USM_LATENCY_MIN_EXPONENT)) {
+        return 0;
+    }
+
+    // compute the position of the most significant bit
+    __u32 exponent = 0;
+    __u64 value = latency;
+    if (value >> 32) { value >>= 32; exponent += 32; }
+    if (value >> 16) { value >>= 16; exponent += 16; }
+    if (value >> 8) { value >>= 8; exponent += 8; }
+    if (value >> 4) { value >>= 4; exponent += 4; }
+    if (value >> 2) { value >>= 2; exponent += 2; }
+    if (value >> 1) { exponent += 1; }
+
+    if (exponent > USM_LATENCY_MAX_EXPONENT) {
+        return USM_LATENCY_BUCKETS - 1;
+    }
+
+    __u32 sub_bucket = (latency >> (exponent - USM_LATENCY_SUB_BUCKET_BITS)) & ((1 << USM_LATENCY_SUB_BUCKET_BITS) - 1);
+    return ((exponent - USM_LATENCY_MIN_EXPONENT) << USM_LATENCY_SUB_BUCKET_BITS) | sub_bucket;
+}
+
+#endif
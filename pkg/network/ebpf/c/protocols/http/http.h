@@ -7,6 +7,7 @@
 #include "protocols/sockfd.h"
 
 #include "protocols/classification/common.h"
+#include "protocols/helpers/latency.h"
 
 #include "protocols/http/types.h"
 #include "protocols/http/maps.h"
@@ -35,7 +36,187 @@ static __always_inline void http_begin_response(http_transaction_t *http, const
     log_debug("http_begin_response: htx=%p status=%d", http, status_code);
 }
 
+// FNV-1a parameters, shared with userspace
+#define HTTP_PATH_HASH_OFFSET 14695981039346656037ULL
+#define HTTP_PATH_HASH_PRIME 1099511628211ULL
+
+// Returns the offset of the path in a request fragment starting with the given method
+static __always_inline __u32 http_path_offset(http_method_t method) {
+    switch (method) {
+    case HTTP_GET:
+    case HTTP_PUT:
+        return 4;
+    case HTTP_POST:
+    case HTTP_HEAD:
+        return 5;
+    case HTTP_PATCH:
+    case HTTP_TRACE:
+        return 6;
+    case HTTP_DELETE:
+        return 7;
+    case HTTP_OPTIONS:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+// http_path_hash computes the FNV-1a hash and the length of the request path, up to the
+// query string. It returns false when the path is longer than HTTP_PATH_HASH_MAX_LEN, as
+// we can't tell such paths apart from each other.
+static __always_inline bool http_path_hash(const char *fragment, http_method_t method, __u64 *hash, __u16 *len) {
+    __u32 offset = http_path_offset(method);
+    if (offset == 0) {
+        return false;
+    }
+
+    __u64 path_hash = HTTP_PATH_HASH_OFFSET;
+    // the path is followed by its terminator, hence the extra iteration
+#pragma unroll(HTTP_PATH_HASH_MAX_LEN + 1)
+    for (__u32 i = 0; i <= HTTP_PATH_HASH_MAX_LEN; i++) {
+        __u32 idx = offset + i;
+        if (idx >= HTTP_BUFFER_SIZE) {
+            return false;
+        }
+        char c = fragment[idx];
+        if (c == ' ' || c == '?' || c == '\0') {
+            *hash = path_hash;
+            *len = i;
+            return true;
+        }
+        path_hash ^= (__u8)c;
+        path_hash *= HTTP_PATH_HASH_PRIME;
+    }
+    return false;
+}
+
+// http_aggregation_enabled returns true when latencies are aggregated in-kernel.
+static __always_inline bool http_aggregation_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("http_aggregation_enabled", val);
+    return val > 0;
+}
+
+// http_aggregate_by_server returns true when the aggregates are keyed by server rather
+// than by connection, as userspace rolls up the connections of a (client, server) pair.
+static __always_inline bool http_aggregate_by_server() {
+    __u64 val = 0;
+    LOAD_CONSTANT("http_aggregation_rollup_enabled", val);
+    return val > 0;
+}
+
+// http_aggregate folds the latency of a complete transaction into the histogram of its
+// (connection, path, method, status class) instead of sending it to userspace. When
+// connections are rolled up, the client port is left out of the connection, so the
+// ephemeral ports of the clients don't create new aggregates.
+// It returns false when the transaction must be enqueued, which is always the case for
+// the first transaction of an aggregate: userspace learns the path behind the hash from it.
+static __always_inline bool http_aggregate(conn_tuple_t *tuple, http_transaction_t *http, __u64 path_hash) {
+    if (!http_aggregation_enabled()) {
+        return false;
+    }
+
+    if (http->request_started == 0 || http->response_status_code == 0 || http->response_last_seen <= http->request_started) {
+        return false;
+    }
+    __u16 status_class = http->response_status_code / 100;
+    if (status_class < 1 || status_class > 5) {
+        return false;
+    }
+
+    http_aggregate_key_t key;
+    bpf_memset(&key, 0, sizeof(http_aggregate_key_t));
+    key.path_hash = path_hash;
+    bpf_memcpy(&key.tuple, tuple, sizeof(conn_tuple_t));
+    if (http_aggregate_by_server()) {
+        normalize_tuple(&key.tuple);
+        key.tuple.sport = 0;
+    }
+    key.request_method = http->request_method;
+    key.status_class = status_class;
+
+    http_latency_sketch_t *sketch = bpf_map_lookup_elem(&http_latency_aggregates, &key);
+    if (sketch == NULL) {
+        const __u32 zero = 0;
+        http_latency_sketch_t *empty = bpf_map_lookup_elem(&http_empty_latency_sketch, &zero);
+        if (empty != NULL) {
+            // another CPU may have created the aggregate meanwhile, only a full map is an error
+            bpf_map_update_with_telemetry(http_latency_aggregates, &key, empty, BPF_NOEXIST, -EEXIST);
+        }
+        return false;
+    }
+
+    __u32 bucket = usm_latency_bucket(http->response_last_seen - http->request_started);
+    /* bounds check to make eBPF verifier happy */
+    barrier_var(bucket);
+    if (bucket >= HTTP_LATENCY_BUCKETS) {
+        return false;
+    }
+    // the map is per-CPU, so there is no need for atomic operations
+    sketch->buckets[bucket]++;
+    sketch->tags |= http->tags;
+    return true;
+}
+
+// http_compact_enqueue sends the transaction as an http_compact_event_t, carrying the
+// path of the request rather than the whole request fragment. The fragment is stored in
+// http_paths the first time the path is seen, when the path doesn't fit in the event.
+// It returns false when the transaction must be sent as an http_event_t.
+static __always_inline bool http_compact_enqueue(conn_tuple_t *tuple, http_transaction_t *http, __u64 path_hash, __u16 path_len) {
+    if (!is_http_compact_monitoring_enabled()) {
+        return false;
+    }
+
+    if (path_len > HTTP_PATH_PREFIX_SIZE && bpf_map_lookup_elem(&http_paths, &path_hash) == NULL) {
+        // http_path_t is nothing but the request fragment
+        long err = bpf_map_update_elem(&http_paths, &path_hash, http->request_fragment, BPF_NOEXIST);
+        if (err < 0 && err != -EEXIST) {
+            return false;
+        }
+    }
+
+    const __u32 zero = 0;
+    http_compact_event_t *event = bpf_map_lookup_elem(&http_compact_scratch_buffer, &zero);
+    if (event == NULL) {
+        return false;
+    }
+
+    __u32 offset = http_path_offset(http->request_method);
+    /* bounds check to make eBPF verifier happy */
+    barrier_var(offset);
+    if (offset > HTTP_BUFFER_SIZE - HTTP_PATH_PREFIX_SIZE) {
+        return false;
+    }
+
+    bpf_memcpy(&event->tuple, tuple, sizeof(conn_tuple_t));
+    event->request_started = http->request_started;
+    event->response_last_seen = http->response_last_seen;
+    event->tags = http->tags;
+    event->path_hash = path_hash;
+    event->response_status_code = http->response_status_code;
+    event->path_len = path_len;
+    event->request_method = http->request_method;
+    bpf_memcpy(event->path_prefix, &http->request_fragment[offset], HTTP_PATH_PREFIX_SIZE);
+    http_compact_batch_enqueue(event);
+    return true;
+}
+
 static __always_inline void http_batch_enqueue_wrapper(conn_tuple_t *tuple, http_transaction_t *http) {
+    // the path is hashed once for both the aggregates and the compact events. Neither
+    // handles paths that can't be hashed, their transactions are sent as http_event_t.
+    __u64 path_hash = 0;
+    __u16 path_len = 0;
+    if ((http_aggregation_enabled() || is_http_compact_monitoring_enabled())
+        && http_path_hash(http->request_fragment, http->request_method, &path_hash, &path_len)) {
+        if (http_aggregate(tuple, http, path_hash)) {
+            return;
+        }
+
+        if (http_compact_enqueue(tuple, http, path_hash, path_len)) {
+            return;
+        }
+    }
+
     u32 zero = 0;
     http_event_t *event = bpf_map_lookup_elem(&http_scratch_buffer, &zero);
     if (!event) {
@@ -264,6 +445,7 @@ int uprobe__http_process(struct pt_regs *ctx) {
     read_into_user_buffer_http(event.http.request_fragment, args->buffer_ptr);
     http_process(&event, NULL, args->tags);
     http_batch_flush(ctx);
+    http_compact_batch_flush(ctx);
 
     return 0;
 }
@@ -283,6 +465,7 @@ int uprobe__http_termination(struct pt_regs *ctx) {
     skb_info.tcp_flags |= TCPHDR_FIN;
     http_process(&event, &skb_info, NO_TAGS);
     http_batch_flush(ctx);
+    http_compact_batch_flush(ctx);
 
     return 0;
 }
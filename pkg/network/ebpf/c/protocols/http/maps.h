@@ -14,4 +14,19 @@ BPF_HASH_MAP(http_in_flight, conn_tuple_t, http_transaction_t, 0)
    enqueued. The primary motivation here is to save eBPF stack memory. */
 BPF_PERCPU_ARRAY_MAP(http_scratch_buffer, http_event_t, 1)
 
+/* This map holds the latency histograms of the HTTP transactions aggregated in-kernel,
+   which userspace drains every check interval. Its size is set by userspace. */
+BPF_PERCPU_HASH_MAP(http_latency_aggregates, http_aggregate_key_t, http_latency_sketch_t, 0)
+
+/* This map holds an empty histogram, used to create entries of http_latency_aggregates
+   without using eBPF stack memory */
+BPF_ARRAY_MAP(http_empty_latency_sketch, http_latency_sketch_t, 1)
+
+/* This map acts as a scratch buffer for "preparing" http_compact_event_t objects */
+BPF_PERCPU_ARRAY_MAP(http_compact_scratch_buffer, http_compact_event_t, 1)
+
+/* This map holds the request fragment of the paths too long to fit in compact events,
+   indexed by path hash. A fragment is only stored the first time its hash is seen */
+BPF_LRU_MAP(http_paths, __u64, http_path_t, HTTP_MAX_PATHS)
+
 #endif
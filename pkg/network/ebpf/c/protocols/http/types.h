@@ -2,6 +2,7 @@
 #define __HTTP_TYPES_H
 
 #include "conn_tuple.h"
+#include "protocols/helpers/latency-defs.h"
 
 // This determines the size of the payload fragment that is captured for each HTTP request
 #define HTTP_BUFFER_SIZE (8 * 26)
@@ -56,6 +57,55 @@ typedef struct {
     http_transaction_t http;
 } http_event_t;
 
+// Maximum length of the paths whose transactions can be aggregated in-kernel.
+// Transactions with longer paths are always sent to userspace.
+#define HTTP_PATH_HASH_MAX_LEN 64
+
+// Latencies are folded into the log-bucketed histograms described in latency-defs.h
+#define HTTP_LATENCY_MIN_EXPONENT USM_LATENCY_MIN_EXPONENT
+#define HTTP_LATENCY_SUB_BUCKET_BITS USM_LATENCY_SUB_BUCKET_BITS
+#define HTTP_LATENCY_BUCKETS USM_LATENCY_BUCKETS
+
+typedef struct {
+    conn_tuple_t tuple;
+    // FNV-1a hash of the request path, up to the query string
+    __u64 path_hash;
+    __u8 request_method;
+    // status code divided by 100
+    __u8 status_class;
+    __u8 pad[6];
+} http_aggregate_key_t;
+
+typedef struct {
+    __u64 tags;
+    __u32 buckets[HTTP_LATENCY_BUCKETS];
+} http_latency_sketch_t;
+
+// Number of bytes of the request path carried by compact events
+#define HTTP_PATH_PREFIX_SIZE 40
+
+// Maximum number of request fragments held in http_paths
+#define HTTP_MAX_PATHS 2048
+
+// http_compact_event_t is sent instead of http_event_t when compact events are enabled.
+// Rather than the request fragment, it carries the hash, the length and a prefix of the
+// request path. The fragments of paths longer than the prefix are stored in http_paths.
+typedef struct {
+    conn_tuple_t tuple;
+    __u64 request_started;
+    __u64 response_last_seen;
+    __u64 tags;
+    __u64 path_hash;
+    __u16 response_status_code;
+    __u16 path_len;
+    __u8 request_method;
+    char path_prefix[HTTP_PATH_PREFIX_SIZE];
+} http_compact_event_t;
+
+typedef struct {
+    char request_fragment[HTTP_BUFFER_SIZE];
+} http_path_t;
+
 // OpenSSL types
 typedef struct {
     void *ctx;
@@ -9,4 +9,8 @@
 
 USM_EVENTS_INIT(http, http_event_t, HTTP_BATCH_SIZE);
 
+#define HTTP_COMPACT_BATCH_SIZE (MAX_BATCH_SIZE(http_compact_event_t))
+
+USM_EVENTS_INIT(http_compact, http_compact_event_t, HTTP_COMPACT_BATCH_SIZE);
+
 #endif
@@ -38,6 +38,22 @@
 #define VARINT_BYTES_RECORD_BATCHES_NUM_BYTES VARINT_BYTES_0fffffff
 
 #define KAFKA_RESPONSE_PARSER_MAX_ITERATIONS 10
+// Bound of the bpf_loop based parsers, used on kernels supporting bpf_loop.
+#define KAFKA_RESPONSE_PARSER_MAX_LOOP_ITERATIONS 512
+
+// The number of partitions whose offsets are tracked in kafka_partition_offsets.
+#define KAFKA_MAX_PARTITION_OFFSETS 4096
+
+// FNV-1a parameters, see kafka_topic_hash
+#define KAFKA_TOPIC_HASH_OFFSET 14695981039346656037ULL
+#define KAFKA_TOPIC_HASH_PRIME 1099511628211ULL
+
+// The distance from the start of a record batch (baseOffset) to its magic
+// byte: baseOffset (8), batchLength (4) and partitionLeaderEpoch (4).
+#define KAFKA_RECORD_BATCH_MAGIC_OFFSET 16
+// The distance from the magic byte of a record batch to its lastOffsetDelta:
+// magic (1), crc (4) and attributes (2).
+#define KAFKA_RECORD_BATCH_MAGIC_TO_LAST_OFFSET_DELTA 7
 
 // We do not have a way to validate the size of the aborted transactions list
 // and if we misinterpret a packet we could end up waiting for a large number
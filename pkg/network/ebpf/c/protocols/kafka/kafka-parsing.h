@@ -167,6 +167,9 @@ enum parse_result {
     RET_ERR = -1,
     // Ran out of iterations in the packet processing loop.
     RET_LOOP_END = -2,
+    // Only used within the packet processing loops: the current element was
+    // parsed, continue with the next one.
+    RET_CONTINUE = 2,
 };
 
 struct read_with_remainder_config {
@@ -466,6 +469,110 @@ static __always_inline enum parse_result skip_tagged_fields(kafka_response_conte
     return RET_DONE;
 }
 
+static __always_inline bool kafka_partition_offsets_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("kafka_partition_offsets_enabled", val);
+    return val > 0;
+}
+
+// Returns the hash identifying the topic of the given transaction in
+// kafka_partition_offsets: the FNV-1a hash of its zero-padded topic name,
+// taken 8 bytes at a time. Only the first topic_name_size bytes are part of
+// the name, the rest of the buffer holds whatever followed it in the request.
+static __always_inline __u64 kafka_topic_hash(kafka_transaction_t *transaction)
+{
+    __u64 hash = KAFKA_TOPIC_HASH_OFFSET;
+    __u32 size = transaction->topic_name_size;
+    if (size > TOPIC_NAME_MAX_STRING_SIZE) {
+        size = TOPIC_NAME_MAX_STRING_SIZE;
+    }
+
+#pragma unroll
+    for (int i = 0; i < TOPIC_NAME_MAX_STRING_SIZE / sizeof(__u64); i++) {
+        __u32 start = i * sizeof(__u64);
+        __u64 word = 0;
+        if (start < size) {
+            bpf_memcpy(&word, &transaction->topic_name[start], sizeof(word));
+            if (size - start < sizeof(__u64)) {
+                // keep the bytes of the name, the first ones in little endian
+                word &= (1ULL << ((size - start) * 8)) - 1;
+            }
+        }
+        hash ^= word;
+        hash *= KAFKA_TOPIC_HASH_PRIME;
+    }
+    return hash;
+}
+
+// Reads the big endian s32 at the given offset if it is entirely part of the
+// current packet, returns -1 otherwise. Unlike read_with_remainder(), values
+// split over two packets are not reconstructed.
+static __always_inline s32 kafka_read_s32_in_packet(pktbuf_t pkt, u32 offset, u32 data_off, u32 data_end)
+{
+    if (offset < data_off || offset + sizeof(s32) > data_end) {
+        return -1;
+    }
+
+    s32 val = 0;
+    pktbuf_load_bytes(pkt, offset, &val, sizeof(val));
+    return bpf_ntohl(val);
+}
+
+// Same as kafka_read_s32_in_packet() for an s64.
+static __always_inline s64 kafka_read_s64_in_packet(pktbuf_t pkt, u32 offset, u32 data_off, u32 data_end)
+{
+    if (offset < data_off || offset + sizeof(s64) > data_end) {
+        return -1;
+    }
+
+    s64 val = 0;
+    pktbuf_load_bytes(pkt, offset, &val, sizeof(val));
+    return bpf_be64_to_cpu(val);
+}
+
+// Updates the offsets of the given partition of the topic of the response in
+// kafka_partition_offsets. Negative offsets are unknown and left untouched.
+// The server is read from kafka->event.tup, set by kafka_response_parser().
+static __always_inline void kafka_update_partition_offsets(kafka_info_t *kafka, kafka_response_context_t *response, s32 partition,
+                                                           s64 high_watermark, s64 fetched_offset, s64 produced_offset)
+{
+    if (partition < 0) {
+        return;
+    }
+
+    kafka_partition_key_t key = {
+        .topic_hash = kafka_topic_hash(&response->transaction),
+        .daddr_h = kafka->event.tup.daddr_h,
+        .daddr_l = kafka->event.tup.daddr_l,
+        .partition = partition,
+        .dport = kafka->event.tup.dport,
+    };
+    kafka_partition_offsets_t *offsets = bpf_map_lookup_elem(&kafka_partition_offsets, &key);
+    if (offsets == NULL) {
+        kafka_partition_offsets_t empty = {
+            .high_watermark = -1,
+            .fetched_offset = -1,
+            .produced_offset = -1,
+        };
+        bpf_map_update_with_telemetry(kafka_partition_offsets, &key, &empty, BPF_NOEXIST, -EEXIST);
+        offsets = bpf_map_lookup_elem(&kafka_partition_offsets, &key);
+        if (offsets == NULL) {
+            return;
+        }
+    }
+
+    if (high_watermark >= 0) {
+        offsets->high_watermark = high_watermark;
+    }
+    if (fetched_offset >= 0) {
+        offsets->fetched_offset = fetched_offset;
+    }
+    if (produced_offset >= 0) {
+        offsets->produced_offset = produced_offset;
+    }
+    offsets->last_updated = bpf_ktime_get_ns();
+}
+
 enum parser_level {
     PARSER_LEVEL_PARTITION,
     PARSER_LEVEL_RECORD_BATCH,
@@ -503,12 +610,219 @@ static enum parser_level parser_state_to_level(kafka_response_state state)
     }
 }
 
+// State shared with the bpf_loop callbacks walking the partitions and the
+// record batches of a response.
+typedef struct {
+    kafka_info_t *kafka;
+    kafka_response_context_t *response;
+    struct pktbuf pkt;
+    u32 offset;
+    u32 data_end;
+    u32 orig_offset;
+    u32 api_version;
+    enum parse_result ret;
+} kafka_response_loop_ctx_t;
+
+// Parses the current partition of a fetch response, resuming from the state saved in the response context. Returns
+// RET_CONTINUE when the partition was parsed and the parser can go on with the next one, RET_LOOP_END when the
+// partition parser must stop for the record batches parser to run. The offsets of the partition are only recorded when
+// record_offsets is set, which the unrolled parsers can't afford.
+static __always_inline enum parse_result kafka_parse_fetch_partition(kafka_info_t *kafka,
+                                                                     kafka_response_context_t *response,
+                                                                     pktbuf_t pkt, u32 *offset,
+                                                                     u32 data_end,
+                                                                     u32 orig_offset,
+                                                                     u32 api_version,
+                                                                     bool first,
+                                                                     bool record_offsets)
+{
+    bool flexible = api_version >= 12;
+    enum parse_result ret;
+
+    extra_debug("partition state: %d", response->state);
+    switch (response->state) {
+    case KAFKA_FETCH_RESPONSE_START:
+    case KAFKA_FETCH_RESPONSE_NUM_TOPICS:
+    case KAFKA_FETCH_RESPONSE_TOPIC_NAME_SIZE:
+    case KAFKA_FETCH_RESPONSE_NUM_PARTITIONS:
+        // Never happens. Only present to supress a compiler warning.
+        break;
+    case KAFKA_FETCH_RESPONSE_PARTITION_START:
+        if (record_offsets) {
+            response->partition_index = kafka_read_s32_in_packet(pkt, *offset, orig_offset, data_end);
+        }
+        *offset += sizeof(s32); // Skip partition_index
+        response->state = KAFKA_FETCH_RESPONSE_PARTITION_ERROR_CODE_START;
+        // fallthrough
+
+     case KAFKA_FETCH_RESPONSE_PARTITION_ERROR_CODE_START:
+     {
+        // Error codes range from -1 to 119 as per the Kafka protocol specification.
+        // For details, refer to: https://kafka.apache.org/protocol.html#protocol_error_codes
+        s16 error_code = 0;
+        ret = read_with_remainder_s16(response, pkt, offset, data_end, &error_code, first);
+        if (ret != RET_DONE) {
+            return ret;
+        }
+        if (error_code < -1 || error_code > 119) {
+            extra_debug("invalid error code: %d", error_code);
+            return RET_ERR;
+        }
+        extra_debug("got error code: %d", error_code);
+        response->partition_error_code = error_code;
+
+        if (record_offsets) {
+            s64 high_watermark = kafka_read_s64_in_packet(pkt, *offset, orig_offset, data_end);
+            kafka_update_partition_offsets(kafka, response, response->partition_index, high_watermark, -1, -1);
+        }
+        *offset += sizeof(s64); // Skip high_watermark
+
+        if (api_version >= 4) {
+            *offset += sizeof(s64); // Skip last_stable_offset
+
+            if (api_version >= 5) {
+                *offset += sizeof(s64); // log_start_offset
+            }
+        }
+
+        response->state = KAFKA_FETCH_RESPONSE_PARTITION_ABORTED_TRANSACTIONS;
+        // fallthrough
+        }
+
+    case KAFKA_FETCH_RESPONSE_PARTITION_ABORTED_TRANSACTIONS:
+        if (api_version >= 4) {
+            s64 aborted_transactions = 0;
+            ret = read_varint_or_s32(flexible, response, pkt, offset, data_end, &aborted_transactions, first,
+                                     VARINT_BYTES_NUM_ABORTED_TRANSACTIONS);
+            if (ret != RET_DONE) {
+                return ret;
+            }
+
+            extra_debug("aborted_transactions: %lld", aborted_transactions);
+
+            // Note that -1 is a valid value which means that the list is empty.
+            if (aborted_transactions < -1) {
+                return RET_ERR;
+            }
+            // If we interpret some junk data as a packet with a huge aborted_transactions,
+            // we could end up missing up a lot of future response processing since we
+            // would wait for the end of the aborted_transactions list. So add a limit
+            // as a heuristic.
+            if (aborted_transactions >= KAFKA_MAX_ABORTED_TRANSACTIONS) {
+                extra_debug("Possibly invalid aborted_transactions %lld", aborted_transactions);
+                return RET_ERR;
+            }
+            if (aborted_transactions >= 0) {
+                // producer_id and first_offset in each aborted transaction
+                u32 transaction_size = sizeof(s64) * 2;
+
+                if (flexible) {
+                    // Assume zero tagged fields.  It's a bit involved to verify that they are
+                    // zero here so we don't do it for now.
+                    transaction_size += sizeof(u8);
+                }
+
+                *offset += transaction_size * aborted_transactions;
+            }
+
+            if (api_version >= 11) {
+                *offset += sizeof(s32); // preferred_read_replica
+            }
+        }
+
+        response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_START;
+        // fallthrough
+
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_START:
+        if (response->record_batches_arrays_count >= KAFKA_MAX_RECORD_BATCHES_ARRAYS) {
+            extra_debug("exit due to record_batches_array full");
+            return RET_LOOP_END;
+        }
+
+        s64 tmp = 0;
+        ret = read_varint_or_s32(flexible, response, pkt, offset, data_end, &tmp, first,
+                                 VARINT_BYTES_RECORD_BATCHES_NUM_BYTES);
+        if (ret != RET_DONE) {
+            return ret;
+        }
+
+        response->record_batches_num_bytes = tmp;
+
+        extra_debug("record_batches_num_bytes: %d", response->record_batches_num_bytes);
+
+        if (response->record_batches_num_bytes != 0) {
+            u32 idx = response->record_batches_arrays_count;
+
+            if (idx >= KAFKA_MAX_RECORD_BATCHES_ARRAYS) {
+                extra_debug("out of space in record_batches_array");
+                return RET_ERR;
+            }
+
+            extra_debug("setting record_batches_arrays in index %d with error code %d", idx, response->partition_error_code);
+            kafka->record_batches_arrays[idx].partition_error_code = response->partition_error_code;
+            kafka->record_batches_arrays[idx].num_bytes = response->record_batches_num_bytes;
+            kafka->record_batches_arrays[idx].offset = *offset - orig_offset;
+            if (record_offsets) {
+                kafka->record_batches_arrays[idx].partition_index = response->partition_index;
+            }
+            response->record_batches_arrays_count++;
+        }
+
+        *offset += response->record_batches_num_bytes;
+        response->state = KAFKA_FETCH_RESPONSE_PARTITION_TAGGED_FIELDS;
+        // fallthrough
+
+    case KAFKA_FETCH_RESPONSE_PARTITION_TAGGED_FIELDS:
+        if (flexible) {
+            // Verification disabled due to code size limitations.
+            ret = skip_tagged_fields(response, pkt, offset, data_end, false);
+            if (ret != RET_DONE) {
+                return ret;
+            }
+        }
+        response->state = KAFKA_FETCH_RESPONSE_PARTITION_END;
+        // fallthrough
+
+    case KAFKA_FETCH_RESPONSE_PARTITION_END:
+        if (*offset > data_end) {
+            response->carry_over_offset = *offset - data_end;
+            return RET_EOP;
+        }
+
+        response->partitions_count--;
+        if (response->partitions_count == 0) {
+            return RET_DONE;
+        }
+
+        response->state = KAFKA_FETCH_RESPONSE_PARTITION_START;
+        break;
+
+    default:
+
+        extra_debug("invalid state %d in partition parser", response->state);
+        return RET_ERR;
+        break;
+    }
+
+    return RET_CONTINUE;
+}
+
+static long kafka_fetch_partition_loop_callback(u32 index, void *data)
+{
+    kafka_response_loop_ctx_t *loop = data;
+    loop->ret = kafka_parse_fetch_partition(loop->kafka, loop->response, loop->pkt, &loop->offset, loop->data_end,
+                                            loop->orig_offset, loop->api_version, index == 0,
+                                            kafka_partition_offsets_enabled());
+    return loop->ret == RET_CONTINUE ? 0 : 1;
+}
+
 static __always_inline enum parse_result kafka_continue_parse_response_partition_loop_fetch(kafka_info_t *kafka,
                                                                             conn_tuple_t *tup,
                                                                             kafka_response_context_t *response,
                                                                             pktbuf_t pkt, u32 offset,
                                                                             u32 data_end,
-                                                                            u32 api_version)
+                                                                            u32 api_version,
+                                                                            bool use_bpf_loop)
 {
     extra_debug("Parsing fetch response");
     u32 orig_offset = offset;
@@ -601,167 +915,34 @@ static __always_inline enum parse_result kafka_continue_parse_response_partition
         break;
     }
 
+    if (use_bpf_loop) {
+        kafka_response_loop_ctx_t loop = {
+            .kafka = kafka,
+            .response = response,
+            .pkt = pkt,
+            .offset = offset,
+            .data_end = data_end,
+            .orig_offset = orig_offset,
+            .api_version = api_version,
+            .ret = RET_CONTINUE,
+        };
+        bpf_loop(KAFKA_RESPONSE_PARSER_MAX_LOOP_ITERATIONS, kafka_fetch_partition_loop_callback, &loop, 0);
+        offset = loop.offset;
+        ret = loop.ret;
+    } else {
 #pragma unroll(KAFKA_RESPONSE_PARSER_MAX_ITERATIONS)
-    for (int i = 0; i < KAFKA_RESPONSE_PARSER_MAX_ITERATIONS; i++) {
-        bool first = i == 0;
-
-        extra_debug("partition state: %d", response->state);
-        switch (response->state) {
-        case KAFKA_FETCH_RESPONSE_START:
-        case KAFKA_FETCH_RESPONSE_NUM_TOPICS:
-        case KAFKA_FETCH_RESPONSE_TOPIC_NAME_SIZE:
-        case KAFKA_FETCH_RESPONSE_NUM_PARTITIONS:
-            // Never happens. Only present to supress a compiler warning.
-            break;
-        case KAFKA_FETCH_RESPONSE_PARTITION_START:
-            offset += sizeof(s32); // Skip partition_index
-            response->state = KAFKA_FETCH_RESPONSE_PARTITION_ERROR_CODE_START;
-            // fallthrough
-
-         case KAFKA_FETCH_RESPONSE_PARTITION_ERROR_CODE_START:
-         {
-            // Error codes range from -1 to 119 as per the Kafka protocol specification.
-            // For details, refer to: https://kafka.apache.org/protocol.html#protocol_error_codes
-            s16 error_code = 0;
-            ret = read_with_remainder_s16(response, pkt, &offset, data_end, &error_code, first);
-            if (ret != RET_DONE) {
-                return ret;
-            }
-            if (error_code < -1 || error_code > 119) {
-                extra_debug("invalid error code: %d", error_code);
-                return RET_ERR;
-            }
-            extra_debug("got error code: %d", error_code);
-            response->partition_error_code = error_code;
-
-            offset += sizeof(s64); // Skip high_watermark
-
-            if (api_version >= 4) {
-                offset += sizeof(s64); // Skip last_stable_offset
-
-                if (api_version >= 5) {
-                    offset += sizeof(s64); // log_start_offset
-                }
-            }
-
-            response->state = KAFKA_FETCH_RESPONSE_PARTITION_ABORTED_TRANSACTIONS;
-            // fallthrough
-            }
-
-        case KAFKA_FETCH_RESPONSE_PARTITION_ABORTED_TRANSACTIONS:
-            if (api_version >= 4) {
-                s64 aborted_transactions = 0;
-                ret = read_varint_or_s32(flexible, response, pkt, &offset, data_end, &aborted_transactions, first,
-                                         VARINT_BYTES_NUM_ABORTED_TRANSACTIONS);
-                if (ret != RET_DONE) {
-                    return ret;
-                }
-
-                extra_debug("aborted_transactions: %lld", aborted_transactions);
-
-                // Note that -1 is a valid value which means that the list is empty.
-                if (aborted_transactions < -1) {
-                    return RET_ERR;
-                }
-                // If we interpret some junk data as a packet with a huge aborted_transactions,
-                // we could end up missing up a lot of future response processing since we
-                // would wait for the end of the aborted_transactions list. So add a limit
-                // as a heuristic.
-                if (aborted_transactions >= KAFKA_MAX_ABORTED_TRANSACTIONS) {
-                    extra_debug("Possibly invalid aborted_transactions %lld", aborted_transactions);
-                    return RET_ERR;
-                }
-                if (aborted_transactions >= 0) {
-                    // producer_id and first_offset in each aborted transaction
-                    u32 transaction_size = sizeof(s64) * 2;
-
-                    if (flexible) {
-                        // Assume zero tagged fields.  It's a bit involved to verify that they are
-                        // zero here so we don't do it for now.
-                        transaction_size += sizeof(u8);
-                    }
-
-                    offset += transaction_size * aborted_transactions;
-                }
-
-                if (api_version >= 11) {
-                    offset += sizeof(s32); // preferred_read_replica
-                }
-            }
-
-            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_START;
-            // fallthrough
-
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_START:
-            if (response->record_batches_arrays_count >= KAFKA_MAX_RECORD_BATCHES_ARRAYS) {
-                extra_debug("exit due to record_batches_array full");
-                goto exit;
-            }
-
-            s64 tmp = 0;
-            ret = read_varint_or_s32(flexible, response, pkt, &offset, data_end, &tmp, first,
-                                     VARINT_BYTES_RECORD_BATCHES_NUM_BYTES);
-            if (ret != RET_DONE) {
-                return ret;
-            }
-
-            response->record_batches_num_bytes = tmp;
-
-            extra_debug("record_batches_num_bytes: %d", response->record_batches_num_bytes);
-
-            if (response->record_batches_num_bytes != 0) {
-                u32 idx = response->record_batches_arrays_count;
-
-                if (idx >= KAFKA_MAX_RECORD_BATCHES_ARRAYS) {
-                    extra_debug("out of space in record_batches_array");
-                    return RET_ERR;
-                }
-
-                extra_debug("setting record_batches_arrays in index %d with error code %d", idx, response->partition_error_code);
-                kafka->record_batches_arrays[idx].partition_error_code = response->partition_error_code;
-                kafka->record_batches_arrays[idx].num_bytes = response->record_batches_num_bytes;
-                kafka->record_batches_arrays[idx].offset = offset - orig_offset;
-                response->record_batches_arrays_count++;
-            }
-
-            offset += response->record_batches_num_bytes;
-            response->state = KAFKA_FETCH_RESPONSE_PARTITION_TAGGED_FIELDS;
-            // fallthrough
-
-        case KAFKA_FETCH_RESPONSE_PARTITION_TAGGED_FIELDS:
-            if (flexible) {
-                // Verification disabled due to code size limitations.
-                ret = skip_tagged_fields(response, pkt, &offset, data_end, false);
-                if (ret != RET_DONE) {
-                    return ret;
-                }
-            }
-            response->state = KAFKA_FETCH_RESPONSE_PARTITION_END;
-            // fallthrough
-
-        case KAFKA_FETCH_RESPONSE_PARTITION_END:
-            if (offset > data_end) {
-                response->carry_over_offset = offset - data_end;
-                return RET_EOP;
-            }
-
-            response->partitions_count--;
-            if (response->partitions_count == 0) {
-                return RET_DONE;
+        for (int i = 0; i < KAFKA_RESPONSE_PARSER_MAX_ITERATIONS; i++) {
+            ret = kafka_parse_fetch_partition(kafka, response, pkt, &offset, data_end, orig_offset, api_version, i == 0, false);
+            if (ret != RET_CONTINUE) {
+                break;
             }
-
-            response->state = KAFKA_FETCH_RESPONSE_PARTITION_START;
-            break;
-
-        default:
-
-            extra_debug("invalid state %d in partition parser", response->state);
-            return RET_ERR;
-            break;
         }
     }
 
-exit:
+    if (ret != RET_CONTINUE && ret != RET_LOOP_END) {
+        return ret;
+    }
+
     // We should have exited at KAFKA_FETCH_RESPONSE_PARTITION_END if we
     // managed to parse the entire packet, so if we get here we still have
     // more to go. Remove the skb_info.data_off so that this function can
@@ -866,6 +1047,9 @@ static __always_inline enum parse_result kafka_continue_parse_response_partition
 
     switch (response->state) {
     case KAFKA_PRODUCE_RESPONSE_PARTITION_START:
+        if (kafka_partition_offsets_enabled()) {
+            response->partition_index = kafka_read_s32_in_packet(pkt, offset, orig_offset, data_end);
+        }
         offset += sizeof(s32); // Skip partition_index
         response->state = KAFKA_PRODUCE_RESPONSE_PARTITION_ERROR_CODE_START;
         // fallthrough
@@ -887,6 +1071,15 @@ static __always_inline enum parse_result kafka_continue_parse_response_partition
         response->partition_error_code = error_code;
         response->transaction.error_code = error_code;
 
+        if (kafka_partition_offsets_enabled() && error_code == 0) {
+            // The records of the request were appended from base_offset on.
+            s64 base_offset = kafka_read_s64_in_packet(pkt, offset, orig_offset, data_end);
+            if (base_offset >= 0) {
+                kafka_update_partition_offsets(kafka, response, response->partition_index, -1, -1,
+                                               base_offset + response->transaction.records_count);
+            }
+        }
+
         // No need to continue parsing the produce response, as we got the error now
         return RET_DONE;
     }
@@ -898,203 +1091,266 @@ static __always_inline enum parse_result kafka_continue_parse_response_partition
     return RET_LOOP_END;
 }
 
-static __always_inline enum parse_result kafka_continue_parse_response_record_batches_loop(kafka_info_t *kafka,
-                                                                            conn_tuple_t *tup,
-                                                                            kafka_response_context_t *response,
-                                                                            pktbuf_t pkt, u32 offset,
-                                                                            u32 data_end,
-                                                                            u32 api_version)
+// Parses the current record batch of a fetch response, resuming from the state saved in the response context.
+// Returns RET_CONTINUE when the record batch was parsed and the parser can go on with the next one, RET_LOOP_END when
+// the transaction accumulated so far must be enqueued first.
+static __always_inline enum parse_result kafka_parse_record_batch(kafka_info_t *kafka,
+                                                                  kafka_response_context_t *response,
+                                                                  pktbuf_t pkt, u32 *offset,
+                                                                  u32 data_end,
+                                                                  u32 orig_offset,
+                                                                  u32 api_version,
+                                                                  bool first,
+                                                                  bool record_offsets)
 {
-    u32 orig_offset = offset;
     enum parse_result ret;
 
-    extra_debug("carry_over_offset %d", response->carry_over_offset);
+    extra_debug("record batches state: %d", response->state);
+    switch (response->state) {
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCH_START:
+            extra_debug("KAFKA_FETCH_RESPONSE_RECORD_BATCH_START: response->error_code %u, transaction.error_code %u, transaction.records_count: %d \n", response->partition_error_code,
+            response->partition_error_code,
+            response->transaction.records_count);
+        // If the next record batch has an error code that the ones we've
+        // been seeing so far in the accumulated transaction, we should emit
+        // the transaction event first and then continue parsing.  We can't
+        // emit the event from inside this loop due to instruction count
+        // restrictions, so force an exit and let the caller do it.
+        if (response->transaction.records_count > 0 && response->partition_error_code != response->transaction.error_code) {
+            return RET_LOOP_END;
+        }
 
-    if (response->carry_over_offset < 0) {
-        return RET_ERR;
-    }
+        extra_debug("KAFKA_FETCH_RESPONSE_RECORD_BATCH_START: setting transaction error code to %d",  response->partition_error_code);
+        response->transaction.error_code = response->partition_error_code;
 
-    offset += response->carry_over_offset;
-    response->carry_over_offset = 0;
+        *offset += sizeof(s64); // baseOffset
+        response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_LENGTH;
+        // fallthrough
 
-    extra_debug("record batches array num_bytes %u offset %u", response->record_batches_num_bytes, offset);
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCH_LENGTH:
+        ret = read_with_remainder(response, pkt, offset, data_end, &response->record_batch_length, first);
+        if (ret != RET_DONE) {
+            return ret;
+        }
 
-#pragma unroll(KAFKA_RESPONSE_PARSER_MAX_ITERATIONS)
-    for (int i = 0; i < KAFKA_RESPONSE_PARSER_MAX_ITERATIONS; i++) {
-        bool first = i == 0;
-
-        extra_debug("record batches state: %d", response->state);
-        switch (response->state) {
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCH_START:
-                extra_debug("KAFKA_FETCH_RESPONSE_RECORD_BATCH_START: response->error_code %u, transaction.error_code %u, transaction.records_count: %d \n", response->partition_error_code,
-                response->partition_error_code,
-                response->transaction.records_count);
-            // If the next record batch has an error code that the ones we've
-            // been seeing so far in the accumulated transaction, we should emit
-            // the transaction event first and then continue parsing.  We can't
-            // emit the event from inside this loop due to instruction count
-            // restrictions, so force an exit and let the caller do it.
-            if (response->transaction.records_count > 0 && response->partition_error_code != response->transaction.error_code) {
-                goto exit;
+        extra_debug("batchLength %d", response->record_batch_length);
+        if (response->record_batch_length <= 0) {
+            extra_debug("batchLength too small %d", response->record_batch_length);
+            return RET_ERR;
+        }
+        // The batchLength excludes the baseOffset (u64) and the batchLength (s32) itself,
+        // so those need to be be added separately.
+        if (response->record_batch_length + sizeof(s32) + sizeof(u64) > response->record_batches_num_bytes) {
+            extra_debug("batchLength too large %d (record_batches_num_bytes: %d)", response->record_batch_length,
+                        response->record_batches_num_bytes);
+
+            // Kafka fetch responses can have some partial, unparseable records in the record
+            // batch block which are truncated due to the maximum response size specified in
+            // the request.  If there are no more partitions left, assume we've reached such
+            // a block and report what we have.
+            if (response->transaction.records_count > 0 && response->partitions_count <= 1 &&
+                    response->record_batches_arrays_count - response->record_batches_arrays_idx == 1) {
+                extra_debug("assuming truncated data due to maxsize");
+                response->record_batch_length = 0;
+                response->record_batches_num_bytes = 0;
+                response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_END;
+                return RET_CONTINUE;
             }
 
-            extra_debug("KAFKA_FETCH_RESPONSE_RECORD_BATCH_START: setting transaction error code to %d",  response->partition_error_code);
-            response->transaction.error_code = response->partition_error_code;
+            extra_debug("assuming corrupt packet");
+            return RET_ERR;
+        }
 
-            offset += sizeof(s64); // baseOffset
-            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_LENGTH;
-            // fallthrough
+        *offset += sizeof(s32); // Skip partitionLeaderEpoch
+        response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_MAGIC;
+        // fallthrough
 
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCH_LENGTH:
-            ret = read_with_remainder(response, pkt, &offset, data_end, &response->record_batch_length, first);
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCH_MAGIC:
+        if (*offset + sizeof(s8) > data_end) {
+            response->carry_over_offset = *offset - data_end;
+            return RET_EOP;
+        }
+
+        if (record_offsets && *offset >= orig_offset + KAFKA_RECORD_BATCH_MAGIC_OFFSET) {
+            // The consumer resumes after the last record of the batch, at
+            // baseOffset + lastOffsetDelta + 1. Both are skipped when not part of this packet.
+            s64 base_offset = kafka_read_s64_in_packet(pkt, *offset - KAFKA_RECORD_BATCH_MAGIC_OFFSET, orig_offset, data_end);
+            s32 last_offset_delta = kafka_read_s32_in_packet(pkt, *offset + KAFKA_RECORD_BATCH_MAGIC_TO_LAST_OFFSET_DELTA, orig_offset, data_end);
+            if (base_offset >= 0 && last_offset_delta >= 0) {
+                kafka_update_partition_offsets(kafka, response, response->record_batches_partition_index, -1,
+                                               base_offset + last_offset_delta + 1, -1);
+            }
+        }
+
+        PKTBUF_READ_BIG_ENDIAN_WRAPPER(s8, magic, pkt, *offset);
+        if (magic != 2) {
+            extra_debug("Invalid magic byte");
+            return RET_ERR;
+        }
+
+        *offset += sizeof(u32); // Skipping crc
+        *offset += sizeof(s16); // Skipping attributes
+        *offset += sizeof(s32); // Skipping last *offset delta
+        *offset += sizeof(s64); // Skipping base timestamp
+        *offset += sizeof(s64); // Skipping max timestamp
+        *offset += sizeof(s64); // Skipping producer id
+        *offset += sizeof(s16); // Skipping producer epoch
+        *offset += sizeof(s32); // Skipping base sequence
+        response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_RECORDS_COUNT;
+        // fallthrough
+
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCH_RECORDS_COUNT:
+        {
+            s32 records_count = 0;
+            ret = read_with_remainder(response, pkt, offset, data_end, &records_count, first);
             if (ret != RET_DONE) {
                 return ret;
             }
 
-            extra_debug("batchLength %d", response->record_batch_length);
-            if (response->record_batch_length <= 0) {
-                extra_debug("batchLength too small %d", response->record_batch_length);
+            extra_debug("records_count: %d", records_count);
+            if (records_count <= 0) {
+                extra_debug("Invalid records count: %d", records_count);
                 return RET_ERR;
             }
-            // The batchLength excludes the baseOffset (u64) and the batchLength (s32) itself,
-            // so those need to be be added separately.
-            if (response->record_batch_length + sizeof(s32) + sizeof(u64) > response->record_batches_num_bytes) {
-                extra_debug("batchLength too large %d (record_batches_num_bytes: %d)", response->record_batch_length,
-                            response->record_batches_num_bytes);
-
-                // Kafka fetch responses can have some partial, unparseable records in the record
-                // batch block which are truncated due to the maximum response size specified in
-                // the request.  If there are no more partitions left, assume we've reached such
-                // a block and report what we have.
-                if (response->transaction.records_count > 0 && response->partitions_count <= 1 &&
-                        response->record_batches_arrays_count - response->record_batches_arrays_idx == 1) {
-                    extra_debug("assuming truncated data due to maxsize");
-                    response->record_batch_length = 0;
-                    response->record_batches_num_bytes = 0;
-                    response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_END;
-                    continue;
-                }
 
-                extra_debug("assuming corrupt packet");
+            // All the records have to fit inside the record batch, so guard against
+            // unreasonable values in corrupt packets.
+            if (records_count >= response->record_batch_length) {
+                extra_debug("Bogus records count %d (batch_length %d)",
+                            records_count, response->record_batch_length);
                 return RET_ERR;
             }
 
-            offset += sizeof(s32); // Skip partitionLeaderEpoch
-            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_MAGIC;
-            // fallthrough
+            response->transaction.records_count += records_count;
+        }
 
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCH_MAGIC:
-            if (offset + sizeof(s8) > data_end) {
-                response->carry_over_offset = offset - data_end;
-                return RET_EOP;
-            }
+        *offset += response->record_batch_length
+        - sizeof(s32) // Skip partitionLeaderEpoch
+        - sizeof(s8) // Skipping magic
+        - sizeof(u32) // Skipping crc
+        - sizeof(s16) // Skipping attributes
+        - sizeof(s32) // Skipping last *offset delta
+        - sizeof(s64) // Skipping base timestamp
+        - sizeof(s64) // Skipping max timestamp
+        - sizeof(s64) // Skipping producer id
+        - sizeof(s16) // Skipping producer epoch
+        - sizeof(s32) // Skipping base sequence
+        - sizeof(s32); // Skipping records count
+        response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_END;
+        // fallthrough
 
-            PKTBUF_READ_BIG_ENDIAN_WRAPPER(s8, magic, pkt, offset);
-            if (magic != 2) {
-                extra_debug("Invalid magic byte");
-                return RET_ERR;
-            }
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCH_END:
+        if (*offset > data_end) {
+            response->carry_over_offset = *offset - data_end;
+            return RET_EOP;
+        }
 
-            offset += sizeof(u32); // Skipping crc
-            offset += sizeof(s16); // Skipping attributes
-            offset += sizeof(s32); // Skipping last offset delta
-            offset += sizeof(s64); // Skipping base timestamp
-            offset += sizeof(s64); // Skipping max timestamp
-            offset += sizeof(s64); // Skipping producer id
-            offset += sizeof(s16); // Skipping producer epoch
-            offset += sizeof(s32); // Skipping base sequence
-            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_RECORDS_COUNT;
-            // fallthrough
-
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCH_RECORDS_COUNT:
-            {
-                s32 records_count = 0;
-                ret = read_with_remainder(response, pkt, &offset, data_end, &records_count, first);
-                if (ret != RET_DONE) {
-                    return ret;
-                }
+        // Record batch batchLength does not include batchOffset and batchLength.
+        response->record_batches_num_bytes -= response->record_batch_length + sizeof(u32) + sizeof(u64);
+        extra_debug("new record_batches_num_bytes %u", response->record_batches_num_bytes);
+        response->record_batch_length = 0;
 
-                extra_debug("records_count: %d", records_count);
-                if (records_count <= 0) {
-                    extra_debug("Invalid records count: %d", records_count);
-                    return RET_ERR;
-                }
+        if (response->record_batches_num_bytes > 0) {
+            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_START;
+            break;
+        }
 
-                // All the records have to fit inside the record batch, so guard against
-                // unreasonable values in corrupt packets.
-                if (records_count >= response->record_batch_length) {
-                    extra_debug("Bogus records count %d (batch_length %d)",
-                                records_count, response->record_batch_length);
-                    return RET_ERR;
-                }
+    case KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_END:
+    {
+        // The u64 type is used here to avoid some verifier errors if the
+        // compiler performs the index bounds check on a different register
+        // than the one used for the final access operation.
+        u64 idx = response->record_batches_arrays_idx + 1;
+        if (idx >= response->record_batches_arrays_count) {
+            response->record_batches_arrays_idx = idx;
+            response->carry_over_offset = *offset - orig_offset;
+            return RET_DONE;
+        }
 
-                response->transaction.records_count += records_count;
-            }
+        if (idx >= KAFKA_MAX_RECORD_BATCHES_ARRAYS) {
+            return RET_ERR;
+        }
 
-            offset += response->record_batch_length
-            - sizeof(s32) // Skip partitionLeaderEpoch
-            - sizeof(s8) // Skipping magic
-            - sizeof(u32) // Skipping crc
-            - sizeof(s16) // Skipping attributes
-            - sizeof(s32) // Skipping last offset delta
-            - sizeof(s64) // Skipping base timestamp
-            - sizeof(s64) // Skipping max timestamp
-            - sizeof(s64) // Skipping producer id
-            - sizeof(s16) // Skipping producer epoch
-            - sizeof(s32) // Skipping base sequence
-            - sizeof(s32); // Skipping records count
-            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_END;
-            // fallthrough
-
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCH_END:
-            if (offset > data_end) {
-                response->carry_over_offset = offset - data_end;
-                return RET_EOP;
-            }
+        response->partition_error_code = kafka->record_batches_arrays[idx].partition_error_code;
+        if (record_offsets) {
+            response->record_batches_partition_index = kafka->record_batches_arrays[idx].partition_index;
+        }
+        response->record_batches_num_bytes = kafka->record_batches_arrays[idx].num_bytes;
+        *offset = kafka->record_batches_arrays[idx].offset + orig_offset;
+        response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_START;
+        response->record_batches_arrays_idx = idx;
+        extra_debug("next idx %llu num_bytes %u offset %u", idx, response->record_batches_num_bytes, *offset);
+        extra_debug("next idx %llu error_code %u\n", idx, response->partition_error_code);
+    }
+        break;
 
-            // Record batch batchLength does not include batchOffset and batchLength.
-            response->record_batches_num_bytes -= response->record_batch_length + sizeof(u32) + sizeof(u64);
-            extra_debug("new record_batches_num_bytes %u", response->record_batches_num_bytes);
-            response->record_batch_length = 0;
+    default:
+        extra_debug("invalid state %d in record batches array parser", response->state);
+        break;
+    }
 
-            if (response->record_batches_num_bytes > 0) {
-                response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_START;
-                break;
-            }
+    return RET_CONTINUE;
+}
 
-        case KAFKA_FETCH_RESPONSE_RECORD_BATCHES_ARRAY_END:
-        {
-            // The u64 type is used here to avoid some verifier errors if the
-            // compiler performs the index bounds check on a different register
-            // than the one used for the final access operation.
-            u64 idx = response->record_batches_arrays_idx + 1;
-            if (idx >= response->record_batches_arrays_count) {
-                response->record_batches_arrays_idx = idx;
-                response->carry_over_offset = offset - orig_offset;
-                return RET_DONE;
-            }
+static long kafka_record_batch_loop_callback(u32 index, void *data)
+{
+    kafka_response_loop_ctx_t *loop = data;
+    loop->ret = kafka_parse_record_batch(loop->kafka, loop->response, loop->pkt, &loop->offset, loop->data_end,
+                                         loop->orig_offset, loop->api_version, index == 0,
+                                         kafka_partition_offsets_enabled());
+    return loop->ret == RET_CONTINUE ? 0 : 1;
+}
 
-            if (idx >= KAFKA_MAX_RECORD_BATCHES_ARRAYS) {
-                return RET_ERR;
-            }
+static __always_inline enum parse_result kafka_continue_parse_response_record_batches_loop(kafka_info_t *kafka,
+                                                                            conn_tuple_t *tup,
+                                                                            kafka_response_context_t *response,
+                                                                            pktbuf_t pkt, u32 offset,
+                                                                            u32 data_end,
+                                                                            u32 api_version,
+                                                                            bool use_bpf_loop)
+{
+    u32 orig_offset = offset;
+    enum parse_result ret;
 
-            response->partition_error_code = kafka->record_batches_arrays[idx].partition_error_code;
-            response->record_batches_num_bytes = kafka->record_batches_arrays[idx].num_bytes;
-            offset = kafka->record_batches_arrays[idx].offset + orig_offset;
-            response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_START;
-            response->record_batches_arrays_idx = idx;
-            extra_debug("next idx %llu num_bytes %u offset %u", idx, response->record_batches_num_bytes, offset);
-            extra_debug("next idx %llu error_code %u\n", idx, response->partition_error_code);
-        }
-            break;
+    extra_debug("carry_over_offset %d", response->carry_over_offset);
 
-        default:
-            extra_debug("invalid state %d in record batches array parser", response->state);
-            break;
+    if (response->carry_over_offset < 0) {
+        return RET_ERR;
+    }
+
+    offset += response->carry_over_offset;
+    response->carry_over_offset = 0;
+
+    extra_debug("record batches array num_bytes %u offset %u", response->record_batches_num_bytes, offset);
+
+    if (use_bpf_loop) {
+        kafka_response_loop_ctx_t loop = {
+            .kafka = kafka,
+            .response = response,
+            .pkt = pkt,
+            .offset = offset,
+            .data_end = data_end,
+            .orig_offset = orig_offset,
+            .api_version = api_version,
+            .ret = RET_CONTINUE,
+        };
+        bpf_loop(KAFKA_RESPONSE_PARSER_MAX_LOOP_ITERATIONS, kafka_record_batch_loop_callback, &loop, 0);
+        offset = loop.offset;
+        ret = loop.ret;
+    } else {
+#pragma unroll(KAFKA_RESPONSE_PARSER_MAX_ITERATIONS)
+        for (int i = 0; i < KAFKA_RESPONSE_PARSER_MAX_ITERATIONS; i++) {
+            ret = kafka_parse_record_batch(kafka, response, pkt, &offset, data_end, orig_offset, api_version, i == 0, false);
+            if (ret != RET_CONTINUE) {
+                break;
+            }
         }
     }
 
-exit:
+    if (ret != RET_CONTINUE && ret != RET_LOOP_END) {
+        return ret;
+    }
+
     // We should have exited at KAFKA_FETCH_RESPONSE_PARTITION_END if we
     // managed to parse the entire packet, so if we get here we still have
     // more to go. Remove the skb_info.data_off so that this function can
@@ -1164,7 +1420,8 @@ static __always_inline enum parse_result kafka_continue_parse_response(void *ctx
                                                                        u32 data_end,
                                                                        enum parser_level level,
                                                                        u32 api_version,
-                                                                       u32 api_key)
+                                                                       u32 api_key,
+                                                                       bool use_bpf_loop)
 {
     enum parse_result ret = 0;
 
@@ -1175,7 +1432,7 @@ static __always_inline enum parse_result kafka_continue_parse_response(void *ctx
         if (api_key == KAFKA_PRODUCE) {
             ret = kafka_continue_parse_response_partition_loop_produce(kafka, tup, response, pkt, offset, data_end, api_version);
         } else if (api_key == KAFKA_FETCH) {
-            ret = kafka_continue_parse_response_partition_loop_fetch(kafka, tup, response, pkt, offset, data_end, api_version);
+            ret = kafka_continue_parse_response_partition_loop_fetch(kafka, tup, response, pkt, offset, data_end, api_version, use_bpf_loop);
         }
         extra_debug("partition loop ret %d record_batches_array_count %u partitions_count %u", ret, response->record_batches_arrays_count, response->partitions_count);
 
@@ -1191,6 +1448,9 @@ static __always_inline enum parse_result kafka_continue_parse_response(void *ctx
             response->partition_state = response->state;
             response->state = KAFKA_FETCH_RESPONSE_RECORD_BATCH_START;
             response->partition_error_code = kafka->record_batches_arrays[0].partition_error_code;
+            if (use_bpf_loop) {
+                response->record_batches_partition_index = kafka->record_batches_arrays[0].partition_index;
+            }
             response->record_batches_num_bytes = kafka->record_batches_arrays[0].num_bytes;
             response->carry_over_offset = kafka->record_batches_arrays[0].offset;
             // Caller will do tail call
@@ -1205,7 +1465,7 @@ static __always_inline enum parse_result kafka_continue_parse_response(void *ctx
     } else {
         extra_debug("record batches before loop idx %u count %u\n", response->record_batches_arrays_idx, response->record_batches_arrays_count);
 
-        ret = kafka_continue_parse_response_record_batches_loop(kafka, tup, response, pkt, offset, data_end, api_version);
+        ret = kafka_continue_parse_response_record_batches_loop(kafka, tup, response, pkt, offset, data_end, api_version, use_bpf_loop);
         extra_debug("record batches loop ret %d carry_over_offset %d", ret, response->carry_over_offset);
         extra_debug("record batches after loop idx %u count %u\n", response->record_batches_arrays_idx, response->record_batches_arrays_count);
 
@@ -1309,7 +1569,7 @@ static __always_inline enum parse_result kafka_continue_parse_response(void *ctx
 }
 
 static __always_inline void kafka_response_parser(kafka_info_t *kafka, void *ctx, conn_tuple_t *tup, pktbuf_t pkt,
-enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_api_key) {
+enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_api_key, bool use_bpf_loop) {
     kafka_response_context_t *response = bpf_map_lookup_elem(&kafka_response, tup);
     if (!response) {
         return;
@@ -1330,12 +1590,18 @@ enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_ap
         return;
     }
 
+    if (kafka_partition_offsets_enabled()) {
+        // The server of the partitions whose offsets are updated while parsing.
+        bpf_memcpy(&kafka->event.tup, tup, sizeof(conn_tuple_t));
+        normalize_tuple(&kafka->event.tup);
+    }
+
     u32 data_off = pktbuf_data_offset(pkt);
     u32 data_end = pktbuf_data_end(pkt);
 
     enum parse_result result = kafka_continue_parse_response(ctx, kafka, tup, response, pkt,
                                                              data_off, data_end, level,
-                                                             api_version, target_api_key);
+                                                             api_version, target_api_key, use_bpf_loop);
     switch (result) {
     case RET_EOP:
         // This packet parsed successfully but more data needed, nothing
@@ -1365,7 +1631,7 @@ enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_ap
     }
 }
 
-static __always_inline int __socket__kafka_response_parser(struct __sk_buff *skb, enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_api_key) {
+static __always_inline int __socket__kafka_response_parser(struct __sk_buff *skb, enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_api_key, bool use_bpf_loop) {
     const __u32 zero = 0;
     kafka_info_t *kafka = bpf_map_lookup_elem(&kafka_heap, &zero);
     if (kafka == NULL) {
@@ -1378,43 +1644,66 @@ static __always_inline int __socket__kafka_response_parser(struct __sk_buff *skb
         return 0;
     }
 
-    kafka_response_parser(kafka, skb, &tup, pktbuf_from_skb(skb, &skb_info), level, min_api_version, max_api_version, target_api_key);
+    kafka_response_parser(kafka, skb, &tup, pktbuf_from_skb(skb, &skb_info), level, min_api_version, max_api_version, target_api_key, use_bpf_loop);
 
     return 0;
 }
 
 SEC("socket/kafka_fetch_response_partition_parser_v0")
 int socket__kafka_fetch_response_partition_parser_v0(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 11, KAFKA_FETCH);
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 11, KAFKA_FETCH, false);
 }
 
 SEC("socket/kafka_fetch_response_partition_parser_v12")
 int socket__kafka_fetch_response_partition_parser_v12(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH);
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, false);
 }
 
 SEC("socket/kafka_fetch_response_record_batch_parser_v0")
 int socket__kafka_fetch_response_record_batch_parser_v0(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 0, 11, KAFKA_FETCH);
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 0, 11, KAFKA_FETCH, false);
 }
 
 SEC("socket/kafka_fetch_response_record_batch_parser_v12")
 int socket__kafka_fetch_response_record_batch_parser_v12(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH);
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, false);
 }
 
 SEC("socket/kafka_produce_response_partition_parser_v0")
 int socket__kafka_produce_response_partition_parser_v0(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 8, KAFKA_PRODUCE);
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 8, KAFKA_PRODUCE, false);
 }
 
 SEC("socket/kafka_produce_response_partition_parser_v9")
 int socket__kafka_produce_response_partition_parser_v9(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 9, KAFKA_DECODING_MAX_SUPPORTED_PRODUCE_REQUEST_API_VERSION, KAFKA_PRODUCE);
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 9, KAFKA_DECODING_MAX_SUPPORTED_PRODUCE_REQUEST_API_VERSION, KAFKA_PRODUCE, false);
+}
+
+// Variants of the fetch response parsers walking the partitions and the record
+// batches with bpf_loop, selected at load time on kernels supporting it. They
+// parse much larger responses before having to tail call.
+SEC("socket/kafka_fetch_response_partition_parser_v0_loop")
+int socket__kafka_fetch_response_partition_parser_v0_loop(struct __sk_buff *skb) {
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 11, KAFKA_FETCH, true);
+}
+
+SEC("socket/kafka_fetch_response_partition_parser_v12_loop")
+int socket__kafka_fetch_response_partition_parser_v12_loop(struct __sk_buff *skb) {
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, true);
+}
+
+SEC("socket/kafka_fetch_response_record_batch_parser_v0_loop")
+int socket__kafka_fetch_response_record_batch_parser_v0_loop(struct __sk_buff *skb) {
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 0, 11, KAFKA_FETCH, true);
+}
+
+SEC("socket/kafka_fetch_response_record_batch_parser_v12_loop")
+int socket__kafka_fetch_response_record_batch_parser_v12_loop(struct __sk_buff *skb) {
+    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, true);
 }
 
 
-static __always_inline int __uprobe__kafka_tls_response_parser(struct pt_regs *ctx, enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_api_key) {
+static __always_inline int __uprobe__kafka_tls_response_parser(struct pt_regs *ctx, enum parser_level level, u32 min_api_version, u32 max_api_version, u32 target_api_key, bool use_bpf_loop) {
     const __u32 zero = 0;
     kafka_info_t *kafka = bpf_map_lookup_elem(&kafka_heap, &zero);
     if (kafka == NULL) {
@@ -1428,39 +1717,59 @@ static __always_inline int __uprobe__kafka_tls_response_parser(struct pt_regs *c
 
     // Put tuple on stack for 4.14.
     conn_tuple_t tup = args->tup;
-    kafka_response_parser(kafka, ctx, &tup, pktbuf_from_tls(ctx, args), level, min_api_version, max_api_version, target_api_key);
+    kafka_response_parser(kafka, ctx, &tup, pktbuf_from_tls(ctx, args), level, min_api_version, max_api_version, target_api_key, use_bpf_loop);
 
     return 0;
 }
 
 SEC("uprobe/kafka_tls_fetch_response_partition_parser_v0")
 int uprobe__kafka_tls_fetch_response_partition_parser_v0(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 11, KAFKA_FETCH);
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 11, KAFKA_FETCH, false);
 }
 
 SEC("uprobe/kafka_tls_fetch_response_partition_parser_v12")
 int uprobe__kafka_tls_fetch_response_partition_parser_v12(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH);
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, false);
 }
 
 SEC("uprobe/kafka_tls_fetch_response_record_batch_parser_v0")
 int uprobe__kafka_tls_fetch_response_record_batch_parser_v0(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 0, 11, KAFKA_FETCH);
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 0, 11, KAFKA_FETCH, false);
 }
 
 SEC("uprobe/kafka_tls_fetch_response_record_batch_parser_v12")
 int uprobe__kafka_tls_fetch_response_record_batch_parser_v12(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH);
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, false);
 }
 
 SEC("uprobe/kafka_tls_produce_response_partition_parser_v0")
 int uprobe__kafka_tls_produce_response_partition_parser_v0(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 8, KAFKA_PRODUCE);
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 8, KAFKA_PRODUCE, false);
 }
 
 SEC("uprobe/kafka_tls_produce_response_partition_parser_v9")
 int uprobe__kafka_tls_produce_response_partition_parser_v9(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 9, KAFKA_DECODING_MAX_SUPPORTED_PRODUCE_REQUEST_API_VERSION, KAFKA_PRODUCE);
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 9, KAFKA_DECODING_MAX_SUPPORTED_PRODUCE_REQUEST_API_VERSION, KAFKA_PRODUCE, false);
+}
+
+SEC("uprobe/kafka_tls_fetch_response_partition_parser_v0_loop")
+int uprobe__kafka_tls_fetch_response_partition_parser_v0_loop(struct pt_regs *ctx) {
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 11, KAFKA_FETCH, true);
+}
+
+SEC("uprobe/kafka_tls_fetch_response_partition_parser_v12_loop")
+int uprobe__kafka_tls_fetch_response_partition_parser_v12_loop(struct pt_regs *ctx) {
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, true);
+}
+
+SEC("uprobe/kafka_tls_fetch_response_record_batch_parser_v0_loop")
+int uprobe__kafka_tls_fetch_response_record_batch_parser_v0_loop(struct pt_regs *ctx) {
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 0, 11, KAFKA_FETCH, true);
+}
+
+SEC("uprobe/kafka_tls_fetch_response_record_batch_parser_v12_loop")
+int uprobe__kafka_tls_fetch_response_record_batch_parser_v12_loop(struct pt_regs *ctx) {
+    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_DECODING_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION, KAFKA_FETCH, true);
 }
 
 // Gets the next expected TCP sequence in the stream, assuming
@@ -1537,6 +1846,8 @@ static __always_inline bool kafka_process_new_response(void *ctx, conn_tuple_t *
         return false;
     }
     kafka->response.carry_over_offset = offset - orig_offset;
+    kafka->response.partition_index = -1;
+    kafka->response.record_batches_partition_index = -1;
     kafka->response.expected_tcp_seq = kafka_get_next_tcp_seq(skb_info);
     kafka->response.transaction.response_last_seen = bpf_ktime_get_ns();
 
@@ -6,6 +6,9 @@ BPF_PERCPU_ARRAY_MAP(kafka_heap, kafka_info_t, 1)
 BPF_HASH_MAP(kafka_in_flight, kafka_transaction_key_t, kafka_transaction_t, 0)
 BPF_HASH_MAP(kafka_response, conn_tuple_t, kafka_response_context_t, 0)
 
+// The latest offsets seen for each partition, when enabled.
+BPF_LRU_MAP(kafka_partition_offsets, kafka_partition_key_t, kafka_partition_offsets_t, KAFKA_MAX_PARTITION_OFFSETS)
+
 /*
  * This BPF map is utilized for kernel-space telemetry.
  * Only key 0 is utilized, and its corresponding value is a Kafka telemetry object.
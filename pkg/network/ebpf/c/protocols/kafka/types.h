@@ -72,6 +72,7 @@ typedef enum {
 typedef struct kafka_fetch_response_record_batches_array_t {
     __u32 num_bytes;
     __u32 offset;
+    __s32 partition_index;
     __s8 partition_error_code;
 } kafka_fetch_response_record_batches_array_t;
 
@@ -105,6 +106,12 @@ typedef struct {
     __s8 partition_error_code;
     // Where the parition parsing needs to resume from.
     kafka_response_state partition_state;
+    // The index of the partition being parsed by the partition parser, and of
+    // the partition of the record batches being parsed by the record batches
+    // parser. Only set when the offsets of the partitions are tracked, -1 when
+    // unknown.
+    __s32 partition_index;
+    __s32 record_batches_partition_index;
 } kafka_response_context_t;
 
 #define KAFKA_MAX_RECORD_BATCHES_ARRAYS 50u
@@ -116,6 +123,33 @@ typedef struct kafka_info_t {
     kafka_fetch_response_record_batches_array_t record_batches_arrays[KAFKA_MAX_RECORD_BATCHES_ARRAYS];
 } kafka_info_t;
 
+// The key of the offsets tracked for each partition in kafka_partition_offsets.
+// Topics are identified by the hash of their name, see kafka_topic_hash. The
+// same topic names can be used by different clusters, so partitions are also
+// keyed by the server of the responses, the destination of the normalized
+// tuple of the connection.
+typedef struct {
+    __u64 topic_hash;
+    __u64 daddr_h;
+    __u64 daddr_l;
+    __s32 partition;
+    __u16 dport;
+    __u16 pad;
+} kafka_partition_key_t;
+
+// The latest offsets seen in the responses for a partition, from which
+// userspace estimates the lag of the consumers. Offsets are -1 until seen.
+typedef struct {
+    // The high watermark of the partition, from fetch responses.
+    __s64 high_watermark;
+    // The offset following the last record batch fetched from the partition.
+    __s64 fetched_offset;
+    // The offset following the records last produced to the partition.
+    __s64 produced_offset;
+    // When the offsets were last updated, in nanoseconds.
+    __u64 last_updated;
+} kafka_partition_offsets_t;
+
 // kafka_telemetry_t is used to hold the Kafka kernel telemetry.
 typedef struct {
     // The array topic_name_size_buckets maps a bucket index to the number of occurrences observed for topic name lengths
@@ -12,6 +12,13 @@ BPF_HASH_MAP(postgres_in_flight, conn_tuple_t, postgres_transaction_t, 0)
 // Acts as a scratch buffer for Postgres events, for preparing events before they are sent to userspace.
 BPF_PERCPU_ARRAY_MAP(postgres_scratch_buffer, postgres_event_t, 1)
 
+// Acts as a scratch buffer for compact Postgres events.
+BPF_PERCPU_ARRAY_MAP(postgres_compact_scratch_buffer, postgres_compact_event_t, 1)
+
+// Holds the query fragments indexed by their fingerprint. A fragment is only stored the first time its
+// fingerprint is seen, later transactions running the same query are sent as compact events.
+BPF_LRU_MAP(postgres_queries, __u64, postgres_query_t, POSTGRES_MAX_QUERIES)
+
 // Maintains the current state of tail calls for each Postgres message.
 BPF_PERCPU_ARRAY_MAP(postgres_iterations, postgres_tail_call_state_t, 1)
 
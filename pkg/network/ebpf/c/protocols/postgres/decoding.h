@@ -15,9 +15,73 @@
 
 PKTBUF_READ_INTO_BUFFER(postgres_query, POSTGRES_BUFFER_SIZE, BLK_SIZE)
 
+// FNV-1a parameters, see queryHash in pkg/network/protocols/postgres
+#define POSTGRES_QUERY_HASH_OFFSET 14695981039346656037ULL
+#define POSTGRES_QUERY_HASH_PRIME 1099511628211ULL
+
+// Computes the fingerprint of the query of the transaction, the FNV-1a hash of its fragment. The fragment is hashed
+// 8 bytes at a time rather than byte by byte, to keep the instruction count of the response handler low.
+static __always_inline __u64 postgres_query_hash(postgres_transaction_t *tx) {
+    const __u64 *words = (const __u64 *)tx->request_fragment;
+    __u32 len = tx->original_query_size < POSTGRES_BUFFER_SIZE ? tx->original_query_size : POSTGRES_BUFFER_SIZE;
+    __u64 hash = POSTGRES_QUERY_HASH_OFFSET;
+
+#pragma unroll
+    for (__u32 i = 0; i < POSTGRES_BUFFER_SIZE / sizeof(__u64); i++) {
+        __u32 offset = i * sizeof(__u64);
+        if (offset >= len) {
+            break;
+        }
+        __u64 word = words[i];
+        // The bytes following the query may hold the next message, they must not be hashed.
+        if (len - offset < sizeof(__u64)) {
+            word &= (1ULL << ((len - offset) * 8)) - 1;
+        }
+        hash ^= word;
+        hash *= POSTGRES_QUERY_HASH_PRIME;
+    }
+    return hash;
+}
+
+// Sends the transaction as a postgres_compact_event_t, carrying the fingerprint of the query rather than the query
+// fragment. The first time a fingerprint is seen, the fragment is stored in postgres_queries and the transaction is
+// sent as a postgres_event_t, for userspace to learn the query. Returns false when the transaction must be sent as a
+// postgres_event_t.
+static __always_inline bool postgres_compact_enqueue(conn_tuple_t *tuple, postgres_transaction_t *tx) {
+    if (!is_postgres_compact_monitoring_enabled() || tx->original_query_size == 0) {
+        return false;
+    }
+
+    __u64 query_hash = postgres_query_hash(tx);
+    if (bpf_map_lookup_elem(&postgres_queries, &query_hash) == NULL) {
+        // postgres_query_t is nothing but the query fragment
+        bpf_map_update_elem(&postgres_queries, &query_hash, tx->request_fragment, BPF_NOEXIST);
+        return false;
+    }
+
+    const __u32 zero = 0;
+    postgres_compact_event_t *event = bpf_map_lookup_elem(&postgres_compact_scratch_buffer, &zero);
+    if (!event) {
+        return false;
+    }
+
+    bpf_memcpy(&event->tuple, tuple, sizeof(conn_tuple_t));
+    event->request_started = tx->request_started;
+    event->response_last_seen = tx->response_last_seen;
+    event->query_hash = query_hash;
+    event->original_query_size = tx->original_query_size;
+    event->tags = tx->tags;
+    postgres_compact_batch_enqueue(event);
+    return true;
+}
+
 // Enqueues a batch of events to the user-space. To spare stack size, we take a scratch buffer from the map, copy
 // the connection tuple and the transaction to it, and then enqueue the event.
 static __always_inline void postgres_batch_enqueue_wrapper(conn_tuple_t *tuple, postgres_transaction_t *tx) {
+    if (postgres_compact_enqueue(tuple, tx)) {
+        return;
+    }
+
     u32 zero = 0;
     postgres_event_t *event = bpf_map_lookup_elem(&postgres_scratch_buffer, &zero);
     if (!event) {
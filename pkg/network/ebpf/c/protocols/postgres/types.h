@@ -32,6 +32,25 @@ typedef struct {
     postgres_transaction_t tx;
 } postgres_event_t;
 
+// Maximum number of query fragments held in postgres_queries
+#define POSTGRES_MAX_QUERIES 2048
+
+// postgres_compact_event_t is sent instead of postgres_event_t when compact events are enabled
+// and the query of the transaction was already seen. Rather than the query fragment, it carries
+// the fingerprint of the query, the hash under which its fragment is stored in postgres_queries.
+typedef struct {
+    conn_tuple_t tuple;
+    __u64 request_started;
+    __u64 response_last_seen;
+    __u64 query_hash;
+    __u32 original_query_size;
+    __u8 tags;
+} postgres_compact_event_t;
+
+typedef struct {
+    char request_fragment[POSTGRES_BUFFER_SIZE];
+} postgres_query_t;
+
 typedef struct {
     __u8 total_msg_count;
     // Saving the packet data offset is crucial for maintaining the current read position and ensuring proper utilization
@@ -9,4 +9,8 @@
 
 USM_EVENTS_INIT(postgres, postgres_event_t, POSTGRES_BATCH_SIZE);
 
+#define POSTGRES_COMPACT_BATCH_SIZE (MAX_BATCH_SIZE(postgres_compact_event_t))
+
+USM_EVENTS_INIT(postgres_compact, postgres_compact_event_t, POSTGRES_COMPACT_BATCH_SIZE);
+
 #endif
@@ -7,9 +7,19 @@
 #include "protocols/redis/types.h"
 
 // Keeps track of in-flight Redis transactions
-BPF_HASH_MAP(redis_in_flight, conn_tuple_t, redis_transaction_t, 0)
+BPF_HASH_MAP(redis_in_flight, conn_tuple_t, redis_pipeline_t, 0)
+
+// Holds an empty pipeline, used to create entries of redis_in_flight without using eBPF stack memory.
+BPF_ARRAY_MAP(redis_empty_pipeline, redis_pipeline_t, 1)
 
 // Acts as a scratch buffer for Redis events, for preparing events before they are sent to userspace.
 BPF_PERCPU_ARRAY_MAP(redis_scratch_buffer, redis_event_t, 1)
 
+// Holds the latency histograms of the Redis transactions aggregated in-kernel, which userspace drains every check
+// interval. Its size is set by userspace.
+BPF_PERCPU_HASH_MAP(redis_latency_aggregates, redis_aggregate_key_t, redis_latency_sketch_t, 0)
+
+// Holds an empty histogram, used to create entries of redis_latency_aggregates without using eBPF stack memory.
+BPF_ARRAY_MAP(redis_empty_latency_sketch, redis_latency_sketch_t, 1)
+
 #endif /* __REDIS_MAPS_H */
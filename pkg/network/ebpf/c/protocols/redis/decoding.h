@@ -2,9 +2,57 @@
 #define __REDIS_DECODING_H
 
 #include "protocols/redis/decoding-maps.h"
+#include "protocols/helpers/latency.h"
 #include "protocols/helpers/pktbuf.h"
 
 PKTBUF_READ_INTO_BUFFER(redis_bulk, MAX_KEY_LEN, READ_KEY_CHUNK_SIZE)
+PKTBUF_READ_INTO_BUFFER(redis_header, RESP_MAX_HEADER_LEN, RESP_READ_HEADER_CHUNK_SIZE)
+
+// The commands we recognize: their name, their redis_command_t, and the prefix of their expected response. Error
+// responses are expected for all commands. To recognize a new command, add it to redis_command_t and here.
+#define REDIS_COMMANDS(X)                          \
+    X(GET, REDIS_GET, RESP_BULK_PREFIX)            \
+    X(SET, REDIS_SET, RESP_SIMPLE_STRING_PREFIX)   \
+    X(HGET, REDIS_HGET, RESP_BULK_PREFIX)          \
+    X(HSET, REDIS_HSET, RESP_INTEGER_PREFIX)       \
+    X(HGETALL, REDIS_HGETALL, RESP_ANY_PREFIX)     \
+    X(MGET, REDIS_MGET, RESP_ARRAY_PREFIX)         \
+    X(MSET, REDIS_MSET, RESP_SIMPLE_STRING_PREFIX) \
+    X(DEL, REDIS_DEL, RESP_INTEGER_PREFIX)         \
+    X(EXISTS, REDIS_EXISTS, RESP_INTEGER_PREFIX)   \
+    X(INCR, REDIS_INCR, RESP_INTEGER_PREFIX)       \
+    X(EXPIRE, REDIS_EXPIRE, RESP_INTEGER_PREFIX)   \
+    X(LPUSH, REDIS_LPUSH, RESP_INTEGER_PREFIX)     \
+    X(RPUSH, REDIS_RPUSH, RESP_INTEGER_PREFIX)     \
+    X(LPOP, REDIS_LPOP, RESP_ANY_PREFIX)           \
+    X(RPOP, REDIS_RPOP, RESP_ANY_PREFIX)           \
+    X(SADD, REDIS_SADD, RESP_INTEGER_PREFIX)       \
+    X(ZADD, REDIS_ZADD, RESP_INTEGER_PREFIX)       \
+    X(EVALSHA, REDIS_EVALSHA, RESP_ANY_PREFIX)
+
+// Returns the command with the given name, which must be upper case, or REDIS_UNKNOWN.
+static __always_inline redis_command_t redis_command_from_name(const char *name, u16 name_len) {
+#define REDIS_MATCH_COMMAND(cmd_name, command, response_prefix)                                         \
+    if (name_len == sizeof(#cmd_name) - 1 && bpf_memcmp(name, #cmd_name, sizeof(#cmd_name) - 1) == 0) { \
+        return command;                                                                                 \
+    }
+    REDIS_COMMANDS(REDIS_MATCH_COMMAND)
+#undef REDIS_MATCH_COMMAND
+    return REDIS_UNKNOWN;
+}
+
+// Returns the prefix of the response expected for the given command, or RESP_ANY_PREFIX.
+static __always_inline char redis_expected_response_prefix(redis_command_t command) {
+    switch (command) {
+#define REDIS_COMMAND_RESPONSE_PREFIX(cmd_name, command, response_prefix) \
+    case command:                                                         \
+        return response_prefix;
+    REDIS_COMMANDS(REDIS_COMMAND_RESPONSE_PREFIX)
+#undef REDIS_COMMAND_RESPONSE_PREFIX
+    default:
+        return RESP_ANY_PREFIX;
+    }
+}
 
 // Read a CRLF terminator from the packet buffer. The terminator is expected to be in the format: \r\n.
 // The function returns true if the terminator was successfully read, or false if the terminator could not be read.
@@ -17,90 +65,163 @@ static __always_inline bool read_crlf(pktbuf_t pkt) {
     return terminator[0] == RESP_TERMINATOR_1 && terminator[1] == RESP_TERMINATOR_2;
 }
 
-// Read an array message from the packet buffer. The array message is expected to be in the format:
-// *<param_count>\r\n<param1>\r\n<param2>\r\n...
-// where <param_count> is the number of parameters in the array, and <param1>, <param2>, etc. are the parameters themselves.
-// The function returns the number of parameters in the array, or 0 if the array message could not be read.
-static __always_inline u32 read_array_message_param_count(pktbuf_t pkt) {
-    // Verify RESP array prefix
-    char first_byte;
-    if (pktbuf_load_bytes_from_current_offset(pkt, &first_byte, sizeof(first_byte)) < 0 || first_byte != RESP_ARRAY_PREFIX) {
-        return 0;
+// Reads the header line of the RESP value at the current offset, in the format: <prefix><number>\r\n for arrays, bulk
+// strings and integers, and <prefix><text>\r\n for simple strings and errors, whose number is set to 0.
+// The function advances past the line and returns true, or returns false if the line could not be read, either
+// because it is not a RESP header, or because it is longer than RESP_MAX_HEADER_LEN.
+static __always_inline bool read_resp_header(pktbuf_t pkt, char *prefix, s64 *number) {
+    char line[RESP_MAX_HEADER_LEN] = {};
+    pktbuf_read_into_buffer_redis_header(line, pkt, pktbuf_data_offset(pkt));
+
+    u32 line_len = 0;
+    #pragma unroll (RESP_MAX_HEADER_LEN - 2)
+    for (int i = 1; i < RESP_MAX_HEADER_LEN - 1; i++) {
+        if (line[i] == RESP_TERMINATOR_1 && line[i + 1] == RESP_TERMINATOR_2) {
+            line_len = i;
+            break;
+        }
     }
-    pktbuf_advance(pkt, sizeof(first_byte));
-
-    // Read parameter count
-    char param_count;
-    // Assuming single-digit param count, as currently we don't need more.
-    if (pktbuf_load_bytes_from_current_offset(pkt, &param_count, 1) < 0) {
-        return 0;
+    if (line_len == 0) {
+        return false;
     }
-    pktbuf_advance(pkt, sizeof(param_count));
 
-    if (param_count < '0' || param_count > '9') {
-        return 0;
+    *prefix = line[0];
+    *number = 0;
+    switch (*prefix) {
+    case RESP_SIMPLE_STRING_PREFIX:
+    case RESP_ERROR_PREFIX:
+        pktbuf_advance(pkt, line_len + RESP_FIELD_TERMINATOR_LEN);
+        return true;
+    case RESP_ARRAY_PREFIX:
+    case RESP_BULK_PREFIX:
+    case RESP_INTEGER_PREFIX:
+        break;
+    default:
+        return false;
     }
 
-    if (!read_crlf(pkt)) {
-        return 0;
+    // The number is a decimal number, negative for null arrays and bulk strings.
+    bool negative = line[1] == '-';
+    s64 value = 0;
+    u32 digits_read = 0;
+    #pragma unroll (RESP_MAX_HEADER_LEN - 2)
+    for (int i = 1; i < RESP_MAX_HEADER_LEN - 1; i++) {
+        if (i >= line_len) {
+            break;
+        }
+        if (i == 1 && negative) {
+            continue;
+        }
+        if (line[i] < '0' || line[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (line[i] - '0');
+        digits_read++;
+    }
+    if (digits_read == 0) {
+        return false;
     }
 
-    return param_count - '0';
+    *number = negative ? -value : value;
+    pktbuf_advance(pkt, line_len + RESP_FIELD_TERMINATOR_LEN);
+    return true;
 }
 
-// Extracts and returns the length of a Redis key from a RESP bulk string.
-// Validates the format and returns 0 if invalid or exceeds maximum length.
-static __always_inline u16 get_key_len(pktbuf_t pkt) {
-    u32 current_offset = pktbuf_data_offset(pkt);
+// Advances past the data of a bulk string of the given length, and its CRLF terminator. Null bulk strings, of negative
+// length, have no data. The function returns false if the bulk string does not end in this packet.
+static __always_inline bool skip_resp_bulk_data(pktbuf_t pkt, s64 len) {
+    if (len < 0) {
+        return true;
+    }
+    const u32 offset = pktbuf_data_offset(pkt);
     const u32 data_end = pktbuf_data_end(pkt);
+    if (offset > data_end || len > data_end - offset) {
+        return false;
+    }
+    pktbuf_advance(pkt, len);
+    return read_crlf(pkt);
+}
 
-    char bulk_prefix;
-    // Verify we can read the RESP bulk prefix.
-    if (current_offset + sizeof(bulk_prefix) > data_end) {
-        return 0;
+// Advances past the reply at the current offset. Arrays are only skipped when made of up to RESP_MAX_SKIPPED_ARRAY_LEN
+// bulk strings and integers, which covers the replies of the commands we recognize.
+// The function returns false if the end of the reply could not be found.
+static __always_inline bool skip_resp_reply(pktbuf_t pkt) {
+    char prefix;
+    s64 number;
+    if (!read_resp_header(pkt, &prefix, &number)) {
+        return false;
     }
-    if (pktbuf_load_bytes(pkt, current_offset, &bulk_prefix, sizeof(bulk_prefix)) < 0 || bulk_prefix != RESP_BULK_PREFIX) {
-        return 0;
+    if (prefix == RESP_BULK_PREFIX) {
+        return skip_resp_bulk_data(pkt, number);
     }
-    current_offset++;
-
-    // Read key length (up to MAX_DIGITS_KEY_LEN_PREFIX digits)
-    char key_size_bytes[MAX_DIGITS_KEY_LEN_PREFIX] = {};
-    if (current_offset + sizeof(key_size_bytes) > data_end) {
-        return 0;
+    if (prefix != RESP_ARRAY_PREFIX) {
+        return true;
     }
-    if (pktbuf_load_bytes(pkt, current_offset, key_size_bytes, sizeof(key_size_bytes)) < 0) {
-        return 0;
+    if (number > RESP_MAX_SKIPPED_ARRAY_LEN) {
+        return false;
     }
 
-    u16 key_size = 0;
-    u32 digits_read = 0;
-    // The key length is a decimal number, so we need to convert it from ASCII to an integer.
-    #pragma unroll (MAX_DIGITS_KEY_LEN_PREFIX)
-    for (int i = 0; i < MAX_DIGITS_KEY_LEN_PREFIX; i++) {
-        if (key_size_bytes[i] == RESP_TERMINATOR_1) {
+    #pragma unroll (RESP_MAX_SKIPPED_ARRAY_LEN)
+    for (int i = 0; i < RESP_MAX_SKIPPED_ARRAY_LEN; i++) {
+        if (i >= number) {
             break;
         }
-        if (key_size_bytes[i] < '0' || key_size_bytes[i] > '9') {
-            return 0;
+        s64 element_len;
+        if (!read_resp_header(pkt, &prefix, &element_len)) {
+            return false;
         }
-        key_size = key_size * 10 + (key_size_bytes[i] - '0');
-        digits_read++;
+        if (prefix == RESP_ARRAY_PREFIX) {
+            return false;
+        }
+        if (prefix == RESP_BULK_PREFIX && !skip_resp_bulk_data(pkt, element_len)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads the name of the command at the current offset, of the given length, without advancing.
+// Returns the command, or REDIS_UNKNOWN if we do not recognize it.
+static __always_inline redis_command_t read_redis_command_name(pktbuf_t pkt, s64 method_len) {
+    char method[MAX_METHOD_LEN] = {};
+    if (method_len >= MAX_METHOD_LEN) {
+        return REDIS_UNKNOWN;
     }
 
-    // Advance past the digits we read
-    current_offset += digits_read;
-    pktbuf_set_offset(pkt, current_offset);
+    // The commands we recognize are followed by CRLF and their key, so we can read a whole buffer.
+    if (pktbuf_load_bytes_from_current_offset(pkt, method, MAX_METHOD_LEN) < 0) {
+        return REDIS_UNKNOWN;
+    }
 
-    if (!read_crlf(pkt)) {
-        return 0;
+    // Commands are case-insensitive, and all the ones we recognize are made of letters.
+    #pragma unroll (MAX_METHOD_LEN)
+    for (int i = 0; i < MAX_METHOD_LEN; i++) {
+        method[i] &= ~0x20;
     }
 
-    if (key_size <= 0 || key_size > MAX_READABLE_KEY_LEN) {
-        return 0;
+    return redis_command_from_name(method, method_len);
+}
+
+// Returns true if the data at the current offset starts with a command we recognize, without advancing. Requests are
+// told apart from replies this way, replies being arrays of bulk strings as well.
+static __always_inline bool redis_starts_with_command(pktbuf_t pkt) {
+    const u32 offset = pktbuf_data_offset(pkt);
+    bool found = false;
+
+    char prefix;
+    s64 param_count;
+    s64 method_len;
+    if (!read_resp_header(pkt, &prefix, &param_count) || prefix != RESP_ARRAY_PREFIX || param_count < 2) {
+        goto end;
     }
+    if (!read_resp_header(pkt, &prefix, &method_len) || prefix != RESP_BULK_PREFIX || method_len < 1) {
+        goto end;
+    }
+    found = read_redis_command_name(pkt, method_len) != REDIS_UNKNOWN;
 
-    return key_size;
+end:
+    pktbuf_set_offset(pkt, offset);
+    return found;
 }
 
 // Reads a Redis key name into the provided buffer with length validation.
@@ -127,61 +248,108 @@ static __always_inline bool read_key_name(pktbuf_t pkt, char *buf, u8 buf_len, u
     return true;
 }
 
-
-// Processes incoming Redis requests (GET or SET commands).
-// Extracts command type and key (up to MAX_KEY_LEN bytes), stores transaction info in redis_in_flight map.
-static __always_inline void process_redis_request(pktbuf_t pkt, conn_tuple_t *conn_tuple) {
-    u32 param_count = read_array_message_param_count(pkt);
-    if (param_count == 0) {
-        return;
+// Reads the command at the current offset into the given transaction: its type and key (up to MAX_KEY_LEN bytes) for
+// the commands listed in REDIS_COMMANDS, and REDIS_UNKNOWN for the others, which still get a reply taking their turn in
+// the pipeline. The parameters following the key are skipped, so that the offset is left at the next command.
+// The function returns false if the data is not a command, or if the end of the command could not be found.
+static __always_inline bool read_redis_command(pktbuf_t pkt, redis_transaction_t *transaction, u64 now) {
+    char prefix;
+    s64 param_count;
+    if (!read_resp_header(pkt, &prefix, &param_count) || prefix != RESP_ARRAY_PREFIX || param_count < 1) {
+        return false;
     }
-    // GET message has 2 parameters, SET message has 3-5 parameters. Anything else is irrelevant for us.
-    if (param_count < MIN_PARAM_COUNT || param_count > MAX_PARAM_COUNT) {
-        return;
+
+    s64 method_len;
+    if (!read_resp_header(pkt, &prefix, &method_len) || prefix != RESP_BULK_PREFIX || method_len < 1) {
+        return false;
     }
 
-    // Read method
-    const u16 method_len = get_key_len(pkt);
-    char method[METHOD_LEN + 1] = {};
-    // We only support GET and SET commands for now, both with length 3.
-    if (method_len != METHOD_LEN) {
-        return;
+    transaction->request_started = now;
+    transaction->response_last_seen = 0;
+    transaction->buf_len = 0;
+    transaction->tags = 0;
+    transaction->truncated = false;
+    transaction->is_error = false;
+    transaction->command = read_redis_command_name(pkt, method_len);
+    if (!skip_resp_bulk_data(pkt, method_len)) {
+        return false;
     }
 
-    if (pktbuf_load_bytes_from_current_offset(pkt, method, METHOD_LEN) < 0) {
-        return;
+    s64 params_left = param_count - 1;
+    if (transaction->command != REDIS_UNKNOWN) {
+        // All the commands we recognize have a key as their first parameter.
+        if (params_left < 1) {
+            transaction->command = REDIS_UNKNOWN;
+        } else {
+            s64 key_len;
+            if (!read_resp_header(pkt, &prefix, &key_len) || prefix != RESP_BULK_PREFIX || key_len < 1 || key_len > MAX_READABLE_KEY_LEN) {
+                return false;
+            }
+            transaction->buf_len = key_len;
+            if (!read_key_name(pkt, transaction->buf, sizeof(transaction->buf), &transaction->buf_len, &transaction->truncated)) {
+                return false;
+            }
+            params_left--;
+        }
     }
-    pktbuf_advance(pkt, METHOD_LEN);
 
-    // Read CRLF after method
-    if (!read_crlf(pkt)) {
-        return;
+    if (params_left > MAX_PARAM_COUNT - 1) {
+        return false;
     }
 
-    redis_transaction_t transaction = {};
-    transaction.request_started = bpf_ktime_get_ns();
-    if (bpf_memcmp(method, REDIS_CMD_SET, METHOD_LEN) == 0) {
-        transaction.command = REDIS_SET;
-    } else if (bpf_memcmp(method, REDIS_CMD_GET, METHOD_LEN) == 0) {
-        transaction.command = REDIS_GET;
-    } else {
-        return;
+    #pragma unroll (MAX_PARAM_COUNT - 1)
+    for (int i = 0; i < MAX_PARAM_COUNT - 1; i++) {
+        if (i >= params_left) {
+            break;
+        }
+        s64 param_len;
+        if (!read_resp_header(pkt, &prefix, &param_len) || prefix != RESP_BULK_PREFIX) {
+            return false;
+        }
+        if (!skip_resp_bulk_data(pkt, param_len)) {
+            // The parameter goes on in the next packets, this one holds nothing else.
+            pktbuf_set_offset(pkt, pktbuf_data_end(pkt));
+            return true;
+        }
     }
+    return true;
+}
 
-    // Read key name
-    transaction.buf_len = get_key_len(pkt);
-    if (transaction.buf_len == 0) {
-        return;
+// Processes incoming Redis requests: appends each of the commands of the packet to the pipeline of the connection,
+// which is created if needed. The pipeline is dropped when its replies can no longer be matched, that is when the
+// end of a command could not be found, or when there are more than REDIS_MAX_PIPELINED_COMMANDS commands in flight.
+static __always_inline void process_redis_request(pktbuf_t pkt, conn_tuple_t *conn_tuple, redis_pipeline_t *pipeline) {
+    if (pipeline == NULL) {
+        const __u32 zero = 0;
+        redis_pipeline_t *empty = bpf_map_lookup_elem(&redis_empty_pipeline, &zero);
+        if (empty == NULL) {
+            return;
+        }
+        bpf_map_update_with_telemetry(redis_in_flight, conn_tuple, empty, BPF_NOEXIST);
+        pipeline = bpf_map_lookup_elem(&redis_in_flight, conn_tuple);
+        if (pipeline == NULL) {
+            return;
+        }
     }
 
-    if (!read_key_name(pkt, transaction.buf, sizeof(transaction.buf), &transaction.buf_len, &transaction.truncated)) {
-        return;
+    const u64 now = bpf_ktime_get_ns();
+    #pragma unroll (REDIS_MAX_PIPELINED_COMMANDS)
+    for (int i = 0; i < REDIS_MAX_PIPELINED_COMMANDS; i++) {
+        if (pktbuf_data_offset(pkt) >= pktbuf_data_end(pkt) || pipeline->count >= REDIS_MAX_PIPELINED_COMMANDS) {
+            break;
+        }
+        const u8 slot = (pipeline->head + pipeline->count) & (REDIS_MAX_PIPELINED_COMMANDS - 1);
+        if (!read_redis_command(pkt, &pipeline->transactions[slot], now)) {
+            break;
+        }
+        pipeline->count++;
     }
 
-    bpf_map_update_with_telemetry(redis_in_flight, conn_tuple, &transaction, BPF_ANY);
+    if (pipeline->count == 0 || pktbuf_data_offset(pkt) < pktbuf_data_end(pkt)) {
+        bpf_map_delete_elem(&redis_in_flight, conn_tuple);
+    }
 }
 
-
 // Handles TCP connection termination by cleaning up in-flight transactions.
 // Removes entries from redis_in_flight map for both directions.
 static void __always_inline redis_tcp_termination(conn_tuple_t *tup) {
@@ -190,9 +358,89 @@ static void __always_inline redis_tcp_termination(conn_tuple_t *tup) {
     bpf_map_delete_elem(&redis_in_flight, tup);
 }
 
+static __always_inline bool redis_aggregation_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("redis_aggregation_enabled", val);
+    return val > 0;
+}
+
+// Returns true if aggregates are keyed by server, dropping the port of the client, which is only done when userspace
+// rolls up the connections of a client to a server.
+static __always_inline bool redis_aggregate_by_server() {
+    __u64 val = 0;
+    LOAD_CONSTANT("redis_aggregation_rollup_enabled", val);
+    return val > 0;
+}
+
+static __always_inline __u64 redis_key_sampling_rate() {
+    __u64 val = 0;
+    LOAD_CONSTANT("redis_key_sampling_rate", val);
+    return val;
+}
+
+// Folds the latency of a complete transaction into the histogram of its (connection, command, error) instead of
+// sending it to userspace. One out of every redis_key_sampling_rate transactions of an aggregate, starting with the
+// first one, is still sent to userspace, for the key names to be sampled. The connection is the normalized tuple,
+// without the client port when connections are rolled up, so that the short-lived connections of a client to a server
+// share their aggregates. Returns false when the transaction must be enqueued.
+static __always_inline bool redis_aggregate(conn_tuple_t *tuple, redis_transaction_t *tx) {
+    if (!redis_aggregation_enabled()) {
+        return false;
+    }
+
+    if (tx->request_started == 0 || tx->response_last_seen <= tx->request_started) {
+        return false;
+    }
+
+    redis_aggregate_key_t key;
+    bpf_memset(&key, 0, sizeof(redis_aggregate_key_t));
+    bpf_memcpy(&key.tuple, tuple, sizeof(conn_tuple_t));
+    if (redis_aggregate_by_server()) {
+        key.tuple.sport = 0;
+    }
+    key.command = tx->command;
+    key.is_error = tx->is_error;
+
+    redis_latency_sketch_t *sketch = bpf_map_lookup_elem(&redis_latency_aggregates, &key);
+    if (sketch == NULL) {
+        const __u32 zero = 0;
+        redis_latency_sketch_t *empty = bpf_map_lookup_elem(&redis_empty_latency_sketch, &zero);
+        if (empty == NULL) {
+            return false;
+        }
+        // another CPU may have created the aggregate meanwhile, only a full map is an error
+        bpf_map_update_with_telemetry(redis_latency_aggregates, &key, empty, BPF_NOEXIST, -EEXIST);
+        sketch = bpf_map_lookup_elem(&redis_latency_aggregates, &key);
+        if (sketch == NULL) {
+            return false;
+        }
+    }
+
+    // the map is per-CPU, so there is no need for atomic operations
+    __u64 sampling_rate = redis_key_sampling_rate();
+    __u32 count = sketch->count++;
+    if (sampling_rate > 0 && count % sampling_rate == 0) {
+        return false;
+    }
+
+    __u32 bucket = usm_latency_bucket(tx->response_last_seen - tx->request_started);
+    /* bounds check to make eBPF verifier happy */
+    barrier_var(bucket);
+    if (bucket >= USM_LATENCY_BUCKETS) {
+        return false;
+    }
+    sketch->buckets[bucket]++;
+    sketch->tags |= tx->tags;
+    return true;
+}
+
 // Enqueues a batch of events to the user-space. To spare stack size, we take a scratch buffer from the map, copy
 // the connection tuple and the transaction to it, and then enqueue the event.
 static __always_inline void redis_batch_enqueue_wrapper(conn_tuple_t *tuple, redis_transaction_t *tx) {
+    if (redis_aggregate(tuple, tx)) {
+        return;
+    }
+
     u32 zero = 0;
     redis_event_t *event = bpf_map_lookup_elem(&redis_scratch_buffer, &zero);
     if (!event) {
@@ -204,32 +452,59 @@ static __always_inline void redis_batch_enqueue_wrapper(conn_tuple_t *tuple, red
     redis_batch_enqueue(event);
 }
 
-// Processes Redis response messages and validates their format.
-// Handles error responses and command-specific response types.
-static void __always_inline process_redis_response(pktbuf_t pkt, conn_tuple_t *tup, redis_transaction_t *transaction) {
-    char first_byte;
-    if (pktbuf_load_bytes_from_current_offset(pkt, &first_byte, sizeof(first_byte)) < 0) {
-        return;
-    }
-    if (first_byte == RESP_ERROR_PREFIX) {
-        transaction->is_error = true;
-        goto enqueue;
-    }
-    if (transaction->command == REDIS_GET && first_byte == RESP_BULK_PREFIX) {
-        goto enqueue;
-    } else if (transaction->command == REDIS_SET && first_byte == RESP_SIMPLE_STRING_PREFIX){
-        goto enqueue;
-    } else {
-        goto cleanup;
+// Processes Redis replies, matching them to the transactions of the pipeline in order. A reply which does not match
+// the command of its transaction, or whose end could not be found while transactions are left, drops the pipeline,
+// since the following replies could not be matched anymore.
+static void __always_inline process_redis_response(pktbuf_t pkt, conn_tuple_t *tup, redis_pipeline_t *pipeline) {
+    #pragma unroll (REDIS_MAX_PIPELINED_COMMANDS)
+    for (int i = 0; i < REDIS_MAX_PIPELINED_COMMANDS; i++) {
+        if (pipeline->count == 0) {
+            break;
+        }
+
+        char first_byte;
+        if (pktbuf_load_bytes_from_current_offset(pkt, &first_byte, sizeof(first_byte)) < 0) {
+            return;
+        }
+
+        redis_transaction_t *transaction = &pipeline->transactions[pipeline->head & (REDIS_MAX_PIPELINED_COMMANDS - 1)];
+        if (first_byte == RESP_ERROR_PREFIX) {
+            transaction->is_error = true;
+        } else {
+            char expected_prefix = redis_expected_response_prefix(transaction->command);
+            if (expected_prefix != RESP_ANY_PREFIX && first_byte != expected_prefix) {
+                goto cleanup;
+            }
+        }
+
+        transaction->response_last_seen = bpf_ktime_get_ns();
+        redis_batch_enqueue_wrapper(tup, transaction);
+        pipeline->head = (pipeline->head + 1) & (REDIS_MAX_PIPELINED_COMMANDS - 1);
+        pipeline->count--;
+
+        if (pipeline->count > 0 && !skip_resp_reply(pkt)) {
+            goto cleanup;
+        }
     }
 
-enqueue:
-    transaction->response_last_seen = bpf_ktime_get_ns();
-    redis_batch_enqueue_wrapper(tup, transaction);
+    if (pipeline->count > 0) {
+        return;
+    }
 cleanup:
     bpf_map_delete_elem(&redis_in_flight, tup);
 }
 
+// Processes a Redis packet: requests start with a command we recognize, anything else is a reply to the in-flight
+// transactions of the connection, if any.
+static __always_inline void process_redis(pktbuf_t pkt, conn_tuple_t *tup) {
+    redis_pipeline_t *pipeline = bpf_map_lookup_elem(&redis_in_flight, tup);
+    if (redis_starts_with_command(pkt)) {
+        process_redis_request(pkt, tup, pipeline);
+    } else if (pipeline != NULL) {
+        process_redis_response(pkt, tup, pipeline);
+    }
+}
+
 // Main socket processing function for Redis traffic.
 // Handles both requests and responses based on connection state.
 SEC("socket/redis_process")
@@ -246,13 +521,7 @@ int socket__redis_process(struct __sk_buff *skb) {
     }
     normalize_tuple(&conn_tuple);
     pktbuf_t pkt = pktbuf_from_skb(skb, &skb_info);
-
-    redis_transaction_t *transaction = bpf_map_lookup_elem(&redis_in_flight, &conn_tuple);
-    if (transaction == NULL) {
-        process_redis_request(pkt, &conn_tuple);
-    } else {
-        process_redis_response(pkt, &conn_tuple, transaction);
-    }
+    process_redis(pkt, &conn_tuple);
 
     return 0;
 }
@@ -273,12 +542,7 @@ int uprobe__redis_tls_process(struct pt_regs *ctx) {
     normalize_tuple(&tup);
 
     pktbuf_t pkt = pktbuf_from_tls(ctx, args);
-    redis_transaction_t *transaction = bpf_map_lookup_elem(&redis_in_flight, &tup);
-    if (transaction == NULL) {
-        process_redis_request(pkt, &tup);
-    } else {
-        process_redis_response(pkt, &tup, transaction);
-    }
+    process_redis(pkt, &tup);
     return 0;
 }
 
@@ -3,20 +3,22 @@
 
 #define REDIS_MIN_FRAME_LENGTH 3
 
-#define REDIS_CMD_GET "GET"
-#define REDIS_CMD_SET "SET"
 #define RESP_ARRAY_PREFIX '*'
 #define RESP_BULK_PREFIX '$'
 #define RESP_SIMPLE_STRING_PREFIX '+'
 #define RESP_ERROR_PREFIX '-'
+#define RESP_INTEGER_PREFIX ':'
+#define RESP_ANY_PREFIX 0 // Accepts any response
 #define RESP_FIELD_TERMINATOR_LEN 2 // CRLF terminator: \r\n
-#define METHOD_LEN 3 // We only support GET and SET for now, both with length 3.
-#define MAX_DIGITS_KEY_LEN_PREFIX 3 // Since we clamp key length to 128, when reading key length prefix, we only need to read up to 3 digits.
+#define MAX_METHOD_LEN 8 // Size of the buffer holding the command name, the longest we recognize has 7 characters.
 #define MAX_KEY_LEN 128
-#define MIN_PARAM_COUNT 2 // GET command has 2 parameters
-#define MAX_PARAM_COUNT 5 // SET command has 3-5 parameters
-#define MAX_READABLE_KEY_LEN 999 // Since we read up to 3 digits of key length, the maximum readable length is 999.
+#define MAX_PARAM_COUNT 9 // Commands with more parameters end the tracking of their pipeline, as they are not skipped
+#define MAX_READABLE_KEY_LEN 999 // Longer keys end the tracking of their pipeline
 #define READ_KEY_CHUNK_SIZE 16 // Read keys in chunks of length 16
+#define RESP_MAX_HEADER_LEN 24 // Size of the buffer holding the header line of a RESP value, e.g. $<length>\r\n
+#define RESP_READ_HEADER_CHUNK_SIZE 8 // Read header lines in chunks of length 8
+#define RESP_MAX_SKIPPED_ARRAY_LEN 4 // Array replies with more elements end the tracking of their pipeline
+#define REDIS_MAX_PIPELINED_COMMANDS 4 // Must be a power of 2, the transactions of a pipeline are held in a ring
 #define RESP_TERMINATOR_1 '\r'
 #define RESP_TERMINATOR_2 '\n'
 #endif
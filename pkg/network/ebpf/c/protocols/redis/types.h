@@ -3,6 +3,7 @@
 
 #include "conn_tuple.h"
 #include "protocols/events-types.h"
+#include "protocols/helpers/latency-defs.h"
 #include "protocols/redis/defs.h"
 
 #define bool _Bool
@@ -13,6 +14,22 @@ typedef enum {
     REDIS_UNKNOWN = 0,
     REDIS_GET = 1,
     REDIS_SET = 2,
+    REDIS_HGET = 3,
+    REDIS_HSET = 4,
+    REDIS_HGETALL = 5,
+    REDIS_MGET = 6,
+    REDIS_MSET = 7,
+    REDIS_DEL = 8,
+    REDIS_EXISTS = 9,
+    REDIS_INCR = 10,
+    REDIS_EXPIRE = 11,
+    REDIS_LPUSH = 12,
+    REDIS_RPUSH = 13,
+    REDIS_LPOP = 14,
+    REDIS_RPOP = 15,
+    REDIS_SADD = 16,
+    REDIS_ZADD = 17,
+    REDIS_EVALSHA = 18,
 
     // This is the last command in the enum, used to determine the size of the enum.
     __MAX_REDIS_COMMAND
@@ -30,12 +47,39 @@ typedef struct {
     bool is_error;
 } redis_transaction_t;
 
+// The transactions of a connection awaiting a reply, in the order the commands were sent. Redis replies to the
+// commands of a pipeline in order, so replies are matched to the oldest transaction.
+typedef struct {
+    redis_transaction_t transactions[REDIS_MAX_PIPELINED_COMMANDS];
+    // Index of the oldest transaction
+    __u8 head;
+    // Number of transactions awaiting a reply
+    __u8 count;
+    __u8 pad[6];
+} redis_pipeline_t;
+
 // The struct we send to userspace, containing the connection tuple and the transaction information.
 typedef struct {
     conn_tuple_t tuple;
     redis_transaction_t tx;
 } redis_event_t;
 
+typedef struct {
+    // The normalized tuple of the connection, whose client port is zeroed when connections are rolled up
+    conn_tuple_t tuple;
+    redis_command_t command;
+    bool is_error;
+    __u8 pad[6];
+} redis_aggregate_key_t;
+
+typedef struct {
+    // Number of transactions seen, including the ones sent to userspace to sample their key
+    __u32 count;
+    __u8 tags;
+    __u8 pad[3];
+    __u32 buckets[USM_LATENCY_BUCKETS];
+} redis_latency_sketch_t;
+
 // Controls the number of Redis transactions read from userspace at a time.
 #define REDIS_BATCH_SIZE (BATCH_BUFFER_SIZE / sizeof(redis_event_t))
 
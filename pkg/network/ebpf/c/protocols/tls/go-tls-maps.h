@@ -9,6 +9,10 @@
 // offsets_data map contains the information about the locations of structs in the inspected binary, mapped by the binary's inode number.
 BPF_HASH_MAP(offsets_data, go_tls_offsets_data_key_t, tls_offsets_data_t, 1024)
 
+/* go_tls_process_offsets caches the offsets_data entry of the binary of running processes,
+   so the uprobes don't have to walk down to the inode of the binary on every call. */
+BPF_LRU_MAP(go_tls_process_offsets, go_tls_process_key_t, tls_offsets_data_t, 1024)
+
 /* go_tls_read_args is used to get the read function info when running in the read-return uprobe.
    The key contains the go routine id and the pid. */
 BPF_HASH_MAP(go_tls_read_args, go_tls_function_args_key_t, go_tls_read_args_data_t, 2048)
@@ -45,6 +45,14 @@ typedef struct {
     __u64 ino;
 } go_tls_offsets_data_key_t;
 
+// Identifies a running process by its tgid and memory descriptor, which is replaced
+// on exec, so the key of a process changes with its binary.
+typedef struct {
+    __u64 mm;
+    __u32 tgid;
+    __u32 _pad;
+} go_tls_process_key_t;
+
 typedef struct {
     goroutine_id_metadata_t goroutine_id;
     tls_conn_layout_t conn_layout;
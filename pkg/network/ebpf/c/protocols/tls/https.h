@@ -335,11 +335,25 @@ static __always_inline void map_ssl_ctx_to_sock(struct sock *skp) {
  */
 static __always_inline tls_offsets_data_t* get_offsets_data() {
     struct task_struct *t = (struct task_struct *) bpf_get_current_task();
+    struct mm_struct *mm = BPF_CORE_READ(t, mm);
+    if (!mm) {
+        log_debug("get_offsets_data: could not read mm field");
+        return NULL;
+    }
+
+    go_tls_process_key_t process_key = {};
+    process_key.mm = (__u64)mm;
+    process_key.tgid = bpf_get_current_pid_tgid() >> 32;
+    tls_offsets_data_t *od = bpf_map_lookup_elem(&go_tls_process_offsets, &process_key);
+    if (od) {
+        return od;
+    }
+
     struct inode *inode;
     go_tls_offsets_data_key_t key;
     dev_t dev_id;
 
-    inode = BPF_CORE_READ(t, mm, exe_file, f_inode);
+    inode = BPF_CORE_READ(mm, exe_file, f_inode);
     if (!inode) {
         log_debug("get_offsets_data: could not read f_inode field");
         return NULL;
@@ -363,7 +377,11 @@ static __always_inline tls_offsets_data_t* get_offsets_data() {
 
     log_debug("get_offsets_data: task binary inode number: %llu; device ID %x:%x", key.ino, key.device_id_major, key.device_id_minor);
 
-    return bpf_map_lookup_elem(&offsets_data, &key);
+    od = bpf_map_lookup_elem(&offsets_data, &key);
+    if (od) {
+        bpf_map_update_elem(&go_tls_process_offsets, &process_key, od, BPF_NOEXIST);
+    }
+    return od;
 }
 
 #endif
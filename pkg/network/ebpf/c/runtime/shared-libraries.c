@@ -6,6 +6,8 @@
 #ifdef COMPILE_RUNTIME
 #include "kconfig.h"
 #include <linux/ptrace.h>
+#include <linux/fdtable.h>
+#include <linux/fs.h>
 #endif
 
 #include "shared-libraries/types.h"
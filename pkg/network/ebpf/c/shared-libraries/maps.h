@@ -8,6 +8,18 @@
 // Thus we need to have a map that can store 1024*3 entries. I'm using a larger map to be safe.
 BPF_HASH_MAP(open_at_args, __u64, lib_path_t, 10240)
 
+// The table of library names to report, filled by userspace for the enabled libsets
+BPF_ARRAY_MAP(shared_libraries_names, lib_names_t, 1)
+
+// The libraries already reported, so processes opening the same library over and
+// over don't flood userspace with events. Userspace removes the libraries no process
+// uses anymore.
+BPF_LRU_MAP(shared_libraries_reported, lib_reported_key_t, __u8, 8192)
+
+// The processes that opened a library of shared_libraries_reported after it was
+// reported, drained by userspace to attach them to the library
+BPF_LRU_MAP(shared_libraries_openers, lib_opener_key_t, __u8, 8192)
+
 /*
  * These maps are used for notifying userspace of a shared library being loaded
  * There is one for each library set, so that userspace isn't overwhelmed with
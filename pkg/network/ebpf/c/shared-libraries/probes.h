@@ -7,6 +7,10 @@
 #include "pid_tgid.h"
 #include "shared-libraries/types.h"
 
+#if defined(COMPILE_CORE) || defined(COMPILE_RUNTIME)
+#include "bpf_core_read.h"
+#endif
+
 static __always_inline void fill_path_safe(lib_path_t *path, const char *path_argument) {
 #pragma unroll
     for (int i = 0; i < LIB_PATH_MAX_SIZE; i++) {
@@ -45,16 +49,61 @@ static __always_inline void do_sys_open_helper_enter(const char *filename) {
     return;
 }
 
+// FNV-1a parameters, see libPathHash in pkg/network/usm/sharedlibraries
+#define LIB_PATH_HASH_OFFSET 14695981039346656037ULL
+#define LIB_PATH_HASH_PRIME 1099511628211ULL
+
+static __always_inline __u64 lib_path_hash(lib_path_t *path) {
+    __u64 hash = LIB_PATH_HASH_OFFSET;
+#pragma unroll
+    for (int i = 0; i < LIB_PATH_MAX_SIZE; i++) {
+        if (i == path->len) {
+            break;
+        }
+        hash ^= (__u8)path->buf[i];
+        hash *= LIB_PATH_HASH_PRIME;
+    }
+    return hash;
+}
+
+// lib_file_id reads the device and inode of the file the current task opened as fd.
+// It returns false when they can't be read, which is always the case in the prebuilt
+// program as it can't walk the fd table without CO-RE.
+static __always_inline bool lib_file_id(long fd, lib_reported_key_t *key) {
+#if defined(COMPILE_CORE) || defined(COMPILE_RUNTIME)
+    struct task_struct *task = (struct task_struct *)bpf_get_current_task();
+    struct fdtable *fdt = BPF_CORE_READ(task, files, fdt);
+    if (!fdt || fd >= BPF_CORE_READ(fdt, max_fds)) {
+        return false;
+    }
+    struct file **fds = BPF_CORE_READ(fdt, fd);
+    struct file *file = NULL;
+    if (!fds || bpf_probe_read_kernel(&file, sizeof(file), &fds[fd]) < 0 || !file) {
+        return false;
+    }
+    struct inode *inode = BPF_CORE_READ(file, f_inode);
+    if (!inode) {
+        return false;
+    }
+    key->ino = BPF_CORE_READ(inode, i_ino);
+    key->dev = BPF_CORE_READ(inode, i_sb, s_dev);
+    return key->ino != 0;
+#else
+    return false;
+#endif
+}
+
 static __always_inline void push_event_if_relevant(void *ctx, lib_path_t *path, long return_code) {
     if (return_code < 0) {
         return;
     }
 
-    // Check the last 9 characters of the following libraries to ensure the file is a relevant `.so`.
-    // Libraries:
+    // Check the characters preceding ".so" against the names of shared_libraries_names,
+    // which hold the last LIB_NAME_SIZE characters of the relevant libraries:
     //    libssl.so -> libssl.so
     // libcrypto.so -> crypto.so
     // libgnutls.so -> gnutls.so
+    // libcudart.so -> cudart.so
     //
     // The matching is done in 2 stages here, first we look if the filename finished by ".so" 6 chars forward
     // this will give us the index (where the loop) for the 2nd stage
@@ -66,7 +115,7 @@ static __always_inline void push_event_if_relevant(void *ctx, lib_path_t *path,
     int i = 0;
 #pragma unroll
     for (i = 0; i < LIB_PATH_MAX_SIZE - (LIB_SO_SUFFIX_SIZE); i++) {
-        if (match3chars(6, '.', 's', 'o')) {
+        if (match3chars(LIB_NAME_SIZE, '.', 's', 'o')) {
             is_shared_library = true;
             break;
         }
@@ -77,18 +126,49 @@ static __always_inline void push_event_if_relevant(void *ctx, lib_path_t *path,
     if (i + LIB_SO_SUFFIX_SIZE > path->len) {
         return;
     }
-    u64 crypto_libset_enabled = 0;
-    LOAD_CONSTANT("crypto_libset_enabled", crypto_libset_enabled);
 
-    if (crypto_libset_enabled && (match6chars(0, 'l', 'i', 'b', 's', 's', 'l') || match6chars(0, 'c', 'r', 'y', 'p', 't', 'o') || match6chars(0, 'g', 'n', 'u', 't', 'l', 's'))) {
-        bpf_perf_event_output(ctx, &crypto_shared_libraries, BPF_F_CURRENT_CPU, path, sizeof(lib_path_t));
+    __u32 zero = 0;
+    lib_names_t *table = bpf_map_lookup_elem(&shared_libraries_names, &zero);
+    if (!table) {
         return;
     }
 
-    u64 gpu_libset_enabled = 0;
-    LOAD_CONSTANT("gpu_libset_enabled", gpu_libset_enabled);
+    __u8 libset = LIBSET_NONE;
+#pragma unroll
+    for (int n = 0; n < LIB_NAMES_MAX; n++) {
+        lib_name_t *lib = &table->names[n];
+        if (lib->libset == LIBSET_NONE) {
+            break;
+        }
+        if (match6chars(0, lib->name[0], lib->name[1], lib->name[2], lib->name[3], lib->name[4], lib->name[5])) {
+            libset = lib->libset;
+            break;
+        }
+    }
+    if (libset == LIBSET_NONE) {
+        return;
+    }
 
-    if (gpu_libset_enabled && (match6chars(0, 'c', 'u', 'd', 'a', 'r', 't'))) {
+    lib_reported_key_t *reported_key = &path->reported_key;
+    reported_key->libset = libset;
+    if (!lib_file_id(return_code, reported_key)) {
+        reported_key->dev = 0;
+        reported_key->ino = lib_path_hash(path);
+    }
+    __u8 reported = 1;
+    if (bpf_map_update_elem(&shared_libraries_reported, reported_key, &reported, BPF_NOEXIST) == -EEXIST) {
+        // the library was already reported, userspace attaches this process to it
+        // when draining shared_libraries_openers
+        lib_opener_key_t opener_key = {};
+        opener_key.lib = *reported_key;
+        opener_key.pid = path->pid;
+        bpf_map_update_elem(&shared_libraries_openers, &opener_key, &reported, BPF_NOEXIST);
+        return;
+    }
+
+    if (libset == LIBSET_CRYPTO) {
+        bpf_perf_event_output(ctx, &crypto_shared_libraries, BPF_F_CURRENT_CPU, path, sizeof(lib_path_t));
+    } else if (libset == LIBSET_GPU) {
         bpf_perf_event_output(ctx, &gpu_shared_libraries, BPF_F_CURRENT_CPU, path, sizeof(lib_path_t));
     }
 }
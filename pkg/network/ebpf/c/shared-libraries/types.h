@@ -6,12 +6,49 @@
 #define LIB_SO_SUFFIX_SIZE 9
 #define LIB_PATH_MAX_SIZE 220
 
+// Library names are matched against the LIB_NAME_SIZE characters preceding ".so"
+#define LIB_NAME_SIZE 6
+#define LIB_NAMES_MAX 8
+
+// Identifiers of the libsets, each one has its own perf buffer
+#define LIBSET_NONE 0
+#define LIBSET_CRYPTO 1
+#define LIBSET_GPU 2
+
+// Identifies a library reported to userspace: the device and inode of the opened
+// file. The prebuilt program can't walk the fd table, it sets the device to 0 and
+// the inode to the hash of the path instead.
+typedef struct {
+    __u64 ino;
+    __u32 dev;
+    __u32 libset;
+} lib_reported_key_t;
+
 typedef struct {
     __u32 pid;
     __u32 len;
     char buf[LIB_PATH_MAX_SIZE];
+    lib_reported_key_t reported_key;
 } lib_path_t;
 
+typedef struct {
+    char name[LIB_NAME_SIZE];
+    __u8 libset;
+    __u8 _pad;
+} lib_name_t;
+
+// The library names userspace is interested in, unused entries have LIBSET_NONE
+typedef struct {
+    lib_name_t names[LIB_NAMES_MAX];
+} lib_names_t;
+
+// The process that opened a library already reported by another process
+typedef struct {
+    lib_reported_key_t lib;
+    __u32 pid;
+    __u32 _pad;
+} lib_opener_key_t;
+
 typedef struct {
     unsigned short common_type;
     unsigned char common_flags;
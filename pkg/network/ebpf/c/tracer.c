@@ -17,6 +17,7 @@
 #include "tracer/events.h"
 #include "tracer/maps.h"
 #include "tracer/port.h"
+#include "tracer/port_iter.h"
 #include "tracer/tcp_recv.h"
 #include "protocols/classification/protocol-classification.h"
 #include "pid_tgid.h"
@@ -1137,4 +1138,18 @@ int tracepoint__net__net_dev_queue(struct net_dev_queue_ctx *ctx) {
     return 0;
 }
 
+#ifdef COMPILE_CORE
+
+SEC("iter/tcp")
+int iter__tcp_port_bindings(struct bpf_iter__tcp *ctx) {
+    return iter_tcp_port_binding(ctx->sk_common);
+}
+
+SEC("iter/udp")
+int iter__udp_port_bindings(struct bpf_iter__udp *ctx) {
+    return iter_udp_port_binding(ctx->udp_sk);
+}
+
+#endif // COMPILE_CORE
+
 char _license[] SEC("license") = "GPL";
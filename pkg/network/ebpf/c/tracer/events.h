@@ -42,6 +42,26 @@ static __always_inline bool is_batching_enabled() {
     return batching_enabled != 0;
 }
 
+static __always_inline bool is_ringbuffers_enabled() {
+    __u64 ringbuffers_enabled = 0;
+    LOAD_CONSTANT("ringbuffers_enabled", ringbuffers_enabled);
+    return ringbuffers_enabled > 0;
+}
+
+// conn_close_batch_size returns the number of closed connections batched before
+// they are flushed, set at load time and bounded by the capacity of the batch in use:
+// CONN_CLOSED_RINGBUF_BATCH_SIZE with ring buffers, CONN_CLOSED_BATCH_SIZE otherwise.
+// 0 uses the whole capacity.
+static __always_inline __u16 conn_close_batch_size() {
+    __u16 capacity = is_ringbuffers_enabled() ? CONN_CLOSED_RINGBUF_BATCH_SIZE : CONN_CLOSED_BATCH_SIZE;
+    __u64 batch_size = 0;
+    LOAD_CONSTANT("conn_close_batch_size", batch_size);
+    if (batch_size == 0 || batch_size > capacity) {
+        return capacity;
+    }
+    return batch_size;
+}
+
 __maybe_unused static __always_inline __u64 get_ringbuf_flags(size_t data_size) {
     if (is_batching_enabled()) {
         return 0;
@@ -58,15 +78,66 @@ __maybe_unused static __always_inline __u64 get_ringbuf_flags(size_t data_size)
 }
 
 __maybe_unused static __always_inline void submit_closed_conn_event(void *ctx, int cpu, void *event_data, size_t data_size) {
-    __u64 ringbuffers_enabled = 0;
-    LOAD_CONSTANT("ringbuffers_enabled", ringbuffers_enabled);
-    if (ringbuffers_enabled > 0) {
+    if (is_ringbuffers_enabled()) {
         bpf_ringbuf_output(&conn_close_event, event_data, data_size, get_ringbuf_flags(data_size));
     } else {
         bpf_perf_event_output(ctx, &conn_close_event, cpu, event_data, data_size);
     }
 }
 
+// batch_closed_conn adds the connection to the batch of the CPU. It returns false when the
+// batch is full, which means it wasn't flushed yet because of interleaved tcp_close calls.
+// Once the batch holds conn_close_batch_size connections, it is ready to be flushed, which
+// we defer to kretprobe/tcp_close in order to cope with the eBPF stack limitation of 512 bytes.
+static __always_inline bool batch_closed_conn(u32 cpu, conn_t *conn) {
+    if (is_ringbuffers_enabled()) {
+        ringbuf_batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_ringbuf_batch, &cpu);
+        if (batch_ptr == NULL) {
+            return false;
+        }
+
+        __u16 len = batch_ptr->len;
+        if (len >= conn_close_batch_size() || len >= CONN_CLOSED_RINGBUF_BATCH_SIZE) {
+            return false;
+        }
+        batch_ptr->c[len] = *conn;
+        batch_ptr->len++;
+        return true;
+    }
+
+    // Batch TCP closed connections before generating a perf event
+    batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_batch, &cpu);
+    if (batch_ptr == NULL) {
+        return false;
+    }
+
+    __u16 len = batch_ptr->len;
+    if (len >= conn_close_batch_size()) {
+        return false;
+    }
+
+    // TODO: Can we turn this into a macro based on TCP_CLOSED_BATCH_SIZE?
+    switch (len) {
+    case 0:
+        batch_ptr->c0 = *conn;
+        batch_ptr->len++;
+        return true;
+    case 1:
+        batch_ptr->c1 = *conn;
+        batch_ptr->len++;
+        return true;
+    case 2:
+        batch_ptr->c2 = *conn;
+        batch_ptr->len++;
+        return true;
+    case 3:
+        batch_ptr->c3 = *conn;
+        batch_ptr->len++;
+        return true;
+    }
+    return false;
+}
+
 static __always_inline int cleanup_conn(void *ctx, conn_tuple_t *tup, struct sock *sk) {
     u32 cpu = bpf_get_smp_processor_id();
     // Will hold the full connection data to send through the perf or ring buffer
@@ -122,34 +193,8 @@ static __always_inline int cleanup_conn(void *ctx, conn_tuple_t *tup, struct soc
     // if we added another field
     conn.conn_stats.duration = bpf_ktime_get_ns() - conn.conn_stats.duration;
 
-    if (is_batching_enabled()) {
-        // Batch TCP closed connections before generating a perf event
-        batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_batch, &cpu);
-        if (batch_ptr == NULL) {
-            return -1;
-        }
-
-        // TODO: Can we turn this into a macro based on TCP_CLOSED_BATCH_SIZE?
-        switch (batch_ptr->len) {
-        case 0:
-            batch_ptr->c0 = conn;
-            batch_ptr->len++;
-            return 0;
-        case 1:
-            batch_ptr->c1 = conn;
-            batch_ptr->len++;
-            return 0;
-        case 2:
-            batch_ptr->c2 = conn;
-            batch_ptr->len++;
-            return 0;
-        case 3:
-            batch_ptr->c3 = conn;
-            batch_ptr->len++;
-            // In this case the batch is ready to be flushed, which we defer to kretprobe/tcp_close
-            // in order to cope with the eBPF stack limitation of 512 bytes.
-            return 0;
-        }
+    if (is_batching_enabled() && batch_closed_conn(cpu, &conn)) {
+        return 0;
     }
 
     // If we hit this section it means we had one or more interleaved tcp_close calls.
@@ -170,8 +215,25 @@ static __always_inline int cleanup_conn(void *ctx, conn_tuple_t *tup, struct soc
 
 static __always_inline void flush_conn_close_if_full(void *ctx) {
     u32 cpu = bpf_get_smp_processor_id();
+    if (is_ringbuffers_enabled()) {
+        ringbuf_batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_ringbuf_batch, &cpu);
+        if (!batch_ptr || batch_ptr->len < conn_close_batch_size()) {
+            return;
+        }
+
+        // Reserving the event in the ring buffer saves copying the batch to the eBPF stack
+        ringbuf_batch_t *event = bpf_ringbuf_reserve(&conn_close_event, sizeof(ringbuf_batch_t), 0);
+        if (event != NULL) {
+            bpf_memcpy(event, batch_ptr, sizeof(ringbuf_batch_t));
+            bpf_ringbuf_submit(event, get_ringbuf_flags(sizeof(ringbuf_batch_t)));
+        }
+        batch_ptr->len = 0;
+        batch_ptr->id++;
+        return;
+    }
+
     batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_batch, &cpu);
-    if (!batch_ptr || batch_ptr->len != CONN_CLOSED_BATCH_SIZE) {
+    if (!batch_ptr || batch_ptr->len < conn_close_batch_size()) {
         return;
     }
 
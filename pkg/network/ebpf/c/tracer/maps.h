@@ -38,6 +38,9 @@ BPF_PERF_EVENT_ARRAY_MAP(conn_close_event, __u32)
  */
 BPF_HASH_MAP(conn_close_batch, __u32, batch_t, 1)
 
+/* Same as conn_close_batch, used instead of it when closed connections are sent through a ring buffer */
+BPF_HASH_MAP(conn_close_ringbuf_batch, __u32, ringbuf_batch_t, 1)
+
 /*
  * Map to hold struct sock parameter for tcp_sendmsg calls
  * to be used in kretprobe/tcp_sendmsg
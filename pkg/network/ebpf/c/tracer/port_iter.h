@@ -0,0 +1,68 @@
+#ifndef __TRACER_PORT_ITER_H
+#define __TRACER_PORT_ITER_H
+
+// Socket iterators require BTF, they are only part of the CO-RE tracers
+#ifdef COMPILE_CORE
+
+#include "ktypes.h"
+#include "bpf_core_read.h"
+
+#include "ipv6.h"
+#include "port_range.h"
+#include "sock.h"
+#include "tracer/maps.h"
+#include "tracer/port.h"
+
+// The socket iterators below walk every TCP and UDP socket once, before the tracer
+// probes are attached, to seed the port binding maps with the ports that were
+// already bound when the tracer started.
+
+// iter_tcp_port_binding counts the given socket in port_bindings if it is listening
+static __always_inline int iter_tcp_port_binding(struct sock_common *skc) {
+    if (!skc || BPF_CORE_READ(skc, skc_state) != TCP_LISTEN) {
+        return 0;
+    }
+
+    struct sock *skp = (struct sock *)skc;
+    if (_sk_family(skp) == AF_INET6 && !is_tcpv6_enabled()) {
+        return 0;
+    }
+
+    port_binding_t pb = {};
+    pb.port = read_sport(skp);
+    if (pb.port == 0) {
+        return 0;
+    }
+    pb.netns = get_netns_from_sock(skp);
+    add_port_bind(&pb, port_bindings);
+    log_debug("iter/tcp: netns=%u listening on port %u", pb.netns, pb.port);
+    return 0;
+}
+
+// iter_udp_port_binding counts the given socket in udp_port_bindings if it is bound
+// and not connected
+static __always_inline int iter_udp_port_binding(struct udp_sock *udp_sk) {
+    struct sock *skp = (struct sock *)udp_sk;
+    if (!skp || BPF_CORE_READ(skp, __sk_common.skc_state) != TCP_CLOSE) {
+        return 0;
+    }
+
+    if (_sk_family(skp) == AF_INET6 && !is_udpv6_enabled()) {
+        return 0;
+    }
+
+    port_binding_t pb = {};
+    pb.port = read_sport(skp);
+    // ignore ephemeral ports as they are more likely to be bound by clients
+    if (pb.port == 0 || is_ephemeral_port(pb.port)) {
+        return 0;
+    }
+    pb.netns = get_netns_from_sock(skp);
+    add_port_bind(&pb, udp_port_bindings);
+    log_debug("iter/udp: netns=%u bound to port %u", pb.netns, pb.port);
+    return 0;
+}
+
+#endif // COMPILE_CORE
+
+#endif // __TRACER_PORT_ITER_H
@@ -111,6 +111,22 @@ typedef struct {
     __u16 len;
 } batch_t;
 
+// Must match the number of conn_t objects embedded in the ringbuf_batch_t struct
+#ifndef CONN_CLOSED_RINGBUF_BATCH_SIZE
+#define CONN_CLOSED_RINGBUF_BATCH_SIZE 16
+#endif
+
+// The container for batching writes to the ring buffer. Batches are reserved in the
+// ring buffer instead of being copied to the eBPF stack, so they can hold more connections
+// than batch_t. Ring buffers are only available on kernels whose verifier allows bounded
+// index access, hence the array.
+typedef struct {
+    conn_t c[CONN_CLOSED_RINGBUF_BATCH_SIZE];
+    __u64 id;
+    __u32 cpu;
+    __u16 len;
+} ringbuf_batch_t;
+
 // Telemetry names
 typedef struct {
     __u64 tcp_sent_miscounts;
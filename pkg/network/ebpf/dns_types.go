@@ -0,0 +1,23 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build ignore
+
+package ebpf
+
+/*
+#include "./c/dns/types.h"
+*/
+import "C"
+
+type DNSKey C.dns_key_t
+type DNSQueryKey C.dns_query_key_t
+type DNSQuery C.dns_query_t
+type DNSStatsKey C.dns_stats_key_t
+type DNSStats C.dns_stats_t
+type DNSTelemetry C.dns_telemetry_t
+type DNSDomain C.dns_domain_t
+
+const DNSMaxDomainLen = C.DNS_MAX_DOMAIN_LEN
@@ -0,0 +1,45 @@
+// Code generated by cmd/cgo -godefs; DO NOT EDIT.
+// cgo -godefs -- -I c -I ../../ebpf/c -fsigned-char dns_types.go
+
+package ebpf
+
+type DNSKey struct {
+	Client_h    uint64
+	Client_l    uint64
+	Server_h    uint64
+	Server_l    uint64
+	Client_port uint16
+	X_pad       uint16
+	Metadata    uint32
+}
+type DNSQueryKey struct {
+	Key   DNSKey
+	Id    uint16
+	X_pad [3]uint16
+}
+type DNSQuery struct {
+	Timestamp   uint64
+	Domain_hash uint64
+	Qtype       uint16
+	X_pad       [3]uint16
+}
+type DNSStatsKey struct {
+	Key         DNSKey
+	Domain_hash uint64
+	Qtype       uint16
+	Rcode       uint8
+	X_pad       [5]uint8
+}
+type DNSStats struct {
+	Latency_sum uint64
+	Count       uint32
+	Timeouts    uint32
+}
+type DNSTelemetry struct {
+	Stats_insert_failed uint64
+}
+type DNSDomain struct {
+	Name [128]int8
+}
+
+const DNSMaxDomainLen = 0x80
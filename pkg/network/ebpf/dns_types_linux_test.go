@@ -0,0 +1,37 @@
+// Code generated by genpost.go; DO NOT EDIT.
+
+package ebpf
+
+import (
+	"testing"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/ebpftest"
+)
+
+func TestCgoAlignment_DNSKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSKey](t)
+}
+
+func TestCgoAlignment_DNSQueryKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSQueryKey](t)
+}
+
+func TestCgoAlignment_DNSQuery(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSQuery](t)
+}
+
+func TestCgoAlignment_DNSStatsKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSStatsKey](t)
+}
+
+func TestCgoAlignment_DNSStats(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSStats](t)
+}
+
+func TestCgoAlignment_DNSTelemetry(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSTelemetry](t)
+}
+
+func TestCgoAlignment_DNSDomain(t *testing.T) {
+	ebpftest.TestCgoAlignment[DNSDomain](t)
+}
@@ -102,3 +102,8 @@ func (cs ConnStats) IsAssured() bool {
 func ToBatch(data []byte) *Batch {
 	return (*Batch)(unsafe.Pointer(&data[0]))
 }
+
+// ToRingBufferBatch converts a byte slice to a RingBufferBatch pointer.
+func ToRingBufferBatch(data []byte) *RingBufferBatch {
+	return (*RingBufferBatch)(unsafe.Pointer(&data[0]))
+}
@@ -23,6 +23,7 @@ type Conn C.conn_t
 type SkpConn C.skp_conn_tuple_t
 type PidTs C.pid_ts_t
 type Batch C.batch_t
+type RingBufferBatch C.ringbuf_batch_t
 type Telemetry C.telemetry_t
 type PortBinding C.port_binding_t
 type PIDFD C.pid_fd_t
@@ -55,6 +56,8 @@ const (
 
 const BatchSize = C.CONN_CLOSED_BATCH_SIZE
 const SizeofBatch = C.sizeof_batch_t
+const RingBufferBatchSize = C.CONN_CLOSED_RINGBUF_BATCH_SIZE
+const SizeofRingBufferBatch = C.sizeof_ringbuf_batch_t
 
 const TCPFailureConnReset = C.TCP_CONN_FAILED_RESET
 const TCPFailureConnTimeout = C.TCP_CONN_FAILED_TIMEOUT
@@ -57,6 +57,13 @@ type Batch struct {
 	Len       uint16
 	Pad_cgo_0 [2]byte
 }
+type RingBufferBatch struct {
+	C         [16]Conn
+	Id        uint64
+	Cpu       uint32
+	Len       uint16
+	Pad_cgo_0 [2]byte
+}
 type Telemetry struct {
 	Tcp_sent_miscounts              uint64
 	Unbatched_tcp_close             uint64
@@ -134,6 +141,8 @@ const (
 
 const BatchSize = 0x4
 const SizeofBatch = 0x1f0
+const RingBufferBatchSize = 0x10
+const SizeofRingBufferBatch = 0x790
 
 const TCPFailureConnReset = 0x68
 const TCPFailureConnTimeout = 0x6e
@@ -36,6 +36,10 @@ func TestCgoAlignment_Batch(t *testing.T) {
 	ebpftest.TestCgoAlignment[Batch](t)
 }
 
+func TestCgoAlignment_RingBufferBatch(t *testing.T) {
+	ebpftest.TestCgoAlignment[RingBufferBatch](t)
+}
+
 func TestCgoAlignment_Telemetry(t *testing.T) {
 	ebpftest.TestCgoAlignment[Telemetry](t)
 }
@@ -175,6 +175,11 @@ const (
 	// Inet6BindRet is the kretprobe of the bind() syscall for IPv6
 	Inet6BindRet ProbeFuncName = "kretprobe__inet6_bind"
 
+	// TCPPortBindingsIter is the iterator seeding the TCP port bindings with the sockets listening at startup
+	TCPPortBindingsIter ProbeFuncName = "iter__tcp_port_bindings"
+	// UDPPortBindingsIter is the iterator seeding the UDP port bindings with the sockets bound at startup
+	UDPPortBindingsIter ProbeFuncName = "iter__udp_port_bindings"
+
 	// SocketDNSFilter is the socket probe for dns
 	SocketDNSFilter ProbeFuncName = "socket__dns_filter"
 
@@ -198,6 +203,9 @@ const (
 	TCPRetransmitsMap BPFMapName = "tcp_retransmits"
 	// TCPOngoingConnectPid is the map storing ongoing TCP connection PIDs by (socket + tuple)
 	TCPOngoingConnectPid BPFMapName = "tcp_ongoing_connect_pid"
+	// TCPOngoingConnectPidSKStorage is the socket-local storage holding ongoing TCP connection PIDs,
+	// used in place of TCPOngoingConnectPid by the fentry tracer when available
+	TCPOngoingConnectPidSKStorage BPFMapName = "tcp_ongoing_connect_pid_sk"
 	// ConnCloseEventMap is the map storing connection close events
 	ConnCloseEventMap BPFMapName = "conn_close_event"
 	// TracerStatusMap is the map storing the status of the tracer
@@ -214,6 +222,8 @@ const (
 	TCPFailureTelemetry BPFMapName = "tcp_failure_telemetry"
 	// ConnCloseBatchMap is the map storing connection close batch events
 	ConnCloseBatchMap BPFMapName = "conn_close_batch"
+	// ConnCloseRingBufferBatchMap is the map storing connection close batch events sent through a ring buffer
+	ConnCloseRingBufferBatchMap BPFMapName = "conn_close_ringbuf_batch"
 	// ConntrackMap is the map storing conntrack entries
 	ConntrackMap BPFMapName = "conntrack"
 	// ConntrackTelemetryMap is the map storing conntrack telemetry
@@ -230,6 +240,8 @@ const (
 	TCPRecvMsgArgsMap BPFMapName = "tcp_recvmsg_args"
 	// ProtocolClassificationBufMap is the map storing the classification buffer
 	ProtocolClassificationBufMap BPFMapName = "classification_buf"
+	// ProtocolHintsMap is the map storing the classification program to try first for a server
+	ProtocolHintsMap BPFMapName = "protocol_hints"
 	// KafkaClientIDBufMap is the map storing the kafka client ID
 	KafkaClientIDBufMap BPFMapName = "kafka_client_id"
 	// KafkaTopicNameBufMap is the map storing the kafka topic name
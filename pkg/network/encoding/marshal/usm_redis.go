@@ -68,6 +68,7 @@ func (e *redisEncoder) encodeData(connectionData *USMConnectionData[redis.Key, *
 				case redis.SetCommand:
 					aggregationBuilder.SetCommand(uint64(model.RedisCommand_RedisSetCommand))
 				default:
+					// the payload only names GET and SET, the latency of the other commands is reported as unknown
 					aggregationBuilder.SetCommand(uint64(model.RedisCommand_RedisUnknownCommand))
 				}
 				aggregationBuilder.SetTruncated(key.Truncated)
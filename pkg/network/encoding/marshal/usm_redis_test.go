@@ -112,6 +112,50 @@ func (s *RedisSuite) TestFormatRedisStats() {
 	assert.ElementsMatch(t, out.Aggregations, aggregations.Aggregations)
 }
 
+func (s *RedisSuite) TestFormatRedisStatsUnnamedCommand() {
+	t := s.T()
+
+	hgetKey := redis.NewKey(
+		localhost,
+		localhost,
+		redisClientPort,
+		redisServerPort,
+		redis.HgetCommand,
+		"dummyKey",
+		false,
+	)
+
+	in := &network.Connections{
+		BufferedData: network.BufferedData{
+			Conns: []network.ConnectionStats{
+				redisDefaultConnection,
+			},
+		},
+		USMData: network.USMProtocolsData{
+			Redis: map[redis.Key]*redis.RequestStats{
+				hgetKey: {ErrorToStats: map[bool]*redis.RequestStat{
+					false: {
+						FirstLatencySample: 1,
+						Count:              3,
+					},
+				}},
+			},
+		},
+	}
+
+	encoder := newRedisEncoder(in.USMData.Redis)
+	t.Cleanup(encoder.Close)
+
+	aggregations := getRedisAggregations(t, encoder, in.Conns[0])
+
+	require.NotNil(t, aggregations)
+	require.Len(t, aggregations.Aggregations, 1)
+	stats := aggregations.Aggregations[0].GetRedis()
+	require.NotNil(t, stats)
+	assert.Equal(t, model.RedisCommand_RedisUnknownCommand, stats.Command)
+	assert.Equal(t, uint32(3), stats.ErrorToStats[0].Count)
+}
+
 func (s *RedisSuite) TestRedisIDCollisionRegression() {
 	t := s.T()
 	assert := assert.New(t)
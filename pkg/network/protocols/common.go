@@ -26,6 +26,15 @@ func NSTimestampToFloat(ns uint64) float64 {
 	return math.Float64frombits(b)
 }
 
+// LatencyBucketValue returns the latency, in nanoseconds, representing the given bucket of
+// the log-bucketed histograms built in eBPF by `usm_latency_bucket`: the middle of the bucket.
+func LatencyBucketValue(bucket, minExponent, subBucketBits int) float64 {
+	subBuckets := 1 << subBucketBits
+	exponent := minExponent + bucket/subBuckets
+	subBucket := bucket % subBuckets
+	return math.Ldexp(1+(float64(subBucket)+0.5)/float64(subBuckets), exponent)
+}
+
 // GetSketchQuantile returns the value at the given percentile in the sketch
 func GetSketchQuantile(sketch *ddsketch.DDSketch, percentile float64) float64 {
 	if sketch == nil {
@@ -46,10 +46,14 @@ func Configure(cfg *config.Config, proto string, m *manager.Manager, o *manager.
 	useRingBuffer := cfg.EnableUSMRingBuffers && features.HaveMapType(ebpf.RingBuf) == nil
 	utils.AddBoolConst(o, useRingBuffer, "use_ring_buffer")
 
+	// direct events rely on bpf_ringbuf_reserve, so they are only available with ring buffers
+	directEvents := useRingBuffer && cfg.EnableUSMDirectEvents
+	utils.AddBoolConst(o, directEvents, "use_direct_events")
+
 	bufferSize := cfg.USMKernelBufferPages * os.Getpagesize()
 
 	if useRingBuffer {
-		setupPerfRing(proto, m, o, numCPUs, cfg.USMDataChannelSize, bufferSize)
+		setupPerfRing(proto, m, o, numCPUs, cfg.USMDataChannelSize, bufferSize, directEvents)
 	} else {
 		setupPerfMap(proto, m, cfg.USMDataChannelSize, bufferSize)
 	}
@@ -79,10 +83,10 @@ func setupPerfMap(proto string, m *manager.Manager, dataChannelSize, perfEventBu
 
 	m.PerfMaps = append(m.PerfMaps, pm)
 	removeRingBufferHelperCalls(m)
-	setHandler(proto, handler)
+	setHandler(proto, handler, false)
 }
 
-func setupPerfRing(proto string, m *manager.Manager, o *manager.Options, numCPUs int, dataChannelSize, ringBufferSize int) {
+func setupPerfRing(proto string, m *manager.Manager, o *manager.Options, numCPUs int, dataChannelSize, ringBufferSize int, directEvents bool) {
 	handler := ddebpf.NewRingBufferHandler(dataChannelSize)
 	mapName := eventMapName(proto)
 	// Adjusting ring buffer size with the number of CPUs and rounding it to the nearest power of 2
@@ -109,7 +113,7 @@ func setupPerfRing(proto string, m *manager.Manager, o *manager.Options, numCPUs
 	}
 
 	m.RingBuffers = append(m.RingBuffers, rb)
-	setHandler(proto, handler)
+	setHandler(proto, handler, directEvents)
 }
 
 func configureBatchMaps(proto string, o *manager.Options, numCPUs int) {
@@ -190,32 +194,38 @@ func alreadySetUp(proto string, m *manager.Manager) bool {
 }
 
 // handlerByProtocol acts as registry holding a temporary reference to a
-// `ddebpf.Handler` instance for a given protocol. This is done to simplify the
+// `ddebpf.Handler` instance for a given protocol, along with whether eBPF sends
+// direct events. This is done to simplify the
 // usage of this package a little bit, so a call to `events.Configure` can be
 // later linked to a call to `events.NewConsumer` without the need to explicitly
 // propagate any values. The map is guarded by `handlerMux`.
-var handlerByProtocol map[string]ddebpf.EventHandler
+var handlerByProtocol map[string]protocolHandler
 var handlerMux sync.Mutex
 
-func getHandler(proto string) ddebpf.EventHandler {
+type protocolHandler struct {
+	handler      ddebpf.EventHandler
+	directEvents bool
+}
+
+func getHandler(proto string) (ddebpf.EventHandler, bool) {
 	handlerMux.Lock()
 	defer handlerMux.Unlock()
 	if handlerByProtocol == nil {
-		return nil
+		return nil, false
 	}
 
-	handler := handlerByProtocol[proto]
+	h := handlerByProtocol[proto]
 	delete(handlerByProtocol, proto)
-	return handler
+	return h.handler, h.directEvents
 }
 
-func setHandler(proto string, handler ddebpf.EventHandler) {
+func setHandler(proto string, handler ddebpf.EventHandler, directEvents bool) {
 	handlerMux.Lock()
 	defer handlerMux.Unlock()
 	if handlerByProtocol == nil {
-		handlerByProtocol = make(map[string]ddebpf.EventHandler)
+		handlerByProtocol = make(map[string]protocolHandler)
 	}
-	handlerByProtocol[proto] = handler
+	handlerByProtocol[proto] = protocolHandler{handler: handler, directEvents: directEvents}
 }
 
 // toPowerOf2 converts a number to its nearest power of 2
@@ -26,6 +26,9 @@ const (
 	batchMapSuffix  = "_batches"
 	eventsMapSuffix = "_batch_events"
 	sizeOfBatch     = int(unsafe.Sizeof(Batch{}))
+	// size of the batch header, eBPF only sends the events following it rather than
+	// the whole data buffer
+	sizeOfBatchHeader = int(unsafe.Offsetof(Batch{}.Data))
 )
 
 var errInvalidPerfEvent = errors.New("invalid perf event")
@@ -40,6 +43,14 @@ type Consumer[V any] struct {
 	batchReader *batchReader
 	callback    func([]V)
 
+	// directEvents is set when eBPF writes single events straight into the ring
+	// buffer, alongside batches holding the events that didn't fit in it.
+	directEvents bool
+	eventSize    int
+
+	// holds batches whose perf event is too small to be used in place
+	scratch Batch
+
 	// termination
 	eventLoopWG sync.WaitGroup
 	stopped     bool
@@ -76,7 +87,7 @@ func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V))
 		return nil, err
 	}
 
-	handler := getHandler(proto)
+	handler, directEvents := getHandler(proto)
 	if handler == nil {
 		return nil, fmt.Errorf("unable to detect perf handler. perhaps you forgot to call events.Configure()?")
 	}
@@ -115,6 +126,9 @@ func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V))
 		handler:     handler,
 		batchReader: batchReader,
 
+		directEvents: directEvents,
+		eventSize:    int(unsafe.Sizeof(*new(V))),
+
 		// telemetry
 		metricGroup:              metricGroup,
 		eventsCount:              eventsCount,
@@ -140,7 +154,15 @@ func (c *Consumer[V]) Start() {
 					return
 				}
 
-				b, err := batchFromEventData(dataEvent.Data)
+				// a flushed batch always holds a header and at least one event, so
+				// it can't be mistaken for a direct event
+				if c.directEvents && len(dataEvent.Data) == c.eventSize {
+					c.processEvent(dataEvent.Data)
+					dataEvent.Done()
+					break
+				}
+
+				b, err := batchFromEventData(dataEvent.Data, &c.scratch)
 
 				if err != nil {
 					c.invalidBatchCount.Add(1)
@@ -209,6 +231,12 @@ func (c *Consumer[V]) Stop() {
 	close(c.syncRequest)
 }
 
+// processEvent hands a single event written straight into the ring buffer to the callback
+func (c *Consumer[V]) processEvent(data []byte) {
+	c.eventsCount.Add(1)
+	c.callback(unsafe.Slice((*V)(unsafe.Pointer(&data[0])), 1))
+}
+
 func (c *Consumer[V]) process(b *Batch, syncing bool) {
 	cpu := int(b.Cpu)
 
@@ -246,21 +274,34 @@ func (c *Consumer[V]) process(b *Batch, syncing bool) {
 	c.callback(events)
 }
 
-func batchFromEventData(data []byte) (*Batch, error) {
-	if len(data) < sizeOfBatch {
+// batchFromEventData returns the batch held by a perf or ring buffer event. eBPF only
+// sends the header and the events of a batch, so when the event is smaller than a
+// Batch it is copied into scratch, unless the underlying buffer is large enough.
+func batchFromEventData(data []byte, scratch *Batch) (*Batch, error) {
+	if len(data) < sizeOfBatchHeader {
 		// For some reason the eBPF program sent us a perf event with a size
 		// different from what we're expecting.
 		//
-		// TODO: we're not ensuring that len(data) == sizeOfBatch, because we're
+		// TODO: we're not ensuring that len(data) matches the batch, because we're
 		// consistently getting events that have a few bytes more than
-		// `sizeof(batch_event_t)`. I haven't determined yet where these extra
+		// what was sent. I haven't determined yet where these extra
 		// bytes are coming from, but I already validated that is not padding
 		// coming from the clang/LLVM toolchain for alignment purposes, so it's
 		// something happening *after* the call to bpf_perf_event_output.
 		return nil, errInvalidPerfEvent
 	}
 
-	return (*Batch)(unsafe.Pointer(&data[0])), nil
+	header := scratch
+	copy(unsafe.Slice((*byte)(unsafe.Pointer(header)), sizeOfBatchHeader), data)
+	if int(header.Len)*int(header.Event_size) > len(data)-sizeOfBatchHeader {
+		return nil, errInvalidPerfEvent
+	}
+
+	if cap(data) >= sizeOfBatch {
+		return (*Batch)(unsafe.Pointer(&data[:sizeOfBatch][0])), nil
+	}
+	copy(unsafe.Slice((*byte)(unsafe.Pointer(scratch)), sizeOfBatch), data)
+	return scratch, nil
 }
 
 func pointerToElement[V any](b *Batch, elementIdx int) *V {
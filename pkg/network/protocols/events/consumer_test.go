@@ -89,7 +89,7 @@ func TestInvalidBatchCountMetric(t *testing.T) {
 	consumer, err := NewConsumer("test", program.Manager, func([]uint64) {})
 	require.NoError(t, err)
 
-	// We are creating a raw sample with a data length of 4, which is smaller than sizeOfBatch
+	// We are creating a raw sample with a data length of 4, which is smaller than sizeOfBatchHeader
 	// and would be considered an invalid batch.
 	RecordSample(c, consumer, []byte("test"))
 
@@ -101,6 +101,76 @@ func TestInvalidBatchCountMetric(t *testing.T) {
 	}, 5*time.Second, 100*time.Millisecond)
 }
 
+func TestDirectEvents(t *testing.T) {
+	kversion, err := kernel.HostVersion()
+	require.NoError(t, err)
+	if minVersion := kernel.VersionCode(4, 14, 0); kversion < minVersion {
+		t.Skipf("package not supported by kernels < %s", minVersion)
+	}
+
+	c := config.New()
+	program, err := NewEBPFProgram(c)
+	require.NoError(t, err)
+	t.Cleanup(func() { program.Stop(manager.CleanAll) })
+
+	var mux sync.Mutex
+	var result []uint64
+	consumer, err := NewConsumer("test", program.Manager, func(events []uint64) {
+		mux.Lock()
+		defer mux.Unlock()
+		result = append(result, events...)
+	})
+	require.NoError(t, err)
+	consumer.directEvents = true
+
+	event := uint64(42)
+	RecordSample(c, consumer, unsafe.Slice((*byte)(unsafe.Pointer(&event)), unsafe.Sizeof(event)))
+
+	consumer.Start()
+	t.Cleanup(func() { consumer.Stop() })
+	require.Eventually(t, func() bool {
+		mux.Lock()
+		defer mux.Unlock()
+		return len(result) == 1 && result[0] == 42
+	}, 5*time.Second, 100*time.Millisecond)
+	assert.Zero(t, consumer.invalidBatchCount.Get())
+}
+
+func TestBatchFromEventData(t *testing.T) {
+	var scratch Batch
+	newEventData := func(events []uint64, capacity int) []byte {
+		header := Batch{Len: uint16(len(events)), Event_size: 8}
+		data := make([]byte, sizeOfBatchHeader+len(events)*8, capacity)
+		copy(data, unsafe.Slice((*byte)(unsafe.Pointer(&header)), sizeOfBatchHeader))
+		for i, event := range events {
+			*(*uint64)(unsafe.Pointer(&data[sizeOfBatchHeader+i*8])) = event
+		}
+		return data
+	}
+
+	t.Run("partial batch", func(t *testing.T) {
+		data := newEventData([]uint64{1, 2, 3}, sizeOfBatchHeader+3*8)
+		b, err := batchFromEventData(data, &scratch)
+		require.NoError(t, err)
+		assert.Same(t, &scratch, b)
+		assert.Equal(t, uint64(3), *pointerToElement[uint64](b, 2))
+	})
+
+	t.Run("partial batch in a large buffer", func(t *testing.T) {
+		data := newEventData([]uint64{1, 2, 3}, sizeOfBatch)
+		b, err := batchFromEventData(data, &scratch)
+		require.NoError(t, err)
+		assert.Equal(t, unsafe.Pointer(&data[0]), unsafe.Pointer(b))
+		assert.Equal(t, uint64(2), *pointerToElement[uint64](b, 1))
+	})
+
+	t.Run("truncated batch", func(t *testing.T) {
+		data := newEventData([]uint64{1, 2, 3}, sizeOfBatchHeader+3*8)
+		_, err := batchFromEventData(data[:len(data)-1], &scratch)
+		assert.ErrorIs(t, err, errInvalidPerfEvent)
+	})
+}
+
 type eventGenerator struct {
 	// map used for coordinating test with eBPF program space
 	testMap *ebpf.Map
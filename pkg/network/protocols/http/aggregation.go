@@ -0,0 +1,226 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http
+
+import (
+	"bytes"
+	"sync"
+
+	manager "github.com/DataDog/ebpf-manager"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+const (
+	latencyAggregatesMap = "http_latency_aggregates"
+	emptyLatencySketch   = "http_empty_latency_sketch"
+
+	// FNV-1a parameters, see HTTP_PATH_HASH_OFFSET and HTTP_PATH_HASH_PRIME
+	pathHashOffset = 14695981039346656037
+	pathHashPrime  = 1099511628211
+)
+
+// pathHash mirrors `http_path_hash`: it returns the FNV-1a hash of the path of the request
+// held in the given fragment, up to the query string. ok is false when the path is too
+// long to be aggregated in eBPF.
+func pathHash(fragment []byte) (hash uint64, ok bool) {
+	i := bytes.IndexByte(fragment, ' ')
+	if i == -1 {
+		return 0, false
+	}
+
+	hash = pathHashOffset
+	for j := i + 1; j < len(fragment) && j <= i+1+PathHashMaxLen; j++ {
+		switch c := fragment[j]; c {
+		case ' ', '?', 0:
+			return hash, true
+		default:
+			hash ^= uint64(c)
+			hash *= pathHashPrime
+		}
+	}
+	return 0, false
+}
+
+// latencyBucketValue returns the latency, in nanoseconds, representing the given bucket
+// of the histograms built in eBPF.
+func latencyBucketValue(bucket int) float64 {
+	return protocols.LatencyBucketValue(bucket, LatencyMinExponent, LatencySubBucketBits)
+}
+
+// learnedPath is the request fragment of the first transaction of an aggregate, holding
+// the path behind its hash.
+type learnedPath struct {
+	fragment   [BufferSize]byte
+	generation uint64
+}
+
+// latencyAggregator drains the latency histograms built in eBPF when in-kernel
+// aggregation is enabled. eBPF only knows the hash of the paths, so the aggregator
+// learns the path behind every hash from the first transaction of each aggregate,
+// which is always sent to userspace.
+type latencyAggregator struct {
+	mux        sync.Mutex
+	paths      map[uint64]*learnedPath
+	generation uint64
+
+	aggregates *maps.GenericMap[EbpfAggregateKey, []EbpfLatencySketch]
+
+	// aggregates whose path was unknown at the previous drain
+	unknownKeys map[EbpfAggregateKey]struct{}
+
+	// buffers reused across drains
+	keysToDelete []EbpfAggregateKey
+	latencies    []LatencyCount
+
+	// aggregates whose path was not learned yet, they are drained on the next check
+	unknownPath *libtelemetry.Counter
+	// aggregates whose path was still not learned on the next check, most likely because
+	// their first transaction was lost. They are deleted, so they don't fill up the map.
+	unknownPathDeleted *libtelemetry.Counter
+}
+
+func newLatencyAggregator(mgr *manager.Manager, telemetry *Telemetry) (*latencyAggregator, error) {
+	aggregates, err := maps.GetMap[EbpfAggregateKey, []EbpfLatencySketch](mgr, latencyAggregatesMap)
+	if err != nil {
+		return nil, err
+	}
+
+	return &latencyAggregator{
+		paths:              make(map[uint64]*learnedPath),
+		unknownKeys:        make(map[EbpfAggregateKey]struct{}),
+		aggregates:         aggregates,
+		unknownPath:        telemetry.metricGroup.NewCounter("kernel_aggregates", "type:unknown-path"),
+		unknownPathDeleted: telemetry.metricGroup.NewCounter("kernel_aggregates", "type:unknown-path-deleted"),
+	}, nil
+}
+
+// Learn records the path of the given transaction, in case it is the first one of an
+// aggregate.
+func (a *latencyAggregator) Learn(tx *EbpfEvent) {
+	hash, ok := pathHash(tx.Http.Request_fragment[:])
+	if !ok {
+		return
+	}
+
+	a.mux.Lock()
+	defer a.mux.Unlock()
+	path, ok := a.paths[hash]
+	if !ok {
+		path = &learnedPath{fragment: tx.Http.Request_fragment}
+		a.paths[hash] = path
+	}
+	path.generation = a.generation
+}
+
+// Drain hands the aggregates built in eBPF to the stat keeper and removes them from the
+// eBPF map. This must be called after the events consumer is synced, so the paths of
+// the aggregates have been learned.
+func (a *latencyAggregator) Drain(statkeeper *StatKeeper, telemetry *Telemetry) {
+	a.mux.Lock()
+	defer a.mux.Unlock()
+
+	var key EbpfAggregateKey
+	var sketches []EbpfLatencySketch
+	used := make(map[uint64]struct{})
+	unknownKeys := make(map[EbpfAggregateKey]struct{})
+	a.keysToDelete = a.keysToDelete[:0]
+	iter := a.aggregates.Iterate()
+	for iter.Next(&key, &sketches) {
+		path, ok := a.paths[key.Path_hash]
+		if !ok {
+			if _, seen := a.unknownKeys[key]; seen {
+				// the path was never learned, the next transaction of the aggregate will
+				// be sent to userspace again once it is deleted
+				a.unknownPathDeleted.Add(1)
+				a.keysToDelete = append(a.keysToDelete, key)
+				continue
+			}
+			// the aggregate was most likely created after the consumer was synced
+			a.unknownPath.Add(1)
+			unknownKeys[key] = struct{}{}
+			continue
+		}
+		used[key.Path_hash] = struct{}{}
+		a.keysToDelete = append(a.keysToDelete, key)
+
+		// fold the per-CPU histograms
+		var buckets [LatencyBuckets]int
+		var tags uint64
+		for i := range sketches {
+			tags |= sketches[i].Tags
+			for b, count := range sketches[i].Buckets {
+				buckets[b] += int(count)
+			}
+		}
+
+		a.latencies = a.latencies[:0]
+		total := 0
+		for b, count := range buckets {
+			if count > 0 {
+				a.latencies = append(a.latencies, LatencyCount{Latency: latencyBucketValue(b), Count: count})
+				total += count
+			}
+		}
+		if total == 0 {
+			continue
+		}
+
+		tx := &EbpfEvent{
+			Tuple: key.Tuple,
+			Http: EbpfTx{
+				Tags:                 tags,
+				Response_status_code: uint16(key.Status_class) * 100,
+				Request_method:       key.Request_method,
+				Request_fragment:     path.fragment,
+			},
+		}
+		telemetry.CountAggregate(tx, total)
+		statkeeper.ProcessAggregate(tx, a.latencies)
+	}
+	if err := iter.Err(); err != nil {
+		log.Warnf("failed to iterate over %s: %s", latencyAggregatesMap, err)
+	}
+	a.unknownKeys = unknownKeys
+
+	// Transactions folded between the lookup above and the deletion below are lost,
+	// this is the price of draining the map without stopping eBPF.
+	for i := range a.keysToDelete {
+		_ = a.aggregates.Delete(&a.keysToDelete[i])
+	}
+
+	// Forget the paths we used, the next transaction of their aggregates will be sent to
+	// userspace again. Paths that were learned but not used since the previous drain
+	// belong to aggregates eBPF failed to create.
+	for hash, path := range a.paths {
+		if _, ok := used[hash]; ok || path.generation < a.generation {
+			delete(a.paths, hash)
+		}
+	}
+	a.generation++
+}
+
+// CountAggregate counts count transactions aggregated in eBPF.
+func (t *Telemetry) CountAggregate(tx Transaction, count int) {
+	statusClass := (tx.StatusCode() / 100) * 100
+	switch statusClass {
+	case 100:
+		t.hits1XX.AddN(tx, int64(count))
+	case 200:
+		t.hits2XX.AddN(tx, int64(count))
+	case 300:
+		t.hits3XX.AddN(tx, int64(count))
+	case 400:
+		t.hits4XX.AddN(tx, int64(count))
+	case 500:
+		t.hits5XX.AddN(tx, int64(count))
+	}
+}
@@ -0,0 +1,136 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http
+
+import (
+	"hash/fnv"
+	"math/bits"
+	"strings"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+	"github.com/DataDog/datadog-agent/pkg/process/util"
+)
+
+// latencyBucket mirrors `usm_latency_bucket`
+func latencyBucket(latency uint64) int {
+	if latency < 1<<LatencyMinExponent {
+		return 0
+	}
+	exponent := bits.Len64(latency) - 1
+	if exponent >= LatencyMinExponent+LatencyBuckets>>LatencySubBucketBits {
+		return LatencyBuckets - 1
+	}
+	subBucket := int(latency>>(exponent-LatencySubBucketBits)) & (1<<LatencySubBucketBits - 1)
+	return (exponent-LatencyMinExponent)<<LatencySubBucketBits | subBucket
+}
+
+func TestPathHash(t *testing.T) {
+	fnvHash := func(s string) uint64 {
+		h := fnv.New64a()
+		h.Write([]byte(s))
+		return h.Sum64()
+	}
+
+	for _, fragment := range []string{"GET /foo HTTP/1.1", "GET /foo?bar=baz HTTP/1.1", "DELETE /foo"} {
+		fragment := requestFragment([]byte(fragment))
+		hash, ok := pathHash(fragment[:])
+		require.True(t, ok)
+		assert.Equal(t, fnvHash("/foo"), hash)
+	}
+
+	// the path must end within PathHashMaxLen bytes
+	path := "/" + strings.Repeat("a", PathHashMaxLen-1)
+	fragment := requestFragment([]byte("GET " + path + " HTTP/1.1"))
+	hash, ok := pathHash(fragment[:])
+	require.True(t, ok)
+	assert.Equal(t, fnvHash(path), hash)
+
+	fragment = requestFragment([]byte("GET " + path + "a HTTP/1.1"))
+	_, ok = pathHash(fragment[:])
+	assert.False(t, ok)
+
+	// the path must end within the fragment
+	fragment = requestFragment([]byte("GET /" + strings.Repeat("a", BufferSize)))
+	_, ok = pathHash(fragment[:])
+	assert.False(t, ok)
+}
+
+func TestLatencyBucketValue(t *testing.T) {
+	for bucket := 0; bucket < LatencyBuckets; bucket++ {
+		assert.Equal(t, bucket, latencyBucket(uint64(latencyBucketValue(bucket))))
+	}
+
+	// buckets are 2^-LatencySubBucketBits wide relatively to their lower bound
+	for _, latency := range []time.Duration{2 * time.Microsecond, 150 * time.Microsecond, 3 * time.Millisecond, 1200 * time.Millisecond} {
+		value := latencyBucketValue(latencyBucket(uint64(latency)))
+		assert.InEpsilon(t, float64(latency), value, 1.0/(1<<LatencySubBucketBits))
+	}
+
+	assert.Equal(t, 0, latencyBucket(10))
+	assert.Equal(t, LatencyBuckets-1, latencyBucket(uint64(time.Hour)))
+}
+
+func TestProcessAggregate(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxHTTPStatsBuffered = 1000
+	tel := NewTelemetry("http")
+	sk := NewStatkeeper(cfg, tel, NewIncompleteBuffer(cfg, tel))
+
+	sourceIP := util.AddressFromString("1.1.1.1")
+	destIP := util.AddressFromString("2.2.2.2")
+	tx := generateIPv4HTTPTransaction(sourceIP, destIP, 1234, 8080, "/testpath", 200, time.Millisecond)
+
+	sk.Process(tx)
+	sk.ProcessAggregate(tx, []LatencyCount{
+		{Latency: float64(2 * time.Millisecond), Count: 3},
+		{Latency: float64(4 * time.Millisecond), Count: 1},
+	})
+
+	stats := sk.GetAndResetAllStats()
+	require.Len(t, stats, 1)
+	for key, stats := range stats {
+		assert.Equal(t, "/testpath", key.Path.Content.Get())
+		s := stats.Data[200]
+		require.NotNil(t, s)
+		assert.Equal(t, 5, s.Count)
+		assert.Equal(t, 5.0, s.Latencies.GetCount())
+		verifyQuantile(t, s.Latencies, 0.0, float64(time.Millisecond))
+		verifyQuantile(t, s.Latencies, 0.5, float64(2*time.Millisecond))
+		verifyQuantile(t, s.Latencies, 1.0, float64(4*time.Millisecond))
+	}
+}
+
+func TestProcessAggregateRollup(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxHTTPStatsBuffered = 1000
+	cfg.EnableUSMConnectionRollup = true
+	tel := NewTelemetry("http")
+	sk := NewStatkeeper(cfg, tel, NewIncompleteBuffer(cfg, tel))
+
+	sourceIP := util.AddressFromString("1.1.1.1")
+	destIP := util.AddressFromString("2.2.2.2")
+	tx := generateIPv4HTTPTransaction(sourceIP, destIP, 1234, 8080, "/testpath", 200, time.Millisecond)
+	sk.Process(tx)
+
+	// aggregates built in eBPF leave the client port out when connections are rolled up
+	aggregate := generateIPv4HTTPTransaction(sourceIP, destIP, 0, 8080, "/testpath", 200, time.Millisecond)
+	sk.ProcessAggregate(aggregate, []LatencyCount{{Latency: float64(2 * time.Millisecond), Count: 3}})
+
+	stats := sk.GetAndResetAllStats()
+	require.Len(t, stats, 1)
+	for _, stats := range stats {
+		s := stats.Data[200]
+		require.NotNil(t, s)
+		assert.Equal(t, 4, s.Count)
+	}
+}
@@ -0,0 +1,106 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http
+
+import (
+	manager "github.com/DataDog/ebpf-manager"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+)
+
+const (
+	compactEventStream = "http_compact"
+	pathsMap           = "http_paths"
+
+	// maxCachedPaths bounds the request fragments cached in userspace, twice the size
+	// of http_paths
+	maxCachedPaths = 4096
+)
+
+// compactEventsDecoder turns the compact events sent by eBPF back into EbpfEvent.
+// Compact events carry the hash, the length and a prefix of the request path: short
+// paths are rebuilt from the prefix, while the request fragments of longer paths are
+// read from http_paths, where eBPF stores them the first time it sees them.
+type compactEventsDecoder struct {
+	paths *maps.GenericMap[uint64, EbpfPath]
+	// request fragments already read from http_paths
+	fragments map[uint64][BufferSize]byte
+
+	// reused across events, the stat keeper copies what it keeps
+	tx EbpfEvent
+
+	// long paths evicted from http_paths before we read them, reported truncated
+	unknownPath *libtelemetry.Counter
+}
+
+func newCompactEventsDecoder(mgr *manager.Manager, telemetry *Telemetry) (*compactEventsDecoder, error) {
+	paths, err := maps.GetMap[uint64, EbpfPath](mgr, pathsMap)
+	if err != nil {
+		return nil, err
+	}
+
+	return &compactEventsDecoder{
+		paths:       paths,
+		fragments:   make(map[uint64][BufferSize]byte),
+		unknownPath: telemetry.metricGroup.NewCounter("compact_events", "type:unknown-path"),
+	}, nil
+}
+
+// Decode returns the transaction held in the given compact event. The returned event
+// is only valid until the next call, and Decode must not be called concurrently.
+func (d *compactEventsDecoder) Decode(event *EbpfCompactEvent) *EbpfEvent {
+	d.tx = EbpfEvent{
+		Tuple: event.Tuple,
+		Http: EbpfTx{
+			Request_started:      event.Request_started,
+			Response_last_seen:   event.Response_last_seen,
+			Tags:                 event.Tags,
+			Response_status_code: event.Response_status_code,
+			Request_method:       event.Request_method,
+		},
+	}
+	d.tx.Http.Request_fragment = d.fragment(event)
+	return &d.tx
+}
+
+func (d *compactEventsDecoder) fragment(event *EbpfCompactEvent) [BufferSize]byte {
+	method := Method(event.Request_method)
+	if int(event.Path_len) <= PathPrefixSize {
+		return compactFragment(method, event.Path_prefix[:event.Path_len], true)
+	}
+
+	if fragment, ok := d.fragments[event.Path_hash]; ok {
+		return fragment
+	}
+
+	var path EbpfPath
+	if err := d.paths.Lookup(&event.Path_hash, &path); err != nil {
+		d.unknownPath.Add(1)
+		return compactFragment(method, event.Path_prefix[:], false)
+	}
+	if len(d.fragments) >= maxCachedPaths {
+		clear(d.fragments)
+	}
+	d.fragments[event.Path_hash] = path.Request_fragment
+	return path.Request_fragment
+}
+
+// compactFragment builds a request fragment holding the given path. Unless fullPath
+// is set, the path isn't terminated, so it is reported as truncated.
+func compactFragment(method Method, path []byte, fullPath bool) [BufferSize]byte {
+	var fragment [BufferSize]byte
+	n := copy(fragment[:], method.String())
+	fragment[n] = ' '
+	n++
+	n += copy(fragment[n:], path)
+	if fullPath {
+		fragment[n] = ' '
+	}
+	return fragment
+}
@@ -0,0 +1,71 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http
+
+import (
+	"strings"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func newCompactEvent(method Method, path string) *EbpfCompactEvent {
+	event := &EbpfCompactEvent{
+		Request_started:      1,
+		Response_last_seen:   2,
+		Tags:                 uint64(TLS),
+		Response_status_code: 200,
+		Request_method:       uint8(method),
+		Path_len:             uint16(len(path)),
+	}
+	event.Path_hash, _ = pathHash([]byte(method.String() + " " + path + " HTTP/1.1"))
+	copy(event.Path_prefix[:], path)
+	return event
+}
+
+func TestDecodeCompactEvent(t *testing.T) {
+	decoder := &compactEventsDecoder{fragments: make(map[uint64][BufferSize]byte)}
+	buffer := make([]byte, BufferSize)
+
+	t.Run("short path", func(t *testing.T) {
+		tx := decoder.Decode(newCompactEvent(MethodPost, "/api/v1/users"))
+		path, fullPath := tx.Path(buffer)
+		assert.Equal(t, "/api/v1/users", string(path))
+		assert.True(t, fullPath)
+		assert.Equal(t, MethodPost, tx.Method())
+		assert.Equal(t, uint16(200), tx.StatusCode())
+		assert.Equal(t, uint64(1), tx.RequestStarted())
+		assert.Equal(t, uint64(2), tx.ResponseLastSeen())
+		assert.Equal(t, uint64(TLS), tx.StaticTags())
+	})
+
+	t.Run("path filling the prefix", func(t *testing.T) {
+		longest := "/" + strings.Repeat("a", PathPrefixSize-1)
+		path, fullPath := decoder.Decode(newCompactEvent(MethodGet, longest)).Path(buffer)
+		assert.Equal(t, longest, string(path))
+		assert.True(t, fullPath)
+	})
+
+	t.Run("long path", func(t *testing.T) {
+		long := "/" + strings.Repeat("b", PathPrefixSize+10)
+		event := newCompactEvent(MethodGet, long)
+		decoder.fragments[event.Path_hash] = requestFragment([]byte("GET " + long + "?q=1 HTTP/1.1"))
+
+		path, fullPath := decoder.Decode(event).Path(buffer)
+		assert.Equal(t, long, string(path))
+		assert.True(t, fullPath)
+	})
+}
+
+func TestCompactFragment(t *testing.T) {
+	buffer := make([]byte, BufferSize)
+	tx := &EbpfEvent{Http: EbpfTx{Request_fragment: compactFragment(MethodGet, []byte("/truncated"), false)}}
+	path, fullPath := tx.Path(buffer)
+	assert.Equal(t, "/truncated", string(path))
+	assert.False(t, fullPath)
+}
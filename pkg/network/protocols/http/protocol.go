@@ -36,6 +36,12 @@ type protocol struct {
 	mapCleaner     *ddebpf.MapCleaner[netebpf.ConnTuple, EbpfTx]
 	eventsConsumer *events.Consumer[EbpfEvent]
 	mgr            *manager.Manager
+	// aggregator is only set when latencies are aggregated in eBPF
+	aggregator *latencyAggregator
+	// compactEventsConsumer and compactEventsDecoder are only set when eBPF sends
+	// compact events
+	compactEventsConsumer *events.Consumer[EbpfCompactEvent]
+	compactEventsDecoder  *compactEventsDecoder
 }
 
 const (
@@ -67,6 +73,27 @@ var Spec = &protocols.ProtocolSpec{
 		{
 			Name: "http_batches",
 		},
+		{
+			Name: latencyAggregatesMap,
+		},
+		{
+			Name: emptyLatencySketch,
+		},
+		{
+			Name: "http_compact_scratch_buffer",
+		},
+		{
+			Name: "http_compact_batch_events",
+		},
+		{
+			Name: "http_compact_batch_state",
+		},
+		{
+			Name: "http_compact_batches",
+		},
+		{
+			Name: pathsMap,
+		},
 	},
 	Probes: []*manager.Probe{
 		{
@@ -140,13 +167,28 @@ func (p *protocol) Name() string {
 // ConfigureOptions add the necessary options for the http monitoring to work,
 // to be used by the manager. These are:
 // - Set the `http_in_flight` map size to the value of the `max_tracked_connection` configuration variable.
+// - Enable the in-kernel aggregation of latencies and size its map, or shrink the map when it is disabled.
+// - Enable compact events, or shrink their maps when they are disabled.
 //
-// We also configure the http event stream with the manager and its options.
+// We also configure the http event streams with the manager and its options.
 func (p *protocol) ConfigureOptions(opts *manager.Options) {
 	opts.MapSpecEditors[inFlightMap] = manager.MapSpecEditor{
 		MaxEntries: p.cfg.MaxUSMConcurrentRequests,
 		EditorFlag: manager.EditMaxEntries,
 	}
+	utils.AddBoolConst(opts, p.cfg.EnableHTTPKernelAggregation, "http_aggregation_enabled")
+	// the client port is only left out of the aggregates when userspace rolls up connections,
+	// otherwise the aggregates could not be matched with their connections
+	utils.AddBoolConst(opts, p.cfg.EnableHTTPKernelAggregation && p.cfg.EnableUSMConnectionRollup, "http_aggregation_rollup_enabled")
+	aggregatesSize := uint32(1)
+	if p.cfg.EnableHTTPKernelAggregation {
+		// userspace can't hold more stats than MaxHTTPStatsBuffered anyway
+		aggregatesSize = uint32(max(min(p.cfg.MaxHTTPKernelAggregates, p.cfg.MaxHTTPStatsBuffered), 1))
+	}
+	opts.MapSpecEditors[latencyAggregatesMap] = manager.MapSpecEditor{
+		MaxEntries: aggregatesSize,
+		EditorFlag: manager.EditMaxEntries,
+	}
 	netifProbeID := manager.ProbeIdentificationPair{
 		EBPFFuncName: netifProbe,
 		UID:          eventStream,
@@ -158,6 +200,17 @@ func (p *protocol) ConfigureOptions(opts *manager.Options) {
 	utils.EnableOption(opts, "http_monitoring_enabled")
 	// Configure event stream
 	events.Configure(p.cfg, eventStream, p.mgr, opts)
+	if p.cfg.EnableHTTPCompactEvents {
+		utils.EnableOption(opts, "http_compact_monitoring_enabled")
+		events.Configure(p.cfg, compactEventStream, p.mgr, opts)
+	} else {
+		for _, name := range []string{pathsMap, "http_compact_batches"} {
+			opts.MapSpecEditors[name] = manager.MapSpecEditor{
+				MaxEntries: 1,
+				EditorFlag: manager.EditMaxEntries,
+			}
+		}
+	}
 }
 
 func (p *protocol) PreStart() (err error) {
@@ -170,8 +223,33 @@ func (p *protocol) PreStart() (err error) {
 		return
 	}
 
+	if p.cfg.EnableHTTPKernelAggregation {
+		p.aggregator, err = newLatencyAggregator(p.mgr, p.telemetry)
+		if err != nil {
+			return
+		}
+	}
+
+	if p.cfg.EnableHTTPCompactEvents {
+		p.compactEventsDecoder, err = newCompactEventsDecoder(p.mgr, p.telemetry)
+		if err != nil {
+			return
+		}
+		p.compactEventsConsumer, err = events.NewConsumer(
+			compactEventStream,
+			p.mgr,
+			p.processCompactHTTP,
+		)
+		if err != nil {
+			return
+		}
+	}
+
 	p.statkeeper = NewStatkeeper(p.cfg, p.telemetry, NewIncompleteBuffer(p.cfg, p.telemetry))
 	p.eventsConsumer.Start()
+	if p.compactEventsConsumer != nil {
+		p.compactEventsConsumer.Start()
+	}
 
 	return
 }
@@ -191,6 +269,10 @@ func (p *protocol) Stop() {
 		p.eventsConsumer.Stop()
 	}
 
+	if p.compactEventsConsumer != nil {
+		p.compactEventsConsumer.Stop()
+	}
+
 	if p.statkeeper != nil {
 		p.statkeeper.Close()
 	}
@@ -211,6 +293,20 @@ func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
 func (p *protocol) processHTTP(events []EbpfEvent) {
 	for i := range events {
 		tx := &events[i]
+		if p.aggregator != nil {
+			p.aggregator.Learn(tx)
+		}
+		p.telemetry.Count(tx)
+		p.statkeeper.Process(tx)
+	}
+}
+
+func (p *protocol) processCompactHTTP(events []EbpfCompactEvent) {
+	for i := range events {
+		tx := p.compactEventsDecoder.Decode(&events[i])
+		if p.aggregator != nil {
+			p.aggregator.Learn(tx)
+		}
 		p.telemetry.Count(tx)
 		p.statkeeper.Process(tx)
 	}
@@ -246,6 +342,12 @@ func (p *protocol) setupMapCleaner(mgr *manager.Manager) {
 // [source, dest tuple, request path] -> RequestStats object
 func (p *protocol) GetStats() (*protocols.ProtocolStats, func()) {
 	p.eventsConsumer.Sync()
+	if p.compactEventsConsumer != nil {
+		p.compactEventsConsumer.Sync()
+	}
+	if p.aggregator != nil {
+		p.aggregator.Drain(p.statkeeper, p.telemetry)
+	}
 	p.telemetry.Log()
 	stats := p.statkeeper.GetAndResetAllStats()
 	return &protocols.ProtocolStats{
@@ -108,11 +108,63 @@ func (h *StatKeeper) GetAndResetAllStats() (stats map[Key]*RequestStats) {
 func (h *StatKeeper) Close() {
 }
 
+// ProcessAggregate adds transactions aggregated in eBPF to the stats. They share the
+// connection, path, method and status code of tx, and have the given latencies.
+func (h *StatKeeper) ProcessAggregate(tx Transaction, latencies []LatencyCount) {
+	h.mux.Lock()
+	defer h.mux.Unlock()
+
+	key, ok := h.newKey(tx)
+	if !ok {
+		return
+	}
+
+	stats := h.getStats(key)
+	if stats == nil {
+		return
+	}
+
+	for _, l := range latencies {
+		stats.AddLatencies(tx.StatusCode(), l.Latency, l.Count, tx.StaticTags())
+	}
+}
+
+// LatencyCount is the number of transactions sharing a latency, in nanoseconds
+type LatencyCount struct {
+	Latency float64
+	Count   int
+}
+
 func (h *StatKeeper) add(tx Transaction) {
+	key, ok := h.newKey(tx)
+	if !ok {
+		return
+	}
+
+	latency := tx.RequestLatency()
+	if latency <= 0 {
+		h.telemetry.invalidLatency.Add(1)
+		if h.oversizedLogLimit.ShouldLog() {
+			log.Warnf("latency should never be equal to 0: %s", tx.String())
+		}
+		return
+	}
+
+	stats := h.getStats(key)
+	if stats == nil {
+		return
+	}
+
+	stats.AddRequest(tx.StatusCode(), latency, tx.StaticTags(), tx.DynamicTags())
+}
+
+// newKey returns the key of the stats of the given transaction, ok is false when the
+// transaction must be ignored.
+func (h *StatKeeper) newKey(tx Transaction) (key Key, ok bool) {
 	rawPath, fullPath := tx.Path(h.buffer)
 	if rawPath == nil {
 		h.telemetry.emptyPath.Add(1)
-		return
+		return Key{}, false
 	}
 
 	// Quantize HTTP path
@@ -123,7 +175,7 @@ func (h *StatKeeper) add(tx Transaction) {
 
 	path, rejected := h.processHTTPPath(tx, rawPath)
 	if rejected {
-		return
+		return Key{}, false
 	}
 
 	if tx.Method() == MethodUnknown {
@@ -131,35 +183,30 @@ func (h *StatKeeper) add(tx Transaction) {
 		if h.oversizedLogLimit.ShouldLog() {
 			log.Warnf("method should never be unknown: %s", tx.String())
 		}
-		return
+		return Key{}, false
 	}
 
-	latency := tx.RequestLatency()
-	if latency <= 0 {
-		h.telemetry.invalidLatency.Add(1)
-		if h.oversizedLogLimit.ShouldLog() {
-			log.Warnf("latency should never be equal to 0: %s", tx.String())
-		}
-		return
-	}
-
-	key := NewKeyWithConnection(tx.ConnTuple(), path, fullPath, tx.Method())
+	key = NewKeyWithConnection(tx.ConnTuple(), path, fullPath, tx.Method())
 	if h.connectionAggregator != nil {
 		key.ConnectionKey = h.connectionAggregator.RollupKey(key.ConnectionKey)
 	}
+	return key, true
+}
 
+// getStats returns the stats of the given key, creating them if needed. It returns nil
+// when the stat keeper is full.
+func (h *StatKeeper) getStats(key Key) *RequestStats {
 	stats, ok := h.stats[key]
 	if !ok {
 		if len(h.stats) >= h.maxEntries {
 			h.telemetry.dropped.Add(1)
-			return
+			return nil
 		}
 		h.telemetry.aggregations.Add(1)
 		stats = NewRequestStats()
 		h.stats[key] = stats
 	}
-
-	stats.AddRequest(tx.StatusCode(), latency, tx.StaticTags(), tx.DynamicTags())
+	return stats
 }
 
 func pathIsMalformed(fullPath []byte) bool {
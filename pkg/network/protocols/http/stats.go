@@ -243,6 +243,44 @@ func (r *RequestStats) AddRequest(statusCode uint16, latency float64, staticTags
 	}
 }
 
+// AddLatencies adds count transactions sharing the same latency to the request stats.
+// This is used for the transactions aggregated in eBPF.
+func (r *RequestStats) AddLatencies(statusCode uint16, latency float64, count int, staticTags uint64) {
+	if count == 1 {
+		r.AddRequest(statusCode, latency, staticTags, nil)
+		return
+	}
+	if count <= 0 || !r.isValid(statusCode) {
+		return
+	}
+
+	stats, exists := r.Data[statusCode]
+	if !exists {
+		stats = &RequestStat{}
+		r.Data[statusCode] = stats
+	}
+
+	stats.StaticTags |= staticTags
+	if stats.Latencies == nil {
+		if err := stats.initSketch(); err != nil {
+			log.Warnf("could not add request latency to ddsketch: %v", err)
+			return
+		}
+
+		// Add the deferred latency sample
+		if stats.Count == 1 {
+			if err := stats.Latencies.Add(stats.FirstLatencySample); err != nil {
+				log.Debugf("could not add request latency to ddsketch: %v", err)
+			}
+		}
+	}
+
+	stats.Count += count
+	if err := stats.Latencies.AddWithCount(latency, float64(count)); err != nil {
+		log.Debugf("could not add request latency to ddsketch: %v", err)
+	}
+}
+
 // HalfAllCounts sets the count of all stats for each status class to half their current value.
 // This is used to remove duplicates from the count in the context of Windows localhost traffic.
 func (r *RequestStats) HalfAllCounts() {
@@ -36,6 +36,25 @@ func TestAddRequest(t *testing.T) {
 	}
 }
 
+func TestAddLatencies(t *testing.T) {
+	stats := NewRequestStats()
+	stats.AddLatencies(200, 10.0, 1, 1)
+	stats.AddLatencies(200, 20.0, 3, 2)
+	stats.AddLatencies(200, 30.0, 0, 4)
+	stats.AddLatencies(600, 30.0, 2, 4)
+
+	assert.Nil(t, stats.Data[600])
+	s := stats.Data[200]
+	if assert.NotNil(t, s) {
+		assert.Equal(t, 4, s.Count)
+		assert.Equal(t, 4.0, s.Latencies.GetCount())
+		assert.Equal(t, uint64(3), s.StaticTags)
+
+		verifyQuantile(t, s.Latencies, 0.0, 10.0)
+		verifyQuantile(t, s.Latencies, 1.0, 20.0)
+	}
+}
+
 func TestCombineWith(t *testing.T) {
 	stats := NewRequestStats()
 	for i := uint16(100); i <= 500; i += 100 {
@@ -9,18 +9,23 @@ package http
 
 // Add increments the TLS-aware counter based on the specified transaction's static tags
 func (t *TLSCounter) Add(tx Transaction) {
+	t.AddN(tx, 1)
+}
+
+// AddN adds n to the TLS-aware counter based on the specified transaction's static tags
+func (t *TLSCounter) AddN(tx Transaction, n int64) {
 	switch tx.StaticTags() {
 	case GnuTLS:
-		t.counterGnuTLS.Add(1)
+		t.counterGnuTLS.Add(n)
 	case OpenSSL:
-		t.counterOpenSSL.Add(1)
+		t.counterOpenSSL.Add(n)
 	case Go:
-		t.counterGoTLS.Add(1)
+		t.counterGoTLS.Add(n)
 	case Istio:
-		t.counterIstioTLS.Add(1)
+		t.counterIstioTLS.Add(n)
 	case NodeJS:
-		t.counterNodeJSTLS.Add(1)
+		t.counterNodeJSTLS.Add(n)
 	default:
-		t.counterPlain.Add(1)
+		t.counterPlain.Add(n)
 	}
 }
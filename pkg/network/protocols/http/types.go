@@ -23,9 +23,19 @@ type SslWriteExArgs C.ssl_write_ex_args_t
 
 type EbpfEvent C.http_event_t
 type EbpfTx C.http_transaction_t
+type EbpfAggregateKey C.http_aggregate_key_t
+type EbpfLatencySketch C.http_latency_sketch_t
+type EbpfCompactEvent C.http_compact_event_t
+type EbpfPath C.http_path_t
 
 const (
 	BufferSize = C.HTTP_BUFFER_SIZE
+
+	PathHashMaxLen       = C.HTTP_PATH_HASH_MAX_LEN
+	LatencyMinExponent   = C.HTTP_LATENCY_MIN_EXPONENT
+	LatencySubBucketBits = C.HTTP_LATENCY_SUB_BUCKET_BITS
+	LatencyBuckets       = C.HTTP_LATENCY_BUCKETS
+	PathPrefixSize       = C.HTTP_PATH_PREFIX_SIZE
 )
 
 type ConnTag = uint64
@@ -52,9 +52,41 @@ type EbpfTx struct {
 	Pad_cgo_0            [1]byte
 	Request_fragment     [208]byte
 }
+type EbpfAggregateKey struct {
+	Tuple          ConnTuple
+	Path_hash      uint64
+	Request_method uint8
+	Status_class   uint8
+	Pad            [6]uint8
+}
+type EbpfLatencySketch struct {
+	Tags    uint64
+	Buckets [104]uint32
+}
+type EbpfCompactEvent struct {
+	Tuple                ConnTuple
+	Request_started      uint64
+	Response_last_seen   uint64
+	Tags                 uint64
+	Path_hash            uint64
+	Response_status_code uint16
+	Path_len             uint16
+	Request_method       uint8
+	Path_prefix          [40]byte
+	Pad_cgo_0            [3]byte
+}
+type EbpfPath struct {
+	Request_fragment [208]byte
+}
 
 const (
 	BufferSize = 0xd0
+
+	PathHashMaxLen       = 0x40
+	LatencyMinExponent   = 0xa
+	LatencySubBucketBits = 0x2
+	LatencyBuckets       = 0x68
+	PathPrefixSize       = 0x28
 )
 
 type ConnTag = uint64
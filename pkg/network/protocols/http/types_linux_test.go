@@ -35,3 +35,19 @@ func TestCgoAlignment_EbpfEvent(t *testing.T) {
 func TestCgoAlignment_EbpfTx(t *testing.T) {
 	ebpftest.TestCgoAlignment[EbpfTx](t)
 }
+
+func TestCgoAlignment_EbpfAggregateKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfAggregateKey](t)
+}
+
+func TestCgoAlignment_EbpfLatencySketch(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfLatencySketch](t)
+}
+
+func TestCgoAlignment_EbpfCompactEvent(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfCompactEvent](t)
+}
+
+func TestCgoAlignment_EbpfPath(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfPath](t)
+}
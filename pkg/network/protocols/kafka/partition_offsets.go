@@ -0,0 +1,183 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package kafka
+
+import (
+	"bytes"
+	"encoding/binary"
+	"sync"
+
+	manager "github.com/DataDog/ebpf-manager"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/process/util"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+const (
+	partitionOffsetsMap = "kafka_partition_offsets"
+
+	// maxCachedTopics bounds the topic names cached in userspace, the size of
+	// kafka_partition_offsets
+	maxCachedTopics = 4096
+
+	// FNV-1a parameters, see kafka_topic_hash in the eBPF parser
+	topicHashOffset = 14695981039346656037
+	topicHashPrime  = 1099511628211
+)
+
+// PartitionKey identifies a partition of a topic of the server the responses came from
+type PartitionKey struct {
+	Server    util.Address
+	Port      uint16
+	Topic     string
+	Partition int32
+}
+
+// PartitionOffsets holds the latest offsets seen in the responses for a partition, -1 when unknown
+type PartitionOffsets struct {
+	// HighWatermark is the offset following the last committed record of the partition, from fetch responses
+	HighWatermark int64
+	// FetchedOffset is the offset following the last record batch fetched from the partition
+	FetchedOffset int64
+	// ProducedOffset is the offset following the records last produced to the partition
+	ProducedOffset int64
+}
+
+// Lag returns the number of records of the partition not fetched yet, estimated from the last fetch
+// responses, or -1 when unknown.
+func (o PartitionOffsets) Lag() int64 {
+	if o.HighWatermark < 0 || o.FetchedOffset < 0 {
+		return -1
+	}
+	return max(o.HighWatermark-o.FetchedOffset, 0)
+}
+
+// partitionOffsets reads the offsets eBPF tracks for each partition when enabled. eBPF only knows
+// the hash of the topic names, their names are learned from the transactions sent by eBPF.
+type partitionOffsets struct {
+	offsets *maps.GenericMap[KafkaPartitionKey, KafkaPartitionOffsets]
+
+	// topic names by hash. Events and reads run on different goroutines, hence the mutex.
+	topicsMutex sync.Mutex
+	topics      map[uint64]string
+
+	// the lag of the partitions, refreshed by UpdateTelemetry
+	laggingPartitions *libtelemetry.Gauge
+	maxLag            *libtelemetry.Gauge
+	totalLag          *libtelemetry.Gauge
+}
+
+func newPartitionOffsets(mgr *manager.Manager) (*partitionOffsets, error) {
+	offsets, err := maps.GetMap[KafkaPartitionKey, KafkaPartitionOffsets](mgr, partitionOffsetsMap)
+	if err != nil {
+		return nil, err
+	}
+
+	metricGroup := libtelemetry.NewMetricGroup("usm.kafka", libtelemetry.OptPrometheus)
+	return &partitionOffsets{
+		offsets:           offsets,
+		topics:            make(map[uint64]string),
+		laggingPartitions: metricGroup.NewGauge("partitions_lagging"),
+		maxLag:            metricGroup.NewGauge("partition_lag_max"),
+		totalLag:          metricGroup.NewGauge("partition_lag_total"),
+	}, nil
+}
+
+// Learn caches the name of the topic of the given transaction.
+func (p *partitionOffsets) Learn(tx *KafkaTransaction) {
+	if tx.Topic_name_size == 0 {
+		return
+	}
+	hash := topicHash(&tx.Topic_name, tx.Topic_name_size)
+
+	p.topicsMutex.Lock()
+	defer p.topicsMutex.Unlock()
+	if _, ok := p.topics[hash]; ok {
+		return
+	}
+	if len(p.topics) >= maxCachedTopics {
+		clear(p.topics)
+	}
+	name := tx.Topic_name[:min(int(tx.Topic_name_size), len(tx.Topic_name))]
+	if i := bytes.IndexByte(name, 0); i != -1 {
+		name = name[:i]
+	}
+	p.topics[hash] = string(name)
+}
+
+// Read returns the offsets of the partitions of the topics seen so far.
+func (p *partitionOffsets) Read() map[PartitionKey]PartitionOffsets {
+	p.topicsMutex.Lock()
+	defer p.topicsMutex.Unlock()
+
+	all := make(map[PartitionKey]PartitionOffsets)
+	var key KafkaPartitionKey
+	var value KafkaPartitionOffsets
+	iter := p.offsets.Iterate()
+	for iter.Next(&key, &value) {
+		topic, ok := p.topics[key.Topic_hash]
+		if !ok {
+			continue
+		}
+		all[PartitionKey{
+			Server:    util.FromLowHigh(key.Daddr_l, key.Daddr_h),
+			Port:      key.Dport,
+			Topic:     topic,
+			Partition: key.Partition,
+		}] = PartitionOffsets{
+			HighWatermark:  value.High_watermark,
+			FetchedOffset:  value.Fetched_offset,
+			ProducedOffset: value.Produced_offset,
+		}
+	}
+	if err := iter.Err(); err != nil {
+		log.Warnf("failed to iterate over %s: %s", partitionOffsetsMap, err)
+	}
+	return all
+}
+
+// UpdateTelemetry reports the number of lagging partitions and their maximum and total lag.
+// It walks all the tracked partitions, so it is meant to run periodically rather than on every
+// stats collection.
+func (p *partitionOffsets) UpdateTelemetry() {
+	lagging, maxLag, totalLag := summarizeLag(p.Read())
+	p.laggingPartitions.Set(lagging)
+	p.maxLag.Set(maxLag)
+	p.totalLag.Set(totalLag)
+}
+
+// summarizeLag returns the number of partitions with a positive lag, and their maximum and total lag.
+func summarizeLag(all map[PartitionKey]PartitionOffsets) (lagging, maxLag, totalLag int64) {
+	for _, offsets := range all {
+		lag := offsets.Lag()
+		if lag <= 0 {
+			continue
+		}
+		lagging++
+		maxLag = max(maxLag, lag)
+		totalLag += lag
+	}
+	return lagging, maxLag, totalLag
+}
+
+// topicHash returns the hash eBPF computes for the given topic name: the FNV-1a hash of the
+// first size bytes of the buffer padded with zeroes, taken 8 bytes at a time. The rest of the
+// buffer holds the bytes that followed the name in the request, which are not hashed.
+func topicHash(topic *[TopicNameMaxSize]byte, size uint8) uint64 {
+	var name [TopicNameMaxSize]byte
+	copy(name[:], topic[:min(int(size), len(topic))])
+
+	hash := uint64(topicHashOffset)
+	for i := 0; i+8 <= len(name); i += 8 {
+		hash ^= binary.LittleEndian.Uint64(name[i : i+8])
+		hash *= topicHashPrime
+	}
+	return hash
+}
@@ -0,0 +1,74 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package kafka
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+
+	"github.com/DataDog/datadog-agent/pkg/process/util"
+)
+
+func newTopicTx(topic string) *KafkaTransaction {
+	tx := &KafkaTransaction{Topic_name_size: uint8(len(topic))}
+	copy(tx.Topic_name[:], topic)
+	return tx
+}
+
+func TestTopicHash(t *testing.T) {
+	tx := newTopicTx("orders")
+	other := newTopicTx("orders-v2")
+	assert.Equal(t, topicHash(&tx.Topic_name, tx.Topic_name_size), topicHash(&newTopicTx("orders").Topic_name, uint8(len("orders"))))
+	assert.NotEqual(t, topicHash(&tx.Topic_name, tx.Topic_name_size), topicHash(&other.Topic_name, other.Topic_name_size))
+}
+
+func TestTopicHashIgnoresTrailingBytes(t *testing.T) {
+	tx := newTopicTx("orders")
+	// the parser copies the bytes following the topic name in the request
+	withGarbage := newTopicTx("orders")
+	copy(withGarbage.Topic_name[len("orders"):], "\x00\x00\x00\x01\xff\xff\xff\xfftrailing request bytes")
+
+	assert.Equal(t, topicHash(&tx.Topic_name, tx.Topic_name_size), topicHash(&withGarbage.Topic_name, withGarbage.Topic_name_size))
+
+	offsets := &partitionOffsets{topics: make(map[uint64]string)}
+	offsets.Learn(withGarbage)
+	assert.Equal(t, map[uint64]string{topicHash(&tx.Topic_name, tx.Topic_name_size): "orders"}, offsets.topics)
+}
+
+func TestPartitionOffsetsLag(t *testing.T) {
+	assert.Equal(t, int64(5), PartitionOffsets{HighWatermark: 15, FetchedOffset: 10, ProducedOffset: -1}.Lag())
+	assert.Equal(t, int64(0), PartitionOffsets{HighWatermark: 10, FetchedOffset: 12, ProducedOffset: -1}.Lag())
+	assert.Equal(t, int64(-1), PartitionOffsets{HighWatermark: -1, FetchedOffset: 10, ProducedOffset: 20}.Lag())
+	assert.Equal(t, int64(-1), PartitionOffsets{HighWatermark: 15, FetchedOffset: -1, ProducedOffset: -1}.Lag())
+}
+
+func TestSummarizeLag(t *testing.T) {
+	server := util.AddressFromString("10.0.0.1")
+	other := util.AddressFromString("10.0.0.2")
+	lagging, maxLag, totalLag := summarizeLag(map[PartitionKey]PartitionOffsets{
+		{Server: server, Port: 9092, Topic: "orders", Partition: 0}: {HighWatermark: 15, FetchedOffset: 10, ProducedOffset: -1},
+		{Server: server, Port: 9092, Topic: "orders", Partition: 1}: {HighWatermark: 10, FetchedOffset: 10, ProducedOffset: -1},
+		// the same topic name on another cluster
+		{Server: other, Port: 9092, Topic: "orders", Partition: 0}:   {HighWatermark: 30, FetchedOffset: 3, ProducedOffset: -1},
+		{Server: other, Port: 9092, Topic: "payments", Partition: 0}: {HighWatermark: -1, FetchedOffset: 3, ProducedOffset: 8},
+	})
+
+	assert.Equal(t, int64(2), lagging)
+	assert.Equal(t, int64(27), maxLag)
+	assert.Equal(t, int64(32), totalLag)
+}
+
+func TestLearnTopic(t *testing.T) {
+	offsets := &partitionOffsets{topics: make(map[uint64]string)}
+	tx := newTopicTx("orders")
+	offsets.Learn(tx)
+	offsets.Learn(&KafkaTransaction{})
+
+	assert.Equal(t, map[uint64]string{topicHash(&tx.Topic_name, tx.Topic_name_size): "orders"}, offsets.topics)
+}
@@ -9,11 +9,14 @@ package kafka
 
 import (
 	"io"
+	"slices"
 	"time"
 	"unsafe"
 
 	manager "github.com/DataDog/ebpf-manager"
 	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/asm"
+	"github.com/cilium/ebpf/features"
 	"github.com/davecgh/go-spew/spew"
 
 	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
@@ -32,6 +35,7 @@ type protocol struct {
 	statkeeper         *StatKeeper
 	inFlightMapCleaner *ddebpf.MapCleaner[KafkaTransactionKey, KafkaTransaction]
 	eventsConsumer     *events.Consumer[EbpfTx]
+	partitionOffsets   *partitionOffsets
 
 	kernelTelemetry            *kernelTelemetry
 	kernelTelemetryStopChannel chan struct{}
@@ -50,6 +54,11 @@ const (
 	produceResponsePartitionParserV0TailCall  = "socket__kafka_produce_response_partition_parser_v0"
 	produceResponsePartitionParserV9TailCall  = "socket__kafka_produce_response_partition_parser_v9"
 
+	fetchResponsePartitionParserV0LoopTailCall    = "socket__kafka_fetch_response_partition_parser_v0_loop"
+	fetchResponsePartitionParserV12LoopTailCall   = "socket__kafka_fetch_response_partition_parser_v12_loop"
+	fetchResponseRecordBatchParserV0LoopTailCall  = "socket__kafka_fetch_response_record_batch_parser_v0_loop"
+	fetchResponseRecordBatchParserV12LoopTailCall = "socket__kafka_fetch_response_record_batch_parser_v12_loop"
+
 	dispatcherTailCall = "socket__protocol_dispatcher_kafka"
 	kafkaHeapMap       = "kafka_heap"
 	inFlightMap        = "kafka_in_flight"
@@ -64,6 +73,11 @@ const (
 	tlsProduceResponsePartitionParserV0TailCall  = "uprobe__kafka_tls_produce_response_partition_parser_v0"
 	tlsProduceResponsePartitionParserV9TailCall  = "uprobe__kafka_tls_produce_response_partition_parser_v9"
 
+	tlsFetchResponsePartitionParserV0LoopTailCall    = "uprobe__kafka_tls_fetch_response_partition_parser_v0_loop"
+	tlsFetchResponsePartitionParserV12LoopTailCall   = "uprobe__kafka_tls_fetch_response_partition_parser_v12_loop"
+	tlsFetchResponseRecordBatchParserV0LoopTailCall  = "uprobe__kafka_tls_fetch_response_record_batch_parser_v0_loop"
+	tlsFetchResponseRecordBatchParserV12LoopTailCall = "uprobe__kafka_tls_fetch_response_record_batch_parser_v12_loop"
+
 	tlsTerminationTailCall = "uprobe__kafka_tls_termination"
 	tlsDispatcherTailCall  = "uprobe__tls_protocol_dispatcher_kafka"
 	// eBPFTelemetryMap is the name of the eBPF map used to retrieve metrics from the kernel
@@ -94,6 +108,9 @@ var Spec = &protocols.ProtocolSpec{
 		{
 			Name: eBPFTelemetryMap,
 		},
+		{
+			Name: partitionOffsetsMap,
+		},
 		{
 			Name: "kafka_batch_events",
 		},
@@ -240,6 +257,31 @@ var Spec = &protocols.ProtocolSpec{
 			},
 		},
 	},
+	// The bpf_loop variants of the fetch response parsers are routed by configureResponseParsers, they must not be
+	// loaded on kernels lacking bpf_loop when kafka is disabled.
+	ExcludedFunctions: []string{
+		fetchResponsePartitionParserV0LoopTailCall,
+		fetchResponsePartitionParserV12LoopTailCall,
+		fetchResponseRecordBatchParserV0LoopTailCall,
+		fetchResponseRecordBatchParserV12LoopTailCall,
+		tlsFetchResponsePartitionParserV0LoopTailCall,
+		tlsFetchResponsePartitionParserV12LoopTailCall,
+		tlsFetchResponseRecordBatchParserV0LoopTailCall,
+		tlsFetchResponseRecordBatchParserV12LoopTailCall,
+	},
+}
+
+// loopResponseParsers maps the fetch response parsers walking the partitions and the record batches with unrolled loops
+// to their variants using bpf_loop.
+var loopResponseParsers = map[string]string{
+	fetchResponsePartitionParserV0TailCall:       fetchResponsePartitionParserV0LoopTailCall,
+	fetchResponsePartitionParserV12TailCall:      fetchResponsePartitionParserV12LoopTailCall,
+	fetchResponseRecordBatchParserV0TailCall:     fetchResponseRecordBatchParserV0LoopTailCall,
+	fetchResponseRecordBatchParserV12TailCall:    fetchResponseRecordBatchParserV12LoopTailCall,
+	tlsFetchResponsePartitionParserV0TailCall:    tlsFetchResponsePartitionParserV0LoopTailCall,
+	tlsFetchResponsePartitionParserV12TailCall:   tlsFetchResponsePartitionParserV12LoopTailCall,
+	tlsFetchResponseRecordBatchParserV0TailCall:  tlsFetchResponseRecordBatchParserV0LoopTailCall,
+	tlsFetchResponseRecordBatchParserV12TailCall: tlsFetchResponseRecordBatchParserV12LoopTailCall,
 }
 
 func newKafkaProtocol(mgr *manager.Manager, cfg *config.Config) (protocols.Protocol, error) {
@@ -283,6 +325,39 @@ func (p *protocol) ConfigureOptions(opts *manager.Options) {
 	opts.ActivatedProbes = append(opts.ActivatedProbes, &manager.ProbeSelector{ProbeIdentificationPair: netifProbeID})
 	events.Configure(p.cfg, eventStreamName, p.mgr, opts)
 	utils.EnableOption(opts, "kafka_monitoring_enabled")
+	utils.AddBoolConst(opts, p.cfg.EnableKafkaPartitionOffsets, "kafka_partition_offsets_enabled")
+	if !p.cfg.EnableKafkaPartitionOffsets {
+		opts.MapSpecEditors[partitionOffsetsMap] = manager.MapSpecEditor{
+			MaxEntries: 1,
+			EditorFlag: manager.EditMaxEntries,
+		}
+	}
+	configureResponseParsers(opts, features.HaveProgramHelper(ebpf.SocketFilter, asm.FnLoop) == nil)
+}
+
+// configureResponseParsers selects the variant of the fetch response parsers to load. When the kernel supports
+// bpf_loop, the partitions and the record batches are walked in bpf_loop callbacks, bounded much higher than the
+// unrolled loops of the fallback parsers, so large responses are parsed with fewer tail calls. Both variants are
+// routed from the same program array keys.
+func configureResponseParsers(opts *manager.Options, useBPFLoop bool) {
+	if useBPFLoop {
+		// the routes are shared with the caller, which removes them on failure by name
+		opts.TailCallRouter = slices.Clone(opts.TailCallRouter)
+	}
+
+	for unrolled, loop := range loopResponseParsers {
+		if !useBPFLoop {
+			opts.ExcludedFunctions = append(opts.ExcludedFunctions, loop)
+			continue
+		}
+
+		opts.ExcludedFunctions = append(opts.ExcludedFunctions, unrolled)
+		for i := range opts.TailCallRouter {
+			if opts.TailCallRouter[i].ProbeIdentificationPair.EBPFFuncName == unrolled {
+				opts.TailCallRouter[i].ProbeIdentificationPair.EBPFFuncName = loop
+			}
+		}
+	}
 }
 
 // PreStart creates the kafka events consumer and starts it.
@@ -297,6 +372,13 @@ func (p *protocol) PreStart() error {
 		return err
 	}
 
+	if p.cfg.EnableKafkaPartitionOffsets {
+		p.partitionOffsets, err = newPartitionOffsets(p.mgr)
+		if err != nil {
+			return err
+		}
+	}
+
 	p.statkeeper = NewStatkeeper(p.cfg, p.telemetry)
 	p.eventsConsumer.Start()
 
@@ -340,6 +422,14 @@ func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
 		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
 			spew.Fdump(w, key, value)
 		}
+	case partitionOffsetsMap:
+		var key KafkaPartitionKey
+		var value KafkaPartitionOffsets
+		protocols.WriteMapDumpHeader(w, currentMap, mapName, key, value)
+		iter := currentMap.Iterate()
+		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+			spew.Fdump(w, key, value)
+		}
 	case eBPFTelemetryMap:
 		var zeroKey uint32
 
@@ -355,6 +445,9 @@ func (p *protocol) processKafka(events []EbpfTx) {
 	for i := range events {
 		tx := &events[i]
 		p.telemetry.Count(&tx.Transaction)
+		if p.partitionOffsets != nil {
+			p.partitionOffsets.Learn(&tx.Transaction)
+		}
 		p.statkeeper.Process(tx)
 	}
 }
@@ -423,6 +516,9 @@ func (p *protocol) setUpKernelTelemetryCollection() {
 					return
 				}
 				p.kernelTelemetry.update(rawTelemetry)
+				if p.partitionOffsets != nil {
+					p.partitionOffsets.UpdateTelemetry()
+				}
 			case <-p.kernelTelemetryStopChannel:
 				return
 			}
@@ -0,0 +1,66 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package kafka
+
+import (
+	"testing"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/stretchr/testify/assert"
+)
+
+func TestConfigureResponseParsers(t *testing.T) {
+	routedFunctions := func(opts *manager.Options) []string {
+		var names []string
+		for _, tc := range opts.TailCallRouter {
+			names = append(names, tc.ProbeIdentificationPair.EBPFFuncName)
+		}
+		return names
+	}
+
+	t.Run("unrolled loops", func(t *testing.T) {
+		opts := &manager.Options{TailCallRouter: Spec.TailCalls}
+		configureResponseParsers(opts, false)
+
+		assert.Equal(t, routedFunctions(&manager.Options{TailCallRouter: Spec.TailCalls}), routedFunctions(opts))
+		assert.ElementsMatch(t, []string{
+			fetchResponsePartitionParserV0LoopTailCall,
+			fetchResponsePartitionParserV12LoopTailCall,
+			fetchResponseRecordBatchParserV0LoopTailCall,
+			fetchResponseRecordBatchParserV12LoopTailCall,
+			tlsFetchResponsePartitionParserV0LoopTailCall,
+			tlsFetchResponsePartitionParserV12LoopTailCall,
+			tlsFetchResponseRecordBatchParserV0LoopTailCall,
+			tlsFetchResponseRecordBatchParserV12LoopTailCall,
+		}, opts.ExcludedFunctions)
+	})
+
+	t.Run("bpf_loop", func(t *testing.T) {
+		opts := &manager.Options{TailCallRouter: Spec.TailCalls}
+		configureResponseParsers(opts, true)
+
+		routed := routedFunctions(opts)
+		for unrolled, loop := range loopResponseParsers {
+			assert.NotContains(t, routed, unrolled)
+			assert.Contains(t, routed, loop)
+			assert.Contains(t, opts.ExcludedFunctions, unrolled)
+		}
+		// the produce parsers have no loop variant
+		assert.Contains(t, routed, produceResponsePartitionParserV9TailCall)
+		// the spec is left untouched
+		assert.Contains(t, routedFunctions(&manager.Options{TailCallRouter: Spec.TailCalls}), fetchResponsePartitionParserV0TailCall)
+	})
+}
+
+func TestLoopResponseParsersAreExcludedWithSpec(t *testing.T) {
+	var loops []string
+	for _, loop := range loopResponseParsers {
+		loops = append(loops, loop)
+	}
+	assert.ElementsMatch(t, loops, Spec.ExcludedFunctions)
+}
@@ -33,4 +33,7 @@ type KafkaTransaction C.kafka_transaction_t
 
 type KafkaResponseContext C.kafka_response_context_t
 
+type KafkaPartitionKey C.kafka_partition_key_t
+type KafkaPartitionOffsets C.kafka_partition_offsets_t
+
 type RawKernelTelemetry C.kafka_telemetry_t
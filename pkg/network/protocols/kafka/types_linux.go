@@ -50,22 +50,40 @@ type KafkaTransaction struct {
 }
 
 type KafkaResponseContext struct {
-	Transaction                 KafkaTransaction
-	Remainder_buf               [4]int8
-	Record_batches_num_bytes    int32
-	Record_batch_length         int32
-	Expected_tcp_seq            uint32
-	Carry_over_offset           int32
-	Partitions_count            uint32
-	Varint_value                uint32
-	Record_batches_arrays_idx   uint32
-	Record_batches_arrays_count uint32
-	State                       uint8
-	Remainder                   uint8
-	Varint_position             uint8
-	Partition_error_code        int8
-	Partition_state             uint8
-	Pad_cgo_0                   [7]byte
+	Transaction                    KafkaTransaction
+	Remainder_buf                  [4]int8
+	Record_batches_num_bytes       int32
+	Record_batch_length            int32
+	Expected_tcp_seq               uint32
+	Carry_over_offset              int32
+	Partitions_count               uint32
+	Varint_value                   uint32
+	Record_batches_arrays_idx      uint32
+	Record_batches_arrays_count    uint32
+	State                          uint8
+	Remainder                      uint8
+	Varint_position                uint8
+	Partition_error_code           int8
+	Partition_state                uint8
+	Pad_cgo_0                      [3]byte
+	Partition_index                int32
+	Record_batches_partition_index int32
+	Pad_cgo_1                      [4]byte
+}
+
+type KafkaPartitionKey struct {
+	Topic_hash uint64
+	Daddr_h    uint64
+	Daddr_l    uint64
+	Partition  int32
+	Dport      uint16
+	Pad        uint16
+}
+type KafkaPartitionOffsets struct {
+	High_watermark  int64
+	Fetched_offset  int64
+	Produced_offset int64
+	Last_updated    uint64
 }
 
 type RawKernelTelemetry struct {
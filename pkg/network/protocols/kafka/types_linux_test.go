@@ -28,6 +28,14 @@ func TestCgoAlignment_KafkaResponseContext(t *testing.T) {
 	ebpftest.TestCgoAlignment[KafkaResponseContext](t)
 }
 
+func TestCgoAlignment_KafkaPartitionKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[KafkaPartitionKey](t)
+}
+
+func TestCgoAlignment_KafkaPartitionOffsets(t *testing.T) {
+	ebpftest.TestCgoAlignment[KafkaPartitionOffsets](t)
+}
+
 func TestCgoAlignment_RawKernelTelemetry(t *testing.T) {
 	ebpftest.TestCgoAlignment[RawKernelTelemetry](t)
 }
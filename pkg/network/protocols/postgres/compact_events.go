@@ -0,0 +1,159 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package postgres
+
+import (
+	"encoding/binary"
+	"sync"
+
+	manager "github.com/DataDog/ebpf-manager"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/postgres/ebpf"
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+)
+
+const (
+	compactEventStream = "postgres_compact"
+	queriesMap         = "postgres_queries"
+
+	// maxCachedQueries bounds the queries cached in userspace, twice the size of
+	// postgres_queries
+	maxCachedQueries = 4096
+
+	// FNV-1a parameters, see postgres_query_hash in the eBPF decoder
+	queryHashOffset = 14695981039346656037
+	queryHashPrime  = 1099511628211
+)
+
+// parsedQuery holds the operation and the parameters extracted from a query
+type parsedQuery struct {
+	operation  Operation
+	parameters string
+}
+
+// unknownQuery is reported for the transactions whose query was evicted from
+// postgres_queries before we read it, rather than dropping them from the stats
+var unknownQuery = parsedQuery{operation: UnknownOP, parameters: "UNKNOWN"}
+
+// compactEventsDecoder turns the compact events sent by eBPF back into EventWrapper.
+// Compact events carry the fingerprint of the query rather than the query fragment, eBPF
+// only sends the fragment, as a full event, the first time it sees a fingerprint. The
+// operation and the parameters of each query are cached by fingerprint, so that queries
+// are only parsed once rather than once per transaction.
+type compactEventsDecoder struct {
+	queries *maps.GenericMap[uint64, ebpf.EbpfQuery]
+	// queries already parsed, by fingerprint. Full and compact events are consumed by
+	// different goroutines, hence the mutex.
+	parsedMutex sync.Mutex
+	parsed      map[uint64]parsedQuery
+
+	// reused across events, the stat keeper copies what it keeps
+	tx      ebpf.EbpfEvent
+	wrapper EventWrapper
+
+	// queries evicted from postgres_queries before we read them, whose transactions are
+	// reported under unknownQuery
+	unknownQuery *libtelemetry.Counter
+}
+
+func newCompactEventsDecoder(mgr *manager.Manager, telemetry *Telemetry) (*compactEventsDecoder, error) {
+	queries, err := maps.GetMap[uint64, ebpf.EbpfQuery](mgr, queriesMap)
+	if err != nil {
+		return nil, err
+	}
+
+	return &compactEventsDecoder{
+		queries:      queries,
+		parsed:       make(map[uint64]parsedQuery),
+		unknownQuery: telemetry.metricGroup.NewCounter("compact_events", "type:unknown-query"),
+	}, nil
+}
+
+// Learn caches the operation and the parameters of the query of a full event, for the
+// compact events of the transactions running the same query.
+func (d *compactEventsDecoder) Learn(tx *EventWrapper) {
+	if tx.Tx.Original_query_size == 0 {
+		return
+	}
+	hash := queryHash(&tx.Tx)
+	if _, ok := d.lookup(hash); ok {
+		return
+	}
+	d.store(hash, parsedQuery{operation: tx.Operation(), parameters: tx.Parameters()})
+}
+
+// Decode returns the transaction held in the given compact event, and whether its query is
+// known. Transactions whose query is unknown are reported under unknownQuery. The returned
+// event is only valid until the next call, and Decode must not be called concurrently.
+func (d *compactEventsDecoder) Decode(event *ebpf.EbpfCompactEvent) (*EventWrapper, bool) {
+	d.tx = ebpf.EbpfEvent{
+		Tuple: event.Tuple,
+		Tx: ebpf.EbpfTx{
+			Request_started:     event.Request_started,
+			Response_last_seen:  event.Response_last_seen,
+			Original_query_size: event.Original_query_size,
+			Tags:                event.Tags,
+		},
+	}
+
+	query, ok := d.lookup(event.Query_hash)
+	if !ok {
+		var fragment ebpf.EbpfQuery
+		if d.queries != nil && d.queries.Lookup(&event.Query_hash, &fragment) == nil {
+			d.tx.Tx.Request_fragment = fragment.Request_fragment
+			wrapper := NewEventWrapper(&d.tx)
+			query = parsedQuery{operation: wrapper.Operation(), parameters: wrapper.Parameters()}
+			d.store(event.Query_hash, query)
+			ok = true
+		} else {
+			d.unknownQuery.Add(1)
+			query = unknownQuery
+		}
+	}
+
+	d.wrapper = EventWrapper{
+		EbpfEvent:     &d.tx,
+		operationSet:  true,
+		operation:     query.operation,
+		parametersSet: true,
+		parameters:    query.parameters,
+	}
+	return &d.wrapper, ok
+}
+
+func (d *compactEventsDecoder) lookup(hash uint64) (parsedQuery, bool) {
+	d.parsedMutex.Lock()
+	defer d.parsedMutex.Unlock()
+	query, ok := d.parsed[hash]
+	return query, ok
+}
+
+func (d *compactEventsDecoder) store(hash uint64, query parsedQuery) {
+	d.parsedMutex.Lock()
+	defer d.parsedMutex.Unlock()
+	if len(d.parsed) >= maxCachedQueries {
+		clear(d.parsed)
+	}
+	d.parsed[hash] = query
+}
+
+// queryHash returns the fingerprint eBPF computes for the query of the given transaction:
+// the FNV-1a hash of the query fragment, taken 8 bytes at a time.
+func queryHash(tx *ebpf.EbpfTx) uint64 {
+	fragment := getFragment(tx)
+	hash := uint64(queryHashOffset)
+	for len(fragment) > 0 {
+		var word [8]byte
+		n := copy(word[:], fragment)
+		fragment = fragment[n:]
+		hash ^= binary.LittleEndian.Uint64(word[:])
+		hash *= queryHashPrime
+	}
+	return hash
+}
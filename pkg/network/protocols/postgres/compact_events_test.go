@@ -0,0 +1,84 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package postgres
+
+import (
+	"strings"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/postgres/ebpf"
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+)
+
+func newQueryTx(query string) ebpf.EbpfTx {
+	return ebpf.EbpfTx{
+		Request_fragment:    requestFragment([]byte(query)),
+		Original_query_size: uint32(len(query)),
+	}
+}
+
+func TestQueryHash(t *testing.T) {
+	query := "SELECT * FROM dummy WHERE id = $1"
+	tx := newQueryTx(query)
+
+	// the bytes following the query aren't part of the fingerprint
+	withTrailer := newQueryTx(query + "Sxxxx")
+	withTrailer.Original_query_size = uint32(len(query))
+	assert.Equal(t, queryHash(&tx), queryHash(&withTrailer))
+
+	other := newQueryTx("SELECT * FROM dummy WHERE id = $2")
+	assert.NotEqual(t, queryHash(&tx), queryHash(&other))
+
+	// queries longer than the buffer are fingerprinted by their fragment
+	long := "SELECT * FROM dummy WHERE name = '" + strings.Repeat("a", ebpf.BufferSize) + "'"
+	longTx := newQueryTx(long)
+	truncated := newQueryTx(long[:ebpf.BufferSize])
+	assert.Equal(t, queryHash(&longTx), queryHash(&truncated))
+}
+
+func TestDecodeCompactEvent(t *testing.T) {
+	decoder := &compactEventsDecoder{
+		parsed:       make(map[uint64]parsedQuery),
+		unknownQuery: libtelemetry.NewCounter("usm.postgres.compact_events", "type:unknown-query"),
+	}
+
+	query := "UPDATE dummy SET name = $1 WHERE id = $2"
+	full := &ebpf.EbpfEvent{Tx: newQueryTx(query)}
+	full.Tx.Tags = 1
+	decoder.Learn(NewEventWrapper(full))
+
+	event := &ebpf.EbpfCompactEvent{
+		Request_started:     100,
+		Response_last_seen:  250,
+		Query_hash:          queryHash(&full.Tx),
+		Original_query_size: uint32(len(query)),
+		Tags:                1,
+	}
+	event.Tuple.Sport = 5432
+
+	tx, known := decoder.Decode(event)
+	require.True(t, known)
+	assert.Equal(t, UpdateOP, tx.Operation())
+	assert.Equal(t, "dummy", tx.Parameters())
+	assert.Equal(t, uint16(5432), tx.ConnTuple().SrcPort)
+	assert.Equal(t, uint8(1), tx.Tx.Tags)
+	assert.Equal(t, float64(150), tx.RequestLatency())
+
+	t.Run("unknown query", func(t *testing.T) {
+		event.Query_hash++
+		tx, known := decoder.Decode(event)
+		assert.False(t, known)
+		assert.Equal(t, UnknownOP, tx.Operation())
+		assert.Equal(t, "UNKNOWN", tx.Parameters())
+		assert.Equal(t, float64(150), tx.RequestLatency())
+		assert.Equal(t, int64(1), decoder.unknownQuery.Get())
+	})
+}
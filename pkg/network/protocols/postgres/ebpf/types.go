@@ -20,6 +20,8 @@ type ConnTuple = C.conn_tuple_t
 
 type EbpfEvent C.postgres_event_t
 type EbpfTx C.postgres_transaction_t
+type EbpfCompactEvent C.postgres_compact_event_t
+type EbpfQuery C.postgres_query_t
 type PostgresKernelMsgCount C.postgres_kernel_msg_count_t
 
 const (
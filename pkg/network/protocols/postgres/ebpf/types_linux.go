@@ -27,6 +27,18 @@ type EbpfTx struct {
 	Tags                uint8
 	Pad_cgo_0           [3]byte
 }
+type EbpfCompactEvent struct {
+	Tuple               ConnTuple
+	Request_started     uint64
+	Response_last_seen  uint64
+	Query_hash          uint64
+	Original_query_size uint32
+	Tags                uint8
+	Pad_cgo_0           [3]byte
+}
+type EbpfQuery struct {
+	Request_fragment [160]byte
+}
 type PostgresKernelMsgCount struct {
 	Reached_max_messages uint64
 	Fragmented_packets   uint64
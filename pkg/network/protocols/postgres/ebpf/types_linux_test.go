@@ -16,6 +16,14 @@ func TestCgoAlignment_EbpfTx(t *testing.T) {
 	ebpftest.TestCgoAlignment[EbpfTx](t)
 }
 
+func TestCgoAlignment_EbpfCompactEvent(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfCompactEvent](t)
+}
+
+func TestCgoAlignment_EbpfQuery(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfQuery](t)
+}
+
 func TestCgoAlignment_PostgresKernelMsgCount(t *testing.T) {
 	ebpftest.TestCgoAlignment[PostgresKernelMsgCount](t)
 }
@@ -58,6 +58,10 @@ type protocol struct {
 	kernelTelemetry       *kernelTelemetry // retrieves Postgres metrics from kernel
 	kernelTelemetryStopCh chan struct{}
 	mgr                   *manager.Manager
+	// compactEventsConsumer and compactEventsDecoder are only set when eBPF sends
+	// compact events
+	compactEventsConsumer *events.Consumer[postgresebpf.EbpfCompactEvent]
+	compactEventsDecoder  *compactEventsDecoder
 }
 
 // Spec is the protocol spec for the postgres protocol.
@@ -82,6 +86,21 @@ var Spec = &protocols.ProtocolSpec{
 		{
 			Name: "postgres_batches",
 		},
+		{
+			Name: "postgres_compact_scratch_buffer",
+		},
+		{
+			Name: "postgres_compact_batch_events",
+		},
+		{
+			Name: "postgres_compact_batch_state",
+		},
+		{
+			Name: "postgres_compact_batches",
+		},
+		{
+			Name: queriesMap,
+		},
 	},
 	Probes: []*manager.Probe{
 		{
@@ -186,8 +205,19 @@ func (p *protocol) ConfigureOptions(opts *manager.Options) {
 	}
 	opts.ActivatedProbes = append(opts.ActivatedProbes, &manager.ProbeSelector{ProbeIdentificationPair: netifProbeID})
 	utils.EnableOption(opts, "postgres_monitoring_enabled")
-	// Configure event stream
+	// Configure event streams
 	events.Configure(p.cfg, eventStream, p.mgr, opts)
+	if p.cfg.EnablePostgresCompactEvents {
+		utils.EnableOption(opts, "postgres_compact_monitoring_enabled")
+		events.Configure(p.cfg, compactEventStream, p.mgr, opts)
+	} else {
+		for _, name := range []string{queriesMap, "postgres_compact_batches"} {
+			opts.MapSpecEditors[name] = manager.MapSpecEditor{
+				MaxEntries: 1,
+				EditorFlag: manager.EditMaxEntries,
+			}
+		}
+	}
 }
 
 // PreStart runs setup required before starting the protocol.
@@ -201,7 +231,25 @@ func (p *protocol) PreStart() (err error) {
 		return
 	}
 
+	if p.cfg.EnablePostgresCompactEvents {
+		p.compactEventsDecoder, err = newCompactEventsDecoder(p.mgr, p.telemetry)
+		if err != nil {
+			return
+		}
+		p.compactEventsConsumer, err = events.NewConsumer(
+			compactEventStream,
+			p.mgr,
+			p.processCompactPostgres,
+		)
+		if err != nil {
+			return
+		}
+	}
+
 	p.eventsConsumer.Start()
+	if p.compactEventsConsumer != nil {
+		p.compactEventsConsumer.Start()
+	}
 
 	return
 }
@@ -222,6 +270,9 @@ func (p *protocol) Stop() {
 	if p.eventsConsumer != nil {
 		p.eventsConsumer.Stop()
 	}
+	if p.compactEventsConsumer != nil {
+		p.compactEventsConsumer.Stop()
+	}
 	if p.kernelTelemetryStopCh != nil {
 		close(p.kernelTelemetryStopCh)
 	}
@@ -259,6 +310,9 @@ func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
 // GetStats returns a map of Postgres stats and a callback to clean resources.
 func (p *protocol) GetStats() (*protocols.ProtocolStats, func()) {
 	p.eventsConsumer.Sync()
+	if p.compactEventsConsumer != nil {
+		p.compactEventsConsumer.Sync()
+	}
 	p.kernelTelemetry.Log()
 
 	stats := p.statskeeper.GetAndResetAllStats()
@@ -283,6 +337,20 @@ func (p *protocol) processPostgres(events []postgresebpf.EbpfEvent) {
 		eventWrapper := NewEventWrapper(tx)
 		p.statskeeper.Process(eventWrapper)
 		p.telemetry.Count(tx, eventWrapper)
+		if p.compactEventsDecoder != nil {
+			p.compactEventsDecoder.Learn(eventWrapper)
+		}
+	}
+}
+
+func (p *protocol) processCompactPostgres(events []postgresebpf.EbpfCompactEvent) {
+	for i := range events {
+		eventWrapper, known := p.compactEventsDecoder.Decode(&events[i])
+		p.statskeeper.Process(eventWrapper)
+		// unknown queries are counted by the decoder, not as failed extractions
+		if known {
+			p.telemetry.Count(eventWrapper.EbpfEvent, eventWrapper)
+		}
 	}
 }
 
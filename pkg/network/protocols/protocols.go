@@ -86,4 +86,8 @@ type ProtocolSpec struct {
 	Maps      []*manager.Map
 	Probes    []*manager.Probe
 	TailCalls []manager.TailCallRoute
+	// ExcludedFunctions lists the programs of the protocol that are neither probes nor tail calls routed by default,
+	// such as variants selected by the protocol at runtime. They are excluded along with the protocol when it is
+	// disabled.
+	ExcludedFunctions []string
 }
@@ -0,0 +1,97 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2025-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package redis
+
+import (
+	manager "github.com/DataDog/ebpf-manager"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+const (
+	latencyAggregatesMap = "redis_latency_aggregates"
+	emptyLatencySketch   = "redis_empty_latency_sketch"
+)
+
+// latencyAggregator drains the latency histograms built in eBPF, by connection, command
+// and error, when in-kernel aggregation is enabled. The aggregates carry no key name, the
+// key names are sampled from the transactions eBPF still sends to userspace.
+type latencyAggregator struct {
+	aggregates *maps.GenericMap[EbpfAggregateKey, []EbpfLatencySketch]
+
+	// buffers reused across drains
+	keysToDelete []EbpfAggregateKey
+	latencies    []LatencyCount
+}
+
+func newLatencyAggregator(mgr *manager.Manager) (*latencyAggregator, error) {
+	aggregates, err := maps.GetMap[EbpfAggregateKey, []EbpfLatencySketch](mgr, latencyAggregatesMap)
+	if err != nil {
+		return nil, err
+	}
+	return &latencyAggregator{aggregates: aggregates}, nil
+}
+
+// Drain hands the aggregates built in eBPF to the stat keeper and removes them from the
+// eBPF map.
+func (a *latencyAggregator) Drain(statskeeper *StatsKeeper) {
+	var key EbpfAggregateKey
+	var sketches []EbpfLatencySketch
+	a.keysToDelete = a.keysToDelete[:0]
+	iter := a.aggregates.Iterate()
+	for iter.Next(&key, &sketches) {
+		a.keysToDelete = append(a.keysToDelete, key)
+
+		// fold the per-CPU histograms
+		var buckets [LatencyBuckets]int
+		var tags uint8
+		for i := range sketches {
+			tags |= sketches[i].Tags
+			for b, count := range sketches[i].Buckets {
+				buckets[b] += int(count)
+			}
+		}
+
+		a.latencies = a.latencies[:0]
+		for b, count := range buckets {
+			if count > 0 {
+				a.latencies = append(a.latencies, LatencyCount{Latency: latencyBucketValue(b), Count: count})
+			}
+		}
+		if len(a.latencies) == 0 {
+			continue
+		}
+
+		tx := NewEventWrapper(&EbpfEvent{
+			Tuple: key.Tuple,
+			Tx: EbpfTx{
+				Command:  key.Command,
+				Is_error: key.Is_error,
+				Tags:     tags,
+			},
+		})
+		statskeeper.ProcessAggregate(tx, a.latencies)
+	}
+	if err := iter.Err(); err != nil {
+		log.Warnf("failed to iterate over %s: %s", latencyAggregatesMap, err)
+	}
+
+	// Transactions folded between the lookup above and the deletion below are lost,
+	// this is the price of draining the map without stopping eBPF.
+	for i := range a.keysToDelete {
+		_ = a.aggregates.Delete(&a.keysToDelete[i])
+	}
+}
+
+// latencyBucketValue returns the latency, in nanoseconds, representing the given bucket
+// of the histograms built in eBPF.
+func latencyBucketValue(bucket int) float64 {
+	return protocols.LatencyBucketValue(bucket, LatencyMinExponent, LatencySubBucketBits)
+}
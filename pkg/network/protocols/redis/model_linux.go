@@ -105,6 +105,38 @@ func (c CommandType) String() string {
 		return "GET"
 	case SetCommand:
 		return "SET"
+	case HgetCommand:
+		return "HGET"
+	case HsetCommand:
+		return "HSET"
+	case HgetallCommand:
+		return "HGETALL"
+	case MgetCommand:
+		return "MGET"
+	case MsetCommand:
+		return "MSET"
+	case DelCommand:
+		return "DEL"
+	case ExistsCommand:
+		return "EXISTS"
+	case IncrCommand:
+		return "INCR"
+	case ExpireCommand:
+		return "EXPIRE"
+	case LpushCommand:
+		return "LPUSH"
+	case RpushCommand:
+		return "RPUSH"
+	case LpopCommand:
+		return "LPOP"
+	case RpopCommand:
+		return "RPOP"
+	case SaddCommand:
+		return "SADD"
+	case ZaddCommand:
+		return "ZADD"
+	case EvalshaCommand:
+		return "EVALSHA"
 	default:
 		return "UNKNOWN"
 	}
@@ -29,6 +29,7 @@ import (
 
 const (
 	inFlightMap            = "redis_in_flight"
+	emptyPipelineMap       = "redis_empty_pipeline"
 	processTailCall        = "socket__redis_process"
 	tlsProcessTailCall     = "uprobe__redis_tls_process"
 	tlsTerminationTailCall = "uprobe__redis_tls_termination"
@@ -40,9 +41,11 @@ const (
 type protocol struct {
 	cfg            *config.Config
 	eventsConsumer *events.Consumer[EbpfEvent]
-	mapCleaner     *ddebpf.MapCleaner[netebpf.ConnTuple, EbpfTx]
+	mapCleaner     *ddebpf.MapCleaner[netebpf.ConnTuple, EbpfPipeline]
 	statskeeper    *StatsKeeper
 	mgr            *manager.Manager
+	// aggregator is only set when in-kernel aggregation is enabled
+	aggregator *latencyAggregator
 }
 
 // Spec is the protocol spec for the redis protocol.
@@ -50,6 +53,9 @@ var Spec = &protocols.ProtocolSpec{
 	Factory: newRedisProtocol,
 	Maps: []*manager.Map{
 		{Name: inFlightMap},
+		{Name: emptyPipelineMap},
+		{Name: latencyAggregatesMap},
+		{Name: emptyLatencySketch},
 	},
 	Probes: []*manager.Probe{
 		{
@@ -126,6 +132,21 @@ func (p *protocol) ConfigureOptions(opts *manager.Options) {
 	}
 	opts.ActivatedProbes = append(opts.ActivatedProbes, &manager.ProbeSelector{ProbeIdentificationPair: netifProbeID})
 	utils.EnableOption(opts, "redis_monitoring_enabled")
+	utils.AddBoolConst(opts, p.cfg.EnableRedisKernelAggregation, "redis_aggregation_enabled")
+	utils.AddBoolConst(opts, p.cfg.EnableRedisKernelAggregation && p.cfg.EnableUSMConnectionRollup, "redis_aggregation_rollup_enabled")
+	aggregatesSize := uint32(1)
+	if p.cfg.EnableRedisKernelAggregation {
+		opts.ConstantEditors = append(opts.ConstantEditors, manager.ConstantEditor{
+			Name:  "redis_key_sampling_rate",
+			Value: uint64(max(p.cfg.RedisKeySamplingRate, 0)),
+		})
+		// userspace can't hold more stats than MaxRedisStatsBuffered anyway
+		aggregatesSize = uint32(max(min(p.cfg.MaxRedisKernelAggregates, p.cfg.MaxRedisStatsBuffered), 1))
+	}
+	opts.MapSpecEditors[latencyAggregatesMap] = manager.MapSpecEditor{
+		MaxEntries: aggregatesSize,
+		EditorFlag: manager.EditMaxEntries,
+	}
 	events.Configure(p.cfg, eventStream, p.mgr, opts)
 }
 
@@ -140,6 +161,13 @@ func (p *protocol) PreStart() (err error) {
 		return
 	}
 
+	if p.cfg.EnableRedisKernelAggregation {
+		p.aggregator, err = newLatencyAggregator(p.mgr)
+		if err != nil {
+			return
+		}
+	}
+
 	p.eventsConsumer.Start()
 	return
 }
@@ -163,9 +191,9 @@ func (p *protocol) Stop() {
 
 // DumpMaps dumps map contents for debugging.
 func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
-	if mapName == inFlightMap { // maps/redis_in_flight (BPF_MAP_TYPE_HASH), key ConnTuple, value EbpfTx
+	if mapName == inFlightMap { // maps/redis_in_flight (BPF_MAP_TYPE_HASH), key ConnTuple, value EbpfPipeline
 		var key netebpf.ConnTuple
-		var value EbpfTx
+		var value EbpfPipeline
 		protocols.WriteMapDumpHeader(w, currentMap, mapName, key, value)
 		iter := currentMap.Iterate()
 		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
@@ -177,6 +205,9 @@ func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
 // GetStats returns a map of Redis stats and a callback to clean resources.
 func (p *protocol) GetStats() (*protocols.ProtocolStats, func()) {
 	p.eventsConsumer.Sync()
+	if p.aggregator != nil {
+		p.aggregator.Drain(p.statskeeper)
+	}
 
 	keysToStats := p.statskeeper.GetAndResetAllStats()
 	return &protocols.ProtocolStats{
@@ -209,7 +240,7 @@ func (p *protocol) setupMapCleaner() {
 		return
 	}
 
-	mapCleaner, err := ddebpf.NewMapCleaner[netebpf.ConnTuple, EbpfTx](redisInFlight, protocols.DefaultMapCleanerBatchSize, inFlightMap, "usm_monitor")
+	mapCleaner, err := ddebpf.NewMapCleaner[netebpf.ConnTuple, EbpfPipeline](redisInFlight, protocols.DefaultMapCleanerBatchSize, inFlightMap, "usm_monitor")
 	if err != nil {
 		log.Errorf("error creating map cleaner: %s", err)
 		return
@@ -217,14 +248,20 @@ func (p *protocol) setupMapCleaner() {
 
 	// Clean up idle connections. We currently use the same TTL as HTTP, but we plan to rename this variable to be more generic.
 	ttl := p.cfg.HTTPIdleConnectionTTL.Nanoseconds()
-	mapCleaner.Clean(p.cfg.HTTPMapCleanerInterval, nil, nil, func(now int64, _ netebpf.ConnTuple, val EbpfTx) bool {
-		if updated := int64(val.Response_last_seen); updated > 0 {
-			return (now - updated) > ttl
-		}
-
-		started := int64(val.Request_started)
-		return started > 0 && (now-started) > ttl
+	mapCleaner.Clean(p.cfg.HTTPMapCleanerInterval, nil, nil, func(now int64, _ netebpf.ConnTuple, val EbpfPipeline) bool {
+		updated := val.lastSeen()
+		return updated > 0 && (now-updated) > ttl
 	})
 
 	p.mapCleaner = mapCleaner
 }
+
+// lastSeen returns the time of the latest request or reply of the pipeline, or 0 if unknown. The
+// transactions already answered are taken into account as well, since they are older.
+func (p *EbpfPipeline) lastSeen() int64 {
+	var lastSeen uint64
+	for i := range p.Transactions {
+		lastSeen = max(lastSeen, p.Transactions[i].Request_started, p.Transactions[i].Response_last_seen)
+	}
+	return int64(lastSeen)
+}
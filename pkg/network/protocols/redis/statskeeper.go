@@ -58,6 +58,41 @@ func (s *StatsKeeper) Process(event *EventWrapper) {
 	requestStats.AddRequest(event.Tx.Is_error, count, uint64(event.Tx.Tags), event.RequestLatency())
 }
 
+// ProcessAggregate adds transactions aggregated in eBPF to the stats. They share the
+// connection, command and error of tx, and have the given latencies. Aggregates carry no
+// key name.
+func (s *StatsKeeper) ProcessAggregate(tx *EventWrapper, latencies []LatencyCount) {
+	if tx.CommandType() >= maxCommand {
+		return
+	}
+
+	s.statsMutex.Lock()
+	defer s.statsMutex.Unlock()
+
+	key := Key{
+		Command:       tx.CommandType(),
+		ConnectionKey: tx.ConnTuple(),
+	}
+
+	requestStats, ok := s.stats[key]
+	if !ok {
+		if len(s.stats) >= s.maxEntries {
+			return
+		}
+		requestStats = NewRequestStats()
+		s.stats[key] = requestStats
+	}
+	for _, l := range latencies {
+		requestStats.AddRequest(tx.Tx.Is_error, l.Count, uint64(tx.Tx.Tags), l.Latency)
+	}
+}
+
+// LatencyCount is the number of transactions sharing a latency, in nanoseconds
+type LatencyCount struct {
+	Latency float64
+	Count   int
+}
+
 // GetAndResetAllStats returns all the records and resets the statskeeper
 func (s *StatsKeeper) GetAndResetAllStats() map[Key]*RequestStats {
 	s.statsMutex.RLock()
@@ -82,6 +82,38 @@ func TestProcessRedisTransactions(t *testing.T) {
 	}
 }
 
+func TestProcessRedisAggregate(t *testing.T) {
+	cfg := &config.Config{MaxRedisStatsBuffered: 1000}
+	sk := NewStatsKeeper(cfg)
+	sourceIP, destIP, sourcePort, destPort := generateAddresses()
+
+	// the sampled transaction, sent to userspace with its key name
+	sk.Process(NewEventWrapper(generateRedisTransaction(sourceIP, destIP, sourcePort, destPort, uint8(HgetCommand), "key", false, time.Millisecond)))
+
+	aggregate := generateRedisTransaction(sourceIP, destIP, sourcePort, destPort, uint8(HgetCommand), "", false, 0)
+	aggregate.Tx.Tags = 1
+	sk.ProcessAggregate(NewEventWrapper(aggregate), []LatencyCount{
+		{Latency: float64(time.Millisecond), Count: 3},
+		{Latency: float64(2 * time.Millisecond), Count: 2},
+	})
+
+	stats := sk.GetAndResetAllStats()
+	require.Len(t, stats, 2)
+
+	key := Key{Command: HgetCommand, ConnectionKey: NewEventWrapper(aggregate).ConnTuple()}
+	require.Contains(t, stats, key)
+	s := stats[key].ErrorToStats[false]
+	require.NotNil(t, s)
+	assert.Equal(t, 5, s.Count)
+	assert.Equal(t, uint64(1), s.StaticTags)
+	require.NotNil(t, s.Latencies)
+	assert.Equal(t, float64(5), s.Latencies.GetCount())
+
+	key.KeyName = "key"
+	require.Contains(t, stats, key)
+	assert.Equal(t, 1, stats[key].ErrorToStats[false].Count)
+}
+
 func generateAddresses() (util.Address, util.Address, int, int) {
 	srcString := "1.1.1.1"
 	dstString := "2.2.2.2"
@@ -21,8 +21,33 @@ var (
 	UnknownCommand = CommandType(C.REDIS_UNKNOWN)
 	GetCommand     = CommandType(C.REDIS_GET)
 	SetCommand     = CommandType(C.REDIS_SET)
+	HgetCommand    = CommandType(C.REDIS_HGET)
+	HsetCommand    = CommandType(C.REDIS_HSET)
+	HgetallCommand = CommandType(C.REDIS_HGETALL)
+	MgetCommand    = CommandType(C.REDIS_MGET)
+	MsetCommand    = CommandType(C.REDIS_MSET)
+	DelCommand     = CommandType(C.REDIS_DEL)
+	ExistsCommand  = CommandType(C.REDIS_EXISTS)
+	IncrCommand    = CommandType(C.REDIS_INCR)
+	ExpireCommand  = CommandType(C.REDIS_EXPIRE)
+	LpushCommand   = CommandType(C.REDIS_LPUSH)
+	RpushCommand   = CommandType(C.REDIS_RPUSH)
+	LpopCommand    = CommandType(C.REDIS_LPOP)
+	RpopCommand    = CommandType(C.REDIS_RPOP)
+	SaddCommand    = CommandType(C.REDIS_SADD)
+	ZaddCommand    = CommandType(C.REDIS_ZADD)
+	EvalshaCommand = CommandType(C.REDIS_EVALSHA)
 	maxCommand     = CommandType(C.__MAX_REDIS_COMMAND)
 )
 
 type EbpfEvent C.redis_event_t
 type EbpfTx C.redis_transaction_t
+type EbpfPipeline C.redis_pipeline_t
+type EbpfAggregateKey C.redis_aggregate_key_t
+type EbpfLatencySketch C.redis_latency_sketch_t
+
+const (
+	LatencyMinExponent   = C.USM_LATENCY_MIN_EXPONENT
+	LatencySubBucketBits = C.USM_LATENCY_SUB_BUCKET_BITS
+	LatencyBuckets       = C.USM_LATENCY_BUCKETS
+)
@@ -21,7 +21,23 @@ var (
 	UnknownCommand = CommandType(0x0)
 	GetCommand     = CommandType(0x1)
 	SetCommand     = CommandType(0x2)
-	maxCommand     = CommandType(0x3)
+	HgetCommand    = CommandType(0x3)
+	HsetCommand    = CommandType(0x4)
+	HgetallCommand = CommandType(0x5)
+	MgetCommand    = CommandType(0x6)
+	MsetCommand    = CommandType(0x7)
+	DelCommand     = CommandType(0x8)
+	ExistsCommand  = CommandType(0x9)
+	IncrCommand    = CommandType(0xa)
+	ExpireCommand  = CommandType(0xb)
+	LpushCommand   = CommandType(0xc)
+	RpushCommand   = CommandType(0xd)
+	LpopCommand    = CommandType(0xe)
+	RpopCommand    = CommandType(0xf)
+	SaddCommand    = CommandType(0x10)
+	ZaddCommand    = CommandType(0x11)
+	EvalshaCommand = CommandType(0x12)
+	maxCommand     = CommandType(0x13)
 )
 
 type EbpfEvent struct {
@@ -39,3 +55,27 @@ type EbpfTx struct {
 	Is_error           bool
 	Pad_cgo_0          [2]byte
 }
+type EbpfPipeline struct {
+	Transactions [4]EbpfTx
+	Head         uint8
+	Count        uint8
+	Pad          [6]uint8
+}
+type EbpfAggregateKey struct {
+	Tuple    ConnTuple
+	Command  uint8
+	Is_error bool
+	Pad      [6]uint8
+}
+type EbpfLatencySketch struct {
+	Count   uint32
+	Tags    uint8
+	Pad     [3]uint8
+	Buckets [104]uint32
+}
+
+const (
+	LatencyMinExponent   = 0xa
+	LatencySubBucketBits = 0x2
+	LatencyBuckets       = 0x68
+)
@@ -15,3 +15,15 @@ func TestCgoAlignment_EbpfEvent(t *testing.T) {
 func TestCgoAlignment_EbpfTx(t *testing.T) {
 	ebpftest.TestCgoAlignment[EbpfTx](t)
 }
+
+func TestCgoAlignment_EbpfPipeline(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfPipeline](t)
+}
+
+func TestCgoAlignment_EbpfAggregateKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfAggregateKey](t)
+}
+
+func TestCgoAlignment_EbpfLatencySketch(t *testing.T) {
+	ebpftest.TestCgoAlignment[EbpfLatencySketch](t)
+}
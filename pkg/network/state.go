@@ -1137,6 +1137,14 @@ func (a *connectionAggregator) dns(c *ConnectionStats) map[dns.Hostname]map[dns.
 		return stats
 	}
 
+	// the stats of the exchanges over UDP aggregated in eBPF are keyed without
+	// client port, they go to the first connection between the client and the server
+	key.ClientPort = 0
+	if stats, ok := a.dnsStats[key]; ok {
+		delete(a.dnsStats, key)
+		return stats
+	}
+
 	return nil
 }
 
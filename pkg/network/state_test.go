@@ -1683,6 +1683,44 @@ func TestDNSStatsWithMultipleClients(t *testing.T) {
 	assert.EqualValues(t, 3, rcode)
 }
 
+func TestDNSStatsWithoutClientPort(t *testing.T) {
+	conn := func(sport uint16) ConnectionStats {
+		return ConnectionStats{ConnectionTuple: ConnectionTuple{
+			Pid:    123,
+			Type:   UDP,
+			Family: AFINET,
+			Source: util.AddressFromString("10.0.0.1"),
+			Dest:   util.AddressFromString("10.0.0.2"),
+			SPort:  sport,
+			DPort:  53,
+		}, Cookie: StatCookie(sport), LastUpdateEpoch: latestEpochTime()}
+	}
+	c1, c2 := conn(1000), conn(1001)
+
+	// stats aggregated in eBPF are keyed without client port
+	dKey := dns.Key{ClientIP: c1.Source, ServerIP: c1.Dest, Protocol: getIPProtocol(c1.Type)}
+	stats := dns.StatsByKeyByNameByType{
+		dKey: {dns.ToHostname("foo.com"): {dns.TypeA: dns.Stats{CountByRcode: map[uint32]uint32{uint32(DNSResponseCodeNoError): 2}}}},
+	}
+
+	client := "client"
+	state := newDefaultState()
+	state.RegisterClient(client)
+
+	delta := state.GetDelta(client, latestEpochTime(), []ConnectionStats{c1, c2}, stats, nil)
+	require.Len(t, delta.Conns, 2)
+
+	// the stats go to a single connection
+	var withStats []ConnectionStats
+	for _, c := range delta.Conns {
+		if len(c.DNSStats) > 0 {
+			withStats = append(withStats, c)
+		}
+	}
+	require.Len(t, withStats, 1)
+	assert.EqualValues(t, 2, withStats[0].DNSStats[dns.ToHostname("foo.com")][dns.TypeA].CountByRcode[uint32(DNSResponseCodeNoError)])
+}
+
 func TestDetermineConnectionIntraHost(t *testing.T) {
 	tests := []struct {
 		name      string
@@ -17,6 +17,9 @@ const defaultExpiredStateInterval = 60 * time.Second
 
 type batchExtractor struct {
 	numCPUs int
+	// batchSize is the number of connections eBPF batches before flushing a batch, 0 for
+	// the whole capacity of the batch
+	batchSize uint16
 	// stateByCPU contains the state of each batch.
 	// The slice is indexed by the CPU core number.
 	stateByCPU           []percpuState
@@ -33,7 +36,7 @@ type batchState struct {
 	updated time.Time
 }
 
-func newBatchExtractor(numCPUs int) *batchExtractor {
+func newBatchExtractor(numCPUs int, batchSize uint16) *batchExtractor {
 	state := make([]percpuState, numCPUs)
 	for cpu := 0; cpu < numCPUs; cpu++ {
 		state[cpu] = percpuState{
@@ -42,6 +45,7 @@ func newBatchExtractor(numCPUs int) *batchExtractor {
 	}
 	return &batchExtractor{
 		numCPUs:              numCPUs,
+		batchSize:            batchSize,
 		stateByCPU:           state,
 		expiredStateInterval: defaultExpiredStateInterval,
 	}
@@ -55,35 +59,11 @@ func (e *batchExtractor) NumCPUs() int {
 // NextConnection returns the next unprocessed connection from the batch.
 // Returns nil if no more connections are left.
 func (e *batchExtractor) NextConnection(b *netebpf.Batch) *netebpf.Conn {
-	cpu := int(b.Cpu)
-	if cpu >= e.numCPUs {
-		return nil
-	}
-	if b.Len == 0 {
+	offset, ok := e.nextOffset(b.Cpu, b.Id, b.Len, netebpf.BatchSize)
+	if !ok {
 		return nil
 	}
 
-	batchID := b.Id
-	cpuState := &e.stateByCPU[cpu]
-	offset := uint16(0)
-	if bState, ok := cpuState.processed[batchID]; ok {
-		offset = bState.offset
-		if offset >= netebpf.BatchSize {
-			delete(cpuState.processed, batchID)
-			return nil
-		}
-		if offset >= b.Len {
-			return nil
-		}
-	}
-
-	defer func() {
-		cpuState.processed[batchID] = batchState{
-			offset:  offset + 1,
-			updated: time.Now(),
-		}
-	}()
-
 	switch offset {
 	case 0:
 		return &b.C0
@@ -98,6 +78,55 @@ func (e *batchExtractor) NextConnection(b *netebpf.Batch) *netebpf.Conn {
 	}
 }
 
+// NextRingBufferConnection returns the next unprocessed connection from the ring buffer batch.
+// Returns nil if no more connections are left.
+func (e *batchExtractor) NextRingBufferConnection(b *netebpf.RingBufferBatch) *netebpf.Conn {
+	offset, ok := e.nextOffset(b.Cpu, b.Id, b.Len, netebpf.RingBufferBatchSize)
+	if !ok {
+		return nil
+	}
+	return &b.C[offset]
+}
+
+// nextOffset returns the offset of the next unprocessed connection of the given batch, which
+// holds up to capacity connections, and marks it as processed. Once all the connections of a
+// complete batch are processed, its state is dropped: eBPF moves on to a new batch id.
+func (e *batchExtractor) nextOffset(cpu uint32, batchID uint64, length uint16, capacity uint16) (uint16, bool) {
+	if int(cpu) >= e.numCPUs {
+		return 0, false
+	}
+	if length == 0 {
+		return 0, false
+	}
+
+	cpuState := &e.stateByCPU[cpu]
+	offset := uint16(0)
+	if bState, ok := cpuState.processed[batchID]; ok {
+		offset = bState.offset
+		if offset >= length {
+			if length >= e.completeBatchLen(capacity) {
+				delete(cpuState.processed, batchID)
+			}
+			return 0, false
+		}
+	}
+
+	cpuState.processed[batchID] = batchState{
+		offset:  offset + 1,
+		updated: time.Now(),
+	}
+	return offset, true
+}
+
+// completeBatchLen returns the number of connections of a batch that is flushed by eBPF,
+// mirroring conn_close_batch_size.
+func (e *batchExtractor) completeBatchLen(capacity uint16) uint16 {
+	if e.batchSize == 0 || e.batchSize > capacity {
+		return capacity
+	}
+	return e.batchSize
+}
+
 // CleanupExpiredState removes entries from per-cpu state that haven't been updated in the last minute
 func (e *batchExtractor) CleanupExpiredState(now time.Time) {
 	for cpu := 0; cpu < len(e.stateByCPU); cpu++ {
@@ -22,7 +22,7 @@ const (
 
 func TestBatchExtract(t *testing.T) {
 	t.Run("normal flush", func(t *testing.T) {
-		extractor := newBatchExtractor(numTestCPUs)
+		extractor := newBatchExtractor(numTestCPUs, 0)
 
 		batch := new(netebpf.Batch)
 		batch.Len = 4
@@ -45,7 +45,7 @@ func TestBatchExtract(t *testing.T) {
 	})
 
 	t.Run("partial flush", func(t *testing.T) {
-		extractor := newBatchExtractor(numTestCPUs)
+		extractor := newBatchExtractor(numTestCPUs, 0)
 		// Simulate a partial flush
 		extractor.stateByCPU[0].processed = map[uint64]batchState{
 			0: {offset: 3},
@@ -67,4 +67,50 @@ func TestBatchExtract(t *testing.T) {
 		assert.Len(t, conns, 1)
 		assert.Equal(t, uint32(4), conns[0].Tup.Pid)
 	})
+
+	t.Run("ring buffer batch", func(t *testing.T) {
+		extractor := newBatchExtractor(numTestCPUs, 0)
+
+		batch := new(netebpf.RingBufferBatch)
+		batch.Len = netebpf.RingBufferBatchSize
+		batch.Id = 0
+		batch.Cpu = 1
+		for i := range batch.C {
+			batch.C[i].Tup.Pid = uint32(i + 1)
+		}
+
+		var conns []*netebpf.Conn
+		for rc := extractor.NextRingBufferConnection(batch); rc != nil; rc = extractor.NextRingBufferConnection(batch) {
+			conns = append(conns, rc)
+		}
+		require.Len(t, conns, netebpf.RingBufferBatchSize)
+		for i, c := range conns {
+			assert.Equal(t, uint32(i+1), c.Tup.Pid)
+		}
+	})
+
+	t.Run("state of complete batches is dropped", func(t *testing.T) {
+		extractor := newBatchExtractor(numTestCPUs, 8)
+
+		batch := new(netebpf.RingBufferBatch)
+		batch.Id = 0
+		batch.Cpu = 1
+
+		extract := func() int {
+			var conns int
+			for rc := extractor.NextRingBufferConnection(batch); rc != nil; rc = extractor.NextRingBufferConnection(batch) {
+				conns++
+			}
+			return conns
+		}
+
+		// an incomplete batch is tracked until eBPF flushes it
+		batch.Len = 5
+		assert.Equal(t, 5, extract())
+		assert.Contains(t, extractor.stateByCPU[1].processed, batch.Id)
+
+		batch.Len = 8
+		assert.Equal(t, 3, extract())
+		assert.NotContains(t, extractor.stateByCPU[1].processed, batch.Id)
+	})
 }
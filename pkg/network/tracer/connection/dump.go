@@ -112,6 +112,15 @@ func dumpMapsHandler(w io.Writer, _ *manager.Manager, mapName string, currentMap
 			spew.Fdump(w, key, value)
 		}
 
+	case probes.ConnCloseRingBufferBatchMap: // maps/conn_close_ringbuf_batch (BPF_MAP_TYPE_HASH), key C.__u32, value ringbuf_batch
+		io.WriteString(w, "Map: '"+mapName+"', key: 'C.__u32', value: 'ringbuf_batch'\n")
+		iter := currentMap.Iterate()
+		var key uint32
+		var value ddebpf.RingBufferBatch
+		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+			spew.Fdump(w, key, value)
+		}
+
 	case "udp_recv_sock": // maps/udp_recv_sock (BPF_MAP_TYPE_HASH), key C.__u64, value C.udp_recv_sock_t
 		io.WriteString(w, "Map: '"+mapName+"', key: 'C.__u64', value: 'C.udp_recv_sock_t'\n")
 		iter := currentMap.Iterate()
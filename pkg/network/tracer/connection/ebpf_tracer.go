@@ -18,6 +18,7 @@ import (
 	manager "github.com/DataDog/ebpf-manager"
 	"github.com/DataDog/ebpf-manager/tracefs"
 	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/link"
 	"github.com/prometheus/client_golang/prometheus"
 	"go.uber.org/atomic"
 	"golang.org/x/sys/unix"
@@ -36,6 +37,7 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/network/tracer/connection/util"
 	"github.com/DataDog/datadog-agent/pkg/telemetry"
 	"github.com/DataDog/datadog-agent/pkg/util/encoding"
+	netnsutil "github.com/DataDog/datadog-agent/pkg/util/kernel/netns"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 	ddsync "github.com/DataDog/datadog-agent/pkg/util/sync"
 )
@@ -195,11 +197,19 @@ func newEbpfTracer(config *config.Config, _ telemetryComponent.Component) (Trace
 		if err != nil {
 			return nil, fmt.Errorf("could not determine number of CPUs: %w", err)
 		}
-		extractor = newBatchExtractor(numCPUs)
+		extractor = newBatchExtractor(numCPUs, uint16(closedConnBatchSize(config)))
 		mgrOptions.MapSpecEditors[probes.ConnCloseBatchMap] = manager.MapSpecEditor{
 			MaxEntries: uint32(numCPUs),
 			EditorFlag: manager.EditMaxEntries,
 		}
+		mgrOptions.MapSpecEditors[probes.ConnCloseRingBufferBatchMap] = manager.MapSpecEditor{
+			MaxEntries: uint32(numCPUs),
+			EditorFlag: manager.EditMaxEntries,
+		}
+		mgrOptions.ConstantEditors = append(mgrOptions.ConstantEditors, manager.ConstantEditor{
+			Name:  "conn_close_batch_size",
+			Value: closedConnBatchSize(config),
+		})
 	}
 
 	tr := &ebpfTracer{
@@ -315,6 +325,15 @@ func initClosedConnEventHandler(config *config.Config, closedCallback func(*netw
 		handler = func(buf []byte) {
 			l := len(buf)
 			switch {
+			case l >= netebpf.SizeofRingBufferBatch:
+				b := netebpf.ToRingBufferBatch(buf)
+				for rc := extractor.NextRingBufferConnection(b); rc != nil; rc = extractor.NextRingBufferConnection(b) {
+					c := pool.Get()
+					c.FromConn(rc)
+					connHasher.Hash(c)
+
+					closedCallback(c)
+				}
 			case l >= netebpf.SizeofBatch:
 				b := netebpf.ToBatch(buf)
 				for rc := extractor.NextConnection(b); rc != nil; rc = extractor.NextConnection(b) {
@@ -346,6 +365,13 @@ func initClosedConnEventHandler(config *config.Config, closedCallback func(*netw
 		perf.RingBufferWakeupSize("ringbuffer_wakeup_size", uint64(config.ClosedBufferWakeupCount*(netebpf.SizeofConn+unix.BPF_RINGBUF_HDR_SZ))))
 }
 
+// closedConnBatchSize returns the number of closed connections batched in eBPF before
+// they are sent to userspace, 0 for the whole capacity of the batch. eBPF bounds it by the
+// capacity of the batch in use, which depends on whether ring buffers are available.
+func closedConnBatchSize(config *config.Config) uint64 {
+	return uint64(min(max(config.ClosedConnBatchSize, 0), netebpf.RingBufferBatchSize))
+}
+
 func boolConst(name string, value bool) manager.ConstantEditor {
 	c := manager.ConstantEditor{
 		Name:  name,
@@ -687,6 +713,17 @@ func (t *ebpfTracer) Type() TracerType {
 }
 
 func (t *ebpfTracer) initializePortBindingMaps() error {
+	seeded, err := t.seedPortBindingMaps()
+	if err != nil {
+		log.Warnf("failed to seed port binding maps with socket iterators, reading ports from %s instead: %s", t.config.ProcRoot, err)
+		// the iterators may have counted some of the ports already, start over so that
+		// the ports read from procfs are not counted twice
+		if err := t.clearPortBindingMaps(); err != nil {
+			return err
+		}
+	} else if seeded {
+		return nil
+	}
 	tcpPorts, err := network.ReadListeningPorts(t.config.ProcRoot, network.TCP, t.config.CollectTCPv6Conns)
 	if err != nil {
 		return fmt.Errorf("failed to read initial TCP pid->port mapping: %s", err)
@@ -732,6 +769,104 @@ func (t *ebpfTracer) initializePortBindingMaps() error {
 	return nil
 }
 
+// seedPortBindingMaps runs the socket iterators of the CO-RE tracers, which fill the port
+// binding maps in eBPF without reading procfs. It returns false when the iterators are not
+// available. This must be called before the probes are attached, since the iterators count
+// every socket they see. When an error is returned, the maps may have been partially seeded.
+func (t *ebpfTracer) seedPortBindingMaps() (bool, error) {
+	type portIter struct {
+		funcName probes.ProbeFuncName
+		iter     *link.Iter
+	}
+	var iters []portIter
+	defer func() {
+		for _, it := range iters {
+			it.iter.Close()
+		}
+	}()
+
+	for _, funcName := range []probes.ProbeFuncName{probes.TCPPortBindingsIter, probes.UDPPortBindingsIter} {
+		progs, ok, err := t.m.GetProgram(manager.ProbeIdentificationPair{EBPFFuncName: funcName})
+		if err != nil || !ok || len(progs) == 0 {
+			return false, nil
+		}
+
+		iter, err := link.AttachIter(link.IterOptions{Program: progs[0]})
+		if err != nil {
+			return false, fmt.Errorf("error attaching %s: %w", funcName, err)
+		}
+		iters = append(iters, portIter{funcName: funcName, iter: iter})
+	}
+
+	// socket iterators only walk the sockets of the network namespace they are opened
+	// from, so they are run from every network namespace, like the procfs scan
+	nss, err := netnsutil.GetNetNamespaces(t.config.ProcRoot)
+	if err != nil {
+		return false, fmt.Errorf("could not get network namespaces: %w", err)
+	}
+	defer func() {
+		for _, ns := range nss {
+			ns.Close()
+		}
+	}()
+
+	for _, ns := range nss {
+		err := netnsutil.WithNS(ns, func() error {
+			for _, it := range iters {
+				if err := runIterator(it.iter); err != nil {
+					return fmt.Errorf("error running %s: %w", it.funcName, err)
+				}
+			}
+			return nil
+		})
+		if err != nil {
+			return false, err
+		}
+	}
+	return true, nil
+}
+
+// runIterator walks the objects of the given BPF iterator once, in the network namespace
+// of the calling thread
+func runIterator(iter *link.Iter) error {
+	reader, err := iter.Open()
+	if err != nil {
+		return err
+	}
+	defer reader.Close()
+
+	// the program doesn't output anything, reading runs it until the end of the iteration
+	_, err = io.Copy(io.Discard, reader)
+	return err
+}
+
+// clearPortBindingMaps removes all the entries of the port binding maps
+func (t *ebpfTracer) clearPortBindingMaps() error {
+	for _, name := range []string{probes.PortBindingsMap, probes.UDPPortBindingsMap} {
+		m, err := maps.GetMap[netebpf.PortBinding, uint32](t.m.Manager, name)
+		if err != nil {
+			return fmt.Errorf("failed to get %s map: %w", name, err)
+		}
+
+		var keys []netebpf.PortBinding
+		var pb netebpf.PortBinding
+		var count uint32
+		iter := m.Iterate()
+		for iter.Next(&pb, &count) {
+			keys = append(keys, pb)
+		}
+		if err := iter.Err(); err != nil {
+			return fmt.Errorf("failed to iterate over %s map: %w", name, err)
+		}
+		for i := range keys {
+			if err := m.Delete(&keys[i]); err != nil && !errors.Is(err, ebpf.ErrKeyNotExist) {
+				return fmt.Errorf("failed to clear %s map: %w", name, err)
+			}
+		}
+	}
+	return nil
+}
+
 func (t *ebpfTracer) getTCPRetransmits(tuple *netebpf.ConnTuple, seen map[netebpf.ConnTuple]struct{}) (uint32, bool) {
 	if tuple.Type() != netebpf.TCP {
 		return 0, false
@@ -773,6 +908,11 @@ func (t *ebpfTracer) setupMapCleaners(m *manager.Manager) {
 
 // setupOngoingConnectMapCleaner sets up a map cleaner for the tcp_ongoing_connect_pid map
 func (t *ebpfTracer) setupOngoingConnectMapCleaner(m *manager.Manager) {
+	if t.ebpfTracerType == TracerTypeFentry && fentry.HasSKStorage() {
+		// the fentry tracer keeps the pids in socket-local storage, freed along with the sockets
+		return
+	}
+
 	tcpOngoingConnectPidMap, _, err := m.GetMap(probes.TCPOngoingConnectPid)
 	if err != nil {
 		log.Errorf("error getting %v map: %s", probes.TCPOngoingConnectPid, err)
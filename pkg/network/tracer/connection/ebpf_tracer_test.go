@@ -16,6 +16,14 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 )
 
+func TestClosedConnBatchSize(t *testing.T) {
+	cfg := config.New()
+	for batchSize, expected := range map[int]uint64{-1: 0, 0: 0, 1: 1, 4: 4, 16: 16, 64: 16} {
+		cfg.ClosedConnBatchSize = batchSize
+		require.Equal(t, expected, closedConnBatchSize(cfg), "batch size %d", batchSize)
+	}
+}
+
 func TestFailedConnectionTelemetryMapLoads(t *testing.T) {
 	tr, err := newEbpfTracer(config.New(), nil)
 	require.NoError(t, err, "could not load tracer")
@@ -20,7 +20,9 @@ func initManager(mgr *ddebpf.Manager) {
 		{Name: probes.ConnMap},
 		{Name: probes.TCPStatsMap},
 		{Name: probes.TCPOngoingConnectPid},
+		{Name: probes.TCPOngoingConnectPidSKStorage},
 		{Name: probes.ConnCloseBatchMap},
+		{Name: probes.ConnCloseRingBufferBatchMap},
 		{Name: "udp_recv_sock"},
 		{Name: "udpv6_recv_sock"},
 		{Name: probes.PortBindingsMap},
@@ -10,10 +10,13 @@ package fentry
 import (
 	"errors"
 	"fmt"
+	"maps"
 	"os"
 	"syscall"
 
 	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/features"
 
 	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
@@ -21,6 +24,9 @@ import (
 	ebpftelemetry "github.com/DataDog/datadog-agent/pkg/ebpf/telemetry"
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
+	"github.com/DataDog/datadog-agent/pkg/network/tracer/connection/util"
+	"github.com/DataDog/datadog-agent/pkg/util/kernel"
 )
 
 const probeUID = "net"
@@ -45,7 +51,8 @@ func LoadTracer(config *config.Config, mgrOpts manager.Options, connCloseEventHa
 	m := ddebpf.NewManagerWithDefault(&manager.Manager{}, "network", &ebpftelemetry.ErrorsTelemetryModifier{}, connCloseEventHandler)
 	err = ddebpf.LoadCOREAsset(netebpf.ModuleFileName("tracer-fentry", config.BPFDebug), func(ar bytecode.AssetReader, o manager.Options) error {
 		o.RemoveRlimit = mgrOpts.RemoveRlimit
-		o.MapSpecEditors = mgrOpts.MapSpecEditors
+		// the editors are shared with the kprobe tracer, in case loading fails
+		o.MapSpecEditors = maps.Clone(mgrOpts.MapSpecEditors)
 		o.ConstantEditors = mgrOpts.ConstantEditors
 		return initFentryTracer(ar, o, config, m)
 	})
@@ -57,6 +64,17 @@ func LoadTracer(config *config.Config, mgrOpts manager.Options, connCloseEventHa
 	return m, nil, nil
 }
 
+// HasSKStorage returns true if tracing programs can use socket-local storage, which
+// requires kernel v5.11+ (https://github.com/torvalds/linux/commit/8e4597c627fb48f361e2a5b012202cb1b6cbcd5e)
+func HasSKStorage() bool {
+	if features.HaveMapType(ebpf.SkStorage) != nil {
+		return false
+	}
+
+	kv, err := kernel.HostVersion()
+	return err == nil && kv >= kernel.VersionCode(5, 11, 0)
+}
+
 // Use a function so someone doesn't accidentally use mgrOpts from the outer scope in LoadTracer
 func initFentryTracer(ar bytecode.AssetReader, o manager.Options, config *config.Config, m *ddebpf.Manager) error {
 	// Use the config to determine what kernel probes should be enabled
@@ -80,6 +98,18 @@ func initFentryTracer(ar bytecode.AssetReader, o manager.Options, config *config
 		Value: pidStat.Ino,
 	})
 
+	useSKStorage := HasSKStorage()
+	util.AddBoolConst(&o, "use_sk_storage", useSKStorage)
+	if useSKStorage {
+		// the pids of ongoing connections are held in socket-local storage instead
+		o.MapSpecEditors[probes.TCPOngoingConnectPid] = manager.MapSpecEditor{
+			MaxEntries: 1,
+			EditorFlag: manager.EditMaxEntries,
+		}
+	}
+
+	util.ExcludePortBindingIterators(&o)
+
 	// exclude all non-enabled probes to ensure we don't run into problems with unsupported probe types
 	for _, p := range m.Probes {
 		if _, enabled := enabledProbes[p.EBPFFuncName]; !enabled {
@@ -71,6 +71,7 @@ func initManager(mgr *ddebpf.Manager, runtimeTracer bool) error {
 		{Name: probes.TCPStatsMap},
 		{Name: probes.TCPOngoingConnectPid},
 		{Name: probes.ConnCloseBatchMap},
+		{Name: probes.ConnCloseRingBufferBatchMap},
 		{Name: "udp_recv_sock"},
 		{Name: "udpv6_recv_sock"},
 		{Name: probes.PortBindingsMap},
@@ -205,12 +205,21 @@ func loadTracerFromAsset(buf bytecode.AssetReader, runtimeTracer, coreTracer boo
 				EditorFlag: manager.EditType,
 			}
 		}
+		// Likewise, kernels < 4.10.0 do not know about LRU hash maps.
+		mgrOpts.MapSpecEditors[probes.ProtocolHintsMap] = manager.MapSpecEditor{
+			Type:       ebpf.Hash,
+			EditorFlag: manager.EditType,
+		}
 	}
 
 	if config.FailedConnectionsSupported() {
 		util.AddBoolConst(&mgrOpts, "tcp_failed_connections_enabled", true)
 	}
 
+	if coreTracer {
+		util.ExcludePortBindingIterators(&mgrOpts)
+	}
+
 	// Use the config to determine what kernel probes should be enabled
 	enabledProbes, err := enabledProbes(config, runtimeTracer, coreTracer)
 	if err != nil {
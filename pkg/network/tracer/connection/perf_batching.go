@@ -29,16 +29,18 @@ import (
 // The motivation is to impose an upper limit on how long a TCP close connection
 // event remains stored in the eBPF map before being processed by the NetworkAgent.
 type perfBatchManager struct {
-	batchMap   *maps.GenericMap[uint32, netebpf.Batch]
-	extractor  *batchExtractor
-	ch         *cookieHasher
-	connGetter ddsync.PoolGetter[network.ConnectionStats]
-	callback   func(stats *network.ConnectionStats)
+	batchMap *maps.GenericMap[uint32, netebpf.Batch]
+	// ringBatchMap holds the batches sent through a ring buffer, it may be nil
+	ringBatchMap *maps.GenericMap[uint32, netebpf.RingBufferBatch]
+	extractor    *batchExtractor
+	ch           *cookieHasher
+	connGetter   ddsync.PoolGetter[network.ConnectionStats]
+	callback     func(stats *network.ConnectionStats)
 }
 
 // newPerfBatchManager returns a new `PerfBatchManager` and initializes the
 // eBPF map that holds the tcp_close batch objects.
-func newPerfBatchManager(batchMap *maps.GenericMap[uint32, netebpf.Batch], extractor *batchExtractor, getter ddsync.PoolGetter[network.ConnectionStats], callback func(stats *network.ConnectionStats)) (*perfBatchManager, error) {
+func newPerfBatchManager(batchMap *maps.GenericMap[uint32, netebpf.Batch], ringBatchMap *maps.GenericMap[uint32, netebpf.RingBufferBatch], extractor *batchExtractor, getter ddsync.PoolGetter[network.ConnectionStats], callback func(stats *network.ConnectionStats)) (*perfBatchManager, error) {
 	if batchMap == nil {
 		return nil, errors.New("batchMap is nil")
 	}
@@ -52,14 +54,22 @@ func newPerfBatchManager(batchMap *maps.GenericMap[uint32, netebpf.Batch], extra
 		if err := batchMap.Put(&cpu, b); err != nil {
 			return nil, fmt.Errorf("error initializing perf batch manager maps: %w", err)
 		}
+		if ringBatchMap == nil {
+			continue
+		}
+		rb := &netebpf.RingBufferBatch{Cpu: cpu}
+		if err := ringBatchMap.Put(&cpu, rb); err != nil {
+			return nil, fmt.Errorf("error initializing perf batch manager maps: %w", err)
+		}
 	}
 
 	return &perfBatchManager{
-		batchMap:   batchMap,
-		extractor:  extractor,
-		ch:         newCookieHasher(),
-		connGetter: getter,
-		callback:   callback,
+		batchMap:     batchMap,
+		ringBatchMap: ringBatchMap,
+		extractor:    extractor,
+		ch:           newCookieHasher(),
+		connGetter:   getter,
+		callback:     callback,
 	}, nil
 }
 
@@ -75,10 +85,19 @@ func (p *perfBatchManager) Flush() {
 		}
 
 		for rc := p.extractor.NextConnection(b); rc != nil; rc = p.extractor.NextConnection(b) {
-			c := p.connGetter.Get()
-			c.FromConn(rc)
-			p.ch.Hash(c)
-			p.callback(c)
+			p.flushConn(rc)
+		}
+	}
+	if p.ringBatchMap != nil {
+		// only one of the maps is filled, depending on whether ring buffers are in use
+		rb := new(netebpf.RingBufferBatch)
+		for cpu := uint32(0); cpu < uint32(p.extractor.NumCPUs()); cpu++ {
+			if err := p.ringBatchMap.Lookup(&cpu, rb); err != nil {
+				continue
+			}
+			for rc := p.extractor.NextRingBufferConnection(rb); rc != nil; rc = p.extractor.NextRingBufferConnection(rb) {
+				p.flushConn(rc)
+			}
 		}
 	}
 	// indicate we are done with all pending connection
@@ -86,12 +105,23 @@ func (p *perfBatchManager) Flush() {
 	p.extractor.CleanupExpiredState(time.Now())
 }
 
+func (p *perfBatchManager) flushConn(rc *netebpf.Conn) {
+	c := p.connGetter.Get()
+	c.FromConn(rc)
+	p.ch.Hash(c)
+	p.callback(c)
+}
+
 func newConnBatchManager(mgr *manager.Manager, extractor *batchExtractor, connGetter ddsync.PoolGetter[network.ConnectionStats], closedCallback func(stats *network.ConnectionStats)) (*perfBatchManager, error) {
 	connCloseMap, err := maps.GetMap[uint32, netebpf.Batch](mgr, probes.ConnCloseBatchMap)
 	if err != nil {
 		return nil, fmt.Errorf("unable to get map %s: %s", probes.ConnCloseBatchMap, err)
 	}
-	batchMgr, err := newPerfBatchManager(connCloseMap, extractor, connGetter, closedCallback)
+	connCloseRingMap, err := maps.GetMap[uint32, netebpf.RingBufferBatch](mgr, probes.ConnCloseRingBufferBatchMap)
+	if err != nil {
+		return nil, fmt.Errorf("unable to get map %s: %s", probes.ConnCloseRingBufferBatchMap, err)
+	}
+	batchMgr, err := newPerfBatchManager(connCloseMap, connCloseRingMap, extractor, connGetter, closedCallback)
 	if err != nil {
 		return nil, err
 	}
@@ -135,9 +135,9 @@ func newTestBatchManager(t *testing.T, callback func(*network.ConnectionStats))
 
 	gm, err := ebpfmaps.Map[uint32, netebpf.Batch](m)
 	require.NoError(t, err)
-	extractor := newBatchExtractor(numTestCPUs)
+	extractor := newBatchExtractor(numTestCPUs, 0)
 	connPool := ddsync.NewDefaultTypedPool[network.ConnectionStats]()
-	mgr, err := newPerfBatchManager(gm, extractor, connPool, callback)
+	mgr, err := newPerfBatchManager(gm, nil, extractor, connPool, callback)
 	require.NoError(t, err)
 	return mgr
 }
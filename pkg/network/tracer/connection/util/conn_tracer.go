@@ -17,7 +17,9 @@ import (
 
 	"github.com/DataDog/datadog-agent/pkg/network"
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
 	"github.com/DataDog/datadog-agent/pkg/process/util"
+	"github.com/DataDog/datadog-agent/pkg/util/kernel"
 )
 
 // toPowerOf2 converts a number to its nearest power of 2
@@ -57,6 +59,19 @@ func AddBoolConst(options *manager.Options, name string, flag bool) {
 	)
 }
 
+// socketIteratorsMinimumKernel is the first kernel version with TCP and UDP socket iterators
+// (https://github.com/torvalds/linux/commit/52d87d5f6418ba1b8b449ed5eea1532664896851)
+var socketIteratorsMinimumKernel = kernel.VersionCode(5, 9, 0)
+
+// ExcludePortBindingIterators excludes the socket iterators seeding the port binding maps,
+// which are part of the CO-RE tracers, when the kernel doesn't support them
+func ExcludePortBindingIterators(options *manager.Options) {
+	if kv, err := kernel.HostVersion(); err == nil && kv >= socketIteratorsMinimumKernel {
+		return
+	}
+	options.ExcludedFunctions = append(options.ExcludedFunctions, probes.TCPPortBindingsIter, probes.UDPPortBindingsIter)
+}
+
 // ConnTupleToEBPFTuple converts a ConnectionTuple to an eBPF ConnTuple
 func ConnTupleToEBPFTuple(c *network.ConnectionTuple, tup *netebpf.ConnTuple) {
 	tup.Sport = c.SPort
@@ -32,6 +32,7 @@ import (
 
 const (
 	offsetsDataMap            = "offsets_data"
+	processOffsetsMap         = "go_tls_process_offsets"
 	goTLSReadArgsMap          = "go_tls_read_args"
 	goTLSWriteArgsMap         = "go_tls_write_args"
 	connectionTupleByGoTLSMap = "conn_tup_by_go_tls_conn"
@@ -65,6 +66,7 @@ var goTLSSpec = &protocols.ProtocolSpec{
 	Factory: newGoTLS,
 	Maps: []*manager.Map{
 		{Name: offsetsDataMap},
+		{Name: processOffsetsMap},
 		{Name: goTLSReadArgsMap},
 		{Name: goTLSWriteArgsMap},
 		{Name: connectionTupleByGoTLSMap},
@@ -465,6 +465,23 @@ func (e *ebpfProgram) init(buf bytecode.AssetReader, options manager.Options) er
 		}
 	}
 
+	excludeNotSupportedProtocols(&options, supported, notSupported)
+
+	err := e.InitWithOptions(buf, &options)
+	if err != nil {
+		cleanup()
+	} else {
+		// Update the protocols lists to reflect the ones we actually enabled
+		e.enabledProtocols = supported
+		e.disabledProtocols = notSupported
+	}
+
+	return err
+}
+
+// excludeNotSupportedProtocols excludes the maps and the programs of the protocols that are disabled or not supported
+// by the current build mode, so they are neither loaded nor verified.
+func excludeNotSupportedProtocols(options *manager.Options, supported, notSupported []*protocols.ProtocolSpec) {
 	// We might have shared maps, probes and TCs between supported and not supported protocols. We need to make sure
 	// that we're not excluding a shared resource if it is used by at least one supported protocol.
 	supportedMaps := make(map[string]struct{})
@@ -511,18 +528,9 @@ func (e *ebpfProgram) init(buf bytecode.AssetReader, options manager.Options) er
 			options.ExcludedFunctions = append(options.ExcludedFunctions, tc.ProbeIdentificationPair.EBPFFuncName)
 			log.Debugf("disabled tail call: %v", tc.ProbeIdentificationPair.EBPFFuncName)
 		}
-	}
 
-	err := e.InitWithOptions(buf, &options)
-	if err != nil {
-		cleanup()
-	} else {
-		// Update the protocols lists to reflect the ones we actually enabled
-		e.enabledProtocols = supported
-		e.disabledProtocols = notSupported
+		options.ExcludedFunctions = append(options.ExcludedFunctions, p.ExcludedFunctions...)
 	}
-
-	return err
 }
 
 func getAssetName(module string, debug bool) string {
@@ -17,6 +17,7 @@ import (
 
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/kafka"
 )
 
 func newMap(name string) *manager.Map { return &manager.Map{Name: name} }
@@ -137,3 +138,20 @@ func TestConfigureManagerWithSupportedProtocols_CleanupOnlyRemovesAdded(t *testi
 	assert.Equal(t, "existingProbe", e.Probes[0].EBPFFuncName)
 	assert.Equal(t, "existingTailCall", e.tailCallRouter[0].ProbeIdentificationPair.EBPFFuncName)
 }
+
+func TestExcludeNotSupportedProtocols_DisabledKafka(t *testing.T) {
+	options := manager.Options{}
+	excludeNotSupportedProtocols(&options, nil, []*protocols.ProtocolSpec{kafka.Spec})
+
+	// the bpf_loop parsers aren't routed by default, they must still be excluded
+	assert.Subset(t, options.ExcludedFunctions, kafka.Spec.ExcludedFunctions)
+	for _, probe := range kafka.Spec.Probes {
+		assert.Contains(t, options.ExcludedFunctions, probe.EBPFFuncName)
+	}
+	for _, tc := range kafka.Spec.TailCalls {
+		assert.Contains(t, options.ExcludedFunctions, tc.ProbeIdentificationPair.EBPFFuncName)
+	}
+	for _, m := range kafka.Spec.Maps {
+		assert.Contains(t, options.ExcludedMaps, m.Name)
+	}
+}
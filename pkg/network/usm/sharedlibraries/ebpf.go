@@ -12,6 +12,7 @@ import (
 	"fmt"
 	"os"
 	"runtime"
+	"slices"
 	"strings"
 	"sync"
 
@@ -24,6 +25,7 @@ import (
 
 	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
 	ebpftelemetry "github.com/DataDog/datadog-agent/pkg/ebpf/telemetry"
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/util/kernel"
@@ -33,6 +35,9 @@ import (
 const (
 	maxActive              = 1024
 	sharedLibrariesPerfMap = "shared_libraries"
+	libNamesMap            = "shared_libraries_names"
+	reportedLibrariesMap   = "shared_libraries_reported"
+	libraryOpenersMap      = "shared_libraries_openers"
 	probeUID               = "so"
 
 	// probe used for streaming shared library events
@@ -46,6 +51,12 @@ var (
 	progSingleton  *EbpfProgram
 
 	traceTypes = []string{"enter", "exit"}
+
+	// libsetIDs maps the libsets to their identifier in eBPF
+	libsetIDs = map[Libset]uint8{
+		LibsetCrypto: libsetCryptoID,
+		LibsetGPU:    libsetGPUID,
+	}
 )
 
 // LibraryCallback defines the type of the callback function that will be called when a shared library event is detected
@@ -111,6 +122,11 @@ type EbpfProgram struct {
 	// when adding new libsets
 	isInitialized bool
 
+	// reportedLibraries holds the libraries eBPF already reported, libraryOpeners the
+	// processes that opened them afterwards
+	reportedLibraries *maps.GenericMap[LibReportedKey, uint8]
+	libraryOpeners    *maps.GenericMap[LibOpenerKey, uint8]
+
 	// enabledProbes is a list of the probes that are enabled for the current system.
 	enabledProbes []manager.ProbeIdentificationPair
 	// disabledProbes is a list of the probes that are disabled for the current system.
@@ -489,6 +505,8 @@ func (e *EbpfProgram) stopImpl() {
 	e.wg.Wait()
 
 	e.Manager = nil
+	e.reportedLibraries = nil
+	e.libraryOpeners = nil
 }
 
 func (e *EbpfProgram) init(buf bytecode.AssetReader, options manager.Options) error {
@@ -506,25 +524,110 @@ func (e *EbpfProgram) init(buf bytecode.AssetReader, options manager.Options) er
 	}
 
 	var enabledMsgs []string
+	var requested []Libset
 	for libset := range LibsetToLibSuffixes {
-		value := uint64(0)
+		value := 0
 		if e.isLibsetRequested(libset) {
-			value = uint64(1)
+			value = 1
+			requested = append(requested, libset)
 		}
-
-		constEd := manager.ConstantEditor{
-			Name:  fmt.Sprintf("%s_libset_enabled", string(libset)),
-			Value: value,
-		}
-
-		options.ConstantEditors = append(options.ConstantEditors, constEd)
 		enabledMsgs = append(enabledMsgs, fmt.Sprintf("%s=%d", libset, value))
 	}
 
 	log.Infof("loading shared libraries program with libsets enabled: %s", strings.Join(enabledMsgs, ", "))
 
+	table, err := libNamesTable(requested)
+	if err != nil {
+		return err
+	}
+
 	options.BypassEnabled = e.cfg.BypassEnabled
-	return e.InitWithOptions(buf, &options)
+	if err := e.InitWithOptions(buf, &options); err != nil {
+		return err
+	}
+
+	libNames, err := maps.GetMap[uint32, LibNames](e.Manager.Manager, libNamesMap)
+	if err != nil {
+		return err
+	}
+	key := uint32(0)
+	if err := libNames.Put(&key, &table); err != nil {
+		return fmt.Errorf("could not write the library names table: %w", err)
+	}
+
+	e.reportedLibraries, err = maps.GetMap[LibReportedKey, uint8](e.Manager.Manager, reportedLibrariesMap)
+	if err != nil {
+		return err
+	}
+	e.libraryOpeners, err = maps.GetMap[LibOpenerKey, uint8](e.Manager.Manager, libraryOpenersMap)
+	return err
+}
+
+// libNamesTable builds the table of the library names eBPF reports for the given
+// libsets. eBPF compares the LibNameSize characters preceding ".so" in the path of the
+// opened files to each name, so the names hold the end of the library suffixes.
+func libNamesTable(libsets []Libset) (LibNames, error) {
+	var table LibNames
+	slices.Sort(libsets)
+
+	n := 0
+	for _, libset := range libsets {
+		for _, suffix := range LibsetToLibSuffixes[libset] {
+			if len(suffix) < LibNameSize {
+				return table, fmt.Errorf("library %q of libset %s is shorter than %d characters", suffix, libset, LibNameSize)
+			}
+			if n == LibNamesMax {
+				return table, fmt.Errorf("too many libraries to report, at most %d are supported", LibNamesMax)
+			}
+			copy(table.Names[n].Name[:], suffix[len(suffix)-LibNameSize:])
+			table.Names[n].Libset = libsetIDs[libset]
+			n++
+		}
+	}
+	return table, nil
+}
+
+// ForgetLibrary removes a library from the libraries eBPF already reported, so the
+// next process opening it gets it reported again.
+func (e *EbpfProgram) ForgetLibrary(key LibReportedKey) {
+	e.initMutex.Lock()
+	defer e.initMutex.Unlock()
+	if e.reportedLibraries == nil {
+		return
+	}
+	_ = e.reportedLibraries.Delete(&key)
+}
+
+// DrainLibraryOpeners calls the callback for the processes that opened a library of
+// the given libset after eBPF reported it, and removes them from the eBPF map.
+func (e *EbpfProgram) DrainLibraryOpeners(libset Libset, callback func(key LibReportedKey, pid uint32)) {
+	e.initMutex.Lock()
+	if e.libraryOpeners == nil {
+		e.initMutex.Unlock()
+		return
+	}
+
+	var key LibOpenerKey
+	var opened uint8
+	var openers []LibOpenerKey
+	iter := e.libraryOpeners.Iterate()
+	for iter.Next(&key, &opened) {
+		if key.Lib.Libset == uint32(libsetIDs[libset]) {
+			openers = append(openers, key)
+		}
+	}
+	if err := iter.Err(); err != nil {
+		log.Warnf("failed to iterate over %s: %s", libraryOpenersMap, err)
+	}
+	for i := range openers {
+		_ = e.libraryOpeners.Delete(&openers[i])
+	}
+	// the callback may forget libraries, which locks initMutex
+	e.initMutex.Unlock()
+
+	for i := range openers {
+		callback(openers[i].Lib, openers[i].Pid)
+	}
 }
 
 func (e *EbpfProgram) initCORE() error {
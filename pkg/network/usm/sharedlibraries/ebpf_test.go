@@ -248,3 +248,26 @@ func (s *EbpfProgramSuite) TestMultipleProgramsReceiveMultipleLibsetEvents() {
 	require.Equal(t, fooPathCuda, receivedEventCuda.String())
 	require.Equal(t, commandCuda.Process.Pid, int(receivedEventCuda.Pid))
 }
+
+func TestLibNamesTable(t *testing.T) {
+	table, err := libNamesTable([]Libset{LibsetGPU, LibsetCrypto})
+	require.NoError(t, err)
+
+	names := make(map[string]uint8)
+	for _, lib := range table.Names {
+		if lib.Libset != 0 {
+			names[string(lib.Name[:])] = lib.Libset
+		}
+	}
+	require.Equal(t, map[string]uint8{
+		"libssl": libsetCryptoID,
+		"crypto": libsetCryptoID,
+		"gnutls": libsetCryptoID,
+		"cudart": libsetGPUID,
+	}, names)
+
+	table, err = libNamesTable([]Libset{LibsetGPU})
+	require.NoError(t, err)
+	require.Equal(t, "cudart", string(table.Names[0].Name[:]))
+	require.Zero(t, table.Names[1].Libset)
+}
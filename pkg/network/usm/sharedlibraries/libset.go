@@ -17,8 +17,8 @@ const (
 	LibsetGPU Libset = "gpu"
 )
 
-// LibsetToLibSuffixes maps a libset to a list of regexes that match the shared libraries that belong to that libset. Should be
-// the same as in the probes.h file
+// LibsetToLibSuffixes maps a libset to a list of regexes that match the shared libraries that belong to that libset. eBPF
+// matches the last LibNameSize characters of each suffix, and supports up to LibNamesMax suffixes in total
 var LibsetToLibSuffixes = map[Libset][]string{
 	LibsetCrypto: {"libssl", "crypto", "gnutls"},
 	LibsetGPU:    {"libcudart"},
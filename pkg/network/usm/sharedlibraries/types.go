@@ -13,7 +13,16 @@ package sharedlibraries
 import "C"
 
 type LibPath C.lib_path_t
+type LibName C.lib_name_t
+type LibNames C.lib_names_t
+type LibReportedKey C.lib_reported_key_t
+type LibOpenerKey C.lib_opener_key_t
 
 const (
 	LibPathMaxSize = C.LIB_PATH_MAX_SIZE
+	LibNameSize    = C.LIB_NAME_SIZE
+	LibNamesMax    = C.LIB_NAMES_MAX
+
+	libsetCryptoID = C.LIBSET_CRYPTO
+	libsetGPUID    = C.LIBSET_GPU
 )
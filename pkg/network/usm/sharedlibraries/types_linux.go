@@ -4,11 +4,36 @@
 package sharedlibraries
 
 type LibPath struct {
-	Pid uint32
-	Len uint32
-	Buf [220]byte
+	Pid          uint32
+	Len          uint32
+	Buf          [220]byte
+	Pad_cgo_0    [4]byte
+	Reported_key LibReportedKey
+}
+type LibName struct {
+	Name   [6]byte
+	Libset uint8
+	X_pad  uint8
+}
+type LibNames struct {
+	Names [8]LibName
+}
+type LibReportedKey struct {
+	Ino    uint64
+	Dev    uint32
+	Libset uint32
+}
+type LibOpenerKey struct {
+	Lib   LibReportedKey
+	Pid   uint32
+	X_pad uint32
 }
 
 const (
 	LibPathMaxSize = 0xdc
+	LibNameSize    = 0x6
+	LibNamesMax    = 0x8
+
+	libsetCryptoID = 0x1
+	libsetGPUID    = 0x2
 )
@@ -11,3 +11,19 @@ import (
 func TestCgoAlignment_LibPath(t *testing.T) {
 	ebpftest.TestCgoAlignment[LibPath](t)
 }
+
+func TestCgoAlignment_LibName(t *testing.T) {
+	ebpftest.TestCgoAlignment[LibName](t)
+}
+
+func TestCgoAlignment_LibNames(t *testing.T) {
+	ebpftest.TestCgoAlignment[LibNames](t)
+}
+
+func TestCgoAlignment_LibReportedKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[LibReportedKey](t)
+}
+
+func TestCgoAlignment_LibOpenerKey(t *testing.T) {
+	ebpftest.TestCgoAlignment[LibOpenerKey](t)
+}
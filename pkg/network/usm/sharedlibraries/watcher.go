@@ -54,6 +54,14 @@ type Rule struct {
 	UnregisterCB func(utils.FilePath) error
 }
 
+// reportedLibrary is a library reported by eBPF, which doesn't report it again when
+// other processes open it
+type reportedLibrary struct {
+	path string
+	rule Rule
+	id   utils.PathIdentifier
+}
+
 // Watcher provides a way to tie callback functions to the lifecycle of shared libraries
 type Watcher struct {
 	syncMutex      sync.RWMutex
@@ -68,6 +76,13 @@ type Watcher struct {
 	thisPID        int
 	scannedPIDs    map[uint32]int
 
+	// The libraries reported by eBPF, by eBPF key and by path identifier. The
+	// processes opening them afterwards are read from the eBPF map of openers and
+	// registered during the periodic sync.
+	reportedMutex sync.Mutex
+	reported      map[LibReportedKey]reportedLibrary
+	reportedByID  map[utils.PathIdentifier][]LibReportedKey
+
 	// telemetry
 	libHits    *telemetry.Counter
 	libMatches *telemetry.Counter
@@ -86,22 +101,37 @@ func NewWatcher(cfg *config.Config, libset Libset, mapsCleaner func(map[uint32]s
 		return nil, fmt.Errorf("error initializing shared library program: %w", err)
 	}
 
-	return &Watcher{
+	w := &Watcher{
 		wg:             sync.WaitGroup{},
 		done:           make(chan struct{}),
 		procRoot:       kernel.ProcFSRoot(),
-		rules:          rules,
 		libset:         libset,
 		processMonitor: monitor.GetProcessMonitor(),
 		ebpfProgram:    ebpfProgram,
 		registry:       utils.NewFileRegistry(consts.USMModuleName, "shared_libraries"),
 		scannedPIDs:    make(map[uint32]int),
+		reported:       make(map[LibReportedKey]reportedLibrary),
+		reportedByID:   make(map[utils.PathIdentifier][]LibReportedKey),
 
 		libHits:    telemetry.NewCounter("usm.so_watcher.hits", telemetry.OptPrometheus),
 		libMatches: telemetry.NewCounter("usm.so_watcher.matches", telemetry.OptPrometheus),
 
 		mapsCleaner: mapsCleaner,
-	}, nil
+	}
+
+	// Once no process uses a library anymore, eBPF forgets it so the next process
+	// opening it gets it reported again.
+	w.rules = make([]Rule, 0, len(rules))
+	for _, r := range rules {
+		if unregisterCB := r.UnregisterCB; unregisterCB != nil {
+			r.UnregisterCB = func(fp utils.FilePath) error {
+				w.forgetLibrary(fp.ID)
+				return unregisterCB(fp)
+			}
+		}
+		w.rules = append(w.rules, r)
+	}
+	return w, nil
 }
 
 // Stop the Watcher
@@ -205,12 +235,71 @@ func (w *Watcher) handleLibraryOpen(lib LibPath) {
 	for _, r := range w.rules {
 		if r.Re.Match(path) {
 			w.libMatches.Add(1)
-			_ = w.registry.Register(string(path), lib.Pid, r.RegisterCB, r.UnregisterCB, utils.IgnoreCB)
+			w.registerLibrary(lib.Reported_key, reportedLibrary{path: string(path), rule: r}, lib.Pid)
 			break
 		}
 	}
 }
 
+// registerLibrary registers a process using a library reported by eBPF, and remembers
+// the library to register the processes opening it afterwards.
+func (w *Watcher) registerLibrary(key LibReportedKey, lib reportedLibrary, pid uint32) {
+	remember := func(fp utils.FilePath) error {
+		lib.id = fp.ID
+		w.rememberLibrary(key, lib)
+		return nil
+	}
+	registerCB := func(fp utils.FilePath) error {
+		if err := lib.rule.RegisterCB(fp); err != nil {
+			return err
+		}
+		return remember(fp)
+	}
+	_ = w.registry.Register(lib.path, pid, registerCB, lib.rule.UnregisterCB, remember)
+}
+
+// attachOpener registers a process that opened a library after eBPF reported it
+func (w *Watcher) attachOpener(key LibReportedKey, pid uint32) {
+	if int(pid) == w.thisPID {
+		return
+	}
+
+	w.reportedMutex.Lock()
+	lib, ok := w.reported[key]
+	w.reportedMutex.Unlock()
+	if !ok {
+		// the library failed to register or its event was lost, have eBPF report it again
+		w.ebpfProgram.ForgetLibrary(key)
+		return
+	}
+	w.registerLibrary(key, lib, pid)
+}
+
+func (w *Watcher) rememberLibrary(key LibReportedKey, lib reportedLibrary) {
+	w.reportedMutex.Lock()
+	defer w.reportedMutex.Unlock()
+
+	if _, ok := w.reported[key]; !ok {
+		w.reportedByID[lib.id] = append(w.reportedByID[lib.id], key)
+	}
+	w.reported[key] = lib
+}
+
+// forgetLibrary is called once no process uses the library anymore
+func (w *Watcher) forgetLibrary(id utils.PathIdentifier) {
+	w.reportedMutex.Lock()
+	keys := w.reportedByID[id]
+	delete(w.reportedByID, id)
+	for _, key := range keys {
+		delete(w.reported, key)
+	}
+	w.reportedMutex.Unlock()
+
+	for _, key := range keys {
+		w.ebpfProgram.ForgetLibrary(key)
+	}
+}
+
 // Start consuming shared-library events
 func (w *Watcher) Start() {
 	if w == nil {
@@ -297,13 +386,16 @@ func (w *Watcher) Start() {
 
 // sync unregisters from any terminated processes which we missed the exit
 // callback for, and also attempts to register to running processes to ensure
-// that we don't miss any process.
+// that we don't miss any process. It also registers the processes that
+// opened a library after eBPF reported it.
 func (w *Watcher) sync() {
 	// The mutex is only used for protection with the test code which reads the
 	// scannedPIDs map.
 	w.syncMutex.Lock()
 	defer w.syncMutex.Unlock()
 
+	w.ebpfProgram.DrainLibraryOpeners(w.libset, w.attachOpener)
+
 	deletionCandidates := w.registry.GetRegisteredProcesses()
 	alivePIDs := make(map[uint32]struct{})
 
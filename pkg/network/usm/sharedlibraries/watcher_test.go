@@ -441,6 +441,11 @@ func (s *SharedLibrarySuite) TestSameInodeRegression() {
 func (s *SharedLibrarySuite) TestSoWatcherLeaks() {
 	t := s.T()
 
+	// eBPF reports fooPath1 once, command2 is attached to it by the periodic sync
+	orig := scanTerminatedProcessesInterval
+	t.Cleanup(func() { scanTerminatedProcessesInterval = orig })
+	scanTerminatedProcessesInterval = 10 * time.Millisecond
+
 	fooPath1, fooPathID1 := createTempTestFile(t, "foo-libssl.so")
 	fooPath2, fooPathID2 := createTempTestFile(t, "foo2-gnutls.so")
 
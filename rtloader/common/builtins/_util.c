@@ -11,8 +11,29 @@
 
 // must be set by the caller
 static cb_get_subprocess_output_t cb_get_subprocess_output = NULL;
+static cb_start_subprocess_t cb_start_subprocess = NULL;
+static cb_read_subprocess_output_t cb_read_subprocess_output = NULL;
+static cb_stop_subprocess_t cb_stop_subprocess = NULL;
+
+// the SubprocessOutput type lives in the module state so every interpreter gets its own copy
+typedef struct {
+    PyTypeObject *subprocess_output_type;
+} util_state_t;
+
+// A subprocess started by `start_subprocess_output`, its stdout is read in chunks
+typedef struct {
+    PyObject_HEAD
+    int64_t handle; // 0 once the subprocess exited, or was stopped, and the handle released
+    int raise_on_empty;
+    int got_output; // whether any stdout was read so far
+    int busy; // a thread is waiting for the subprocess with the GIL released
+    PyObject *stderr_output; // set once the subprocess exited
+    int ret_code;
+    PyObject *result; // cached by result()
+} subprocess_output_t;
 
 static PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw);
+static PyObject *start_subprocess_output(PyObject *self, PyObject *args, PyObject *kw);
 
 // Exceptions
 
@@ -31,16 +52,96 @@ static PyMethodDef methods[] = {
       "Exec a process and return the output." },
     { "get_subprocess_output", (PyCFunction)subprocess_output, METH_VARARGS | METH_KEYWORDS,
       "Exec a process and return the output." },
+    { "start_subprocess_output", (PyCFunction)start_subprocess_output, METH_VARARGS | METH_KEYWORDS,
+      "Exec a process and return a SubprocessOutput streaming its output." },
     { NULL, NULL } // guards
 };
 
-static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, _UTIL_MODULE_NAME, NULL, -1, methods };
+static PyObject *subprocess_output_next(subprocess_output_t *self);
+static PyObject *subprocess_output_result(subprocess_output_t *self, PyObject *unused);
+static PyObject *subprocess_output_close(subprocess_output_t *self, PyObject *unused);
+static void subprocess_output_dealloc(subprocess_output_t *self);
 
-PyMODINIT_FUNC PyInit__util(void)
+static PyMethodDef subprocess_output_methods[] = {
+    { "result", (PyCFunction)subprocess_output_result, METH_NOARGS,
+      "Wait for the process to exit and return the rest of its output." },
+    { "close", (PyCFunction)subprocess_output_close, METH_NOARGS, "Stop the process if it is still running." },
+    { NULL, NULL } // guards
+};
+
+static PyType_Slot subprocess_output_slots[] = {
+    { Py_tp_dealloc, subprocess_output_dealloc },
+    { Py_tp_iter, PyObject_SelfIter },
+    { Py_tp_iternext, subprocess_output_next },
+    { Py_tp_methods, subprocess_output_methods },
+    { Py_tp_doc, "A running process, iterating over it yields chunks of its standard output." },
+    { 0, NULL } // guards
+};
+
+static PyType_Spec subprocess_output_spec = {
+    _SUBPROCESS_OUTPUT_NS_NAME,
+    sizeof(subprocess_output_t),
+    0,
+#if PY_VERSION_HEX >= 0x030A0000
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+#else
+    Py_TPFLAGS_DEFAULT,
+#endif
+    subprocess_output_slots,
+};
+
+static int module_exec(PyObject *m)
 {
-    PyObject *m = PyModule_Create(&module_def);
+    util_state_t *state = (util_state_t *)PyModule_GetState(m);
+    state->subprocess_output_type = (PyTypeObject *)PyType_FromSpec(&subprocess_output_spec);
+    if (state->subprocess_output_type == NULL) {
+        return -1;
+    }
+    Py_INCREF(state->subprocess_output_type);
+    if (PyModule_AddObject(m, _SUBPROCESS_OUTPUT_NAME, (PyObject *)state->subprocess_output_type) < 0) {
+        Py_DECREF(state->subprocess_output_type);
+        return -1;
+    }
+
     addSubprocessException(m);
-    return m;
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+static int module_traverse(PyObject *m, visitproc visit, void *arg)
+{
+    util_state_t *state = (util_state_t *)PyModule_GetState(m);
+    Py_VISIT(state->subprocess_output_type);
+    return 0;
+}
+
+static int module_clear(PyObject *m)
+{
+    util_state_t *state = (util_state_t *)PyModule_GetState(m);
+    Py_CLEAR(state->subprocess_output_type);
+    return 0;
+}
+
+static void module_free(void *m)
+{
+    module_clear((PyObject *)m);
+}
+
+static PyModuleDef_Slot module_slots[] = {
+    { Py_mod_exec, module_exec },
+#if PY_VERSION_HEX >= 0x030C0000
+    { Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED },
+#endif
+    { 0, NULL } // guards
+};
+
+static struct PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT, _UTIL_MODULE_NAME, NULL, sizeof(util_state_t), methods, module_slots,
+    module_traverse,       module_clear,      module_free
+};
+
+PyMODINIT_FUNC PyInit__util(void)
+{
+    return PyModuleDef_Init(&module_def);
 }
 
 void _set_get_subprocess_output_cb(cb_get_subprocess_output_t cb)
@@ -48,6 +149,21 @@ void _set_get_subprocess_output_cb(cb_get_subprocess_output_t cb)
     cb_get_subprocess_output = cb;
 }
 
+void _set_start_subprocess_cb(cb_start_subprocess_t cb)
+{
+    cb_start_subprocess = cb;
+}
+
+void _set_read_subprocess_output_cb(cb_read_subprocess_output_t cb)
+{
+    cb_read_subprocess_output = cb;
+}
+
+void _set_stop_subprocess_cb(cb_stop_subprocess_t cb)
+{
+    cb_stop_subprocess = cb;
+}
+
 /*! \fn void raiseEmptyOutputError()
     \brief sets the SubprocessOutputEmptyError exception as the interpreter error.
 
@@ -75,75 +191,82 @@ static void raiseEmptyOutputError()
     Py_DecRef(utilModule);
 }
 
-/*! \fn PyObject *subprocess_output(PyObject *self, PyObject *args)
-    \brief This function implements the `_util.subprocess_output` _and_ `_util.get_subprocess_output`
-    python method, allowing to execute a subprocess and collect its output.
-    \param self A PyObject* pointer to the _util module.
+/*! \fn void free_string_array(char **array)
+    \brief Frees a NULL-terminated array of strings built by build_command.
+    \param array The array to free, may be NULL.
+*/
+static void free_string_array(char **array)
+{
+    int i;
+
+    if (array == NULL) {
+        return;
+    }
+    for (i = 0; array[i]; i++) {
+        _free(array[i]);
+    }
+    _free(array);
+}
+
+/*! \fn int build_command(PyObject *args, PyObject *kw, const char *format, char ***subprocess_args,
+                           char ***subprocess_env, int *raise)
+    \brief Parses the arguments shared by the subprocess builtins.
     \param args A PyObject* pointer to the args tuple with the desired subprocess commands, and
     optionally a boolean raise_on_empty flag.
     \param kw A PyObject* pointer to the kw dict with optionally an env dict.
-    \return a PyObject * pointer to a python tuple with the stdout, stderr output and the
-    command exit code.
-
-    This function is callable as the `_util.subprocess_output` or `_util.get_subprocess_output`
-    python methods. The command arguments list is fed to the CGO callback, where the command is
-    executed in go-land. The stdout, stderr and exit codes for the command are returned by the
-    callback; these are then converted into python strings and integer respectively and returned
-    in a tuple. If the optional `raise_on_empty` boolean flag is set, and the command output is
-    empty an exception will be raised: the error will be set in the interpreter and NULL will be
-    returned.
+    \param format The PyArg_ParseTupleAndKeywords format, naming the builtin in error messages.
+    \param subprocess_args Set to the NULL-terminated array of command arguments.
+    \param subprocess_env Set to the NULL-terminated array of `key=value` environment
+    variables, NULL when no env was passed.
+    \param raise Set to 1 when raise_on_empty is True.
+    \return 1 on success, 0 with the python error set otherwise.
+
+    The arrays must be released with free_string_array in both cases.
 */
-PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
+static int build_command(PyObject *args, PyObject *kw, const char *format, char ***subprocess_args,
+                         char ***subprocess_env, int *raise)
 {
     int i;
-    int raise = 0;
-    int ret_code = 0;
     int subprocess_args_sz = 0;
     int subprocess_env_sz = 0;
-    char **subprocess_args = NULL;
-    char **subprocess_env = NULL;
-    char *c_stdout = NULL;
-    char *c_stderr = NULL;
-    char *exception = NULL;
+    char **cmd = NULL;
+    char **env_vars = NULL;
     PyObject *cmd_args = NULL;
     PyObject *cmd_raise_on_empty = NULL;
     PyObject *cmd_env = NULL;
-    PyObject *pyResult = NULL;
-
-    if (!cb_get_subprocess_output) {
-        Py_RETURN_NONE;
-    }
 
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    *subprocess_args = NULL;
+    *subprocess_env = NULL;
+    *raise = 0;
 
     static char *keywords[] = { "command", "raise_on_empty", "env", NULL };
     // `cmd_args` is mandatory and should be a list, `cmd_raise_on_empty` is an optional
     // boolean. The string after the ':' is used as the function name in error messages.
-    if (!PyArg_ParseTupleAndKeywords(args, kw, "O|O" PY_ARG_PARSE_TUPLE_KEYWORD_ONLY "O:get_subprocess_output",
-                                     keywords, &cmd_args, &cmd_raise_on_empty, &cmd_env)) {
-        goto cleanup;
+    if (!PyArg_ParseTupleAndKeywords(args, kw, format, keywords, &cmd_args, &cmd_raise_on_empty, &cmd_env)) {
+        return 0;
     }
 
     if (!PyList_Check(cmd_args)) {
         PyErr_SetString(PyExc_TypeError, "command args is not a list");
-        goto cleanup;
+        return 0;
     }
 
     // We already PyList_Check cmd_args, so PyList_Size won't fail and return -1
     subprocess_args_sz = PyList_Size(cmd_args);
     if (subprocess_args_sz == 0) {
         PyErr_SetString(PyExc_TypeError, "invalid command: empty list");
-        goto cleanup;
+        return 0;
     }
 
-    if (!(subprocess_args = (char **)_malloc(sizeof(*subprocess_args) * (subprocess_args_sz + 1)))) {
+    if (!(cmd = (char **)_malloc(sizeof(*cmd) * (subprocess_args_sz + 1)))) {
         PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
-        goto cleanup;
+        return 0;
     }
+    *subprocess_args = cmd;
 
     // init to NULL for safety - could use memset, but this is safer.
     for (i = 0; i <= subprocess_args_sz; i++) {
-        subprocess_args[i] = NULL;
+        cmd[i] = NULL;
     }
 
     for (i = 0; i < subprocess_args_sz; i++) {
@@ -151,28 +274,29 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
 
         if (subprocess_arg == NULL) {
             PyErr_SetString(PyExc_TypeError, "command argument must be valid strings");
-            goto cleanup;
+            return 0;
         }
 
-        subprocess_args[i] = subprocess_arg;
+        cmd[i] = subprocess_arg;
     }
 
     if (cmd_env != NULL && cmd_env != Py_None) {
         if (!PyDict_Check(cmd_env)) {
             PyErr_SetString(PyExc_TypeError, "env is not a dict");
-            goto cleanup;
+            return 0;
         }
 
         subprocess_env_sz = PyDict_Size(cmd_env);
         if (subprocess_env_sz != 0) {
 
-            if (!(subprocess_env = (char **)_malloc(sizeof(*subprocess_env) * (subprocess_env_sz + 1)))) {
+            if (!(env_vars = (char **)_malloc(sizeof(*env_vars) * (subprocess_env_sz + 1)))) {
                 PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
-                goto cleanup;
+                return 0;
             }
+            *subprocess_env = env_vars;
 
             for (i = 0; i <= subprocess_env_sz; i++) {
-                subprocess_env[i] = NULL;
+                env_vars[i] = NULL;
             }
 
             Py_ssize_t pos = 0;
@@ -182,14 +306,14 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
                 char *env_key = as_string(key);
                 if (env_key == NULL) {
                     PyErr_SetString(PyExc_TypeError, "env key is not a string");
-                    goto cleanup;
+                    return 0;
                 }
 
                 char *env_value = as_string(value);
                 if (env_value == NULL) {
                     PyErr_SetString(PyExc_TypeError, "env value is not a string");
                     _free(env_key);
-                    goto cleanup;
+                    return 0;
                 }
 
                 char *env = (char *)_malloc((strlen(env_key) + 1 + strlen(env_value) + 1) * sizeof(*env));
@@ -197,7 +321,7 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
                     PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
                     _free(env_key);
                     _free(env_value);
-                    goto cleanup;
+                    return 0;
                 }
 
                 strcpy(env, env_key);
@@ -207,18 +331,61 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
                 _free(env_key);
                 _free(env_value);
 
-                subprocess_env[i] = env;
+                env_vars[i] = env;
             }
         }
     }
 
     if (cmd_raise_on_empty != NULL && !PyBool_Check(cmd_raise_on_empty)) {
         PyErr_SetString(PyExc_TypeError, "bad raise_on_empty argument: should be bool");
-        goto cleanup;
+        return 0;
     }
 
     if (cmd_raise_on_empty == Py_True) {
-        raise = 1;
+        *raise = 1;
+    }
+
+    return 1;
+}
+
+/*! \fn PyObject *subprocess_output(PyObject *self, PyObject *args)
+    \brief This function implements the `_util.subprocess_output` _and_ `_util.get_subprocess_output`
+    python method, allowing to execute a subprocess and collect its output.
+    \param self A PyObject* pointer to the _util module.
+    \param args A PyObject* pointer to the args tuple with the desired subprocess commands, and
+    optionally a boolean raise_on_empty flag.
+    \param kw A PyObject* pointer to the kw dict with optionally an env dict.
+    \return a PyObject * pointer to a python tuple with the stdout, stderr output and the
+    command exit code.
+
+    This function is callable as the `_util.subprocess_output` or `_util.get_subprocess_output`
+    python methods. The command arguments list is fed to the CGO callback, where the command is
+    executed in go-land. The stdout, stderr and exit codes for the command are returned by the
+    callback; these are then converted into python strings and integer respectively and returned
+    in a tuple. If the optional `raise_on_empty` boolean flag is set, and the command output is
+    empty an exception will be raised: the error will be set in the interpreter and NULL will be
+    returned.
+*/
+PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
+{
+    int raise = 0;
+    int ret_code = 0;
+    char **subprocess_args = NULL;
+    char **subprocess_env = NULL;
+    char *c_stdout = NULL;
+    char *c_stderr = NULL;
+    char *exception = NULL;
+    PyObject *pyResult = NULL;
+
+    if (!cb_get_subprocess_output) {
+        Py_RETURN_NONE;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    if (!build_command(args, kw, "O|O" PY_ARG_PARSE_TUPLE_KEYWORD_ONLY "O:get_subprocess_output", &subprocess_args,
+                       &subprocess_env, &raise)) {
+        goto cleanup;
     }
 
     // Release the GIL so Python can execute other checks while Go runs the subprocess
@@ -277,23 +444,256 @@ cleanup:
         cgo_free(exception);
     }
 
-    if (subprocess_args) {
-        for (i = 0; i <= subprocess_args_sz && subprocess_args[i]; i++) {
-            _free(subprocess_args[i]);
+    free_string_array(subprocess_args);
+    free_string_array(subprocess_env);
+
+    // Please note that if we get here we have a matching PyGILState_Ensure above, so we're safe.
+    PyGILState_Release(gstate);
+
+    // pyResult will be NULL in the face of error to raise the exception set by PyErr_SetString
+    return pyResult;
+}
+
+/*! \fn PyObject *start_subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
+    \brief This function implements the `_util.start_subprocess_output` python method, starting
+    a subprocess without waiting for it to exit.
+    \param self A PyObject* pointer to the _util module.
+    \param args A PyObject* pointer to the args tuple with the desired subprocess commands, and
+    optionally a boolean raise_on_empty flag.
+    \param kw A PyObject* pointer to the kw dict with optionally an env dict.
+    \return a new `_util.SubprocessOutput` for the running process, or NULL with the python
+    error set.
+
+    Takes the same arguments as `_util.subprocess_output`. The process is run in go-land and
+    its stdout is handed back in chunks as it is produced: iterating over the returned object
+    yields them, and its `result()` method waits for the process to exit and returns the
+    same tuple as `_util.subprocess_output`, with the stdout that was not iterated over yet.
+    The GIL is released whenever the caller waits for the process, so other checks keep
+    running meanwhile, and `raise_on_empty` is checked by `result()`.
+*/
+static PyObject *start_subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
+{
+    int raise = 0;
+    int64_t handle = 0;
+    char **subprocess_args = NULL;
+    char **subprocess_env = NULL;
+    char *exception = NULL;
+    subprocess_output_t *output = NULL;
+
+    if (!cb_start_subprocess || !cb_read_subprocess_output || !cb_stop_subprocess) {
+        Py_RETURN_NONE;
+    }
+
+    if (!build_command(args, kw, "O|O" PY_ARG_PARSE_TUPLE_KEYWORD_ONLY "O:start_subprocess_output",
+                       &subprocess_args, &subprocess_env, &raise)) {
+        goto cleanup;
+    }
+
+    // starting the process can take a while, let other checks run meanwhile
+    Py_BEGIN_ALLOW_THREADS
+    handle = cb_start_subprocess(subprocess_args, subprocess_env, &exception);
+    Py_END_ALLOW_THREADS
+
+    if (exception) {
+        PyErr_SetString(PyExc_Exception, exception);
+        goto cleanup;
+    }
+    if (handle == 0) {
+        PyErr_SetString(PyExc_Exception, "unable to start the subprocess");
+        goto cleanup;
+    }
+
+    util_state_t *state = (util_state_t *)PyModule_GetState(self);
+    output = PyObject_New(subprocess_output_t, state->subprocess_output_type);
+    if (output == NULL) {
+        cb_stop_subprocess(handle);
+        goto cleanup;
+    }
+    output->handle = handle;
+    output->raise_on_empty = raise;
+    output->got_output = 0;
+    output->busy = 0;
+    output->stderr_output = NULL;
+    output->ret_code = 0;
+    output->result = NULL;
+
+cleanup:
+    if (exception) {
+        cgo_free(exception);
+    }
+    free_string_array(subprocess_args);
+    free_string_array(subprocess_env);
+
+    return (PyObject *)output;
+}
+
+/*! \fn PyObject *read_chunk(subprocess_output_t *self)
+    \brief Waits for the next chunk of stdout of a subprocess, with the GIL released.
+    \param self The SubprocessOutput to read from.
+    \return a new reference to the chunk as a python string, or NULL once stdout was
+    entirely read, or with the python error set.
+
+    Once stdout is exhausted the process has exited, its stderr and exit code are kept
+    for `result()`.
+*/
+static PyObject *read_chunk(subprocess_output_t *self)
+{
+    int more = 0;
+    int ret_code = 0;
+    char *chunk = NULL;
+    size_t chunk_len = 0;
+    char *c_stderr = NULL;
+    char *exception = NULL;
+    PyObject *pyChunk = NULL;
+
+    if (self->handle == 0) {
+        return NULL;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "the subprocess output is already being read");
+        return NULL;
+    }
+
+    // other threads may use the object meanwhile, busy keeps them from reading concurrently
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    more = cb_read_subprocess_output(self->handle, &chunk, &chunk_len, &c_stderr, &ret_code, &exception);
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+
+    // the handle was released by go-land
+    if (!more) {
+        self->handle = 0;
+    }
+
+    if (exception) {
+        PyErr_SetString(PyExc_Exception, exception);
+        goto cleanup;
+    }
+
+    if (more) {
+        pyChunk = PyUnicode_DecodeUTF8(chunk ? chunk : "", chunk_len, NULL);
+        if (chunk_len > 0) {
+            self->got_output = 1;
         }
-        _free(subprocess_args);
+        goto cleanup;
+    }
+
+    self->ret_code = ret_code;
+    if (c_stderr) {
+        self->stderr_output = PyUnicode_FromString(c_stderr);
+    } else {
+        Py_INCREF(Py_None);
+        self->stderr_output = Py_None;
+    }
+
+cleanup:
+    if (chunk) {
+        cgo_free(chunk);
+    }
+    if (c_stderr) {
+        cgo_free(c_stderr);
+    }
+    if (exception) {
+        cgo_free(exception);
+    }
+
+    return pyChunk;
+}
+
+/*! \fn PyObject *subprocess_output_next(subprocess_output_t *self)
+    \brief Implements iteration over a `_util.SubprocessOutput`, yielding chunks of stdout.
+*/
+static PyObject *subprocess_output_next(subprocess_output_t *self)
+{
+    // NULL without an error set stops the iteration
+    return read_chunk(self);
+}
+
+/*! \fn PyObject *subprocess_output_result(subprocess_output_t *self, PyObject *unused)
+    \brief Implements `_util.SubprocessOutput.result`.
+    \return a PyObject * pointer to a python tuple with the stdout that was not read yet, the
+    stderr output and the command exit code.
+
+    Waits for the process to exit, with the GIL released. The exit code is -1 and stderr
+    None when the process was stopped by `close()`. If `raise_on_empty` was set and the
+    process produced no stdout at all, SubprocessOutputEmptyError is raised.
+*/
+static PyObject *subprocess_output_result(subprocess_output_t *self, PyObject *unused)
+{
+    PyObject *chunk = NULL;
+    PyObject *pyStdout = NULL;
+    PyObject *separator = NULL;
+
+    if (self->result) {
+        Py_INCREF(self->result);
+        return self->result;
     }
 
-    if (subprocess_env) {
-        for (i = 0; i <= subprocess_env_sz && subprocess_env[i]; i++) {
-            _free(subprocess_env[i]);
+    PyObject *chunks = PyList_New(0);
+    if (chunks == NULL) {
+        return NULL;
+    }
+    while ((chunk = read_chunk(self)) != NULL) {
+        int appended = PyList_Append(chunks, chunk);
+        Py_DECREF(chunk);
+        if (appended < 0) {
+            goto done;
         }
-        _free(subprocess_env);
+    }
+    if (PyErr_Occurred()) {
+        goto done;
     }
 
-    // Please note that if we get here we have a matching PyGILState_Ensure above, so we're safe.
-    PyGILState_Release(gstate);
+    if (self->raise_on_empty && !self->got_output) {
+        raiseEmptyOutputError();
+        goto done;
+    }
 
-    // pyResult will be NULL in the face of error to raise the exception set by PyErr_SetString
-    return pyResult;
+    if ((separator = PyUnicode_FromString("")) == NULL) {
+        goto done;
+    }
+    if ((pyStdout = PyUnicode_Join(separator, chunks)) == NULL) {
+        goto done;
+    }
+
+    self->result = Py_BuildValue("(OOi)", pyStdout, self->stderr_output ? self->stderr_output : Py_None,
+                                 self->stderr_output ? self->ret_code : -1);
+    Py_XINCREF(self->result);
+
+done:
+    Py_XDECREF(pyStdout);
+    Py_XDECREF(separator);
+    Py_DECREF(chunks);
+
+    return self->result;
+}
+
+/*! \fn PyObject *subprocess_output_close(subprocess_output_t *self, PyObject *unused)
+    \brief Implements `_util.SubprocessOutput.close`, stopping the process if it still runs.
+*/
+static PyObject *subprocess_output_close(subprocess_output_t *self, PyObject *unused)
+{
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "the subprocess output is being read");
+        return NULL;
+    }
+    if (self->handle != 0) {
+        cb_stop_subprocess(self->handle);
+        self->handle = 0;
+    }
+    Py_RETURN_NONE;
+}
+
+static void subprocess_output_dealloc(subprocess_output_t *self)
+{
+    PyTypeObject *tp = Py_TYPE(self);
+
+    if (self->handle != 0) {
+        cb_stop_subprocess(self->handle);
+    }
+    Py_XDECREF(self->stderr_output);
+    Py_XDECREF(self->result);
+    tp->tp_free((PyObject *)self);
+    Py_DECREF(tp);
 }
@@ -29,11 +29,37 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_start_subprocess_cb(cb_start_subprocess_t)
+    \brief Sets a callback to be used by rtloader to start a subprocess without waiting for
+    it to exit.
+    \param object A function pointer with cb_start_subprocess_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+/*! \fn void _set_read_subprocess_output_cb(cb_read_subprocess_output_t)
+    \brief Sets a callback to be used by rtloader to read the next chunk of stdout of a
+    subprocess started with the cb_start_subprocess_t callback.
+    \param object A function pointer with cb_read_subprocess_output_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+/*! \fn void _set_stop_subprocess_cb(cb_stop_subprocess_t)
+    \brief Sets a callback to be used by rtloader to stop a subprocess started with the
+    cb_start_subprocess_t callback, and release its handle.
+    \param object A function pointer with cb_stop_subprocess_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 
 #define _DOT "."
 #define _UTIL_MODULE_NAME "_util"
 #define _SUBPROCESS_OUTPUT_ERROR_NAME "SubprocessOutputEmptyError"
 #define _SUBPROCESS_OUTPUT_ERROR_NS_NAME _UTIL_MODULE_NAME _DOT _SUBPROCESS_OUTPUT_ERROR_NAME
+#define _SUBPROCESS_OUTPUT_NAME "SubprocessOutput"
+#define _SUBPROCESS_OUTPUT_NS_NAME _UTIL_MODULE_NAME _DOT _SUBPROCESS_OUTPUT_NAME
 
 // The keyword-only arguments separator ($) for PyArg_ParseTupleAndKeywords()
 // has been introduced in Python 3.3
@@ -47,6 +73,9 @@ extern "C" {
 PyMODINIT_FUNC PyInit__util(void);
 
 void _set_get_subprocess_output_cb(cb_get_subprocess_output_t);
+void _set_start_subprocess_cb(cb_start_subprocess_t);
+void _set_read_subprocess_output_cb(cb_read_subprocess_output_t);
+void _set_stop_subprocess_cb(cb_stop_subprocess_t);
 #ifdef __cplusplus
 }
 #endif
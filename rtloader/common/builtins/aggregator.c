@@ -3,6 +3,7 @@
 // This product includes software developed at Datadog (https://www.datadoghq.com/).
 // Copyright 2019-present Datadog, Inc.
 #include "aggregator.h"
+#include "fastcall.h"
 #include "rtloader_mem.h"
 #include "stringutils.h"
 
@@ -12,20 +13,25 @@ static cb_submit_service_check_t cb_submit_service_check = NULL;
 static cb_submit_event_t cb_submit_event = NULL;
 static cb_submit_histogram_bucket_t cb_submit_histogram_bucket = NULL;
 static cb_submit_event_platform_event_t cb_submit_event_platform_event = NULL;
+static cb_submit_metric_batch_t cb_submit_metric_batch = NULL;
 
 // forward declarations
-static PyObject *submit_metric(PyObject *self, PyObject *args);
-static PyObject *submit_service_check(PyObject *self, PyObject *args);
-static PyObject *submit_event(PyObject *self, PyObject *args);
-static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args);
-static PyObject *submit_event_platform_event(PyObject *self, PyObject *args);
-
+static PyObject *submit_metric(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *submit_service_check(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *submit_event(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *submit_histogram_bucket(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *submit_event_platform_event(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *submit_metrics_batch(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+
+// these are called for every sample a check submits, METH_FASTCALL spares us an argument
+// tuple allocation and the format string parsing on each call
 static PyMethodDef methods[] = {
-    { "submit_metric", (PyCFunction)submit_metric, METH_VARARGS, "Submit metrics." },
-    { "submit_service_check", (PyCFunction)submit_service_check, METH_VARARGS, "Submit service checks." },
-    { "submit_event", (PyCFunction)submit_event, METH_VARARGS, "Submit events." },
-    { "submit_histogram_bucket", (PyCFunction)submit_histogram_bucket, METH_VARARGS, "Submit histogram bucket." },
-    { "submit_event_platform_event", (PyCFunction)submit_event_platform_event, METH_VARARGS, "Submit event platform event." },
+    { "submit_metric", (PyCFunction)submit_metric, METH_FASTCALL, "Submit metrics." },
+    { "submit_service_check", (PyCFunction)submit_service_check, METH_FASTCALL, "Submit service checks." },
+    { "submit_event", (PyCFunction)submit_event, METH_FASTCALL, "Submit events." },
+    { "submit_histogram_bucket", (PyCFunction)submit_histogram_bucket, METH_FASTCALL, "Submit histogram bucket." },
+    { "submit_event_platform_event", (PyCFunction)submit_event_platform_event, METH_FASTCALL, "Submit event platform event." },
+    { "submit_metrics_batch", (PyCFunction)submit_metrics_batch, METH_FASTCALL, "Submit a batch of metrics." },
     { NULL, NULL } // guards
 };
 
@@ -48,13 +54,25 @@ static void add_constants(PyObject *m)
     PyModule_AddIntConstant(m, "HISTORATE", DATADOG_AGENT_RTLOADER_HISTORATE);
 }
 
-static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, AGGREGATOR_MODULE_NAME, NULL, -1, methods };
+static int module_exec(PyObject *m)
+{
+    add_constants(m);
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+static PyModuleDef_Slot module_slots[] = {
+    { Py_mod_exec, module_exec },
+#if PY_VERSION_HEX >= 0x030C0000
+    { Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED },
+#endif
+    { 0, NULL } // guards
+};
+
+static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, AGGREGATOR_MODULE_NAME, NULL, 0, methods, module_slots };
 
 PyMODINIT_FUNC PyInit_aggregator(void)
 {
-    PyObject *m = PyModule_Create(&module_def);
-    add_constants(m);
-    return m;
+    return PyModuleDef_Init(&module_def);
 }
 
 void _set_submit_metric_cb(cb_submit_metric_t cb)
@@ -82,6 +100,11 @@ void _set_submit_event_platform_event_cb(cb_submit_event_platform_event_t cb)
     cb_submit_event_platform_event = cb;
 }
 
+void _set_submit_metric_batch_cb(cb_submit_metric_batch_t cb)
+{
+    cb_submit_metric_batch = cb;
+}
+
 
 /*! \fn py_tag_to_c(PyObject *py_tags)
     \brief A function to convert a list of python strings (tags) into an
@@ -89,9 +112,11 @@ void _set_submit_event_platform_event_cb(cb_submit_event_platform_event_t cb)
     \return a char ** pointer to the C-representation of the provided python
     tag list. In the event of failure NULL is returned.
 
-    The returned char ** string array pointer is heap allocated here and should
-    be subsequently freed by the caller. This function may set and raise python
-    interpreter errors. The function is static and not in the builtin's API.
+    The returned char ** string array pointer is allocated from the thread's scratch
+    arena and is released by release_call_memory(). The C-strings it points to are
+    interned (see as_interned_string) and are not owned by the array. This function
+    may set and raise python interpreter errors. The function is static and not in
+    the builtin's API.
 */
 static char **py_tag_to_c(PyObject *py_tags)
 {
@@ -108,7 +133,7 @@ static char **py_tag_to_c(PyObject *py_tags)
         PyErr_SetString(PyExc_RuntimeError, "could not compute tags length");
         return NULL;
     } else if (len == 0) {
-        if (!(tags = _malloc(sizeof(*tags)))) {
+        if (!(tags = _arena_malloc(sizeof(*tags)))) {
             PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for tags");
             return NULL;
         }
@@ -121,7 +146,7 @@ static char **py_tag_to_c(PyObject *py_tags)
         goto done;
     }
 
-    if (!(tags = _malloc(sizeof(*tags) * (len + 1)))) {
+    if (!(tags = _arena_malloc(sizeof(*tags) * (len + 1)))) {
         PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for tags");
         goto done;
     }
@@ -131,7 +156,7 @@ static char **py_tag_to_c(PyObject *py_tags)
         // `item` is borrowed, no need to decref
         PyObject *item = PySequence_Fast_GET_ITEM(py_tags_list, i);
 
-        char *ctag = as_string(item);
+        char *ctag = as_interned_string(item);
         if (ctag == NULL) {
             continue;
         }
@@ -145,33 +170,32 @@ done:
     return tags;
 }
 
-/*! \fn free_tags(char **tags)
-    \brief A helper function to free the memory allocated by the py_tag_to_c() function.
+/*! \fn release_call_memory(void)
+    \brief A helper function to release the scratch memory used while converting the
+    arguments of a builtin call.
 
-    This function is for internal use and expects the tag array to be properly intialized,
-    and have a NULL canary at the end of the array, just like py_tag_to_c() initializes and
-    populates the array. Be mindful if using this function in any other context.
+    Every builtin calls it once, after the callback has returned: it resets the thread's
+    scratch arena, which holds the tag arrays built by py_tag_to_c() and the event fields,
+    and lets the intern table be trimmed. None of those pointers may be used afterwards.
 */
-static void free_tags(char **tags)
+static void release_call_memory(void)
 {
-    int i;
-    for (i = 0; tags[i] != NULL; i++) {
-        _free(tags[i]);
-    }
-    _free(tags);
+    _arena_reset();
+    release_interned_strings();
 }
 
-/*! \fn submit_metric(PyObject *self, PyObject *args)
+/*! \fn submit_metric(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief Aggregator builtin class method for metric submission.
     \param self A PyObject * pointer to self - the aggregator module.
-    \param args A PyObject * pointer to the python args or kwargs.
+    \param args A PyObject * array of the python positional args.
+    \param nargs The number of positional args.
     \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
 
     This function implements the `submit_metric` python callable in C and is used from the python code.
     More specifically, in the context of rtloader and datadog-agent, this is called from our python base check
     class to submit metrics to the aggregator.
 */
-static PyObject *submit_metric(PyObject *self, PyObject *args)
+static PyObject *submit_metric(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_submit_metric == NULL) {
         Py_RETURN_NONE;
@@ -179,7 +203,6 @@ static PyObject *submit_metric(PyObject *self, PyObject *args)
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    PyObject *check = NULL; // borrowed
     PyObject *py_tags = NULL; // borrowed
     char *name = NULL;
     char *hostname = NULL;
@@ -190,36 +213,41 @@ static PyObject *submit_metric(PyObject *self, PyObject *args)
     bool flush_first_value = false;
 
     // Python call: aggregator.submit_metric(self, check_id, aggregator.metric_type.GAUGE, name, value, tags, hostname, flush_first_value)
-    if (!PyArg_ParseTuple(args, "OsisdOs|b", &check, &check_id, &mt, &name, &value, &py_tags, &hostname, &flush_first_value)) {
+    if (!fastcall_check_nargs(nargs, 7, 8) || !fastcall_parse_string(args[1], 2, &check_id)
+        || !fastcall_parse_int(args[2], 3, &mt) || !fastcall_parse_string(args[3], 4, &name)
+        || !fastcall_parse_double(args[4], 5, &value) || !fastcall_parse_string(args[6], 7, &hostname)
+        || (nargs > 7 && !fastcall_parse_bool(args[7], 8, &flush_first_value))) {
         goto error;
     }
+    py_tags = args[5];
 
     if ((tags = py_tag_to_c(py_tags)) == NULL)
         goto error;
 
     cb_submit_metric(check_id, mt, name, value, tags, hostname, flush_first_value);
 
-    free_tags(tags);
-
+    release_call_memory();
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 
 error:
+    release_call_memory();
     PyGILState_Release(gstate);
     return NULL;
 }
 
-/*! \fn submit_service_check(PyObject *self, PyObject *args)
+/*! \fn submit_service_check(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief Aggregator builtin class method for service_check submission.
     \param self A PyObject * pointer to self - the aggregator module.
-    \param args A PyObject * pointer to the python args or kwargs.
+    \param args A PyObject * array of the python positional args.
+    \param nargs The number of positional args.
     \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
 
     This function implements the `submit_service_check` python callable in C and is used from the python code.
     More specifically, in the context of rtloader and datadog-agent, this is called from our python base check
     class to submit service_checks to the aggregator.
 */
-static PyObject *submit_service_check(PyObject *self, PyObject *args)
+static PyObject *submit_service_check(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_submit_service_check == NULL) {
         Py_RETURN_NONE;
@@ -228,7 +256,6 @@ static PyObject *submit_service_check(PyObject *self, PyObject *args)
     // acquiring GIL to be able to raise exception
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    PyObject *check = NULL; // borrowed
     PyObject *py_tags = NULL; // borrowed
     char *name = NULL;
     int status;
@@ -238,36 +265,40 @@ static PyObject *submit_service_check(PyObject *self, PyObject *args)
     char **tags = NULL;
 
     // aggregator.submit_service_check(self, check_id, name, status, tags, hostname, message)
-    if (!PyArg_ParseTuple(args, "OssiOss", &check, &check_id, &name, &status, &py_tags, &hostname, &message)) {
+    if (!fastcall_check_nargs(nargs, 7, 7) || !fastcall_parse_string(args[1], 2, &check_id)
+        || !fastcall_parse_string(args[2], 3, &name) || !fastcall_parse_int(args[3], 4, &status)
+        || !fastcall_parse_string(args[5], 6, &hostname) || !fastcall_parse_string(args[6], 7, &message)) {
         goto error;
     }
+    py_tags = args[4];
 
     if ((tags = py_tag_to_c(py_tags)) == NULL)
         goto error;
 
     cb_submit_service_check(check_id, name, status, tags, hostname, message);
 
-    free_tags(tags);
-
+    release_call_memory();
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 
 error:
+    release_call_memory();
     PyGILState_Release(gstate);
     return NULL;
 }
 
-/*! \fn submit_event(PyObject *self, PyObject *args)
+/*! \fn submit_event(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief Aggregator builtin class method for event submission.
     \param self A PyObject * pointer to self - the aggregator module.
-    \param args A PyObject * pointer to the python args or kwargs.
+    \param args A PyObject * array of the python positional args.
+    \param nargs The number of positional args.
     \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
 
     This function implements the `submit_event` python callable in C and is used from the python code.
     More specifically, in the context of rtloader and datadog-agent, this is called from our python base check
     class to submit events to the aggregator.
 */
-static PyObject *submit_event(PyObject *self, PyObject *args)
+static PyObject *submit_event(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_submit_event == NULL) {
         Py_RETURN_NONE;
@@ -275,7 +306,6 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    PyObject *check = NULL; // borrowed
     PyObject *event_dict = NULL; // borrowed
     PyObject *py_tags = NULL; // borrowed
     char *check_id = NULL;
@@ -283,11 +313,12 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
     PyObject * retval = NULL;
 
     // aggregator.submit_event(self, check_id, event)
-    if (!PyArg_ParseTuple(args, "OsO", &check, &check_id, &event_dict)) {
-        // error is set by PyArg_ParseTuple but we return NULL to raise
+    if (!fastcall_check_nargs(nargs, 3, 3) || !fastcall_parse_string(args[1], 2, &check_id)) {
+        // error is set by the fastcall helpers but we return NULL to raise
         retval = NULL;
         goto gstate_cleanup;
     }
+    event_dict = args[2];
 
     if (!PyDict_Check(event_dict)) {
         PyErr_SetString(PyExc_TypeError, "event must be a dict");
@@ -296,15 +327,15 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
         goto gstate_cleanup;
     }
 
-    if (!(ev = (event_t *)_malloc(sizeof(event_t)))) {
+    if (!(ev = (event_t *)_arena_malloc(sizeof(event_t)))) {
         PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for event");
         retval = NULL;
         goto gstate_cleanup;
     }
 
     // notice: PyDict_GetItemString returns a borrowed ref or NULL if key was not found
-    ev->title = as_string(PyDict_GetItemString(event_dict, "msg_title"));
-    ev->text = as_string(PyDict_GetItemString(event_dict, "msg_text"));
+    ev->title = as_arena_string(PyDict_GetItemString(event_dict, "msg_title"));
+    ev->text = as_arena_string(PyDict_GetItemString(event_dict, "msg_text"));
     // PyLong_AsLong will fail if called passing a NULL argument, be safe
     if (PyDict_GetItemString(event_dict, "timestamp") != NULL) {
         ev->ts = PyLong_AsLong(PyDict_GetItemString(event_dict, "timestamp"));
@@ -318,12 +349,12 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
     } else {
         ev->ts = 0;
     }
-    ev->priority = as_string(PyDict_GetItemString(event_dict, "priority"));
-    ev->host = as_string(PyDict_GetItemString(event_dict, "host"));
-    ev->alert_type = as_string(PyDict_GetItemString(event_dict, "alert_type"));
-    ev->aggregation_key = as_string(PyDict_GetItemString(event_dict, "aggregation_key"));
-    ev->source_type_name = as_string(PyDict_GetItemString(event_dict, "source_type_name"));
-    ev->event_type = as_string(PyDict_GetItemString(event_dict, "event_type"));
+    ev->priority = as_arena_string(PyDict_GetItemString(event_dict, "priority"));
+    ev->host = as_arena_string(PyDict_GetItemString(event_dict, "host"));
+    ev->alert_type = as_arena_string(PyDict_GetItemString(event_dict, "alert_type"));
+    ev->aggregation_key = as_arena_string(PyDict_GetItemString(event_dict, "aggregation_key"));
+    ev->source_type_name = as_arena_string(PyDict_GetItemString(event_dict, "source_type_name"));
+    ev->event_type = as_arena_string(PyDict_GetItemString(event_dict, "event_type"));
     // process the list of tags, set ev->tags = NULL if tags are missing
     py_tags = PyDict_GetItemString(event_dict, "tags");
     if (py_tags != NULL) {
@@ -331,7 +362,7 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
         if (ev->tags == NULL) {
             // we need to return NULL to raise the exception set by PyErr_SetString in py_tag_to_c
             retval = NULL;
-            goto ev_cleanup;
+            goto gstate_cleanup;
         }
     } else {
         ev->tags = NULL;
@@ -344,27 +375,14 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
     Py_INCREF(Py_None); //Increment, sice we are not using the macro Py_RETURN_NONE that does it for us
     retval = Py_None;
 
-ev_cleanup:
-    if (ev->tags != NULL) {
-        free_tags(ev->tags);
-    }
-    _free(ev->title);
-    _free(ev->text);
-    _free(ev->priority);
-    _free(ev->host);
-    _free(ev->alert_type);
-    _free(ev->aggregation_key);
-    _free(ev->source_type_name);
-    _free(ev->event_type);
-    _free(ev);
-
 gstate_cleanup:
+    release_call_memory();
     PyGILState_Release(gstate);
 
     return retval;
 }
 
-static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args)
+static PyObject *submit_histogram_bucket(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_submit_histogram_bucket == NULL) {
         Py_RETURN_NONE;
@@ -372,7 +390,6 @@ static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args)
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    PyObject *check = NULL; // borrowed
     PyObject *py_tags = NULL; // borrowed
     char *check_id = NULL;
     char *name = NULL;
@@ -385,26 +402,31 @@ static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args)
     bool flush_first_value = false;
 
     // Python call: aggregator.submit_histogram_bucket(self, metric string, value, lowerBound, upperBound, monotonic, hostname, tags, flush_first_value)
-    if (!PyArg_ParseTuple(args, "OssLffisO|b", &check, &check_id, &name, &value, &lower_bound, &upper_bound, &monotonic, &hostname, &py_tags, &flush_first_value)) {
+    if (!fastcall_check_nargs(nargs, 9, 10) || !fastcall_parse_string(args[1], 2, &check_id)
+        || !fastcall_parse_string(args[2], 3, &name) || !fastcall_parse_long_long(args[3], 4, &value)
+        || !fastcall_parse_float(args[4], 5, &lower_bound) || !fastcall_parse_float(args[5], 6, &upper_bound)
+        || !fastcall_parse_int(args[6], 7, &monotonic) || !fastcall_parse_string(args[7], 8, &hostname)
+        || (nargs > 9 && !fastcall_parse_bool(args[9], 10, &flush_first_value))) {
         goto error;
     }
+    py_tags = args[8];
 
     if ((tags = py_tag_to_c(py_tags)) == NULL)
         goto error;
 
     cb_submit_histogram_bucket(check_id, name, value, lower_bound, upper_bound, monotonic, hostname, tags, flush_first_value);
 
-    free_tags(tags);
-
+    release_call_memory();
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 
 error:
+    release_call_memory();
     PyGILState_Release(gstate);
     return NULL;
 }
 
-static PyObject *submit_event_platform_event(PyObject *self, PyObject *args)
+static PyObject *submit_event_platform_event(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_submit_event_platform_event == NULL) {
         Py_RETURN_NONE;
@@ -412,13 +434,15 @@ static PyObject *submit_event_platform_event(PyObject *self, PyObject *args)
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    PyObject *check = NULL;
     char *check_id = NULL;
     char *raw_event_ptr = NULL;
     Py_ssize_t raw_event_sz = 0;
     char *event_type = NULL;
 
-    if (!PyArg_ParseTuple(args, "Oss#s", &check, &check_id, &raw_event_ptr, &raw_event_sz, &event_type)) {
+    // aggregator.submit_event_platform_event(self, check_id, raw_event, event_type)
+    if (!fastcall_check_nargs(nargs, 4, 4) || !fastcall_parse_string(args[1], 2, &check_id)
+        || !fastcall_parse_string_and_size(args[2], 3, &raw_event_ptr, &raw_event_sz)
+        || !fastcall_parse_string(args[3], 4, &event_type)) {
         PyGILState_Release(gstate);
         return NULL;
     }
@@ -433,3 +457,112 @@ static PyObject *submit_event_platform_event(PyObject *self, PyObject *args)
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 }
+
+/*! \fn submit_metrics_batch(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+    \brief Aggregator builtin class method for batched metric submission.
+    \param self A PyObject * pointer to self - the aggregator module.
+    \param args A PyObject * array of the python positional args.
+    \param nargs The number of positional args.
+    \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
+
+    This function implements the `submit_metrics_batch` python callable in C. Each sample is a
+    `(metric_type, name, value, tags, hostname[, flush_first_value])` tuple. The whole batch is
+    converted up front and handed over to the agent with a single callback invocation, so a check
+    submitting thousands of samples only crosses into go-land once. When no batch callback has
+    been set, the samples are submitted one by one through the submit metric callback.
+*/
+static PyObject *submit_metrics_batch(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    if (cb_submit_metric_batch == NULL && cb_submit_metric == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    PyObject *py_samples = NULL; // borrowed
+    PyObject *py_samples_list = NULL; // new reference
+    metric_sample_t *samples = NULL;
+    char *check_id = NULL;
+    PyObject *retval = NULL;
+    int nb_samples = 0;
+
+    // Python call: aggregator.submit_metrics_batch(self, check_id, [(aggregator.GAUGE, name, value, tags, hostname, flush_first_value), ...])
+    if (!fastcall_check_nargs(nargs, 3, 3) || !fastcall_parse_string(args[1], 2, &check_id)) {
+        goto done;
+    }
+    py_samples = args[2];
+
+    py_samples_list = PySequence_Fast(py_samples, "samples must be a sequence"); // new reference
+    if (py_samples_list == NULL) {
+        goto done;
+    }
+
+    Py_ssize_t len = PySequence_Fast_GET_SIZE(py_samples_list);
+    if (len > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many samples in batch");
+        goto done;
+    } else if (len == 0) {
+        Py_INCREF(Py_None);
+        retval = Py_None;
+        goto done;
+    }
+
+    if (!(samples = _arena_malloc(sizeof(*samples) * len))) {
+        PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for samples");
+        goto done;
+    }
+
+    Py_ssize_t i;
+    for (i = 0; i < len; i++) {
+        // `item` is borrowed, no need to decref
+        PyObject *item = PySequence_Fast_GET_ITEM(py_samples_list, i);
+        metric_sample_t *sample = &samples[nb_samples];
+        PyObject *py_tags = NULL; // borrowed
+        int mt;
+
+        if (!PyTuple_Check(item)) {
+            PyErr_SetString(PyExc_TypeError, "each sample must be a tuple");
+            goto done;
+        }
+
+        // (metric_type, name, value, tags, hostname[, flush_first_value])
+        PyObject **fields = PySequence_Fast_ITEMS(item);
+        Py_ssize_t nfields = PyTuple_GET_SIZE(item);
+
+        sample->flush_first_value = false;
+        // name and hostname point to the UTF-8 buffers cached on the python strings, they
+        // remain valid for as long as `py_samples_list` holds a reference to the tuple
+        if (!fastcall_check_nargs(nfields, 5, 6) || !fastcall_parse_int(fields[0], 1, &mt)
+            || !fastcall_parse_string(fields[1], 2, &sample->name) || !fastcall_parse_double(fields[2], 3, &sample->value)
+            || !fastcall_parse_string(fields[4], 5, &sample->hostname)
+            || (nfields > 5 && !fastcall_parse_bool(fields[5], 6, &sample->flush_first_value))) {
+            goto done;
+        }
+        sample->type = (metric_type_t)mt;
+        py_tags = fields[3];
+
+        if ((sample->tags = py_tag_to_c(py_tags)) == NULL) {
+            goto done;
+        }
+        nb_samples++;
+    }
+
+    if (cb_submit_metric_batch != NULL) {
+        cb_submit_metric_batch(check_id, samples, nb_samples);
+    } else {
+        int j;
+        for (j = 0; j < nb_samples; j++) {
+            cb_submit_metric(check_id, samples[j].type, samples[j].name, samples[j].value, samples[j].tags,
+                             samples[j].hostname, samples[j].flush_first_value);
+        }
+    }
+
+    Py_INCREF(Py_None);
+    retval = Py_None;
+
+done:
+    release_call_memory();
+    Py_XDECREF(py_samples_list);
+    PyGILState_Release(gstate);
+    return retval;
+}
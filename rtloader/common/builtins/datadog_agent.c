@@ -4,6 +4,7 @@
 // Copyright 2019-present Datadog, Inc.
 #include "datadog_agent.h"
 #include "cgo_free.h"
+#include "fastcall.h"
 #include "rtloader_mem.h"
 #include "stringutils.h"
 
@@ -12,6 +13,7 @@
 // these must be set by the Agent
 static cb_get_clustername_t cb_get_clustername = NULL;
 static cb_get_config_t cb_get_config = NULL;
+static cb_get_config_binary_t cb_get_config_binary = NULL;
 static cb_get_hostname_t cb_get_hostname = NULL;
 static cb_get_host_tags_t cb_get_host_tags = NULL;
 static cb_tracemalloc_enabled_t cb_tracemalloc_enabled = NULL;
@@ -30,13 +32,13 @@ static cb_emit_agent_telemetry_t cb_emit_agent_telemetry = NULL;
 
 // forward declarations
 static PyObject *get_clustername(PyObject *self, PyObject *args);
-static PyObject *get_config(PyObject *self, PyObject *args);
+static PyObject *get_config(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 static PyObject *get_hostname(PyObject *self, PyObject *args);
 static PyObject *get_host_tags(PyObject *self, PyObject *args);
 static PyObject *tracemalloc_enabled(PyObject *self, PyObject *args);
 static PyObject *get_version(PyObject *self, PyObject *args);
 static PyObject *headers(PyObject *self, PyObject *args, PyObject *kwargs);
-static PyObject *log_message(PyObject *self, PyObject *args);
+static PyObject *log_message(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 static PyObject *send_log(PyObject *self, PyObject *args);
 static PyObject *set_check_metadata(PyObject *self, PyObject *args);
 static PyObject *set_external_tags(PyObject *self, PyObject *args);
@@ -50,13 +52,13 @@ static PyObject *emit_agent_telemetry(PyObject *self, PyObject *args, PyObject *
 
 static PyMethodDef methods[] = {
     { "get_clustername", get_clustername, METH_NOARGS, "Get the cluster name." },
-    { "get_config", get_config, METH_VARARGS, "Get an Agent config item." },
+    { "get_config", (PyCFunction)get_config, METH_FASTCALL, "Get an Agent config item." },
     { "get_hostname", get_hostname, METH_NOARGS, "Get the hostname." },
     { "get_host_tags", get_host_tags, METH_NOARGS, "Get the host tags." },
     { "tracemalloc_enabled", tracemalloc_enabled, METH_VARARGS, "Gets if tracemalloc is enabled." },
     { "get_version", get_version, METH_NOARGS, "Get Agent version." },
     { "headers", (PyCFunction)headers, METH_VARARGS | METH_KEYWORDS, "Get standard set of HTTP headers." },
-    { "log", log_message, METH_VARARGS, "Log a message through the agent logger." },
+    { "log", (PyCFunction)log_message, METH_FASTCALL, "Log a message through the agent logger." },
     { "send_log", send_log, METH_VARARGS, "Submit a log for Checks." },
     { "set_check_metadata", set_check_metadata, METH_VARARGS, "Send metadata for Checks." },
     { "set_external_tags", set_external_tags, METH_VARARGS, "Send external host tags." },
@@ -70,11 +72,18 @@ static PyMethodDef methods[] = {
     { NULL, NULL } // guards
 };
 
-static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, DATADOG_AGENT_MODULE_NAME, NULL, -1, methods };
+static PyModuleDef_Slot module_slots[] = {
+#if PY_VERSION_HEX >= 0x030C0000
+    { Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED },
+#endif
+    { 0, NULL } // guards
+};
+
+static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, DATADOG_AGENT_MODULE_NAME, NULL, 0, methods, module_slots };
 
 PyMODINIT_FUNC PyInit_datadog_agent(void)
 {
-    return PyModule_Create(&module_def);
+    return PyModuleDef_Init(&module_def);
 }
 
 void _set_get_version_cb(cb_get_version_t cb)
@@ -87,6 +96,11 @@ void _set_get_config_cb(cb_get_config_t cb)
     cb_get_config = cb;
 }
 
+void _set_get_config_binary_cb(cb_get_config_binary_t cb)
+{
+    cb_get_config_binary = cb;
+}
+
 void _set_headers_cb(cb_headers_t cb)
 {
     cb_headers = cb;
@@ -191,11 +205,12 @@ PyObject *get_version(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
-/*! \fn PyObject *get_config(PyObject *self, PyObject *args)
+/*! \fn PyObject *get_config(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief This function implements the `datadog-agent.get_config` method, allowing
     to collect elements in the agent configuration, from the agent.
     \param self A PyObject* pointer to the `datadog_agent` module.
-    \param args A PyObject* pointer to a tuple containing a python string.
+    \param args A PyObject* array containing a python string.
+    \param nargs The number of positional args.
     \return a PyObject * pointer to a safe unmarshaled python object. Or `None`
     if the callback is unavailable.
 
@@ -206,6 +221,10 @@ PyObject *get_version(PyObject *self, PyObject *args)
     unmarshaled by the `yaml.safe_load` function when calling `from_yaml()` with
     the payload returned by callback. If no callback is set, `None` will be returned.
 
+    When the `cb_get_config_binary()` callback is set, it is tried first and the value
+    is decoded with `from_binary()`, sparing the YAML round-trip. The YAML callback is
+    only used when it returns no payload.
+
     Before RtLoader the Agent used reflection to inspect the contents of a configuration
     value and the CPython API to perform conversion to a Python equivalent. Such
     a conversion wouldn't be possible in a Python-agnostic way so we use YAML to
@@ -217,21 +236,41 @@ PyObject *get_version(PyObject *self, PyObject *args)
     string, for python2, which would be a breaking change from the previous
     version of the agent.
 */
-PyObject *get_config(PyObject *self, PyObject *args)
+PyObject *get_config(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     // callback must be set
-    if (cb_get_config == NULL) {
+    if (cb_get_config == NULL && cb_get_config_binary == NULL) {
         Py_RETURN_NONE;
     }
 
     char *key = NULL;
-    // PyArg_ParseTuple returns a pointer to the existing string in &key
+    // fastcall_parse_string returns a pointer to the existing string in &key
     // No need to free the result.
-    if (!PyArg_ParseTuple(args, "s", &key)) {
+    if (!fastcall_check_nargs(nargs, 1, 1) || !fastcall_parse_string(args[0], 1, &key)) {
         return NULL;
     }
 
     char *data = NULL;
+    if (cb_get_config_binary != NULL) {
+        size_t len = 0;
+        cb_get_config_binary(key, &data, &len);
+        if (data != NULL) {
+            // new ref
+            PyObject *value = from_binary(data, len);
+            cgo_free(data);
+            if (value == NULL) {
+                // clear error set by `from_binary`
+                PyErr_Clear();
+                Py_RETURN_NONE;
+            }
+            return value;
+        }
+        // no payload for unset keys and values that can't be encoded, try YAML
+        if (cb_get_config == NULL) {
+            Py_RETURN_NONE;
+        }
+    }
+
     cb_get_config(key, &data);
 
     // new ref
@@ -421,11 +460,12 @@ PyObject *tracemalloc_enabled(PyObject *self, PyObject *args)
     Py_RETURN_FALSE;
 }
 
-/*! \fn PyObject *log_message(PyObject *self, PyObject *args)
+/*! \fn PyObject *log_message(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief This function implements the `datadog_agent.log` method, allowing to log
     python messages using the agent's go logging subsytem and its facilities.
     \param self A PyObject* pointer to the `datadog_agent` module.
-    \param args A PyObject* pointer to any empty tuple, as no input args are taken.
+    \param args A PyObject* array containing the message and the log level.
+    \param nargs The number of positional args.
     \return a PyObject * pointer to a python string with the canonical clustername. Or
     `None` if the callback is unavailable.
 
@@ -434,16 +474,17 @@ PyObject *tracemalloc_enabled(PyObject *self, PyObject *args)
     the agent logging facilities from python-land.
     Should the callback not be available the function will do nothing.
 */
-static PyObject *log_message(PyObject *self, PyObject *args)
+static PyObject *log_message(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     char *message = NULL;
     int log_level;
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    // PyArg_ParseTuple returns a pointer to the existing string in &message
+    // fastcall_parse_string returns a pointer to the existing string in &message
     // No need to free the result.
-    if (!PyArg_ParseTuple(args, "si", &message, &log_level)) {
+    if (!fastcall_check_nargs(nargs, 2, 2) || !fastcall_parse_string(args[0], 1, &message)
+        || !fastcall_parse_int(args[1], 2, &log_level)) {
         PyGILState_Release(gstate);
         return NULL;
     }
@@ -34,6 +34,15 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_get_config_binary_cb(cb_get_config_binary_t)
+    \brief Sets a callback to be used by rtloader to collect the agent configuration in the
+    binary config encoding.
+    \param object A function pointer with cb_get_config_binary_t prototype to the
+    callback function.
+
+    When set, it takes precedence over the YAML callback.
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 /*! \fn void _set_headers_cb(cb_headers_t)
     \brief Sets a callback to be used by rtloader to collect the typical HTTP headers for
     agent requests.
@@ -141,6 +150,7 @@ PyMODINIT_FUNC PyInit_datadog_agent(void);
 
 void _set_get_clustername_cb(cb_get_clustername_t);
 void _set_get_config_cb(cb_get_config_t);
+void _set_get_config_binary_cb(cb_get_config_binary_t);
 void _set_get_hostname_cb(cb_get_hostname_t);
 void _set_get_host_tags_cb(cb_get_host_tags_t);
 void _set_tracemalloc_enabled_cb(cb_tracemalloc_enabled_t);
@@ -19,11 +19,18 @@ static PyMethodDef methods[] = {
     { NULL, NULL } // guards
 };
 
-static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, KUBEUTIL_MODULE_NAME, NULL, -1, methods };
+static PyModuleDef_Slot module_slots[] = {
+#if PY_VERSION_HEX >= 0x030C0000
+    { Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED },
+#endif
+    { 0, NULL } // guards
+};
+
+static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, KUBEUTIL_MODULE_NAME, NULL, 0, methods, module_slots };
 
 PyMODINIT_FUNC PyInit_kubeutil(void)
 {
-    return PyModule_Create(&module_def);
+    return PyModuleDef_Init(&module_def);
 }
 
 void _set_get_connection_info_cb(cb_get_connection_info_t cb)
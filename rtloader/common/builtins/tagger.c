@@ -6,30 +6,47 @@
 #include "tagger.h"
 
 #include "cgo_free.h"
+#include "fastcall.h"
 #include "stringutils.h"
 
 // these must be set by the Agent
 static cb_tags_t cb_tags = NULL;
 
-/*! \fn int parseArgs(PyObject *args, char **id, int *cardinality)
+// upper bound on the number of cached (id, cardinality) entries
+#define MAX_CACHED_TAGS 10000
+
+// tags_generation is bumped by the Agent from any thread; zero disables the cache.
+// Generations are taken from tags_generation_counter, which is never reset, so
+// re-enabling the cache never reuses the generation of entries cached before.
+static uint64_t tags_generation = 0;
+static uint64_t tags_generation_counter = 0;
+
+// the cache lives in the module state so every interpreter gets its own copy,
+// it is only accessed with the GIL of that interpreter held.
+typedef struct {
+    PyObject *cache; // (id, cardinality) -> tuple of tags
+    uint64_t generation;
+} tagger_state_t;
+
+/*! \fn int parseArgs(PyObject *const *args, Py_ssize_t nargs, char **id, int *cardinality)
     \brief This function parses the python arguments to it's C homonyms for
     entity id and cardinality.
-    \param args A PyObject* pointer to the corresponding python args.
+    \param args A PyObject* array of the corresponding python positional args.
+    \param nargs The number of positional args.
     \param id A char** C-string pointer, it will be set to the entity id string.
     \param cardinality An int* pointer, it will be set to the corresponding tag
     cardinality for the entity id.
     \return an int value - non-zero for success; zero for failure.
 
-    This function assumes the provided C-string array has been allocated with cgo
-    and frees it with the cgo_free callback for safety. The parameter passed should
-    not be used after calling this function. The list and string python references
-    are created by this function, no futher considerations are necessary.
+    The entity id C-string is owned by the python string object and must not be freed.
+    A python error is set on failure.
 */
-int parseArgs(PyObject *args, char **id, int *cardinality)
+int parseArgs(PyObject *const *args, Py_ssize_t nargs, char **id, int *cardinality)
 {
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    if (!PyArg_ParseTuple(args, "si", id, cardinality)) {
+    if (!fastcall_check_nargs(nargs, 2, 2) || !fastcall_parse_string(args[0], 1, id)
+        || !fastcall_parse_int(args[1], 2, cardinality)) {
         PyGILState_Release(gstate);
         return 0;
     }
@@ -68,12 +85,69 @@ PyObject *buildTagsList(char **tags)
     return res;
 }
 
-/*! \fn PyObject *tag(PyObject *self, PyObject *args)
+/*! \fn PyObject *fetchTags(PyObject *module, PyObject *id, char *cid, int cardinality)
+    \brief returns the tag list for an entity, using the tags cache if enabled.
+    \param module A PyObject* pointer to the tagger module holding the cache.
+    \param id A PyObject* pointer to the python entity id string, used in the cache key.
+    \param cid A char* C-string for the entity id, passed to the cb_tags callback.
+    \param cardinality The tag cardinality.
+    \return a new PyObject * tag list, or NULL on error.
+
+    Cached entries are immutable tuples so they can be shared between calls; the
+    caller always gets a fresh list, as it may mutate it. An entry is only stored
+    if the generation did not change while cb_tags was running, so tags fetched
+    before a tagger update never outlive it.
+*/
+static PyObject *fetchTags(PyObject *module, PyObject *id, char *cid, int cardinality)
+{
+    tagger_state_t *state = (tagger_state_t *)PyModule_GetState(module);
+    uint64_t generation = __atomic_load_n(&tags_generation, __ATOMIC_ACQUIRE);
+    if (generation == 0 || state == NULL || state->cache == NULL) {
+        return buildTagsList(cb_tags(cid, cardinality));
+    }
+
+    PyObject *tags_cache = state->cache;
+    if (generation != state->generation) {
+        PyDict_Clear(tags_cache);
+        state->generation = generation;
+    }
+
+    PyObject *key = Py_BuildValue("(Oi)", id, cardinality);
+    if (key == NULL) {
+        return NULL;
+    }
+
+    // borrowed reference
+    PyObject *cached = PyDict_GetItemWithError(tags_cache, key);
+    if (cached != NULL) {
+        Py_DECREF(key);
+        return PySequence_List(cached);
+    } else if (PyErr_Occurred()) {
+        Py_DECREF(key);
+        return NULL;
+    }
+
+    PyObject *tags = buildTagsList(cb_tags(cid, cardinality));
+    if (tags != NULL && PyDict_GET_SIZE(tags_cache) < MAX_CACHED_TAGS
+        && __atomic_load_n(&tags_generation, __ATOMIC_ACQUIRE) == generation) {
+        PyObject *entry = PyList_AsTuple(tags);
+        if (entry == NULL || PyDict_SetItem(tags_cache, key, entry) < 0) {
+            // caching is best effort
+            PyErr_Clear();
+        }
+        Py_XDECREF(entry);
+    }
+    Py_DECREF(key);
+    return tags;
+}
+
+/*! \fn PyObject *tag(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief builds a tag list as per the entity id and cardinality passed as method
     arguments.
     \param self A PyObject* pointer to the tagger module.
-    \param args A PyObject* pointer to the tag python args, expected to contain the
+    \param args A PyObject* array of the tag python args, expected to contain the
     id and the cardinality.
+    \param nargs The number of positional args.
     \return a PyObject * pointer to the tag list, NONE if callback not set, or NULL in an error.
 
     The method will return a tag list as long as the cardinality provided is
@@ -81,7 +155,7 @@ PyObject *buildTagsList(char **tags)
     callback, please read more about the internals of the registered callback.
     There are important memory considerations so please keep that in mind.
 */
-PyObject *tag(PyObject *self, PyObject *args)
+PyObject *tag(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_tags == NULL) {
         // Py_RETURN_NONE macro increases the refcount on Py_None
@@ -90,7 +164,7 @@ PyObject *tag(PyObject *self, PyObject *args)
 
     char *id;
     int cardinality;
-    if (!parseArgs(args, &id, &cardinality)) {
+    if (!parseArgs(args, nargs, &id, &cardinality)) {
         return NULL;
     }
 
@@ -105,15 +179,16 @@ PyObject *tag(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    return buildTagsList(cb_tags(id, cardinality));
+    return fetchTags(self, args[0], id, cardinality);
 }
 
-/*! \fn PyObject *get_tag(PyObject *self, PyObject *args)
+/*! \fn PyObject *get_tag(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     \brief builds a tag list as per the entity id and cardinality passed as
     arguments.
     \param self A PyObject* pointer to the tagger module.
-    \param args A PyObject* pointer to the python args, expected to
+    \param args A PyObject* array of the python args, expected to
     contain the id and the cardinality.
+    \param nargs The number of positional args.
     \return a PyObject * pointer to the python tag list.
 
     This method is deprecated in favor of tag(), it will similarly receive an
@@ -123,7 +198,7 @@ PyObject *tag(PyObject *self, PyObject *args)
     the registered callback. There are important memory considerations so please
     keep that in mind.
 */
-PyObject *get_tags(PyObject *self, PyObject *args)
+PyObject *get_tags(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     if (cb_tags == NULL) {
         // Py_RETURN_NONE macro increases the refcount on Py_None
@@ -132,7 +207,7 @@ PyObject *get_tags(PyObject *self, PyObject *args)
 
     char *id;
     int highCard;
-    if (!parseArgs(args, &id, &highCard)) {
+    if (!parseArgs(args, nargs, &id, &highCard)) {
         return NULL;
     }
 
@@ -143,7 +218,7 @@ PyObject *get_tags(PyObject *self, PyObject *args)
         cardinality = DATADOG_AGENT_RTLOADER_TAGGER_LOW;
     }
 
-    return buildTagsList(cb_tags(id, cardinality));
+    return fetchTags(self, args[0], id, cardinality);
 }
 
 void _set_tags_cb(cb_tags_t cb)
@@ -151,9 +226,20 @@ void _set_tags_cb(cb_tags_t cb)
     cb_tags = cb;
 }
 
+void _bump_tags_cache_generation(void)
+{
+    uint64_t generation = __atomic_add_fetch(&tags_generation_counter, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&tags_generation, generation, __ATOMIC_RELEASE);
+}
+
+void _disable_tags_cache(void)
+{
+    __atomic_store_n(&tags_generation, 0, __ATOMIC_RELEASE);
+}
+
 static PyMethodDef methods[] = {
-    { "tag", (PyCFunction)tag, METH_VARARGS, "Get tags for an entity." },
-    { "get_tags", (PyCFunction)get_tags, METH_VARARGS, "(Deprecated) Get tags for an entity." },
+    { "tag", (PyCFunction)tag, METH_FASTCALL, "Get tags for an entity." },
+    { "get_tags", (PyCFunction)get_tags, METH_FASTCALL, "(Deprecated) Get tags for an entity." },
     { NULL, NULL } // guards
 };
 
@@ -172,11 +258,52 @@ static void add_constants(PyObject *m)
     PyModule_AddIntConstant(m, "HIGH", DATADOG_AGENT_RTLOADER_TAGGER_HIGH);
 }
 
-static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, TAGGER_MODULE_NAME, NULL, -1, methods };
+static int module_exec(PyObject *m)
+{
+    tagger_state_t *state = (tagger_state_t *)PyModule_GetState(m);
+    state->cache = PyDict_New();
+    state->generation = 0;
+    if (state->cache == NULL) {
+        return -1;
+    }
+
+    add_constants(m);
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+static int module_traverse(PyObject *m, visitproc visit, void *arg)
+{
+    tagger_state_t *state = (tagger_state_t *)PyModule_GetState(m);
+    Py_VISIT(state->cache);
+    return 0;
+}
+
+static int module_clear(PyObject *m)
+{
+    tagger_state_t *state = (tagger_state_t *)PyModule_GetState(m);
+    Py_CLEAR(state->cache);
+    return 0;
+}
+
+static void module_free(void *m)
+{
+    module_clear((PyObject *)m);
+}
+
+static PyModuleDef_Slot module_slots[] = {
+    { Py_mod_exec, module_exec },
+#if PY_VERSION_HEX >= 0x030C0000
+    { Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED },
+#endif
+    { 0, NULL } // guards
+};
+
+static struct PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT, TAGGER_MODULE_NAME, NULL, sizeof(tagger_state_t), methods, module_slots,
+    module_traverse,       module_clear,       module_free
+};
 
 PyMODINIT_FUNC PyInit_tagger(void)
 {
-    PyObject *module = PyModule_Create(&module_def);
-    add_constants(module);
-    return module;
+    return PyModuleDef_Init(&module_def);
 }
@@ -32,6 +32,22 @@
     tagger generate tags. This memory should be freed with the cgo_free helper
     available when done.
 */
+/*! \fn void _bump_tags_cache_generation(void)
+    \brief Invalidates the tags cached by the tag and get_tags methods.
+
+    Tag lists returned by the cb_tags callback are cached per entity id and
+    cardinality, and stamped with the generation they were fetched at. Bumping
+    the generation drops every cached entry on the next lookup. The cache stays
+    disabled until the first bump, so callers that never bump keep the uncached
+    behavior. The counter is updated atomically: the GIL is not required.
+*/
+/*! \fn void _disable_tags_cache(void)
+    \brief Disables the tags cache until the next _bump_tags_cache_generation.
+
+    Resets the generation to zero, so the tag and get_tags methods call cb_tags
+    again instead of serving entries that are no longer invalidated. The GIL is
+    not required.
+*/
 
 #include <Python.h>
 #include <rtloader_types.h>
@@ -45,6 +61,8 @@ extern "C" {
 #endif
 
 void _set_tags_cb(cb_tags_t);
+void _bump_tags_cache_generation(void);
+void _disable_tags_cache(void);
 
 #ifdef __cplusplus
 }
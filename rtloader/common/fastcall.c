@@ -0,0 +1,160 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#include "fastcall.h"
+
+#include <limits.h>
+#include <string.h>
+
+int fastcall_check_nargs(Py_ssize_t nargs, Py_ssize_t min, Py_ssize_t max)
+{
+    if (nargs >= min && nargs <= max) {
+        return 1;
+    }
+
+    if (min == max) {
+        PyErr_Format(PyExc_TypeError, "function takes exactly %zd arguments (%zd given)", min, nargs);
+    } else if (nargs < min) {
+        PyErr_Format(PyExc_TypeError, "function takes at least %zd arguments (%zd given)", min, nargs);
+    } else {
+        PyErr_Format(PyExc_TypeError, "function takes at most %zd arguments (%zd given)", max, nargs);
+    }
+    return 0;
+}
+
+int fastcall_parse_string(PyObject *arg, Py_ssize_t pos, char **value)
+{
+    Py_ssize_t size = 0;
+
+    if (!PyUnicode_Check(arg)) {
+        PyErr_Format(PyExc_TypeError, "argument %zd must be str, not %.50s", pos, Py_TYPE(arg)->tp_name);
+        return 0;
+    }
+
+    // the UTF-8 representation is cached on the object, this is a no-op on ASCII strings
+    const char *buf = PyUnicode_AsUTF8AndSize(arg, &size);
+    if (buf == NULL) {
+        return 0;
+    }
+    if ((size_t)size != strlen(buf)) {
+        PyErr_SetString(PyExc_ValueError, "embedded null character");
+        return 0;
+    }
+
+    *value = (char *)buf;
+    return 1;
+}
+
+int fastcall_parse_string_and_size(PyObject *arg, Py_ssize_t pos, char **value, Py_ssize_t *size)
+{
+    if (PyBytes_Check(arg)) {
+        *value = PyBytes_AS_STRING(arg);
+        *size = PyBytes_GET_SIZE(arg);
+        return 1;
+    }
+
+    if (!PyUnicode_Check(arg)) {
+        PyErr_Format(PyExc_TypeError, "argument %zd must be str or bytes, not %.50s", pos, Py_TYPE(arg)->tp_name);
+        return 0;
+    }
+
+    const char *buf = PyUnicode_AsUTF8AndSize(arg, size);
+    if (buf == NULL) {
+        return 0;
+    }
+
+    *value = (char *)buf;
+    return 1;
+}
+
+// integer format units refuse floats rather than silently truncating them
+static int check_not_float(PyObject *arg)
+{
+    if (PyFloat_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "integer argument expected, got float");
+        return 0;
+    }
+    return 1;
+}
+
+int fastcall_parse_int(PyObject *arg, Py_ssize_t pos, int *value)
+{
+    if (!check_not_float(arg)) {
+        return 0;
+    }
+
+    long ival = PyLong_AsLong(arg);
+    if (ival == -1 && PyErr_Occurred()) {
+        return 0;
+    }
+    if (ival > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "signed integer is greater than maximum");
+        return 0;
+    } else if (ival < INT_MIN) {
+        PyErr_SetString(PyExc_OverflowError, "signed integer is less than minimum");
+        return 0;
+    }
+
+    *value = (int)ival;
+    return 1;
+}
+
+int fastcall_parse_long_long(PyObject *arg, Py_ssize_t pos, long long *value)
+{
+    if (!check_not_float(arg)) {
+        return 0;
+    }
+
+    long long ival = PyLong_AsLongLong(arg);
+    if (ival == -1 && PyErr_Occurred()) {
+        return 0;
+    }
+
+    *value = ival;
+    return 1;
+}
+
+int fastcall_parse_double(PyObject *arg, Py_ssize_t pos, double *value)
+{
+    double dval = PyFloat_AsDouble(arg);
+    if (dval == -1.0 && PyErr_Occurred()) {
+        return 0;
+    }
+
+    *value = dval;
+    return 1;
+}
+
+int fastcall_parse_float(PyObject *arg, Py_ssize_t pos, float *value)
+{
+    double dval = 0;
+    if (!fastcall_parse_double(arg, pos, &dval)) {
+        return 0;
+    }
+
+    *value = (float)dval;
+    return 1;
+}
+
+int fastcall_parse_bool(PyObject *arg, Py_ssize_t pos, bool *value)
+{
+    if (!check_not_float(arg)) {
+        return 0;
+    }
+
+    long ival = PyLong_AsLong(arg);
+    if (ival == -1 && PyErr_Occurred()) {
+        return 0;
+    }
+    if (ival < 0) {
+        PyErr_SetString(PyExc_OverflowError, "unsigned byte integer is less than minimum");
+        return 0;
+    } else if (ival > UCHAR_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "unsigned byte integer is greater than maximum");
+        return 0;
+    }
+
+    *value = ival != 0;
+    return 1;
+}
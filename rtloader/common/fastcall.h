@@ -0,0 +1,68 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#ifndef DATADOG_AGENT_RTLOADER_FASTCALL_H
+#define DATADOG_AGENT_RTLOADER_FASTCALL_H
+
+/*! \file fastcall.h
+    \brief RtLoader METH_FASTCALL argument helpers header file.
+
+    The prototypes here defined convert the positional arguments of builtins registered
+    with `METH_FASTCALL` to their C homonyms. They mirror the `PyArg_ParseTuple` format
+    units the builtins used to rely on - and the errors those raise - without allocating
+    an argument tuple nor interpreting a format string on every call. All of them return
+    a non-zero value on success; on failure zero is returned and a python error is set.
+    The `pos` argument is the 1-based position of the argument, used in error messages.
+    The GIL must be held.
+*/
+/*! \fn int fastcall_check_nargs(Py_ssize_t nargs, Py_ssize_t min, Py_ssize_t max)
+    \brief Checks that the number of positional arguments is within [min, max].
+*/
+/*! \fn int fastcall_parse_string(PyObject *arg, Py_ssize_t pos, char **value)
+    \brief Equivalent to the `s` format unit: the UTF-8 buffer of a str without embedded
+    null characters. The buffer is owned by the python object and must not be freed.
+*/
+/*! \fn int fastcall_parse_string_and_size(PyObject *arg, Py_ssize_t pos, char **value, Py_ssize_t *size)
+    \brief Equivalent to the `s#` format unit for str and bytes objects. The buffer is
+    owned by the python object and must not be freed.
+*/
+/*! \fn int fastcall_parse_int(PyObject *arg, Py_ssize_t pos, int *value)
+    \brief Equivalent to the `i` format unit.
+*/
+/*! \fn int fastcall_parse_long_long(PyObject *arg, Py_ssize_t pos, long long *value)
+    \brief Equivalent to the `L` format unit.
+*/
+/*! \fn int fastcall_parse_double(PyObject *arg, Py_ssize_t pos, double *value)
+    \brief Equivalent to the `d` format unit.
+*/
+/*! \fn int fastcall_parse_float(PyObject *arg, Py_ssize_t pos, float *value)
+    \brief Equivalent to the `f` format unit.
+*/
+/*! \fn int fastcall_parse_bool(PyObject *arg, Py_ssize_t pos, bool *value)
+    \brief Equivalent to the `b` format unit, any non-zero byte value is true.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int fastcall_check_nargs(Py_ssize_t nargs, Py_ssize_t min, Py_ssize_t max);
+int fastcall_parse_string(PyObject *arg, Py_ssize_t pos, char **value);
+int fastcall_parse_string_and_size(PyObject *arg, Py_ssize_t pos, char **value, Py_ssize_t *size);
+int fastcall_parse_int(PyObject *arg, Py_ssize_t pos, int *value);
+int fastcall_parse_long_long(PyObject *arg, Py_ssize_t pos, long long *value);
+int fastcall_parse_double(PyObject *arg, Py_ssize_t pos, double *value);
+int fastcall_parse_float(PyObject *arg, Py_ssize_t pos, float *value);
+int fastcall_parse_bool(PyObject *arg, Py_ssize_t pos, bool *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,6 +6,11 @@
 
 #include <stdlib.h>
 #include <string.h>
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <pthread.h>
+#endif
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -19,42 +24,163 @@ static rtloader_free_t rt_free = free;
 
 // these must be set by the Agent
 static cb_memory_tracker_t cb_memory_tracker = NULL;
+static cb_memory_tracker_batch_t cb_memory_tracker_batch = NULL;
 
-void _set_memory_tracker_cb(cb_memory_tracker_t cb) {
+// Events for the batch memory tracker go through a ring shared by all threads.
+// Writers claim positions with an atomic increment, which orders the events, and
+// publish them through the sequence number of their slot: a slot is free for the
+// lap `pos / TRACKER_RING_SIZE` when its sequence is twice the lap, and holds an
+// event of that lap once it is one more. A single thread at a time, the one holding
+// `tracker_lock`, delivers published events in position order and stops at the
+// first slot that was claimed but not published yet.
+#define TRACKER_RING_SIZE (4 * RTLOADER_MEM_TRACKER_BATCH)
+
+typedef struct tracker_slot_s {
+    size_t seq;
+    rtloader_mem_event_t event;
+} tracker_slot_t;
+
+static tracker_slot_t tracker_ring[TRACKER_RING_SIZE];
+static size_t tracker_tail = 0; // next position to claim
+#ifdef _WIN32
+static SRWLOCK tracker_lock = SRWLOCK_INIT;
+#    define TRACKER_LOCK() AcquireSRWLockExclusive(&tracker_lock)
+#    define TRACKER_TRYLOCK() TryAcquireSRWLockExclusive(&tracker_lock)
+#    define TRACKER_UNLOCK() ReleaseSRWLockExclusive(&tracker_lock)
+#else
+static pthread_mutex_t tracker_lock = PTHREAD_MUTEX_INITIALIZER;
+#    define TRACKER_LOCK() pthread_mutex_lock(&tracker_lock)
+#    define TRACKER_TRYLOCK() (pthread_mutex_trylock(&tracker_lock) == 0)
+#    define TRACKER_UNLOCK() pthread_mutex_unlock(&tracker_lock)
+#endif
+// only accessed while holding tracker_lock
+static size_t tracker_head = 0; // next position to deliver
+static rtloader_mem_event_t tracker_batch[RTLOADER_MEM_TRACKER_BATCH];
+
+// round allocations up so that any type can be stored in arena memory
+#define ARENA_ALIGN(sz) (((sz) + (2 * sizeof(void *) - 1)) & ~(2 * sizeof(void *) - 1))
 
-    // Memory barrier for a little bit of safety on sets
-    __sync_synchronize();
-    cb_memory_tracker = cb;
+typedef struct arena_chunk_s {
+    struct arena_chunk_s *next;
+    size_t size;
+    size_t used;
+    void *data[]; // pointer-aligned
+} arena_chunk_t;
+
+// per-thread scratch arena: a static buffer that serves most calls without
+// touching the heap, and a list of heap chunks for whatever does not fit in it
+static __thread union {
+    char data[RTLOADER_ARENA_SIZE];
+    long double align;
+} arena_buf;
+static __thread size_t arena_used = 0;
+static __thread arena_chunk_t *arena_chunks = NULL;
+
+void _set_memory_tracker_cb(cb_memory_tracker_t cb) {
+    __atomic_store_n(&cb_memory_tracker, cb, __ATOMIC_RELEASE);
 }
 
 cb_memory_tracker_t _get_memory_tracker_cb(void) {
+    return __atomic_load_n(&cb_memory_tracker, __ATOMIC_ACQUIRE);
+}
+
+cb_memory_tracker_batch_t _get_memory_tracker_batch_cb(void) {
+    return __atomic_load_n(&cb_memory_tracker_batch, __ATOMIC_ACQUIRE);
+}
+
+void _set_memory_tracker_batch_cb(cb_memory_tracker_batch_t cb) {
+    // hand what was queued so far to the previous callback
+    _flush_memory_tracker();
+    __atomic_store_n(&cb_memory_tracker_batch, cb, __ATOMIC_RELEASE);
+}
+
+// Delivers the published events, the caller must hold tracker_lock.
+static void _drain_memory_tracker(void) {
+    cb_memory_tracker_batch_t cb = __atomic_load_n(&cb_memory_tracker_batch, __ATOMIC_ACQUIRE);
+    size_t count;
 
-    // Memory barrier for a little bit of safety on gets
-    __sync_synchronize();
-    return cb_memory_tracker;
+    do {
+        for (count = 0; count < RTLOADER_MEM_TRACKER_BATCH; count++, tracker_head++) {
+            tracker_slot_t *slot = &tracker_ring[tracker_head % TRACKER_RING_SIZE];
+            size_t lap = tracker_head / TRACKER_RING_SIZE;
+
+            if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != 2 * lap + 1) {
+                break;
+            }
+            tracker_batch[count] = slot->event;
+            __atomic_store_n(&slot->seq, 2 * (lap + 1), __ATOMIC_RELEASE);
+        }
+        // events queued before the callback was unset are dropped
+        if (count > 0 && cb) {
+            cb(tracker_batch, count);
+        }
+    } while (count == RTLOADER_MEM_TRACKER_BATCH);
+}
+
+// Delivers the published events unless another thread is already doing it.
+static void _try_flush_memory_tracker(void) {
+    if (!TRACKER_TRYLOCK()) {
+        return;
+    }
+    _drain_memory_tracker();
+    TRACKER_UNLOCK();
+}
+
+void _flush_memory_tracker(void) {
+    // waits for another thread delivering a batch, it has to be seen first
+    TRACKER_LOCK();
+    _drain_memory_tracker();
+    TRACKER_UNLOCK();
+}
+
+static void _queue_memory_event(void *ptr, size_t sz, rtloader_mem_ops_t op) {
+    size_t pos = __atomic_fetch_add(&tracker_tail, 1, __ATOMIC_RELAXED);
+    tracker_slot_t *slot = &tracker_ring[pos % TRACKER_RING_SIZE];
+    size_t lap = pos / TRACKER_RING_SIZE;
+
+    // the ring only fills up when delivering lags behind by several batches
+    while (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != 2 * lap) {
+        _flush_memory_tracker();
+    }
+    slot->event.ptr = ptr;
+    slot->event.sz = sz;
+    slot->event.op = op;
+    __atomic_store_n(&slot->seq, 2 * lap + 1, __ATOMIC_RELEASE);
+
+    // the writer completing a batch delivers it
+    if ((pos + 1) % RTLOADER_MEM_TRACKER_BATCH == 0) {
+        _try_flush_memory_tracker();
+    }
+}
+
+void _track_memory(void *ptr, size_t sz, rtloader_mem_ops_t op) {
+    cb_memory_tracker_t cb;
+
+    if (__atomic_load_n(&cb_memory_tracker_batch, __ATOMIC_ACQUIRE)) {
+        _queue_memory_event(ptr, sz, op);
+    } else if ((cb = __atomic_load_n(&cb_memory_tracker, __ATOMIC_ACQUIRE))) {
+        cb(ptr, sz, op);
+    }
 }
 
 void *_malloc(size_t sz) {
     void *ptr = NULL;
     ptr = rt_malloc(sz);
 
-    // This is currently thread-unsafe, so be sure to set the callback before
-    // running this code.
-    if (ptr && cb_memory_tracker) {
-        cb_memory_tracker(ptr, sz, DATADOG_AGENT_RTLOADER_ALLOCATION);
+    if (ptr) {
+        _track_memory(ptr, sz, DATADOG_AGENT_RTLOADER_ALLOCATION);
     }
 
     return ptr;
 }
 
 void _free(void *ptr) {
-    rt_free(ptr);
-
-    // This is currently thread-unsafe, so be sure to set the callback before
-    // running this code.
-    if (ptr && cb_memory_tracker) {
-        cb_memory_tracker(ptr, 0, DATADOG_AGENT_RTLOADER_FREE);
+    // reported first, so it can't be delivered after a new allocation reusing ptr
+    if (ptr) {
+        _track_memory(ptr, 0, DATADOG_AGENT_RTLOADER_FREE);
     }
+
+    rt_free(ptr);
 }
 
 char *strdupe(const char *s1) {
@@ -66,3 +192,53 @@ char *strdupe(const char *s1) {
 
     return strcpy(s2, s1);
 }
+
+void *_arena_malloc(size_t sz) {
+    sz = ARENA_ALIGN(sz);
+
+    if (arena_chunks == NULL && sz <= RTLOADER_ARENA_SIZE - arena_used) {
+        void *ptr = arena_buf.data + arena_used;
+        arena_used += sz;
+        return ptr;
+    }
+
+    arena_chunk_t *chunk = arena_chunks;
+    if (chunk == NULL || sz > chunk->size - chunk->used) {
+        // grow geometrically so large batches only need a handful of chunks
+        size_t size = chunk == NULL ? 2 * RTLOADER_ARENA_SIZE : 2 * chunk->size;
+        if (size < sz) {
+            size = sz;
+        }
+        // chunks go through _malloc so the memory tracker still accounts for them
+        if (!(chunk = (arena_chunk_t *)_malloc(sizeof(*chunk) + size))) {
+            return NULL;
+        }
+        chunk->size = size;
+        chunk->used = 0;
+        chunk->next = arena_chunks;
+        arena_chunks = chunk;
+    }
+
+    void *ptr = (char *)chunk->data + chunk->used;
+    chunk->used += sz;
+    return ptr;
+}
+
+char *_arena_strdupe(const char *s1) {
+    char *s2 = NULL;
+
+    if (!(s2 = (char *)_arena_malloc(strlen(s1) + 1))) {
+        return NULL;
+    }
+
+    return strcpy(s2, s1);
+}
+
+void _arena_reset(void) {
+    while (arena_chunks != NULL) {
+        arena_chunk_t *next = arena_chunks->next;
+        _free(arena_chunks);
+        arena_chunks = next;
+    }
+    arena_used = 0;
+}
@@ -32,38 +32,96 @@ extern void free(void *ptr) __attribute__((deprecated(MEM_DEPRECATION_MSG)));
     \param object A function pointer to the callback function.
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
-    This function is thread unsafe, be sure to call it early on before multiple threads
-    may start using the allocator.
 */
 void _set_memory_tracker_cb(cb_memory_tracker_t);
 
 /*! \fn cb_memory_tracker_t _set_memory_tracker_cb(void)
     \brief Returns the callback used by rtloader for memory tracking stats.
     \return object A function pointer to the callback function.
-
-    This function is thread unsafe, be sure to call it early on before multiple threads
-    may start using the allocator.
 */
 cb_memory_tracker_t _get_memory_tracker_cb(void);
 
+/*! \def RTLOADER_MEM_TRACKER_BATCH
+    \brief Number of allocations and frees handed to the batch memory tracker at once.
+*/
+#define RTLOADER_MEM_TRACKER_BATCH 256
+
+/*! \fn cb_memory_tracker_batch_t _get_memory_tracker_batch_cb(void)
+    \brief Returns the callback receiving the memory tracking stats in batches.
+    \return object A function pointer to the callback function.
+*/
+cb_memory_tracker_batch_t _get_memory_tracker_batch_cb(void);
+
+/*! \fn void _set_memory_tracker_batch_cb(cb_memory_tracker_batch_t cb)
+    \brief Sets a callback receiving the memory tracking stats in batches.
+    \param object A function pointer to the callback function, or NULL to go back to
+    the per-allocation callback.
+
+    Events are queued in a lock-free ring shared by all threads, in the order they
+    happen, so a free is never delivered before the allocation it releases. They are
+    delivered by a single thread at a time, under a mutex.
+*/
+void _set_memory_tracker_batch_cb(cb_memory_tracker_batch_t);
+
+/*! \fn void _flush_memory_tracker(void)
+    \brief Hands every queued memory tracking event to the batch callback.
+*/
+void _flush_memory_tracker(void);
+
+/*! \fn void _track_memory(void *ptr, size_t sz, rtloader_mem_ops_t op)
+    \brief Reports an allocation or a free to the memory tracker, if any.
+    \param ptr the pointer allocated or about to be freed.
+    \param sz the number of bytes allocated, 0 for frees.
+    \param op the operation.
+
+    Used by `_malloc` and `_free`, and by callers allocating tracked memory on their
+    own, so their events are ordered with the ones from rtloader. Frees must be
+    reported before the memory is released, otherwise the pointer may be reused and
+    its new allocation reported first.
+*/
+void _track_memory(void *ptr, size_t sz, rtloader_mem_ops_t op);
+
 /*! \fn void *_malloc(size_t sz)
     \brief Basic malloc wrapper that will also keep memory stats if enabled.
     \param sz the number of bytes to allocate.
-
-    This function is thread unsafe in its access to the memory tracker. Onle, use this
-    logic once the memory tracker has be set (or tracking remains disabled).
 */
 void *_malloc(size_t sz);
 
 /*! \fn void _free(void *ptr)
     \brief Basic free wrapper that will also keep memory stats if enabled.
     \param ptr the pointer to the heap region you wish to free.
-
-    This function is thread unsafe in its access to the memory tracker. Onle, use this
-    logic once the memory tracker has be set (or tracking remains disabled).
 */
 void _free(void *ptr);
 
+/*! \def RTLOADER_ARENA_SIZE
+    \brief Size in bytes of the per-thread static buffer backing the scratch arena.
+*/
+#define RTLOADER_ARENA_SIZE 4096
+
+/*! \fn void *_arena_malloc(size_t sz)
+    \brief Allocates short-lived scratch memory from the calling thread's arena.
+    \param sz the number of bytes to allocate.
+
+    Memory is handed out by bumping a pointer into a per-thread buffer and must never be
+    passed to `_free`; it is released all at once by `_arena_reset`. Requests that do not
+    fit in the static buffer are served from heap chunks allocated with `_malloc`, so the
+    memory tracker keeps accounting for them in aggregate rather than per allocation.
+*/
+void *_arena_malloc(size_t sz);
+
+/*! \fn char *_arena_strdupe(const char *s1)
+    \brief `strdupe` counterpart allocating the copy from the calling thread's arena.
+*/
+char *_arena_strdupe(const char *s1);
+
+/*! \fn void _arena_reset(void)
+    \brief Releases every allocation made from the calling thread's arena.
+
+    Builtins call this once, right before returning to python, after which any pointer
+    previously returned by `_arena_malloc` is invalid.
+*/
+void _arena_reset(void);
+
 #ifdef __cplusplus
 #    ifndef __GLIBC__
 #        define __THROW
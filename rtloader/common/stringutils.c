@@ -2,28 +2,59 @@
 // under the Apache License Version 2.0.
 // This product includes software developed at Datadog (https://www.datadoghq.com/).
 // Copyright 2019-present Datadog, Inc.
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "rtloader_mem.h"
 #include "rtloader_types.h"
 #include "stringutils.h"
 
+// Python objects can't be shared between interpreters: `init_stringutils` fills
+// one state per interpreter, the main interpreter always being the first one.
+// States are only added during initialization, lookups need no locking.
+typedef struct {
+    PyInterpreterState *interp;
+    PyObject *yload;
+    PyObject *ydump;
+    PyObject *loader;
+    PyObject *dumper;
+    PyObject *interned_strings;
+} stringutils_state_t;
 
-PyObject * yload = NULL;
-PyObject * ydump = NULL;
-PyObject * loader = NULL;
-PyObject * dumper = NULL;
+static stringutils_state_t states[MAX_INTERPRETERS];
+static int states_count = 0;
 
-/**
- * returns a C (NULL terminated UTF-8) string from a python string.
- *
- * \param object  A Python string to be converted to C-string.
- *
- * \return A standard C string (NULL terminated character pointer)
- *  The returned pointer is allocated from the heap and must be
- * deallocated (free()ed) by the caller
- */
-char *as_string(PyObject *object)
+static PyInterpreterState *current_interpreter(void)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    return PyInterpreterState_Get();
+#else
+    return PyThreadState_Get()->interp;
+#endif
+}
+
+static stringutils_state_t *find_state(PyInterpreterState *interp)
+{
+    int i;
+    for (i = 0; i < states_count; i++) {
+        if (states[i].interp == interp) {
+            return &states[i];
+        }
+    }
+    return NULL;
+}
+
+static stringutils_state_t *get_state(void)
+{
+    // without sub-interpreters there's no need to look the interpreter up
+    if (states_count == 1) {
+        return &states[0];
+    }
+    return find_state(current_interpreter());
+}
+
+static char *_as_string(PyObject *object, char *(*dup)(const char *))
 {
     if (object == NULL) {
         return NULL;
@@ -50,16 +81,136 @@ char *as_string(PyObject *object)
         return NULL;
     }
 
-    retval = strdupe(PyBytes_AS_STRING(temp_bytes));
+    retval = dup(PyBytes_AS_STRING(temp_bytes));
     Py_XDECREF(temp_bytes);
 
     return retval;
 }
 
+/**
+ * returns a C (NULL terminated UTF-8) string from a python string.
+ *
+ * \param object  A Python string to be converted to C-string.
+ *
+ * \return A standard C string (NULL terminated character pointer)
+ *  The returned pointer is allocated from the heap and must be
+ * deallocated (free()ed) by the caller
+ */
+char *as_string(PyObject *object)
+{
+    return _as_string(object, strdupe);
+}
+
+/**
+ * returns a C (NULL terminated UTF-8) string from a python string.
+ *
+ * \param object  A Python string to be converted to C-string.
+ *
+ * \return A standard C string (NULL terminated character pointer)
+ *  The returned pointer is allocated from the calling thread's arena and is
+ * released by the next _arena_reset()
+ */
+char *as_arena_string(PyObject *object)
+{
+    return _as_string(object, _arena_strdupe);
+}
+
+/**
+ * returns a C (NULL terminated UTF-8) string from a python string, interning the
+ * python object so that the returned buffer outlives the caller's reference to it.
+ *
+ * \param object  A Python string to be converted to C-string.
+ *
+ * \return A standard C string (NULL terminated character pointer)
+ *  The returned pointer is owned by the intern table and must NOT be freed by
+ * the caller. It remains valid until the next call to release_interned_strings().
+ */
+char *as_interned_string(PyObject *object)
+{
+    stringutils_state_t *state = get_state();
+    if (object == NULL || state == NULL || state->interned_strings == NULL) {
+        return NULL;
+    }
+
+    PyObject *interned_strings = state->interned_strings;
+
+    PyObject *key = NULL; // new reference
+    PyObject *interned = NULL; // borrowed
+    char *retval = NULL;
+
+    // subclasses may override hashing and comparison, intern an exact copy instead
+    if (PyUnicode_CheckExact(object) || PyBytes_CheckExact(object)) {
+        key = object;
+        Py_INCREF(key);
+    } else if (PyUnicode_Check(object)) {
+        key = PyUnicode_FromObject(object);
+    } else if (PyBytes_Check(object)) {
+        key = PyBytes_FromStringAndSize(PyBytes_AS_STRING(object), PyBytes_GET_SIZE(object));
+    } else {
+        return NULL;
+    }
+    if (key == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    // lookups hit the identity fast path and the hash cached on the object, so a
+    // string seen before costs neither an allocation nor a re-encode
+    interned = PyDict_SetDefault(interned_strings, key, key);
+    if (interned == NULL) {
+        PyErr_Clear();
+        goto done;
+    }
+
+    if (PyBytes_Check(interned)) {
+        // We already have an encoded string, we suppose it has the correct encoding (UTF-8)
+        retval = PyBytes_AS_STRING(interned);
+    } else {
+        // the UTF-8 representation is cached on the object by the interpreter
+        retval = (char *)PyUnicode_AsUTF8(interned);
+        if (retval == NULL) {
+            // PyUnicode_AsUTF8 raises if the string can't be encoded, e.g. lone surrogates
+            PyErr_Clear();
+            PyDict_DelItem(interned_strings, interned);
+            PyErr_Clear();
+        }
+    }
+
+done:
+    Py_DECREF(key);
+    return retval;
+}
+
+void release_interned_strings(void)
+{
+    stringutils_state_t *state = get_state();
+    if (state != NULL && state->interned_strings != NULL
+        && PyDict_Size(state->interned_strings) > MAX_INTERNED_STRINGS) {
+        PyDict_Clear(state->interned_strings);
+    }
+}
+
 int init_stringutils(void) {
     PyObject *yaml = NULL;
     int ret = EXIT_FAILURE;
 
+    PyInterpreterState *interp = current_interpreter();
+    stringutils_state_t *state = find_state(interp);
+    if (state == NULL) {
+        if (states_count == MAX_INTERPRETERS) {
+            PyErr_SetString(PyExc_RuntimeError, "too many interpreters");
+            return ret;
+        }
+        state = &states[states_count++];
+        state->interp = interp;
+    }
+
+    Py_XDECREF(state->interned_strings);
+    state->interned_strings = PyDict_New();
+    if (state->interned_strings == NULL) {
+        goto done;
+    }
+
     char module_name[] = "yaml";
     yaml = PyImport_ImportModule(module_name);
     if (yaml == NULL) {
@@ -68,37 +219,37 @@ int init_stringutils(void) {
 
     // get pyyaml load()
     char load_name[] = "load";
-    yload = PyObject_GetAttrString(yaml, load_name);
-    if (yload == NULL) {
+    state->yload = PyObject_GetAttrString(yaml, load_name);
+    if (state->yload == NULL) {
         goto done;
     }
 
     // We try to use the C-extensions, if they're available, but it's a best effort
     char c_loader_name[] = "CSafeLoader";
-    loader = PyObject_GetAttrString(yaml, c_loader_name);
-    if (loader == NULL) {
+    state->loader = PyObject_GetAttrString(yaml, c_loader_name);
+    if (state->loader == NULL) {
         PyErr_Clear();
         char loader_name[] = "SafeLoader";
-        loader = PyObject_GetAttrString(yaml, loader_name);
-        if (loader == NULL) {
+        state->loader = PyObject_GetAttrString(yaml, loader_name);
+        if (state->loader == NULL) {
             goto done;
         }
     }
 
     // get pyyaml dump()
     char dump_name[] = "dump";
-    ydump = PyObject_GetAttrString(yaml, dump_name);
-    if (ydump == NULL) {
+    state->ydump = PyObject_GetAttrString(yaml, dump_name);
+    if (state->ydump == NULL) {
         goto done;
     }
 
     char c_dumper_name[] = "CSafeDumper";
-    dumper = PyObject_GetAttrString(yaml, c_dumper_name);
-    if (dumper == NULL) {
+    state->dumper = PyObject_GetAttrString(yaml, c_dumper_name);
+    if (state->dumper == NULL) {
         PyErr_Clear();
         char dumper_name[] = "SafeDumper";
-        dumper = PyObject_GetAttrString(yaml, dumper_name);
-        if (dumper == NULL) {
+        state->dumper = PyObject_GetAttrString(yaml, dumper_name);
+        if (state->dumper == NULL) {
             goto done;
         }
     }
@@ -114,11 +265,12 @@ PyObject *from_yaml(const char *data) {
     PyObject *args = NULL;
     PyObject *kwargs = NULL;
     PyObject *retval = NULL;
+    stringutils_state_t *state = get_state();
 
     if (!data) {
         goto done;
     }
-    if (yload == NULL) {
+    if (state == NULL || state->yload == NULL) {
         goto done;
     }
 
@@ -126,11 +278,11 @@ PyObject *from_yaml(const char *data) {
     if (args == NULL) {
         goto done;
     }
-    kwargs = Py_BuildValue("{s:s, s:O}", "stream", data, "Loader", loader);
+    kwargs = Py_BuildValue("{s:s, s:O}", "stream", data, "Loader", state->loader);
     if (kwargs == NULL) {
         goto done;
     }
-    retval = PyObject_Call(yload, args, kwargs);
+    retval = PyObject_Call(state->yload, args, kwargs);
 
 done:
     Py_XDECREF(kwargs);
@@ -141,11 +293,15 @@ done:
 char *as_yaml(PyObject *object) {
     char *retval = NULL;
     PyObject *dumped = NULL;
+    stringutils_state_t *state = get_state();
+    if (state == NULL || state->ydump == NULL) {
+        return NULL;
+    }
 
     PyObject *args = PyTuple_New(0);
-    PyObject *kwargs = Py_BuildValue("{s:O, s:O}", "data", object, "Dumper", dumper);
+    PyObject *kwargs = Py_BuildValue("{s:O, s:O}", "data", object, "Dumper", state->dumper);
 
-    dumped = PyObject_Call(ydump, args, kwargs);
+    dumped = PyObject_Call(state->ydump, args, kwargs);
     if (dumped == NULL) {
         goto done;
     }
@@ -158,3 +314,160 @@ done:
     Py_XDECREF(args);
     return retval;
 }
+
+// cursor over a binary config payload
+typedef struct {
+    const unsigned char *data;
+    size_t len;
+    size_t pos;
+} binary_reader_t;
+
+static int read_bytes(binary_reader_t *reader, size_t count, const unsigned char **out)
+{
+    if (reader->len - reader->pos < count) {
+        PyErr_SetString(PyExc_ValueError, "truncated binary config");
+        return 0;
+    }
+    *out = reader->data + reader->pos;
+    reader->pos += count;
+    return 1;
+}
+
+static int read_uint(binary_reader_t *reader, size_t width, uint64_t *value)
+{
+    const unsigned char *bytes = NULL;
+    size_t i;
+
+    if (!read_bytes(reader, width, &bytes)) {
+        return 0;
+    }
+    // little endian, whatever the host byte order
+    *value = 0;
+    for (i = 0; i < width; i++) {
+        *value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return 1;
+}
+
+static PyObject *read_value(binary_reader_t *reader, int depth)
+{
+    const unsigned char *bytes = NULL;
+    uint64_t value = 0;
+    uint64_t count = 0;
+    uint64_t i;
+    PyObject *retval = NULL;
+    PyObject *key = NULL;
+    PyObject *item = NULL;
+    double d;
+
+    if (depth > MAX_BINARY_DEPTH) {
+        PyErr_SetString(PyExc_ValueError, "binary config is nested too deeply");
+        return NULL;
+    }
+    if (!read_bytes(reader, 1, &bytes)) {
+        return NULL;
+    }
+
+    switch (bytes[0]) {
+    case BINARY_NONE:
+        Py_RETURN_NONE;
+    case BINARY_TRUE:
+        Py_RETURN_TRUE;
+    case BINARY_FALSE:
+        Py_RETURN_FALSE;
+    case BINARY_INT:
+        if (!read_uint(reader, 8, &value)) {
+            return NULL;
+        }
+        return PyLong_FromLongLong((long long)(int64_t)value);
+    case BINARY_UINT:
+        if (!read_uint(reader, 8, &value)) {
+            return NULL;
+        }
+        return PyLong_FromUnsignedLongLong(value);
+    case BINARY_FLOAT:
+        if (!read_uint(reader, 8, &value)) {
+            return NULL;
+        }
+        memcpy(&d, &value, sizeof(d));
+        return PyFloat_FromDouble(d);
+    case BINARY_STRING:
+        if (!read_uint(reader, 4, &count) || !read_bytes(reader, count, &bytes)) {
+            return NULL;
+        }
+        return PyUnicode_DecodeUTF8((const char *)bytes, count, NULL);
+    case BINARY_LIST:
+        if (!read_uint(reader, 4, &count)) {
+            return NULL;
+        }
+        // every item takes at least one byte, don't trust the count for the allocation
+        if (count > reader->len - reader->pos) {
+            PyErr_SetString(PyExc_ValueError, "truncated binary config");
+            return NULL;
+        }
+        retval = PyList_New(count);
+        if (retval == NULL) {
+            return NULL;
+        }
+        for (i = 0; i < count; i++) {
+            item = read_value(reader, depth + 1);
+            if (item == NULL) {
+                Py_DECREF(retval);
+                return NULL;
+            }
+            // steals the reference to item
+            PyList_SET_ITEM(retval, i, item);
+        }
+        return retval;
+    case BINARY_MAP:
+        if (!read_uint(reader, 4, &count)) {
+            return NULL;
+        }
+        retval = PyDict_New();
+        if (retval == NULL) {
+            return NULL;
+        }
+        for (i = 0; i < count; i++) {
+            key = read_value(reader, depth + 1);
+            if (key == NULL) {
+                goto error;
+            }
+            item = read_value(reader, depth + 1);
+            if (item == NULL) {
+                goto error;
+            }
+            if (PyDict_SetItem(retval, key, item) == -1) {
+                goto error;
+            }
+            Py_CLEAR(key);
+            Py_CLEAR(item);
+        }
+        return retval;
+    default:
+        PyErr_Format(PyExc_ValueError, "unknown binary config type: 0x%02x", bytes[0]);
+        return NULL;
+    }
+
+error:
+    Py_XDECREF(key);
+    Py_XDECREF(item);
+    Py_XDECREF(retval);
+    return NULL;
+}
+
+PyObject *from_binary(const char *data, size_t len) {
+    binary_reader_t reader = { (const unsigned char *)data, len, 0 };
+    PyObject *retval = NULL;
+
+    if (data == NULL) {
+        PyErr_SetString(PyExc_ValueError, "empty binary config");
+        return NULL;
+    }
+
+    retval = read_value(&reader, 0);
+    if (retval != NULL && reader.pos != reader.len) {
+        PyErr_SetString(PyExc_ValueError, "trailing data after binary config");
+        Py_CLEAR(retval);
+    }
+    return retval;
+}
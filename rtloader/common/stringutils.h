@@ -27,6 +27,10 @@
     it falls back to its python variants: SafeLoader and SafeDumper. They're all cached
     and so `as_yaml`, and `from_yaml1` will not need to grab new references and will be able
     to call them directly.
+
+    Python objects can't be shared across interpreters: the function must be called once in
+    every interpreter using stringutils, up to `MAX_INTERPRETERS`. Calling it again in the
+    same interpreter resets its intern table.
 */
 /*! \fn char *as_string(PyObject * object)
     \brief Returns a Python object representation for the supplied YAML C-string.
@@ -36,6 +40,32 @@
     The returned C-string is allocated by this function and should subsequently be freed by
     the caller. This function should not set errors on the python interpreter.
 */
+/*! \fn char *as_arena_string(PyObject * object)
+    \brief Returns the UTF-8 C-string representation of the supplied python string.
+    \param object The python string (or bytes) object we wish to convert.
+    \return char * representation of the supplied string. In case of error NULL is returned.
+
+    Same as `as_string`, except the returned C-string is allocated from the calling thread's
+    scratch arena: it must not be freed by the caller and is only valid until the next call
+    to `_arena_reset`.
+*/
+/*! \fn char *as_interned_string(PyObject * object)
+    \brief Returns the UTF-8 C-string representation of the supplied python string, interning it.
+    \param object The python string (or bytes) object we wish to convert.
+    \return char * representation of the supplied string. In case of error NULL is returned.
+
+    The returned C-string is owned by the rtloader intern table and must not be freed nor
+    modified by the caller. The same python string value always yields the same pointer, so
+    tags that recur on every check run are neither copied nor re-encoded. The pointer is valid
+    until the next call to `release_interned_strings`. This function should not set errors on
+    the python interpreter. The GIL must be held.
+*/
+/*! \fn void release_interned_strings(void)
+    \brief Signals that no pointer returned by `as_interned_string` is in use anymore.
+
+    Once the intern table holds more than `MAX_INTERNED_STRINGS` entries it is emptied here,
+    bounding the memory used by checks submitting unbounded tag values. The GIL must be held.
+*/
 /*! \fn PyObject *from_yaml(const char * object)
     \brief Returns a Python object representation for the supplied YAML C-string.
     \param object The YAML C-string representation of the object we wish to deserialize.
@@ -45,6 +75,26 @@
     The returned Python object is a new reference and should subsequently be DECREF'd when
     no longer used, wanted by the caller.
 */
+/*! \fn PyObject *from_binary(const char *data, size_t len)
+    \brief Returns a Python object representation for the supplied binary config payload.
+    \param data Pointer to the payload, in the binary config encoding described below.
+    \param len Size of the payload in bytes.
+    \return PyObject * pointer to the decoded python object. In case of error, NULL will be
+    returned and a python exception set.
+
+    A faster alternative to `from_yaml` for configurations produced by the Agent: the
+    payload is decoded in a single pass, without going through PyYAML. Every value starts
+    with a one byte type, integers are little endian:
+    - `BINARY_NONE`, `BINARY_TRUE`, `BINARY_FALSE`: no payload.
+    - `BINARY_INT`, `BINARY_UINT`: signed or unsigned 64-bit integer.
+    - `BINARY_FLOAT`: IEEE 754 double.
+    - `BINARY_STRING`: 32-bit length followed by as many UTF-8 bytes, invalid UTF-8 is an error.
+    - `BINARY_LIST`: 32-bit item count followed by the items.
+    - `BINARY_MAP`: 32-bit entry count followed by the entries, each key before its value.
+
+    The returned Python object is a new reference and should subsequently be DECREF'd when
+    no longer used, wanted by the caller.
+*/
 /*! \fn char *as_yaml(PyObject * object)
     \brief Returns a C string YAML representation for the supplied Python object.
     \param object The python object whose YAML representation we want.
@@ -61,9 +111,30 @@ extern "C" {
 
 #include <Python.h>
 
+#define MAX_INTERNED_STRINGS 100000
+// maximum number of interpreters stringutils can be initialized for, main interpreter included
+#define MAX_INTERPRETERS 64
+
+// binary config value types, see `from_binary`
+#define BINARY_NONE 'n'
+#define BINARY_TRUE 't'
+#define BINARY_FALSE 'f'
+#define BINARY_INT 'i'
+#define BINARY_UINT 'u'
+#define BINARY_FLOAT 'd'
+#define BINARY_STRING 's'
+#define BINARY_LIST 'l'
+#define BINARY_MAP 'm'
+// maximum nesting of lists and maps in a binary config
+#define MAX_BINARY_DEPTH 64
+
 int init_stringutils(void);
 char *as_string(PyObject *);
+char *as_arena_string(PyObject *);
+char *as_interned_string(PyObject *);
+void release_interned_strings(void);
 PyObject *from_yaml(const char *);
+PyObject *from_binary(const char *, size_t);
 char *as_yaml(PyObject *);
 
 #ifdef __cplusplus
@@ -49,6 +49,27 @@ DATADOG_AGENT_RTLOADER_API rtloader_t *make3(const char *python_home, const char
 */
 DATADOG_AGENT_RTLOADER_API void set_memory_tracker_cb(cb_memory_tracker_t);
 
+/*! \fn void set_memory_tracker_batch_cb(cb_memory_tracker_batch_t)
+    \brief Sets a callback receiving the memory allocation book-keeping in batches.
+    \param object A function pointer to the callback function.
+
+    Once set, it takes precedence over the callback set with `set_memory_tracker_cb`:
+    allocations and frees are queued in the order they happen and delivered
+    `RTLOADER_MEM_TRACKER_BATCH` at a time, so the latest ones are only seen after
+    the next batch fills up or `flush_memory_tracker` is called. It must be set
+    before `make3` to apply to the allocations of the backend.
+*/
+DATADOG_AGENT_RTLOADER_API void set_memory_tracker_batch_cb(cb_memory_tracker_batch_t);
+
+/*! \fn void flush_memory_tracker(void)
+    \brief Delivers the queued memory allocation book-keeping to the batch callback.
+
+    Waits for a batch being delivered by another thread, if any, so every allocation
+    and free that happened before the call was seen by the callback when it returns.
+    This includes the allocations of the backend created by `make3`, if any.
+*/
+DATADOG_AGENT_RTLOADER_API void flush_memory_tracker(void);
+
 // API
 /*! \fn void destroy(rtloader_t *rtloader)
     \brief Destructor function for the provided rtloader backend.
@@ -158,6 +179,32 @@ DATADOG_AGENT_RTLOADER_API int get_check(rtloader_t *rtloader, rtloader_pyobject
                                          const char *instance, const char *check_id, const char *check_name,
                                          rtloader_pyobject_t **check);
 
+/*! \fn int get_check_from_binary(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *init_config,
+                                     size_t init_config_len, const char *instance, size_t instance_len,
+                                     const char *check_id, const char *check_name, rtloader_pyobject_t **check)
+    \brief Attempts to instantiate a datadog python check with the supplied configuration
+    parameters, encoded in the binary config encoding.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param py_class A rtloader_pyobject_t * pointer to the python check class we wish to instantiate.
+    \param init_config A pointer to the binary encoded init config for the check instance.
+    \param init_config_len The size in bytes of init_config.
+    \param instance A pointer to the binary encoded instance-specific config for the check instance.
+    \param instance_len The size in bytes of instance.
+    \param check_id A constant C-string unique identifier for the check instance.
+    \param check_name A constant C-string with the check name.
+    \param check A rtloader_pyobject_t ** pointer to the check instantiated if successful or NULL otherwise.
+    \return An integer with the success of the operation. Zero for success, non-zero for failure.
+    \sa rtloader_pyobject_t, rtloader_t, get_check
+
+    Unlike `get_check()`, the configuration is turned into python objects directly, without
+    going through `AgentCheck.load_config` and PyYAML. The buffers are only read during the
+    call: they aren't copied and remain owned by the caller.
+*/
+DATADOG_AGENT_RTLOADER_API int get_check_from_binary(rtloader_t *rtloader, rtloader_pyobject_t *py_class,
+                                                     const char *init_config, size_t init_config_len,
+                                                     const char *instance, size_t instance_len, const char *check_id,
+                                                     const char *check_name, rtloader_pyobject_t **check);
+
 /*! \fn int get_check_deprecated(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *init_config,
                                                const char *instance, const char *check_id, const char *check_name,
                                                const char *agent_config, rtloader_pyobject_t **check)
@@ -416,6 +463,18 @@ DATADOG_AGENT_RTLOADER_API void set_submit_histogram_bucket_cb(rtloader_t *, cb_
 */
 DATADOG_AGENT_RTLOADER_API void set_submit_event_platform_event_cb(rtloader_t *, cb_submit_event_platform_event_t);
 
+/*! \fn void set_submit_metric_batch_cb(rtloader_t *, cb_submit_metric_batch_t)
+    \brief Sets the submit metric batch callback to be used by rtloader for batched metric
+    submission.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param cb A function pointer with cb_submit_metric_batch_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+    When unset, batched submissions fall back to one submit metric callback per sample.
+*/
+DATADOG_AGENT_RTLOADER_API void set_submit_metric_batch_cb(rtloader_t *, cb_submit_metric_batch_t);
+
 // DATADOG_AGENT API
 /*! \fn void set_get_version_cb(rtloader_t *, cb_get_version_t)
     \brief Sets a callback to be used by rtloader to collect the agent version.
@@ -437,6 +496,18 @@ DATADOG_AGENT_RTLOADER_API void set_get_version_cb(rtloader_t *, cb_get_version_
 */
 DATADOG_AGENT_RTLOADER_API void set_get_config_cb(rtloader_t *, cb_get_config_t);
 
+/*! \fn void set_get_config_binary_cb(rtloader_t *, cb_get_config_binary_t)
+    \brief Sets a callback to be used by rtloader to collect the agent configuration in the
+    binary config encoding.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer with cb_get_config_binary_t prototype to the
+    callback function.
+
+    When set, it takes precedence over the callback set with `set_get_config_cb`.
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+DATADOG_AGENT_RTLOADER_API void set_get_config_binary_cb(rtloader_t *, cb_get_config_binary_t);
+
 /*! \fn void set_headers_cb(rtloader_t *, cb_headers_t)
     \brief Sets a callback to be used by rtloader to collect the typical HTTP headers for
     agent requests.
@@ -547,6 +618,42 @@ DATADOG_AGENT_RTLOADER_API void set_set_external_tags_cb(rtloader_t *, cb_set_ex
 */
 DATADOG_AGENT_RTLOADER_API void set_get_subprocess_output_cb(rtloader_t *rtloader, cb_get_subprocess_output_t cb);
 
+/*! \fn void set_start_subprocess_cb(rtloader_t *rtloader, cb_start_subprocess_t)
+    \brief Sets a callback to be used by rtloader to start subprocess commands whose output is
+    streamed back, see `_util.start_subprocess_output`.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer with cb_start_subprocess_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+    It is only used once the read and stop callbacks are set as well.
+*/
+DATADOG_AGENT_RTLOADER_API void set_start_subprocess_cb(rtloader_t *rtloader, cb_start_subprocess_t cb);
+
+/*! \fn void set_read_subprocess_output_cb(rtloader_t *rtloader, cb_read_subprocess_output_t)
+    \brief Sets a callback to be used by rtloader to wait for the next chunk of stdout of a
+    subprocess started with the start callback.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer with cb_read_subprocess_output_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+    It is called without the GIL held.
+*/
+DATADOG_AGENT_RTLOADER_API void set_read_subprocess_output_cb(rtloader_t *rtloader, cb_read_subprocess_output_t cb);
+
+/*! \fn void set_stop_subprocess_cb(rtloader_t *rtloader, cb_stop_subprocess_t)
+    \brief Sets a callback to be used by rtloader to stop a subprocess started with the start
+    callback before it exited, and release its handle.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer with cb_stop_subprocess_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+    It must not wait for the subprocess to exit, as it is called with the GIL held.
+*/
+DATADOG_AGENT_RTLOADER_API void set_stop_subprocess_cb(rtloader_t *rtloader, cb_stop_subprocess_t cb);
+
 // CGO API
 /*! \fn void set_cgo_free_cb(rtloader_t *rtloader, cb_cgo_free_t cb)
     \brief Sets a callback to be used by rtloader to free memory allocated by the
@@ -576,6 +683,29 @@ DATADOG_AGENT_RTLOADER_API void set_cgo_free_cb(rtloader_t *, cb_cgo_free_t);
 */
 DATADOG_AGENT_RTLOADER_API void set_tags_cb(rtloader_t *, cb_tags_t);
 
+/*! \fn void bump_tags_cache_generation(rtloader_t *)
+    \brief Invalidates the tags cached by the tagger builtin.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+
+    The tagger builtin caches the tags returned by the cb_tags callback, keyed by
+    entity id and cardinality. The cache is disabled until this function is first
+    called; every call afterwards drops all cached entries. The Agent is expected
+    to call it whenever the tagger reports entity changes. This function does not
+    require the GIL and may be called from any thread.
+*/
+DATADOG_AGENT_RTLOADER_API void bump_tags_cache_generation(rtloader_t *);
+
+/*! \fn void disable_tags_cache(rtloader_t *)
+    \brief Disables the tags cache of the tagger builtin.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+
+    The Agent is expected to call it when it stops invalidating the cache, the
+    tags are then fetched through cb_tags on every call until
+    bump_tags_cache_generation is called again. This function does not require
+    the GIL and may be called from any thread.
+*/
+DATADOG_AGENT_RTLOADER_API void disable_tags_cache(rtloader_t *);
+
 // KUBEUTIL API
 /*! \fn void set_get_connection_info_cb(rtloader_t *, cb_get_connection_info_t)
     \brief Sets a callback to be used by rtloader for kubernetes connection information
@@ -667,6 +797,20 @@ DATADOG_AGENT_RTLOADER_API void init_pymem_stats(rtloader_t *);
 */
 DATADOG_AGENT_RTLOADER_API void get_pymem_stats(rtloader_t *, pymem_stats_t *);
 
+/*! \fn int get_check_profile(rtloader_t *, rtloader_pyobject_t *check, check_profile_t *profile)
+    \brief Retrieve the resources used by a check across all its runs.
+    \param rtloader A pointer to the RtLoader instance.
+    \param check A rtloader_pyobject_t * pointer to the check instance.
+    \param profile A pointer to check_profile_t structure that will be updated with the check totals.
+    \return An integer with the success of the operation. Zero if the check was never run, one otherwise.
+
+    Wall time, CPU time and allocations are accounted for while the check `run` method
+    executes. GIL wait covers the last `ensure_gil` call preceding the run on the same thread.
+    Waits on the GIL within the run itself, e.g. after I/O, are counted as wall time. Allocations are only
+    tracked once `init_pymem_stats` was called. The GIL must be held.
+*/
+DATADOG_AGENT_RTLOADER_API int get_check_profile(rtloader_t *, rtloader_pyobject_t *check, check_profile_t *profile);
+
 /*! \fn void set_obfuscate_mongodb_string_cb(rtloader_t *, cb_obfuscate_mongodb_string_t)
     \brief Sets a callback to be used by rtloader to allow retrieving a value for a given
     check instance.
@@ -32,7 +32,7 @@ class RtLoader
 {
 public:
     //! Constructor.
-    RtLoader(cb_memory_tracker_t memtrack_cb);
+    RtLoader(cb_memory_tracker_t memtrack_cb, cb_memory_tracker_batch_t memtrack_batch_cb);
 
     //! Destructor.
     virtual ~RtLoader(){};
@@ -111,6 +111,27 @@ public:
                           RtLoaderPyObject *&check)
         = 0;
 
+    //! Pure virtual getCheckFromBinary member.
+    /*!
+      \param py_class The python check class we wish to instantiate.
+      \param init_config A pointer to the init_config for the check instance, in the binary config
+      encoding.
+      \param init_config_len The size in bytes of init_config.
+      \param instance A pointer to the instance config for the check instance, in the binary
+      config encoding.
+      \param instance_len The size in bytes of instance.
+      \param check_id_str A C-string containing the identifier for the check instance.
+      \param check_name A C-string containing the check name.
+      \param check The output python object pointer to the instantiated check, if we succeed.
+      \return A boolean indicating the success or not of the operation.
+
+      Same as getCheck, without the YAML parsing of the configuration.
+    */
+    virtual bool getCheckFromBinary(RtLoaderPyObject *py_class, const char *init_config, size_t init_config_len,
+                                    const char *instance, size_t instance_len, const char *check_id_str,
+                                    const char *check_name, RtLoaderPyObject *&check)
+        = 0;
+
     //! Pure virtual runCheck member.
     /*!
       \param check The python object pointer to the check we wish to run.
@@ -282,6 +303,15 @@ public:
     */
     virtual void setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t) = 0;
 
+    //! setSubmitMetricBatchCb member.
+    /*!
+      \param A cb_submit_metric_batch_t function pointer to the CGO callback.
+
+      Batches of metric samples are submitted from go-land in a single call, this allows us to
+      set the CGO callback.
+    */
+    virtual void setSubmitMetricBatchCb(cb_submit_metric_batch_t) = 0;
+
     // datadog_agent API
 
     //! setGetVersionCb member.
@@ -300,6 +330,15 @@ public:
     */
     virtual void setGetConfigCb(cb_get_config_t) = 0;
 
+    //! setGetConfigBinaryCb member.
+    /*!
+      \param A cb_get_config_binary_t function pointer to the CGO callback.
+
+      This allows us to set the CGO callback that will enable us to get the agent configuration
+      in the binary config encoding, rather than in YAML.
+    */
+    virtual void setGetConfigBinaryCb(cb_get_config_binary_t) = 0;
+
     //! setHeadersCb member.
     /*!
       \param A cb_headers_t function pointer to the CGO callback.
@@ -391,6 +430,33 @@ public:
     */
     virtual void setSubprocessOutputCb(cb_get_subprocess_output_t) = 0;
 
+    //! setStartSubprocessCb member.
+    /*!
+      \param A cb_start_subprocess_t function pointer to the CGO callback.
+
+      This allows us to set the relevant CGO callback that will allow starting subprocess
+      commands from go-land, whose output is streamed back to python.
+    */
+    virtual void setStartSubprocessCb(cb_start_subprocess_t) = 0;
+
+    //! setReadSubprocessOutputCb member.
+    /*!
+      \param A cb_read_subprocess_output_t function pointer to the CGO callback.
+
+      This allows us to set the relevant CGO callback that will allow reading the output of
+      subprocess commands started with the start callback, one chunk at a time.
+    */
+    virtual void setReadSubprocessOutputCb(cb_read_subprocess_output_t) = 0;
+
+    //! setStopSubprocessCb member.
+    /*!
+      \param A cb_stop_subprocess_t function pointer to the CGO callback.
+
+      This allows us to set the relevant CGO callback that will allow stopping subprocess
+      commands started with the start callback.
+    */
+    virtual void setStopSubprocessCb(cb_stop_subprocess_t) = 0;
+
     // CGO API
     //! setCGOFreeCb member.
     /*!
@@ -413,6 +479,21 @@ public:
     */
     virtual void setTagsCb(cb_tags_t) = 0;
 
+    //! bumpTagsCacheGeneration member.
+    /*!
+      Invalidates the tags cached by the tagger builtin. The first call enables
+      the cache. This method is thread-safe and does not require the GIL.
+    */
+    virtual void bumpTagsCacheGeneration() = 0;
+
+    //! disableTagsCache member.
+    /*!
+      Disables the tags cache of the tagger builtin until the next
+      bumpTagsCacheGeneration call. This method is thread-safe and does not
+      require the GIL.
+    */
+    virtual void disableTagsCache() = 0;
+
     // kubeutil API
     //! setGetConnectionInfoCb member.
     /*!
@@ -496,6 +577,19 @@ public:
     {
     }
 
+    //! getCheckProfile member.
+    /*!
+      \param check The python object pointer to the check instance.
+      \param profile Profile output.
+      \return A boolean indicating whether the check has a profile, i.e. was run.
+
+      Retrieve the resources used by a check across all its runs.
+    */
+    virtual bool getCheckProfile(RtLoaderPyObject *check, check_profile_t &profile)
+    {
+        return false;
+    }
+
     //! setObfuscateMongoDBStringCb member.
     /*!
       \param A cb_obfuscate_mongodb_string_t function pointer to the CGO callback.
@@ -514,6 +608,14 @@ public:
     */
     virtual void setEmitAgentTelemetryCb(cb_emit_agent_telemetry_t) = 0;
 
+    //! flushMemoryTracker member.
+    /*!
+      This method hands the memory tracking events queued by the runtime to the batch
+      callback. When the runtime is statically linked with its own copy of the memory
+      tracker, as on Windows, it is the only way to reach its queue.
+    */
+    virtual void flushMemoryTracker();
+
 protected:
     //! _allocateInternalErrorDiagnoses member.
     /*!
@@ -533,9 +635,12 @@ private:
   the underlying python runtimes.
   \param python_home A C-string path to the python home for the target python runtime.
   \param python_exe A C-string path to the python interpreter.
+  \param memtrack_cb The memory tracker callback of the loader.
+  \param memtrack_batch_cb The batch memory tracker callback of the loader.
   \return A pointer to the RtLoader instance created by the implementing function.
 */
-typedef RtLoader *(create_t)(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb);
+typedef RtLoader *(create_t)(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb,
+                             cb_memory_tracker_batch_t memtrack_batch_cb);
 
 /*! destroy_t function prototype
   \typedef destroy_t defines the destructor function prototype to destroy existing RtLoader instances.
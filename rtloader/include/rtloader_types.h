@@ -6,6 +6,7 @@
 #ifndef DATADOG_AGENT_RTLOADER_TYPES_H
 #define DATADOG_AGENT_RTLOADER_TYPES_H
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -40,6 +41,13 @@ typedef enum {
     DATADOG_AGENT_RTLOADER_FREE,
 } rtloader_mem_ops_t;
 
+// A single allocation or free, handed to the memory tracker in batches
+typedef struct rtloader_mem_event_s {
+    void *ptr;
+    size_t sz;
+    rtloader_mem_ops_t op;
+} rtloader_mem_event_t;
+
 typedef void *(*rtloader_malloc_t)(size_t);
 typedef void (*rtloader_free_t)(void *);
 
@@ -72,6 +80,15 @@ typedef struct event_s {
     char *event_type;
 } event_t;
 
+typedef struct metric_sample_s {
+    metric_type_t type;
+    char *name;
+    double value;
+    char **tags;
+    char *hostname;
+    bool flush_first_value;
+} metric_sample_t;
+
 typedef struct py_info_s {
     const char *version; // returned by Py_GetInfo(); is static string owned by python
     char *path; // allocated within getPyInfo()
@@ -90,6 +107,15 @@ typedef struct pymem_stats_s {
     size_t inuse, alloc;
 } pymem_stats_t;
 
+// Resources used by a check since its creation, see get_check_profile
+typedef struct check_profile_s {
+    uint64_t runs; // number of calls to the check `run` method
+    uint64_t wall_time_ns; // time spent in the `run` method
+    uint64_t cpu_time_ns; // CPU time used by the running thread meanwhile
+    uint64_t gil_wait_ns; // time spent waiting for the GIL to run the check
+    uint64_t alloc_bytes; // memory requested by the interpreter meanwhile, needs init_pymem_stats
+} check_profile_t;
+
 /*
  * custom builtins
  */
@@ -106,6 +132,8 @@ typedef void (*cb_submit_event_t)(char *, event_t *);
 typedef void (*cb_submit_histogram_bucket_t)(char *, char *, long long, float, float, int, char *, char **, bool);
 // (id, event, event_type)
 typedef void (*cb_submit_event_platform_event_t)(char *, char *, int, char *);
+// (id, samples, samples_count)
+typedef void (*cb_submit_metric_batch_t)(char *, metric_sample_t *, int);
 
 // datadog_agent
 //
@@ -113,6 +141,8 @@ typedef void (*cb_submit_event_platform_event_t)(char *, char *, int, char *);
 typedef void (*cb_get_version_t)(char **);
 // (key, yaml_result)
 typedef void (*cb_get_config_t)(char *, char **);
+// (key, binary_result, binary_result_len)
+typedef void (*cb_get_config_binary_t)(char *, char **, size_t *);
 // (yaml_result)
 typedef void (*cb_headers_t)(char **);
 // (hostname)
@@ -149,6 +179,14 @@ typedef void (*cb_emit_agent_telemetry_t)(char *, char *, double, char *);
 // _util
 // (argv, env, stdout, stderr, ret_code, exception)
 typedef void (*cb_get_subprocess_output_t)(char **, char **, char **, char **, int *, char **);
+// (argv, env, exception), returns a handle to the running subprocess, 0 on error
+typedef int64_t (*cb_start_subprocess_t)(char **, char **, char **);
+// (handle, chunk, chunk_len, stderr, ret_code, exception), returns 1 with the next chunk of
+// stdout, 0 once the subprocess exited, with stderr and ret_code set, or failed, with exception
+// set. The handle is released when 0 is returned.
+typedef int (*cb_read_subprocess_output_t)(int64_t, char **, size_t *, char **, int *, char **);
+// (handle)
+typedef void (*cb_stop_subprocess_t)(int64_t);
 
 // CGO API
 //
@@ -156,6 +194,8 @@ typedef void (*cb_get_subprocess_output_t)(char **, char **, char **, char **, i
 //
 typedef void (*cb_cgo_free_t)(void *);
 typedef void (*cb_memory_tracker_t)(void *, size_t sz, rtloader_mem_ops_t op);
+// (events, count)
+typedef void (*cb_memory_tracker_batch_t)(rtloader_mem_event_t *, size_t);
 
 // tagger
 //
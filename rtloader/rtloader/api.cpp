@@ -53,6 +53,8 @@ static HMODULE rtloader_backend = NULL;
 #else
 static void *rtloader_backend = NULL;
 #endif
+// the instance created by the backend, there is at most one
+static RtLoader *rtloader_instance = NULL;
 
 #ifdef _WIN32
 
@@ -109,7 +111,8 @@ rtloader_t *make3(const char *python_home, const char *python_exe, char **error)
     if (!create_three) {
         return NULL;
     }
-    return AS_TYPE(rtloader_t, create_three(python_home, python_exe, _get_memory_tracker_cb()));
+    rtloader_instance = create_three(python_home, python_exe, _get_memory_tracker_cb(), _get_memory_tracker_batch_cb());
+    return AS_TYPE(rtloader_t, rtloader_instance);
 }
 
 /*! \fn void destroy(rtloader_t *rtloader)
@@ -127,6 +130,7 @@ void destroy(rtloader_t *rtloader)
             std::cerr << "Unable to open 'three' destructor: " << GetLastError() << std::endl;
             return;
         }
+        rtloader_instance = NULL;
         destroy(AS_TYPE(RtLoader, rtloader));
         rtloader_backend = NULL;
     }
@@ -164,7 +168,8 @@ rtloader_t *make3(const char *python_home, const char *python_exe, char **error)
         return NULL;
     }
 
-    return AS_TYPE(rtloader_t, create_three(python_home, python_exe, _get_memory_tracker_cb()));
+    rtloader_instance = create_three(python_home, python_exe, _get_memory_tracker_cb(), _get_memory_tracker_batch_cb());
+    return AS_TYPE(rtloader_t, rtloader_instance);
 }
 
 void destroy(rtloader_t *rtloader)
@@ -177,6 +182,7 @@ void destroy(rtloader_t *rtloader)
             std::cerr << "Unable to dlopen backend destructor: " << dlsym_error;
             return;
         }
+        rtloader_instance = NULL;
         destroy(AS_TYPE(RtLoader, rtloader));
         rtloader_backend = NULL;
     }
@@ -188,6 +194,20 @@ void set_memory_tracker_cb(cb_memory_tracker_t cb)
     _set_memory_tracker_cb(cb);
 }
 
+void set_memory_tracker_batch_cb(cb_memory_tracker_batch_t cb)
+{
+    _set_memory_tracker_batch_cb(cb);
+}
+
+void flush_memory_tracker(void)
+{
+    _flush_memory_tracker();
+    // the backend may have its own copy of the memory tracker
+    if (rtloader_instance) {
+        rtloader_instance->flushMemoryTracker();
+    }
+}
+
 int init(rtloader_t *rtloader)
 {
     return AS_TYPE(RtLoader, rtloader)->init() ? 1 : 0;
@@ -256,6 +276,17 @@ int get_check(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *i
         : 0;
 }
 
+int get_check_from_binary(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *init_config,
+                          size_t init_config_len, const char *instance, size_t instance_len, const char *check_id,
+                          const char *check_name, rtloader_pyobject_t **check)
+{
+    return AS_TYPE(RtLoader, rtloader)
+               ->getCheckFromBinary(AS_TYPE(RtLoaderPyObject, py_class), init_config, init_config_len, instance,
+                                    instance_len, check_id, check_name, *AS_PTYPE(RtLoaderPyObject, check))
+        ? 1
+        : 0;
+}
+
 int get_check_deprecated(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *init_config,
                          const char *instance, const char *agent_config, const char *check_id, const char *check_name,
                          rtloader_pyobject_t **check)
@@ -443,6 +474,11 @@ void set_submit_event_platform_event_cb(rtloader_t *rtloader, cb_submit_event_pl
     AS_TYPE(RtLoader, rtloader)->setSubmitEventPlatformEventCb(cb);
 }
 
+void set_submit_metric_batch_cb(rtloader_t *rtloader, cb_submit_metric_batch_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setSubmitMetricBatchCb(cb);
+}
+
 /*
  * datadog_agent API
  */
@@ -457,6 +493,11 @@ void set_get_config_cb(rtloader_t *rtloader, cb_get_config_t cb)
     AS_TYPE(RtLoader, rtloader)->setGetConfigCb(cb);
 }
 
+void set_get_config_binary_cb(rtloader_t *rtloader, cb_get_config_binary_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setGetConfigBinaryCb(cb);
+}
+
 void set_headers_cb(rtloader_t *rtloader, cb_headers_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setHeadersCb(cb);
@@ -555,6 +596,21 @@ void set_get_subprocess_output_cb(rtloader_t *rtloader, cb_get_subprocess_output
     AS_TYPE(RtLoader, rtloader)->setSubprocessOutputCb(cb);
 }
 
+void set_start_subprocess_cb(rtloader_t *rtloader, cb_start_subprocess_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setStartSubprocessCb(cb);
+}
+
+void set_read_subprocess_output_cb(rtloader_t *rtloader, cb_read_subprocess_output_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setReadSubprocessOutputCb(cb);
+}
+
+void set_stop_subprocess_cb(rtloader_t *rtloader, cb_stop_subprocess_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setStopSubprocessCb(cb);
+}
+
 /*
  * CGO API
  */
@@ -571,6 +627,16 @@ void set_tags_cb(rtloader_t *rtloader, cb_tags_t cb)
     AS_TYPE(RtLoader, rtloader)->setTagsCb(cb);
 }
 
+void bump_tags_cache_generation(rtloader_t *rtloader)
+{
+    AS_TYPE(RtLoader, rtloader)->bumpTagsCacheGeneration();
+}
+
+void disable_tags_cache(rtloader_t *rtloader)
+{
+    AS_TYPE(RtLoader, rtloader)->disableTagsCache();
+}
+
 /*
  * kubeutil API
  */
@@ -602,3 +668,11 @@ void get_pymem_stats(rtloader_t *rtloader, pymem_stats_t *stats)
     }
     AS_TYPE(RtLoader, rtloader)->getPymemStats(*stats);
 }
+
+int get_check_profile(rtloader_t *rtloader, rtloader_pyobject_t *check, check_profile_t *profile)
+{
+    if (profile == NULL) {
+        return 0;
+    }
+    return AS_TYPE(RtLoader, rtloader)->getCheckProfile(AS_TYPE(RtLoaderPyObject, check), *profile) ? 1 : 0;
+}
@@ -13,13 +13,19 @@
     "[{\"result\":3, \"diagnosis\": \"check's get_diagnoses() method failed\", \"rawerror\": \""
 #define GET_DIANGOSES_FAILURE_DIAGNOSES_END "\"}]"
 
-RtLoader::RtLoader(cb_memory_tracker_t memtrack_cb)
+RtLoader::RtLoader(cb_memory_tracker_t memtrack_cb, cb_memory_tracker_batch_t memtrack_batch_cb)
     : _error()
     , _errorFlag(false)
 {
     _set_memory_tracker_cb(memtrack_cb);
+    _set_memory_tracker_batch_cb(memtrack_batch_cb);
 };
 
+void RtLoader::flushMemoryTracker()
+{
+    _flush_memory_tracker();
+}
+
 void RtLoader::setError(const std::string &msg) const
 {
     _errorFlag = true;
@@ -26,6 +26,7 @@ extern void submitServiceCheck(char *, char *, int, char **, char *, char *);
 extern void submitEvent(char*, event_t*);
 extern void submitHistogramBucket(char *, char *, long long, float, float, int, char *, char **, bool);
 extern void submitEventPlatformEvent(char *, char *, int, char *);
+extern void submitMetricBatch(char *, metric_sample_t *, int);
 
 static void initAggregatorTests(rtloader_t *rtloader) {
    set_submit_metric_cb(rtloader, submitMetric);
@@ -33,6 +34,7 @@ static void initAggregatorTests(rtloader_t *rtloader) {
    set_submit_event_cb(rtloader, submitEvent);
    set_submit_histogram_bucket_cb(rtloader, submitHistogramBucket);
    set_submit_event_platform_event_cb(rtloader, submitEventPlatformEvent);
+   set_submit_metric_batch_cb(rtloader, submitMetricBatch);
 }
 */
 import "C"
@@ -56,8 +58,19 @@ var (
 	lowerBound      float64
 	upperBound      float64
 	monotonic       bool
+	batchCalls      int
+	batch           []sample
 )
 
+type sample struct {
+	metricType      int
+	name            string
+	value           float64
+	tags            []string
+	hostname        string
+	flushFirstValue bool
+}
+
 type event struct {
 	title          string
 	text           string
@@ -86,6 +99,8 @@ func resetOuputValues() {
 	lowerBound = 1.0
 	upperBound = 1.0
 	monotonic = false
+	batchCalls = 0
+	batch = nil
 }
 
 func setUp() error {
@@ -241,3 +256,19 @@ func submitEventPlatformEvent(id *C.char, _rawEventPtr *C.char, _rawEventSize C.
 	rawEvent = C.GoBytes(unsafe.Pointer(_rawEventPtr), _rawEventSize)
 	eventType = C.GoString(_eventType)
 }
+
+//export submitMetricBatch
+func submitMetricBatch(id *C.char, samples *C.metric_sample_t, samplesCount C.int) {
+	checkID = C.GoString(id)
+	batchCalls++
+	for _, s := range unsafe.Slice(samples, int(samplesCount)) {
+		batch = append(batch, sample{
+			metricType:      int(s._type),
+			name:            C.GoString(s.name),
+			value:           float64(s.value),
+			tags:            charArrayToSlice(s.tags),
+			hostname:        C.GoString(s.hostname),
+			flushFirstValue: bool(s.flush_first_value),
+		})
+	}
+}
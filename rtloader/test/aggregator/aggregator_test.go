@@ -65,6 +65,33 @@ func TestSubmitMetric(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestSubmitMetricInternedTags(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	// the same tag values are submitted several times, from a str subclass, as bytes and one can't be encoded
+	code := `Tag = type('Tag', (str,), {}); [aggregator.submit_metric(None, 'id', aggregator.GAUGE, 'name', 1.0, ['foo', b'bar', Tag('baz'), '\udc80', 'foo'], 'myhost') for _ in range(3)]`
+	out, err := run(code)
+
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if len(tags) != 12 {
+		t.Fatalf("Unexpected tags length: %d", len(tags))
+	}
+	for i := 0; i < 3; i++ {
+		if tags[i*4] != "foo" || tags[i*4+1] != "bar" || tags[i*4+2] != "baz" || tags[i*4+3] != "foo" {
+			t.Fatalf("Unexpected tags: %v", tags)
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestSubmitMetric_FlushFirstValue(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -495,3 +522,129 @@ func TestSubmitEventPlatformEvent(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestSubmitMetricsBatch(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_metrics_batch(None, 'id', [(aggregator.GAUGE, 'name', -99.0, ['foo', 21, 'bar', ["hey"]], 'myhost'), (aggregator.MONOTONIC_COUNT, 'other', 42, [], '', True)])`)
+
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if checkID != "id" {
+		t.Fatalf("Unexpected id value: %s", checkID)
+	}
+	if batchCalls != 1 {
+		t.Fatalf("Unexpected number of batch submissions: %d", batchCalls)
+	}
+	if len(batch) != 2 {
+		t.Fatalf("Unexpected batch length: %d", len(batch))
+	}
+	if batch[0].metricType != 0 || batch[0].name != "name" || batch[0].value != -99.0 || batch[0].hostname != "myhost" || batch[0].flushFirstValue {
+		t.Fatalf("Unexpected first sample: %+v", batch[0])
+	}
+	if len(batch[0].tags) != 2 || batch[0].tags[0] != "foo" || batch[0].tags[1] != "bar" {
+		t.Fatalf("Unexpected tags: %v", batch[0].tags)
+	}
+	if batch[1].metricType != 3 || batch[1].name != "other" || batch[1].value != 42 || batch[1].hostname != "" || !batch[1].flushFirstValue {
+		t.Fatalf("Unexpected second sample: %+v", batch[1])
+	}
+	if len(batch[1].tags) != 0 {
+		t.Fatalf("Unexpected tags: %v", batch[1].tags)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubmitMetricsBatchErrors(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	cases := []struct {
+		args        string
+		expectedOut string
+	}{
+		{
+			"None, 'id', 42",
+			"TypeError: samples must be a sequence",
+		},
+		{
+			"None, 'id', [(aggregator.GAUGE, 'name', 1.0, ['foo'], 'myhost'), 'not a tuple']",
+			"TypeError: each sample must be a tuple",
+		},
+		{
+			"None, 'id', [(aggregator.GAUGE, 'name', 1.0, ['foo'], 'myhost'), (aggregator.GAUGE, 'name', 'nan', [], 'myhost')]",
+			"TypeError: .*",
+		},
+	}
+
+	for _, testCase := range cases {
+		out, err := run(fmt.Sprintf("aggregator.submit_metrics_batch(%s)", testCase.args))
+		if err != nil {
+			t.Fatal(err)
+		}
+		matched, err := regexp.Match(testCase.expectedOut, []byte(out))
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !matched {
+			t.Fatalf("Unexpected output '%s', expected '%s'", out, testCase.expectedOut)
+		}
+		if batchCalls != 0 {
+			t.Fatalf("Unexpected batch submission for invalid input")
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubmitMetricsBatchLarge(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	// large enough to spill out of the static scratch buffer into heap chunks
+	out, err := run(`aggregator.submit_metrics_batch(None, 'id', [(aggregator.GAUGE, 'name', float(i), ['foo', 'bar:{}'.format(i)], 'myhost') for i in range(5000)])`)
+
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if batchCalls != 1 {
+		t.Fatalf("Unexpected number of batch submissions: %d", batchCalls)
+	}
+	if len(batch) != 5000 {
+		t.Fatalf("Unexpected batch length: %d", len(batch))
+	}
+	for i, s := range batch {
+		if s.value != float64(i) || len(s.tags) != 2 || s.tags[1] != fmt.Sprintf("bar:%d", i) {
+			t.Fatalf("Unexpected sample %d: %+v", i, s)
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func BenchmarkSubmitMetric(b *testing.B) {
+	code := fmt.Sprintf(`for _ in range(%d): aggregator.submit_metric(None, 'id', aggregator.GAUGE, 'name', 1.0, ['foo', 'bar'], 'myhost', False)`, b.N)
+
+	b.ResetTimer()
+	out, err := run(code)
+	b.StopTimer()
+
+	if err != nil {
+		b.Fatal(err)
+	}
+	if out != "" {
+		b.Fatalf("Unexpected printed value: '%s'", out)
+	}
+	b.ReportMetric(float64(b.N)/b.Elapsed().Seconds(), "calls/s")
+}
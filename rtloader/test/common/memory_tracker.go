@@ -0,0 +1,103 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+package testcommon
+
+import (
+	"sync"
+	"unsafe"
+
+	"github.com/DataDog/datadog-agent/rtloader/test/helpers"
+)
+
+/*
+#include <datadog_agent_rtloader.h>
+#include <rtloader_mem.h>
+
+extern void trackMemoryEvents(rtloader_mem_event_t *, size_t);
+
+static void initOrderedMemoryTracker(void) {
+	set_memory_tracker_batch_cb(trackMemoryEvents);
+}
+
+static void churn(int rounds) {
+	void *ptrs[16];
+	for (int i = 0; i < rounds; i++) {
+		for (int j = 0; j < 16; j++) {
+			ptrs[j] = _malloc(j + 1);
+		}
+		for (int j = 0; j < 16; j++) {
+			_free(ptrs[j]);
+		}
+	}
+}
+*/
+import "C"
+
+const churnAllocations = 16
+
+// memoryEvents checks the events handed to the batch memory tracker against the
+// pointers currently allocated.
+type memoryEvents struct {
+	sync.Mutex
+	live         map[unsafe.Pointer]C.size_t
+	allocations  int
+	frees        int
+	unknownFrees int
+	maxBatch     int
+}
+
+var events memoryEvents
+
+//export trackMemoryEvents
+func trackMemoryEvents(batch *C.rtloader_mem_event_t, count C.size_t) {
+	events.Lock()
+	defer events.Unlock()
+
+	if int(count) > events.maxBatch {
+		events.maxBatch = int(count)
+	}
+	for _, event := range unsafe.Slice(batch, int(count)) {
+		switch event.op {
+		case C.DATADOG_AGENT_RTLOADER_ALLOCATION:
+			events.allocations++
+			events.live[event.ptr] = event.sz
+		case C.DATADOG_AGENT_RTLOADER_FREE:
+			if _, ok := events.live[event.ptr]; !ok {
+				events.unknownFrees++
+				continue
+			}
+			events.frees++
+			delete(events.live, event.ptr)
+		}
+	}
+}
+
+func startOrderedMemoryTracker() {
+	C.flush_memory_tracker()
+	events = memoryEvents{live: map[unsafe.Pointer]C.size_t{}}
+	C.initOrderedMemoryTracker()
+}
+
+func stopOrderedMemoryTracker() {
+	C.flush_memory_tracker()
+	helpers.InitMemoryTracker()
+}
+
+func churn(rounds int) {
+	C.churn(C.int(rounds))
+}
+
+func allocate(size int) unsafe.Pointer {
+	return C._malloc(C.size_t(size))
+}
+
+func free(ptr unsafe.Pointer) {
+	C._free(ptr)
+}
+
+func batchSize() int {
+	return C.RTLOADER_MEM_TRACKER_BATCH
+}
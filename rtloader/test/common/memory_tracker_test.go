@@ -0,0 +1,73 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+package testcommon
+
+import (
+	"sync"
+	"testing"
+	"unsafe"
+)
+
+func TestMemoryTrackerBatches(t *testing.T) {
+	startOrderedMemoryTracker()
+
+	const workers, rounds = 8, 500
+
+	var wg sync.WaitGroup
+	for i := 0; i < workers; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			churn(rounds)
+		}()
+	}
+
+	// pointers freed on another thread than the one that allocated them
+	ptrs := make(chan unsafe.Pointer, 64)
+	wg.Add(2)
+	go func() {
+		defer wg.Done()
+		defer close(ptrs)
+		for i := 0; i < rounds; i++ {
+			ptrs <- allocate(i%64 + 1)
+		}
+	}()
+	go func() {
+		defer wg.Done()
+		for ptr := range ptrs {
+			free(ptr)
+		}
+	}()
+	wg.Wait()
+
+	// full batches are delivered as they fill up, not only when flushing
+	events.Lock()
+	if events.allocations+events.frees == 0 {
+		t.Errorf("no batch was delivered")
+	}
+	events.Unlock()
+
+	stopOrderedMemoryTracker()
+
+	events.Lock()
+	defer events.Unlock()
+	expected := workers*rounds*churnAllocations + rounds
+	if events.allocations != expected {
+		t.Errorf("expected %d allocations, got %d", expected, events.allocations)
+	}
+	if events.frees != expected {
+		t.Errorf("expected %d frees, got %d", expected, events.frees)
+	}
+	if events.unknownFrees != 0 {
+		t.Errorf("%d frees were delivered before their allocation", events.unknownFrees)
+	}
+	if len(events.live) != 0 {
+		t.Errorf("%d allocations were never freed", len(events.live))
+	}
+	if events.maxBatch != batchSize() {
+		t.Errorf("expected batches of %d events, got at most %d", batchSize(), events.maxBatch)
+	}
+}
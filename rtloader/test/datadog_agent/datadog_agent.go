@@ -6,6 +6,7 @@
 package testdatadogagent
 
 import (
+	"encoding/binary"
 	"encoding/json"
 	"fmt"
 	"os"
@@ -28,6 +29,7 @@ import (
 extern void doLog(char*, int);
 extern void getClustername(char **);
 extern void getConfig(char *, char **);
+extern void getConfigBinary(char *, char **, size_t *);
 extern void getHostname(char **);
 extern bool getTracemallocEnabled();
 extern void getVersion(char **);
@@ -64,6 +66,10 @@ static void initDatadogAgentTests(rtloader_t *rtloader) {
    set_obfuscate_mongodb_string_cb(rtloader, obfuscateMongoDBString);
    set_emit_agent_telemetry_cb(rtloader, emitAgentTelemetry);
 }
+
+static void setBinaryConfig(rtloader_t *rtloader, bool enabled) {
+   set_get_config_binary_cb(rtloader, enabled ? getConfigBinary : NULL);
+}
 */
 import "C"
 
@@ -161,6 +167,35 @@ func getConfig(key *C.char, in **C.char) {
 	}
 }
 
+//export getConfigBinary
+func getConfigBinary(key *C.char, payload **C.char, payloadLen *C.size_t) {
+	var data []byte
+
+	switch C.GoString(key) {
+	case "foo":
+		// {"name": "foo", "body": "Binary", "time": 654321}
+		data = binary.LittleEndian.AppendUint32([]byte{'m'}, 3)
+		for _, s := range []string{"name", "foo", "body", "Binary", "time"} {
+			data = binary.LittleEndian.AppendUint32(append(data, 's'), uint32(len(s)))
+			data = append(data, s...)
+		}
+		data = binary.LittleEndian.AppendUint64(append(data, 'i'), 654321)
+	case "invalid":
+		data = []byte{'x'}
+	default:
+		// no payload, falls back to getConfig
+		*payload = nil
+		return
+	}
+
+	*payload = (*C.char)(helpers.TrackedCString(string(data)))
+	*payloadLen = C.size_t(len(data))
+}
+
+func setBinaryConfig(enabled bool) {
+	C.setBinaryConfig(rtloader, C.bool(enabled))
+}
+
 //export headers
 func headers(in **C.char) {
 	h := map[string]string{
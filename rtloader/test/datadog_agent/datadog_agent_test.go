@@ -74,6 +74,32 @@ func TestGetConfig(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetConfigBinary(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setBinaryConfig(true)
+	defer setBinaryConfig(false)
+
+	code := fmt.Sprintf(`
+	d = datadog_agent.get_config("foo")
+	level = datadog_agent.get_config("log_level")
+	invalid = datadog_agent.get_config("invalid")
+	with open(r'%s', 'w') as f:
+		f.write("{}:{}:{}:{}:{}".format(d.get('name'), d.get('body'), d.get('time'), level, invalid))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "foo:Binary:654321:warning:None" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestHeaders(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -717,3 +743,19 @@ func TestEmitAgentTelemetry(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func BenchmarkGetConfig(b *testing.B) {
+	code := fmt.Sprintf(`for _ in range(%d): datadog_agent.get_config("log_level")`, b.N)
+
+	b.ResetTimer()
+	out, err := run(code)
+	b.StopTimer()
+
+	if err != nil {
+		b.Fatal(err)
+	}
+	if out != "" {
+		b.Fatalf("Unexpected printed value: '%s'", out)
+	}
+	b.ReportMetric(float64(b.N)/b.Elapsed().Seconds(), "calls/s")
+}
@@ -34,3 +34,12 @@ func TestMemoryTracker(ptr unsafe.Pointer, sz C.size_t, op C.rtloader_mem_ops_t)
 		Frees.Add(1)
 	}
 }
+
+// TestMemoryTrackerBatch is the method exposed to the RTLoader for batched memory tracking
+//
+//export TestMemoryTrackerBatch
+func TestMemoryTrackerBatch(events *C.rtloader_mem_event_t, count C.size_t) {
+	for _, event := range unsafe.Slice(events, int(count)) {
+		TestMemoryTracker(event.ptr, event.sz, event.op)
+	}
+}
@@ -17,9 +17,9 @@ import (
 #include "datadog_agent_rtloader.h"
 #include "rtloader_mem.h"
 
-void TestMemoryTracker(void *, size_t, rtloader_mem_ops_t);
+void TestMemoryTrackerBatch(rtloader_mem_event_t *, size_t);
 void initTestMemoryTracker(void) {
-	set_memory_tracker_cb(TestMemoryTracker);
+	set_memory_tracker_batch_cb(TestMemoryTrackerBatch);
 }
 
 */
@@ -40,19 +40,23 @@ func TrackedCString(str string) unsafe.Pointer {
 
 // ResetMemoryStats resets allocations and frees counters to zero
 func ResetMemoryStats() {
+	// forget about what is still queued as well
+	C.flush_memory_tracker()
 	Allocations.Set(0)
 	Frees.Set(0)
 }
 
 // AssertMemoryUsage makes sure the allocations and frees match
 func AssertMemoryUsage(t *testing.T) {
+	C.flush_memory_tracker()
 	assert.Equal(t, Allocations.Value(), Frees.Value(),
 		"Number of allocations doesn't match number of frees")
 }
 
 // AssertMemoryExpectation makes sure the allocations match the
 // provided value
-func AssertMemoryExpectation(t *testing.T, counter expvar.Int, expected int64) {
+func AssertMemoryExpectation(t *testing.T, counter *expvar.Int, expected int64) {
+	C.flush_memory_tracker()
 	assert.Equal(t, expected, counter.Value(),
 		"Memory statistic doesn't match the expected value")
 }
@@ -20,5 +20,5 @@ func TestInit(t *testing.T) {
 	}
 
 	// Check for expected allocations
-	helpers.AssertMemoryExpectation(t, helpers.Allocations, initAllocations)
+	helpers.AssertMemoryExpectation(t, &helpers.Allocations, initAllocations)
 }
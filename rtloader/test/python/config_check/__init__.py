@@ -0,0 +1,15 @@
+from datadog_checks.base.checks import AgentCheck
+
+
+# Check reporting the configuration it was instantiated with, for testing purposes
+class ConfigCheck(AgentCheck):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.init_config = kwargs.get('init_config')
+        self.instances = kwargs.get('instances')
+
+    def get_warnings(self):
+        return [repr(self.init_config), repr(self.instances[0])]
+
+
+__version__ = '0.1.0'
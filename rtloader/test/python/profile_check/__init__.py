@@ -0,0 +1,14 @@
+from datadog_checks.base.checks import AgentCheck
+
+
+# Check using some CPU and memory on every run, for testing purposes
+class ProfileCheck(AgentCheck):
+    def run(self):
+        items = [str(i) for i in range(100000)]
+        total = 0
+        for item in items:
+            total += len(item)
+        return ""
+
+
+__version__ = '0.1.0'
@@ -12,8 +12,10 @@ package testrtloader
 import "C"
 
 import (
+	"encoding/binary"
 	"errors"
 	"fmt"
+	"math"
 	"os"
 	"path/filepath"
 	"runtime"
@@ -48,6 +50,9 @@ func setUp() error {
 	// Updates sys.path so testing Check can be found
 	C.add_python_path(rtloader, C.CString(filepath.Join("..", "python")))
 
+	// Track interpreter allocations, as the Agent does with python memory telemetry
+	C.init_pymem_stats(rtloader)
+
 	ok := C.init(rtloader)
 	if ok != 1 {
 		return fmt.Errorf("`init` failed: %s", C.GoString(C.get_error(rtloader)))
@@ -308,6 +313,126 @@ func runFakeGetWarnings() ([]string, error) {
 	return warnings, nil
 }
 
+// runProfileCheck runs `profile_check` the given number of times and returns its profile,
+// along with whether a profile was available before the first run
+func runProfileCheck(runs int) (C.check_profile_t, bool, error) {
+	var module *C.rtloader_pyobject_t
+	var class *C.rtloader_pyobject_t
+	var check *C.rtloader_pyobject_t
+	var profile C.check_profile_t
+
+	runtime.LockOSThread()
+	defer runtime.UnlockOSThread()
+	state := C.ensure_gil(rtloader)
+	defer C.release_gil(rtloader, state)
+
+	classStr := (*C.char)(helpers.TrackedCString("profile_check"))
+	defer C._free(unsafe.Pointer(classStr))
+
+	if C.get_class(rtloader, classStr, &module, &class) != 1 {
+		return profile, false, errors.New(C.GoString(C.get_error(rtloader)))
+	}
+	defer C.rtloader_decref(rtloader, module)
+	defer C.rtloader_decref(rtloader, class)
+
+	emptyStr := (*C.char)(helpers.TrackedCString(""))
+	defer C._free(unsafe.Pointer(emptyStr))
+	configStr := (*C.char)(helpers.TrackedCString("{}"))
+	defer C._free(unsafe.Pointer(configStr))
+	checkIDStr := (*C.char)(helpers.TrackedCString("checkID"))
+	defer C._free(unsafe.Pointer(checkIDStr))
+
+	if C.get_check(rtloader, class, emptyStr, configStr, checkIDStr, classStr, &check) != 1 {
+		return profile, false, errors.New(C.GoString(C.get_error(rtloader)))
+	}
+	defer C.rtloader_decref(rtloader, check)
+
+	profiled := C.get_check_profile(rtloader, check, &profile) == 1
+
+	for i := 0; i < runs; i++ {
+		result := C.run_check(rtloader, check)
+		if result == nil {
+			return profile, profiled, errors.New(C.GoString(C.get_error(rtloader)))
+		}
+		C._free(unsafe.Pointer(result))
+	}
+
+	if C.get_check_profile(rtloader, check, &profile) != 1 {
+		return profile, profiled, errors.New("no profile after running the check")
+	}
+
+	return profile, profiled, nil
+}
+
+// Helpers building payloads in the binary config encoding, see `from_binary`
+func binaryString(s string) []byte {
+	return append(binary.LittleEndian.AppendUint32([]byte{'s'}, uint32(len(s))), s...)
+}
+
+func binaryInt(i int64) []byte {
+	return binary.LittleEndian.AppendUint64([]byte{'i'}, uint64(i))
+}
+
+func binaryFloat(f float64) []byte {
+	return binary.LittleEndian.AppendUint64([]byte{'d'}, math.Float64bits(f))
+}
+
+func binaryContainer(kind byte, count int, items ...[]byte) []byte {
+	buf := binary.LittleEndian.AppendUint32([]byte{kind}, uint32(count))
+	for _, item := range items {
+		buf = append(buf, item...)
+	}
+	return buf
+}
+
+// getConfigCheck instantiates `config_check` from binary payloads and returns the
+// representation of the init_config and instance it received
+func getConfigCheck(initConfig []byte, instance []byte) ([]string, error) {
+	var module *C.rtloader_pyobject_t
+	var class *C.rtloader_pyobject_t
+	var check *C.rtloader_pyobject_t
+
+	runtime.LockOSThread()
+	defer runtime.UnlockOSThread()
+	state := C.ensure_gil(rtloader)
+	defer C.release_gil(rtloader, state)
+
+	classStr := (*C.char)(helpers.TrackedCString("config_check"))
+	defer C._free(unsafe.Pointer(classStr))
+
+	if C.get_class(rtloader, classStr, &module, &class) != 1 {
+		return nil, errors.New(C.GoString(C.get_error(rtloader)))
+	}
+	defer C.rtloader_decref(rtloader, module)
+	defer C.rtloader_decref(rtloader, class)
+
+	checkIDStr := (*C.char)(helpers.TrackedCString("checkID"))
+	defer C._free(unsafe.Pointer(checkIDStr))
+
+	ret := C.get_check_from_binary(rtloader, class,
+		(*C.char)(unsafe.Pointer(unsafe.SliceData(initConfig))), C.size_t(len(initConfig)),
+		(*C.char)(unsafe.Pointer(unsafe.SliceData(instance))), C.size_t(len(instance)),
+		checkIDStr, classStr, &check)
+	if ret != 1 || check == nil {
+		return nil, errors.New(C.GoString(C.get_error(rtloader)))
+	}
+	defer C.rtloader_decref(rtloader, check)
+
+	warns := C.get_checks_warnings(rtloader, check)
+	if warns == nil {
+		return nil, fmt.Errorf("get_checks_warnings return NULL: %s", C.GoString(C.get_error(rtloader)))
+	}
+	defer C._free(unsafe.Pointer(warns))
+
+	warnings := []string{}
+	for _, warn := range unsafe.Slice(warns, 2) {
+		defer C._free(unsafe.Pointer(warn))
+		warnings = append(warnings, C.GoString(warn))
+	}
+
+	return warnings, nil
+}
+
 func getIntegrationList() ([]string, error) {
 	runtime.LockOSThread()
 	state := C.ensure_gil(rtloader)
@@ -194,6 +194,68 @@ func TestGetCheck(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetCheckFromBinary(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	instance := binaryContainer('m', 5,
+		binaryString("host"), binaryString("localhost"),
+		binaryString("port"), binaryInt(-8125),
+		binaryString("ratio"), binaryFloat(0.5),
+		binaryString("tags"), binaryContainer('l', 2, binaryString("a:b"), binaryString("c")),
+		binaryString("options"), binaryContainer('m', 2, binaryString("ssl"), []byte{'t'}, binaryString("proxy"), []byte{'n'}),
+	)
+
+	res, err := getConfigCheck([]byte{'n'}, instance)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if res[0] != "{}" {
+		t.Errorf("Unexpected init_config: %s", res[0])
+	}
+	expected := "{'host': 'localhost', 'port': -8125, 'ratio': 0.5, 'tags': ['a:b', 'c'], 'options': {'ssl': True, 'proxy': None}}"
+	if res[1] != expected {
+		t.Errorf("Unexpected instance: %s", res[1])
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestGetCheckFromBinaryErrors(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	instance := binaryContainer('m', 1, binaryString("host"), binaryString("localhost"))
+	// lists nested deeper than MAX_BINARY_DEPTH
+	nested := []byte{'n'}
+	for i := 0; i < 100; i++ {
+		nested = binaryContainer('l', 1, nested)
+	}
+
+	payloads := map[string][]byte{
+		"truncated binary config":      instance[:len(instance)-1],
+		"trailing data after binary":   append(instance, 'n'),
+		"unknown binary config type":   {'x'},
+		"error instance is not a dict": binaryContainer('l', 0),
+		"unhashable type":              binaryContainer('m', 1, binaryContainer('l', 0), []byte{'n'}),
+		"nested too deeply":            nested,
+	}
+
+	for expected, payload := range payloads {
+		_, err := getConfigCheck([]byte{'n'}, payload)
+		if err == nil {
+			t.Errorf("Expected an error for '%s'", expected)
+		} else if !strings.Contains(err.Error(), expected) {
+			t.Errorf("Expected error to contain '%s', got: %s", expected, err)
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestRunCheck(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -212,6 +274,36 @@ func TestRunCheck(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetCheckProfile(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	profile, profiled, err := runProfileCheck(2)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if profiled {
+		t.Error("Expected no profile before the first run")
+	}
+	if profile.runs != 2 {
+		t.Errorf("Expected 2 runs, got %d", profile.runs)
+	}
+	if profile.wall_time_ns == 0 {
+		t.Error("Expected wall time to be accounted")
+	}
+	if profile.cpu_time_ns == 0 || profile.cpu_time_ns > profile.wall_time_ns+profile.gil_wait_ns {
+		t.Errorf("Unexpected CPU time: %d for a wall time of %d", profile.cpu_time_ns, profile.wall_time_ns)
+	}
+	// each run builds a list of 100000 pointers
+	if profile.alloc_bytes < 2*100000*8 {
+		t.Errorf("Expected allocations to be accounted, got %d bytes", profile.alloc_bytes)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestGetCheckWarnings(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -373,4 +465,4 @@ fake_check.foo = None`,
 
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
-}
\ No newline at end of file
+}
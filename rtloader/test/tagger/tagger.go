@@ -31,8 +31,9 @@ static void initTaggerTests(rtloader_t *rtloader) {
 import "C"
 
 var (
-	rtloader *C.rtloader_t
-	tmpfile  *os.File
+	rtloader  *C.rtloader_t
+	tmpfile   *os.File
+	tagsCalls int
 )
 
 func setUp() error {
@@ -94,10 +95,19 @@ except Exception as e:
 	return strings.TrimSpace(string(output)), err
 }
 
+func bumpTagsCacheGeneration() {
+	C.bump_tags_cache_generation(rtloader)
+}
+
+func disableTagsCache() {
+	C.disable_tags_cache(rtloader)
+}
+
 //revive:disable
 //export Tags
 func Tags(id *C.char, cardinality C.int) **C.char {
 	goID := C.GoString(id)
+	tagsCalls++
 
 	if goID != "base" {
 		return nil
@@ -228,3 +228,103 @@ func TestTagsErrorType(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestTagsCache(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	bumpTagsCacheGeneration()
+	tagsCalls = 0
+
+	code := fmt.Sprintf(`
+	import json
+	low = tagger.tag("base", tagger.LOW)
+	low.append("mutated")
+	with open(r'%s', 'w') as f:
+		f.write(json.dumps([tagger.tag("base", tagger.LOW), tagger.get_tags("base", False), tagger.tag("base", tagger.HIGH)]))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != `[["a", "b", "c"], ["a", "b", "c"], ["A", "B", "C"]]` {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if tagsCalls != 2 {
+		t.Errorf("Expected 2 calls to the tags callback, got %d", tagsCalls)
+	}
+
+	bumpTagsCacheGeneration()
+	out, err = run(`tagger.tag("base", tagger.LOW)`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if tagsCalls != 3 {
+		t.Errorf("Expected 3 calls to the tags callback, got %d", tagsCalls)
+	}
+
+	// the cached tags are neither served while disabled nor once re-enabled
+	disableTagsCache()
+	out, err = run(`tagger.tag("base", tagger.LOW); tagger.tag("base", tagger.LOW)`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if tagsCalls != 5 {
+		t.Errorf("Expected 5 calls to the tags callback, got %d", tagsCalls)
+	}
+
+	bumpTagsCacheGeneration()
+	out, err = run(`tagger.tag("base", tagger.LOW); tagger.tag("base", tagger.LOW)`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if tagsCalls != 6 {
+		t.Errorf("Expected 6 calls to the tags callback, got %d", tagsCalls)
+	}
+	disableTagsCache()
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func BenchmarkTag(b *testing.B) {
+	code := fmt.Sprintf(`for _ in range(%d): tagger.tag("base", tagger.LOW)`, b.N)
+
+	b.ResetTimer()
+	out, err := run(code)
+	b.StopTimer()
+
+	if err != nil {
+		b.Fatal(err)
+	}
+	if out != "" {
+		b.Fatalf("Unexpected printed value: '%s'", out)
+	}
+	b.ReportMetric(float64(b.N)/b.Elapsed().Seconds(), "calls/s")
+}
+
+func BenchmarkTagCached(b *testing.B) {
+	bumpTagsCacheGeneration()
+	code := fmt.Sprintf(`for _ in range(%d): tagger.tag("base", tagger.LOW)`, b.N)
+
+	b.ResetTimer()
+	out, err := run(code)
+	b.StopTimer()
+
+	if err != nil {
+		b.Fatal(err)
+	}
+	if out != "" {
+		b.Fatalf("Unexpected printed value: '%s'", out)
+	}
+	b.ReportMetric(float64(b.N)/b.Elapsed().Seconds(), "calls/s")
+}
@@ -21,10 +21,16 @@ import (
 #include "datadog_agent_rtloader.h"
 
 extern void getSubprocessOutput(char **, char **, char **, char **, int*, char **);
+extern int64_t startSubprocess(char **, char **, char **);
+extern int readSubprocessOutput(int64_t, char **, size_t *, char **, int *, char **);
+extern void stopSubprocess(int64_t);
 
 static void init_utilTests(rtloader_t *rtloader) {
    set_cgo_free_cb(rtloader, _free);
    set_get_subprocess_output_cb(rtloader, getSubprocessOutput);
+   set_start_subprocess_cb(rtloader, startSubprocess);
+   set_read_subprocess_output_cb(rtloader, readSubprocessOutput);
+   set_stop_subprocess_cb(rtloader, stopSubprocess);
 }
 */
 import "C"
@@ -124,3 +130,36 @@ func getSubprocessOutput(cargs **C.char, cenv **C.char, cstdout **C.char, cstder
 		*cexception = (*C.char)(helpers.TrackedCString(exception))
 	}
 }
+
+// handle of the subprocess started by startSubprocess
+const subprocessHandle = 42
+
+//export startSubprocess
+func startSubprocess(cargs **C.char, cenv **C.char, cexception **C.char) C.int64_t {
+	args = charArrayToSlice(cargs)
+	env = charArrayToSlice(cenv)
+	if setException {
+		*cexception = (*C.char)(helpers.TrackedCString(exception))
+		return 0
+	}
+	pendingChunks = chunks
+	return subprocessHandle
+}
+
+//export readSubprocessOutput
+func readSubprocessOutput(handle C.int64_t, cchunk **C.char, cchunkLen *C.size_t, cstderr **C.char, cretCode *C.int, cexception **C.char) C.int {
+	if len(pendingChunks) > 0 {
+		*cchunk = (*C.char)(helpers.TrackedCString(pendingChunks[0]))
+		*cchunkLen = C.size_t(len(pendingChunks[0]))
+		pendingChunks = pendingChunks[1:]
+		return 1
+	}
+	*cstderr = (*C.char)(helpers.TrackedCString(stderr))
+	*cretCode = C.int(retCode)
+	return 0
+}
+
+//export stopSubprocess
+func stopSubprocess(handle C.int64_t) {
+	stoppedHandle = int64(handle)
+}
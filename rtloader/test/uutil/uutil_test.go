@@ -22,10 +22,15 @@ var (
 	retCode      int
 	args         []string
 	env          []string
+
+	chunks        []string
+	pendingChunks []string
+	stoppedHandle int64
 )
 
 func resetTest() {
 	stdout = ""
+	chunks = nil
 	stderr = ""
 	setException = false
 	exception = ""
@@ -315,3 +320,129 @@ func TestGetSubprocessOutputEnv(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestStartSubprocessOutput(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	chunks = []string{"a\n", "b\n"}
+	stderr = "some error"
+	retCode = 2
+	code := fmt.Sprintf(`
+	p = _util.start_subprocess_output(["ls"])
+	parts = list(p)
+	with open(r'%s', 'w') as f:
+		f.write(repr(parts) + " | " + repr(p.result()))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != `['a\n', 'b\n'] | ('', 'some error', 2)` {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestStartSubprocessOutputResult(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	chunks = []string{"a\n", "b\n", "c"}
+	code := fmt.Sprintf(`
+	p = _util.start_subprocess_output(["ls"], env={'FOO': 'BAR'})
+	first = next(p)
+	r = p.result()
+	with open(r'%s', 'w') as f:
+		f.write(repr(first) + " | " + repr(r) + " | " + str(r is p.result()))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != `'a\n' | ('b\nc', '', 0) | True` {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if !reflect.DeepEqual(env, []string{"FOO=BAR"}) {
+		t.Errorf("Unexpected env value: '%v'", env)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestStartSubprocessOutputRaiseEmptyStdout(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	code := fmt.Sprintf(`_util.start_subprocess_output(["ls"], True).result()`)
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "SubprocessOutputEmptyError: get_subprocess_output expected output but had none." {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestStartSubprocessOutputRaiseException(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setException = true
+	exception = "THIS IS AN ERROR FROM GO"
+	code := fmt.Sprintf(`_util.start_subprocess_output(["ls"])`)
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "Exception: THIS IS AN ERROR FROM GO" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestStartSubprocessOutputClose(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	stoppedHandle = 0
+	chunks = []string{"a\n", "b\n"}
+	code := fmt.Sprintf(`
+	p = _util.start_subprocess_output(["ls"])
+	next(p)
+	p.close()
+	with open(r'%s', 'w') as f:
+		f.write(repr(list(p)) + " | " + repr(p.result()))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != `[] | ('', None, -1)` {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if stoppedHandle != subprocessHandle {
+		t.Errorf("Subprocess was not stopped")
+	}
+
+	// dropping a running subprocess stops it as well
+	stoppedHandle = 0
+	chunks = []string{"a\n"}
+	if _, err = run(`_util.start_subprocess_output(["ls"])`); err != nil {
+		t.Fatal(err)
+	}
+	if stoppedHandle != subprocessHandle {
+		t.Errorf("Subprocess was not stopped")
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
@@ -19,13 +19,54 @@
 #include "util.h"
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <sstream>
 
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
+// Time the calling thread waited in its last GILEnsure, accounted to the check it runs next
+static thread_local uint64_t pendingGilWaitNs = 0;
+
+static uint64_t monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static uint64_t threadCpuTimeNs()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    // FILETIME counts 100ns intervals
+    return (k.QuadPart + u.QuadPart) * 100;
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
 extern "C" DATADOG_AGENT_RTLOADER_API RtLoader *create(const char *python_home, const char *python_exe,
-                                                       cb_memory_tracker_t memtrack_cb)
+                                                       cb_memory_tracker_t memtrack_cb,
+                                                       cb_memory_tracker_batch_t memtrack_batch_cb)
 {
-    return new Three(python_home, python_exe, memtrack_cb);
+    return new Three(python_home, python_exe, memtrack_cb, memtrack_batch_cb);
 }
 
 extern "C" DATADOG_AGENT_RTLOADER_API void destroy(RtLoader *p)
@@ -33,15 +74,15 @@ extern "C" DATADOG_AGENT_RTLOADER_API void destroy(RtLoader *p)
     delete p;
 }
 
-Three::Three(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb)
-    : RtLoader(memtrack_cb)
+Three::Three(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb,
+             cb_memory_tracker_batch_t memtrack_batch_cb)
+    : RtLoader(memtrack_cb, memtrack_batch_cb)
     , _pythonHome("")
     , _pythonExe("")
     , _baseClass(NULL)
     , _pythonPaths()
+    , _checkProfiles()
     , _pymallocPrev{ 0 }
-    , _pymemInuse(0)
-    , _pymemAlloc(0)
 {
     _pythonHome = (python_home && strlen(python_home) > 0) ? python_home : _defaultPythonHome;
     _pythonExe = (python_exe && strlen(python_exe) > 0) ? python_exe : "";
@@ -125,28 +166,8 @@ bool Three::init()
     PyConfig_Clear(&_config);
 
     // Set PYTHONPATH
-    if (!_pythonPaths.empty()) {
-        char pathchr[] = "path";
-        PyObject *path = PySys_GetObject(pathchr); // borrowed
-        if (path == NULL) {
-            // sys.path doesn't exist, which should never happen.
-            // No exception is set on the interpreter, so no need to handle any.
-            setError("could not access sys.path");
-            goto done;
-        }
-        for (PyPaths::iterator pit = _pythonPaths.begin(); pit != _pythonPaths.end(); ++pit) {
-            PyObject *p = PyUnicode_FromString(pit->c_str());
-            if (p == NULL) {
-                setError("could not set pythonPath: " + _fetchPythonError());
-                goto done;
-            }
-            int retval = PyList_Append(path, p);
-            Py_XDECREF(p);
-            if (retval == -1) {
-                setError("could not append path to pythonPath: " + _fetchPythonError());
-                goto done;
-            }
-        }
+    if (!_setPythonPaths()) {
+        goto done;
     }
 
     if (init_stringutils() != EXIT_SUCCESS) {
@@ -238,9 +259,41 @@ bool Three::addPythonPath(const char *path)
     return false;
 }
 
+bool Three::_setPythonPaths()
+{
+    if (_pythonPaths.empty()) {
+        return true;
+    }
+
+    char pathchr[] = "path";
+    PyObject *path = PySys_GetObject(pathchr); // borrowed
+    if (path == NULL) {
+        // sys.path doesn't exist, which should never happen.
+        // No exception is set on the interpreter, so no need to handle any.
+        setError("could not access sys.path");
+        return false;
+    }
+    for (PyPaths::iterator pit = _pythonPaths.begin(); pit != _pythonPaths.end(); ++pit) {
+        PyObject *p = PyUnicode_FromString(pit->c_str());
+        if (p == NULL) {
+            setError("could not set pythonPath: " + _fetchPythonError());
+            return false;
+        }
+        int retval = PyList_Append(path, p);
+        Py_XDECREF(p);
+        if (retval == -1) {
+            setError("could not append path to pythonPath: " + _fetchPythonError());
+            return false;
+        }
+    }
+    return true;
+}
+
 rtloader_gilstate_t Three::GILEnsure()
 {
+    uint64_t start = monotonicNs();
     PyGILState_STATE state = PyGILState_Ensure();
+    pendingGilWaitNs = monotonicNs() - start;
     if (state == PyGILState_LOCKED) {
         return DATADOG_AGENT_RTLOADER_GIL_LOCKED;
     }
@@ -288,8 +341,51 @@ bool Three::getCheck(RtLoaderPyObject *py_class, const char *init_config_str, co
                      const char *check_id_str, const char *check_name, const char *agent_config_str,
                      RtLoaderPyObject *&check)
 {
+    PyObject *py_check = NULL;
+    ConfigPayload init_config = { init_config_str, 0, false };
+    ConfigPayload instance = { instance_str, 0, false };
+
+    if (!_getCheck(reinterpret_cast<PyObject *>(py_class), init_config, instance, check_id_str, check_name,
+                   agent_config_str, py_check)) {
+        return false;
+    }
+    check = reinterpret_cast<RtLoaderPyObject *>(py_check);
+    return true;
+}
 
-    PyObject *klass = reinterpret_cast<PyObject *>(py_class);
+bool Three::getCheckFromBinary(RtLoaderPyObject *py_class, const char *init_config_data, size_t init_config_len,
+                               const char *instance_data, size_t instance_len, const char *check_id_str,
+                               const char *check_name, RtLoaderPyObject *&check)
+{
+    PyObject *py_check = NULL;
+    ConfigPayload init_config = { init_config_data, init_config_len, true };
+    ConfigPayload instance = { instance_data, instance_len, true };
+
+    if (!_getCheck(reinterpret_cast<PyObject *>(py_class), init_config, instance, check_id_str, check_name, NULL,
+                   py_check)) {
+        return false;
+    }
+    check = reinterpret_cast<RtLoaderPyObject *>(py_check);
+    return true;
+}
+
+PyObject *Three::_loadConfig(PyObject *klass, const ConfigPayload &config)
+{
+    if (config.binary) {
+        return from_binary(config.data, config.len);
+    }
+
+    char load_config[] = "load_config";
+    char format[] = "(s)"; // use parentheses to force Tuple creation
+
+    // call `AgentCheck.load_config(config)`
+    return PyObject_CallMethod(klass, load_config, format, config.data);
+}
+
+bool Three::_getCheck(PyObject *klass, const ConfigPayload &init_config_payload,
+                      const ConfigPayload &instance_payload, const char *check_id_str, const char *check_name,
+                      const char *agent_config_str, PyObject *&check)
+{
     PyObject *agent_config = NULL;
     PyObject *init_config = NULL;
     PyObject *instance = NULL;
@@ -303,8 +399,7 @@ bool Three::getCheck(RtLoaderPyObject *py_class, const char *init_config_str, co
     char load_config[] = "load_config";
     char format[] = "(s)"; // use parentheses to force Tuple creation
 
-    // call `AgentCheck.load_config(init_config)`
-    init_config = PyObject_CallMethod(klass, load_config, format, init_config_str);
+    init_config = _loadConfig(klass, init_config_payload);
     if (init_config == NULL) {
         setError("error parsing init_config: " + _fetchPythonError());
         goto done;
@@ -322,8 +417,7 @@ bool Three::getCheck(RtLoaderPyObject *py_class, const char *init_config_str, co
         goto done;
     }
 
-    // call `AgentCheck.load_config(instance)`
-    instance = PyObject_CallMethod(klass, load_config, format, instance_str);
+    instance = _loadConfig(klass, instance_payload);
     if (instance == NULL) {
         setError("error parsing instance: " + _fetchPythonError());
         goto done;
@@ -434,7 +528,7 @@ done:
         return false;
     }
 
-    check = reinterpret_cast<RtLoaderPyObject *>(py_check);
+    check = py_check;
     return true;
 }
 
@@ -452,7 +546,15 @@ char *Three::runCheck(RtLoaderPyObject *check)
     char run[] = "run";
     PyObject *result = NULL;
 
+    uint64_t runStart = monotonicNs();
+    uint64_t cpuStart = threadCpuTimeNs();
+    size_t allocStart = _threadPymemAlloc();
+
     result = PyObject_CallMethod(py_check, run, NULL);
+
+    uint64_t runEnd = monotonicNs();
+    uint64_t cpuEnd = threadCpuTimeNs();
+    size_t allocEnd = _threadPymemAlloc();
     if (result == NULL || !PyUnicode_Check(result)) {
         setError("error invoking 'run' method: " + _fetchPythonError());
         goto done;
@@ -467,6 +569,15 @@ char *Three::runCheck(RtLoaderPyObject *check)
 
 done:
     Py_XDECREF(result);
+
+    check_profile_t &profile = _checkProfiles[py_check];
+    profile.runs++;
+    profile.wall_time_ns += runEnd - runStart;
+    profile.cpu_time_ns += cpuEnd - cpuStart;
+    profile.gil_wait_ns += pendingGilWaitNs;
+    profile.alloc_bytes += allocEnd - allocStart;
+    pendingGilWaitNs = 0;
+
     return ret;
 }
 
@@ -874,7 +985,28 @@ bool Three::getAttrBool(RtLoaderPyObject *obj, const char *attributeName, bool &
 
 void Three::decref(RtLoaderPyObject *obj)
 {
-    Py_XDECREF(reinterpret_cast<PyObject *>(obj));
+    PyObject *py_obj = reinterpret_cast<PyObject *>(obj);
+    if (py_obj == NULL) {
+        return;
+    }
+
+    bool released = Py_REFCNT(py_obj) == 1;
+    Py_DECREF(py_obj);
+
+    if (released) {
+        _checkProfiles.erase(py_obj);
+    }
+}
+
+bool Three::getCheckProfile(RtLoaderPyObject *check, check_profile_t &profile)
+{
+    std::map<PyObject *, check_profile_t>::const_iterator it
+        = _checkProfiles.find(reinterpret_cast<PyObject *>(check));
+    if (it == _checkProfiles.end()) {
+        return false;
+    }
+    profile = it->second;
+    return true;
 }
 
 void Three::incref(RtLoaderPyObject *obj)
@@ -925,6 +1057,11 @@ void Three::setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t cb)
     _set_submit_event_platform_event_cb(cb);
 }
 
+void Three::setSubmitMetricBatchCb(cb_submit_metric_batch_t cb)
+{
+    _set_submit_metric_batch_cb(cb);
+}
+
 void Three::setGetVersionCb(cb_get_version_t cb)
 {
     _set_get_version_cb(cb);
@@ -935,6 +1072,11 @@ void Three::setGetConfigCb(cb_get_config_t cb)
     _set_get_config_cb(cb);
 }
 
+void Three::setGetConfigBinaryCb(cb_get_config_binary_t cb)
+{
+    _set_get_config_binary_cb(cb);
+}
+
 void Three::setHeadersCb(cb_headers_t cb)
 {
     _set_headers_cb(cb);
@@ -985,6 +1127,21 @@ void Three::setSubprocessOutputCb(cb_get_subprocess_output_t cb)
     _set_get_subprocess_output_cb(cb);
 }
 
+void Three::setStartSubprocessCb(cb_start_subprocess_t cb)
+{
+    _set_start_subprocess_cb(cb);
+}
+
+void Three::setReadSubprocessOutputCb(cb_read_subprocess_output_t cb)
+{
+    _set_read_subprocess_output_cb(cb);
+}
+
+void Three::setStopSubprocessCb(cb_stop_subprocess_t cb)
+{
+    _set_stop_subprocess_cb(cb);
+}
+
 void Three::setCGOFreeCb(cb_cgo_free_t cb)
 {
     _set_cgo_free_cb(cb);
@@ -995,6 +1152,16 @@ void Three::setTagsCb(cb_tags_t cb)
     _set_tags_cb(cb);
 }
 
+void Three::bumpTagsCacheGeneration()
+{
+    _bump_tags_cache_generation();
+}
+
+void Three::disableTagsCache()
+{
+    _disable_tags_cache();
+}
+
 void Three::setGetConnectionInfoCb(cb_get_connection_info_t cb)
 {
     _set_get_connection_info_cb(cb);
@@ -27,7 +27,8 @@ public:
       Basic constructor, initializes the _error string to an empty string and
       errorFlag to false and set the supplied PYTHONHOME and ProgramName.
     */
-    Three(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb);
+    Three(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb,
+          cb_memory_tracker_batch_t memtrack_batch_cb);
 
     //! Destructor.
     /*!
@@ -60,6 +61,9 @@ public:
     bool getCheck(RtLoaderPyObject *py_class, const char *init_config_str, const char *instance_str,
                   const char *check_id_str, const char *check_name, const char *agent_config_str,
                   RtLoaderPyObject *&check);
+    bool getCheckFromBinary(RtLoaderPyObject *py_class, const char *init_config, size_t init_config_len,
+                            const char *instance, size_t instance_len, const char *check_id_str,
+                            const char *check_name, RtLoaderPyObject *&check);
 
     char *runCheck(RtLoaderPyObject *check);
     void cancelCheck(RtLoaderPyObject *check);
@@ -88,10 +92,12 @@ public:
     void setSubmitEventCb(cb_submit_event_t);
     void setSubmitHistogramBucketCb(cb_submit_histogram_bucket_t);
     void setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t);
+    void setSubmitMetricBatchCb(cb_submit_metric_batch_t);
 
     // datadog_agent API
     void setGetVersionCb(cb_get_version_t);
     void setGetConfigCb(cb_get_config_t);
+    void setGetConfigBinaryCb(cb_get_config_binary_t);
     void setHeadersCb(cb_headers_t);
     void setGetHostnameCb(cb_get_hostname_t);
     void setGetHostTagsCb(cb_get_host_tags_t);
@@ -111,15 +117,21 @@ public:
 
     void initPymemStats();
     void getPymemStats(pymem_stats_t &);
+    bool getCheckProfile(RtLoaderPyObject *check, check_profile_t &profile);
 
     // _util API
     virtual void setSubprocessOutputCb(cb_get_subprocess_output_t);
+    void setStartSubprocessCb(cb_start_subprocess_t);
+    void setReadSubprocessOutputCb(cb_read_subprocess_output_t);
+    void setStopSubprocessCb(cb_stop_subprocess_t);
 
     // CGO API
     void setCGOFreeCb(cb_cgo_free_t);
 
     // tagger
     void setTagsCb(cb_tags_t);
+    void bumpTagsCacheGeneration();
+    void disableTagsCache();
 
     // kubeutil
     void setGetConnectionInfoCb(cb_get_connection_info_t);
@@ -163,6 +175,52 @@ private:
     */
     std::string _fetchPythonError() const;
 
+    //! _setPythonPaths member.
+    /*!
+      \brief This member function appends the configured python paths to `sys.path` in the
+      current interpreter.
+      \return A boolean indicating the success or not of the operation, the error is set
+      on failure.
+    */
+    bool _setPythonPaths();
+
+    //! ConfigPayload type.
+    /*!
+      \brief A check configuration, either as a YAML C-string or in the binary config encoding.
+    */
+    struct ConfigPayload {
+        const char *data; /*!< the YAML C-string or the binary payload */
+        size_t len; /*!< the size of the binary payload */
+        bool binary; /*!< whether data holds a binary payload */
+    };
+
+    //! _loadConfig member.
+    /*!
+      \brief This member function turns a check configuration into a python object.
+      \param klass The python check class, whose `load_config` parses YAML configurations.
+      \param config The configuration to load.
+      \return A new reference to the python object, NULL with the python error set on failure.
+    */
+    PyObject *_loadConfig(PyObject *klass, const ConfigPayload &config);
+
+    //! _getCheck member.
+    /*!
+      \brief This member function instantiates a check.
+      \sa getCheck
+    */
+    bool _getCheck(PyObject *klass, const ConfigPayload &init_config, const ConfigPayload &instance,
+                   const char *check_id_str, const char *check_name, const char *agent_config_str,
+                   PyObject *&check);
+
+    //! _threadPymemAlloc static member.
+    /*!
+      \brief Returns the number of bytes allocated by the interpreter on the calling thread.
+      \return The total since the thread started, zero as long as initPymemStats wasn't called.
+
+      Used to attribute allocations to the running check.
+    */
+    static size_t _threadPymemAlloc();
+
     /*! PyPaths type prototype
       \typedef PyPaths defines a vector of strings.
     */
@@ -174,6 +232,7 @@ private:
     PyObject *_baseClass; /*!< PyObject * pointer to the base Agent check class */
     PyPaths _pythonPaths; /*!< string vector containing paths in the PYTHONPATH */
     PyThreadState *_threadState; /*!< PyThreadState * pointer to the saved Python interpreter thread state */
+    std::map<PyObject *, check_profile_t> _checkProfiles; /*!< resources used by each check that was run */
 
     //! pymallocAlloc member.
     /*!
@@ -264,8 +323,6 @@ private:
     static void pyrawFreeCb(void *ctx, void *ptr);
 
     PyObjectArenaAllocator _pymallocPrev; //!< Previous value of the global python arena allocator backend.
-    std::atomic_size_t _pymemInuse; //!< Number of bytes currently allocated.
-    std::atomic_size_t _pymemAlloc; //!< Total number of bytes allocated  since the start of the process.
 };
 
 #endif
\ No newline at end of file
@@ -23,6 +23,42 @@
 #    include <malloc/malloc.h>
 #endif
 
+// Bytes allocated on the current thread, runCheck attributes the difference over a
+// run to the check.
+static thread_local size_t threadPymemAlloc = 0;
+
+// The process-wide counters are split into cache line sized shards, threads are
+// spread over them round-robin so concurrent allocations from different threads
+// don't keep bouncing the same cache line. getPymemStats folds them on read.
+#define PYMEM_STATS_SHARDS 64
+
+struct alignas(64) PymemShard {
+    std::atomic<int64_t> inuse; // may be negative when memory is freed on another thread
+    std::atomic<uint64_t> alloc;
+};
+
+static PymemShard pymemShards[PYMEM_STATS_SHARDS];
+static std::atomic<size_t> pymemNextShard(0);
+static thread_local PymemShard *threadPymemShard
+    = &pymemShards[pymemNextShard.fetch_add(1, std::memory_order_relaxed) % PYMEM_STATS_SHARDS];
+
+static inline void pymemTrackAlloc(size_t size)
+{
+    threadPymemShard->inuse.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    threadPymemShard->alloc.fetch_add(size, std::memory_order_relaxed);
+    threadPymemAlloc += size;
+}
+
+static inline void pymemTrackFree(size_t size)
+{
+    threadPymemShard->inuse.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+size_t Three::_threadPymemAlloc()
+{
+    return threadPymemAlloc;
+}
+
 void Three::initPymemStats()
 {
     PyObject_GetArenaAllocator(&_pymallocPrev);
@@ -45,8 +81,15 @@ void Three::initPymemStats()
 
 void Three::getPymemStats(pymem_stats_t &s)
 {
-    s.inuse = _pymemInuse;
-    s.alloc = _pymemAlloc;
+    int64_t inuse = 0;
+    uint64_t alloc = 0;
+    for (size_t i = 0; i < PYMEM_STATS_SHARDS; i++) {
+        inuse += pymemShards[i].inuse.load(std::memory_order_relaxed);
+        alloc += pymemShards[i].alloc.load(std::memory_order_relaxed);
+    }
+    // shards are read one at a time, a free may be seen without its allocation
+    s.inuse = inuse > 0 ? static_cast<size_t>(inuse) : 0;
+    s.alloc = static_cast<size_t>(alloc);
 }
 
 // Tracking allocations by Pymalloc. Pymalloc is the optimized
@@ -59,8 +102,7 @@ void *Three::pymallocAlloc(size_t size)
 {
     void *ptr = _pymallocPrev.alloc(_pymallocPrev.ctx, size);
     if (ptr != NULL) {
-        _pymemInuse += size;
-        _pymemAlloc += size;
+        pymemTrackAlloc(size);
     }
     return ptr;
 }
@@ -68,7 +110,7 @@ void *Three::pymallocAlloc(size_t size)
 void Three::pymallocFree(void *ptr, size_t size)
 {
     _pymallocPrev.free(_pymallocPrev.ctx, ptr, size);
-    _pymemInuse -= size;
+    pymemTrackFree(size);
 }
 
 void *Three::pymallocAllocCb(void *ctx, size_t size)
@@ -109,9 +151,7 @@ void Three::pyrawTrackAlloc(void *ptr)
     if (ptr == NULL) {
         return;
     }
-    size_t size = pyrawAllocSize(ptr);
-    _pymemInuse += size;
-    _pymemAlloc += size;
+    pymemTrackAlloc(pyrawAllocSize(ptr));
 }
 
 void Three::pyrawTrackFree(void *ptr)
@@ -119,8 +159,7 @@ void Three::pyrawTrackFree(void *ptr)
     if (ptr == NULL) {
         return;
     }
-    size_t size = pyrawAllocSize(ptr);
-    _pymemInuse -= size;
+    pymemTrackFree(pyrawAllocSize(ptr));
 }
 
 void *Three::pyrawMalloc(size_t size)